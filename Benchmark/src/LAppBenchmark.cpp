@@ -0,0 +1,806 @@
+﻿/**
+ * 无窗口的性能基准
+ *
+ * 对 Resources/v3 下的每个模型分别测量：加载的各个阶段、各功能组合下稳定状态的 Update、
+ * csmUpdateModel、在 EGL 软件上下文中的 Draw，以及 HitTest / HitPart 的吞吐量，结果以 JSON 输出，
+ * 便于在版本之间比较。
+ *
+ * 用法：Benchmark [--resources DIR] [--output FILE|-] [--frames N] [--loads N] [--filter NAME] [--no-draw]
+ */
+
+#include <GL/glew.h>
+
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <CubismFramework.hpp>
+#include <LAppAllocator.hpp>
+#include <LAppAssetCache.hpp>
+#include <LAppDefine.hpp>
+#include <LAppModel.hpp>
+#include <LAppPal.hpp>
+#include <Log.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifndef LIVE2D_RESOURCES_DIR
+#define LIVE2D_RESOURCES_DIR "Resources"
+#endif
+
+namespace
+{
+    const float DeltaTime = 1.0f / 60.0f;
+    const int WarmupFrames = 30;
+    const int ViewportSize = 512;
+    const int HitTestPoints = 2000;
+
+    struct Options
+    {
+        std::string resources;
+        std::string output;
+        std::string filter;
+        int frames;
+        int loads;
+        bool draw;
+    };
+
+    /**
+    * @brief 各次测量的耗时，单位为微秒
+    */
+    struct Summary
+    {
+        double mean;
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    Summary Summarize(std::vector<double> samples)
+    {
+        Summary summary = {0.0, 0.0, 0.0, 0.0, 0.0};
+        if (samples.empty())
+        {
+            return summary;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        double sum = 0.0;
+        for (double sample : samples)
+        {
+            sum += sample;
+        }
+
+        // 最近秩法
+        const size_t n = samples.size();
+        summary.mean = sum / n;
+        summary.p50 = samples[std::max<size_t>(1, (n * 50 + 99) / 100) - 1];
+        summary.p95 = samples[std::max<size_t>(1, (n * 95 + 99) / 100) - 1];
+        summary.p99 = samples[std::max<size_t>(1, (n * 99 + 99) / 100) - 1];
+        summary.max = samples[n - 1];
+        return summary;
+    }
+
+    double Median(std::vector<double> samples)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    double Now()
+    {
+        return LAppPal::GetCurrentTimePoint();
+    }
+
+    /**
+    * @brief 逐段拼出 JSON，不做缩进以外的格式化
+    */
+    class JsonWriter
+    {
+    public:
+        JsonWriter()
+            : _first(true)
+        {
+        }
+
+        void BeginObject(const char* key = NULL)
+        {
+            Key(key);
+            _text += "{";
+            _first = true;
+        }
+
+        void EndObject()
+        {
+            _text += "}";
+            _first = false;
+        }
+
+        void BeginArray(const char* key = NULL)
+        {
+            Key(key);
+            _text += "[";
+            _first = true;
+        }
+
+        void EndArray()
+        {
+            _text += "]";
+            _first = false;
+        }
+
+        void Number(const char* key, double value)
+        {
+            Key(key);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "%.4f", value);
+            _text += buffer;
+        }
+
+        void Integer(const char* key, long long value)
+        {
+            Key(key);
+            _text += std::to_string(value);
+        }
+
+        void String(const char* key, const char* value)
+        {
+            Key(key);
+            _text += "\"";
+            for (const char* c = value; *c != '\0'; ++c)
+            {
+                if (*c == '"' || *c == '\\')
+                {
+                    _text += '\\';
+                }
+                if (static_cast<unsigned char>(*c) >= 0x20)
+                {
+                    _text += *c;
+                }
+            }
+            _text += "\"";
+        }
+
+        void Null(const char* key)
+        {
+            Key(key);
+            _text += "null";
+        }
+
+        void Summary(const char* key, const ::Summary& summary)
+        {
+            BeginObject(key);
+            Number("meanUs", summary.mean);
+            Number("p50Us", summary.p50);
+            Number("p95Us", summary.p95);
+            Number("p99Us", summary.p99);
+            Number("maxUs", summary.max);
+            EndObject();
+        }
+
+        const std::string& GetText() const
+        {
+            return _text;
+        }
+
+    private:
+        void Key(const char* key)
+        {
+            if (!_first)
+            {
+                _text += ",";
+            }
+            _first = false;
+            if (key != NULL)
+            {
+                _text += "\"";
+                _text += key;
+                _text += "\":";
+            }
+        }
+
+        std::string _text;
+        bool _first;
+    };
+
+    /**
+    * @brief 无窗口的 EGL 上下文，绘制到离屏的帧缓冲
+    */
+    class HeadlessContext
+    {
+    public:
+        HeadlessContext()
+            : _display(EGL_NO_DISPLAY)
+            , _context(EGL_NO_CONTEXT)
+            , _framebuffer(0)
+            , _colorBuffer(0)
+            , _depthBuffer(0)
+        {
+        }
+
+        ~HeadlessContext()
+        {
+            if (_framebuffer != 0)
+            {
+                glDeleteFramebuffers(1, &_framebuffer);
+                glDeleteRenderbuffers(1, &_colorBuffer);
+                glDeleteRenderbuffers(1, &_depthBuffer);
+            }
+            if (_context != EGL_NO_CONTEXT)
+            {
+                eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+                eglDestroyContext(_display, _context);
+            }
+            if (_display != EGL_NO_DISPLAY)
+            {
+                eglTerminate(_display);
+            }
+        }
+
+        bool Create(int width, int height)
+        {
+            // 优先使用不需要窗口系统的 surfaceless 平台（Mesa），否则退回默认显示
+            PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay != NULL)
+            {
+                _display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+            }
+            if (_display == EGL_NO_DISPLAY)
+            {
+                _display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+            }
+            if (_display == EGL_NO_DISPLAY || !eglInitialize(_display, NULL, NULL) || !eglBindAPI(EGL_OPENGL_API))
+            {
+                return false;
+            }
+
+            // 只绘制到帧缓冲对象，没有匹配的配置时使用 EGL_KHR_no_config_context
+            const EGLint configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+            EGLConfig config = EGL_NO_CONFIG_KHR;
+            EGLint configCount = 0;
+            if (!eglChooseConfig(_display, configAttributes, &config, 1, &configCount) || configCount == 0)
+            {
+                config = EGL_NO_CONFIG_KHR;
+            }
+
+            _context = eglCreateContext(_display, config, EGL_NO_CONTEXT, NULL);
+            if (_context == EGL_NO_CONTEXT || !eglMakeCurrent(_display, EGL_NO_SURFACE, EGL_NO_SURFACE, _context))
+            {
+                return false;
+            }
+
+            if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress))
+            {
+                return false;
+            }
+
+            glGenFramebuffers(1, &_framebuffer);
+            glGenRenderbuffers(1, &_colorBuffer);
+            glGenRenderbuffers(1, &_depthBuffer);
+            glBindRenderbuffer(GL_RENDERBUFFER, _colorBuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, _depthBuffer);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+            glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _colorBuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthBuffer);
+            glViewport(0, 0, width, height);
+            return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        void Clear()
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        const char* GetRenderer() const
+        {
+            const GLubyte* renderer = glGetString(GL_RENDERER);
+            return renderer != NULL ? reinterpret_cast<const char*>(renderer) : "";
+        }
+
+        const char* GetVersion() const
+        {
+            const GLubyte* version = glGetString(GL_VERSION);
+            return version != NULL ? reinterpret_cast<const char*>(version) : "";
+        }
+
+    private:
+        EGLDisplay _display;
+        EGLContext _context;
+        GLuint _framebuffer;
+        GLuint _colorBuffer;
+        GLuint _depthBuffer;
+    };
+
+    /**
+    * @brief Update 的功能组合
+    */
+    struct UpdateConfig
+    {
+        const char* name;
+        bool eyeBlink;
+        bool breath;
+        bool motion;
+        bool expression;
+        bool lipSync;
+    };
+
+    const UpdateConfig UpdateConfigs[] = {
+        {"minimal", false, false, false, false, false},     // 只有物理与姿势
+        {"eyeBlink", true, false, false, false, false},
+        {"breath", false, true, false, false, false},
+        {"motion", false, false, true, false, false},
+        {"expression", false, false, false, true, false},
+        {"lipSync", false, false, false, false, true},
+        {"all", true, true, true, true, true},
+    };
+
+    void CollectString(void* collector, const char* value)
+    {
+        static_cast<std::vector<std::string>*>(collector)->push_back(value);
+    }
+
+    void CollectMotionGroup(void* collector, const char* groupName, int count)
+    {
+        if (count > 0)
+        {
+            static_cast<std::vector<std::string>*>(collector)->push_back(groupName);
+        }
+    }
+
+    void CountHit(void* collector, const char* /* partId */)
+    {
+        ++*static_cast<long long*>(collector);
+    }
+
+    /**
+    * @brief 加载失败（例如缺少 moc3）时返回 NULL
+    */
+    LAppModel* LoadModel(const std::string& path)
+    {
+        LAppModel* model = new LAppModel();
+        model->LoadModelJson(path.c_str());
+        if (model->GetModel() == NULL)
+        {
+            delete model;
+            return NULL;
+        }
+        model->Resize(ViewportSize, ViewportSize);
+        return model;
+    }
+
+    /**
+    * @brief 按配置开关功能，返回主动作的组名（不播放动作时为空）
+    */
+    std::string ApplyConfig(LAppModel* model, const UpdateConfig& config)
+    {
+        model->StopAllMotions();
+        model->ResetExpression();
+        model->ResetParameters();
+        model->ResetPose();
+        model->GetLipSync().Stop();
+        model->SetAutoBlinkEnable(config.eyeBlink);
+        model->SetAutoBreathEnable(config.breath);
+
+        if (config.expression)
+        {
+            std::vector<std::string> expressions;
+            model->GetExpressionIds(&expressions, CollectString);
+            if (!expressions.empty())
+            {
+                model->SetExpression(expressions[0].c_str());
+            }
+        }
+
+        if (config.lipSync)
+        {
+            model->GetLipSync().OpenStream(16000, 1, 1.0f);
+        }
+
+        std::string motionGroup;
+        if (config.motion)
+        {
+            std::vector<std::string> groups;
+            model->GetMotionGroups(&groups, CollectMotionGroup);
+            if (!groups.empty())
+            {
+                motionGroup = std::find(groups.begin(), groups.end(), "Idle") != groups.end() ? "Idle" : groups[0];
+            }
+        }
+        return motionGroup;
+    }
+
+    /**
+    * @brief 口型同步的输入：每帧推入 1/60 秒的 220 Hz 正弦
+    */
+    void FeedLipSync(LAppModel* model, int frame)
+    {
+        float samples[16000 / 60];
+        const int count = static_cast<int>(sizeof(samples) / sizeof(samples[0]));
+        for (int i = 0; i < count; ++i)
+        {
+            const double t = (frame * count + i) / 16000.0;
+            samples[i] = static_cast<float>(0.5 * sin(2.0 * 3.14159265358979 * 220.0 * t));
+        }
+        model->GetLipSync().Feed(samples, count, LAppLipSync::SampleFormat_Float32);
+    }
+
+    void StepConfig(LAppModel* model, const UpdateConfig& config, const std::string& motionGroup, int frame)
+    {
+        if (!motionGroup.empty() && model->IsMotionFinished())
+        {
+            model->StartRandomMotion(motionGroup.c_str(), LAppDefine::PriorityForce, NULL, NULL, NULL, NULL);
+        }
+        if (config.lipSync)
+        {
+            FeedLipSync(model, frame);
+        }
+    }
+
+    /**
+    * @brief 某次加载失败时不写入结果并返回 false
+    */
+    bool BenchmarkLoad(JsonWriter& json, const std::string& path, int loads)
+    {
+        // 关闭资源缓存，每次都从文件读取
+        std::vector<double> setting, moc, expressions, physics, pose, userData, motions, textures, total, peak;
+        for (int i = 0; i < loads; ++i)
+        {
+            // 基准测试拥有整个进程，可以重置峰值以得到每次加载的精确峰值
+            LAppPal::ResetPeakResidentBytes();
+            LAppModel* model = LoadModel(path);
+            if (model == NULL)
+            {
+                fprintf(stderr, "failed to load %s (run %d)\n", path.c_str(), i + 1);
+                return false;
+            }
+            const LAppModel::LoadTimings& timings = model->GetLoadTimings();
+            setting.push_back(timings.settingMs);
+            moc.push_back(timings.mocMs);
+            expressions.push_back(timings.expressionsMs);
+            physics.push_back(timings.physicsMs);
+            pose.push_back(timings.poseMs);
+            userData.push_back(timings.userDataMs);
+            motions.push_back(timings.motionsMs);
+            textures.push_back(timings.texturesMs);
+            total.push_back(timings.totalMs);
+            LAppModel::MemoryStats stats;
+            model->GetMemoryStats(stats);
+            peak.push_back(static_cast<double>(stats.loadPeakBytes));
+            delete model;
+        }
+
+        json.BeginObject("load");
+        json.Integer("runs", loads);
+        json.Number("settingMs", Median(setting));
+        json.Number("mocMs", Median(moc));
+        json.Number("expressionsMs", Median(expressions));
+        json.Number("physicsMs", Median(physics));
+        json.Number("poseMs", Median(pose));
+        json.Number("userDataMs", Median(userData));
+        json.Number("motionsMs", Median(motions));
+        json.Number("texturesMs", Median(textures));
+        json.Number("totalMs", Median(total));
+        json.Integer("peakBytes", static_cast<long long>(Median(peak)));
+        json.EndObject();
+        return true;
+    }
+
+    void BenchmarkUpdate(JsonWriter& json, LAppModel* model, int frames)
+    {
+        json.BeginObject("update");
+        for (const UpdateConfig& config : UpdateConfigs)
+        {
+            model->SetRandomSeed(1);
+            const std::string motionGroup = ApplyConfig(model, config);
+            for (int frame = 0; frame < WarmupFrames; ++frame)
+            {
+                StepConfig(model, config, motionGroup, frame);
+                model->Update(DeltaTime);
+            }
+
+            std::vector<double> samples;
+            samples.reserve(frames);
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                StepConfig(model, config, motionGroup, WarmupFrames + frame);
+                const double start = Now();
+                model->Update(DeltaTime);
+                samples.push_back((Now() - start) * 1e6);
+            }
+            json.Summary(config.name, Summarize(samples));
+        }
+        json.EndObject();
+
+        // csmUpdateModel 与功能无关，只测一次
+        ApplyConfig(model, UpdateConfigs[0]);
+        std::vector<double> samples;
+        samples.reserve(frames);
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            model->Update(DeltaTime);
+            const double start = Now();
+            model->UpdateDrawables();
+            samples.push_back((Now() - start) * 1e6);
+        }
+        json.Summary("modelUpdate", Summarize(samples));
+    }
+
+    void BenchmarkDraw(JsonWriter& json, LAppModel* model, HeadlessContext& context, int frames)
+    {
+        ApplyConfig(model, UpdateConfigs[0]);
+
+        // glFinish 使软件渲染的实际耗时计入本帧
+        std::vector<double> samples;
+        samples.reserve(frames);
+        for (int frame = 0; frame < WarmupFrames + frames; ++frame)
+        {
+            model->Update(DeltaTime);
+            model->UpdateDrawables();
+            context.Clear();
+            const double start = Now();
+            model->Draw();
+            glFinish();
+            if (frame >= WarmupFrames)
+            {
+                samples.push_back((Now() - start) * 1e6);
+            }
+        }
+        json.Summary("draw", Summarize(samples));
+    }
+
+    void BenchmarkHitTest(JsonWriter& json, LAppModel* model)
+    {
+        ApplyConfig(model, UpdateConfigs[0]);
+        model->Update(DeltaTime);
+        model->UpdateDrawables();
+
+        std::vector<std::pair<float, float>> points;
+        srand(1);
+        for (int i = 0; i < HitTestPoints; ++i)
+        {
+            points.push_back(std::make_pair(static_cast<float>(rand() % ViewportSize),
+                                            static_cast<float>(rand() % ViewportSize)));
+        }
+
+        std::vector<std::string> hitAreas;
+        model->GetHitAreaNames(&hitAreas, CollectString);
+
+        json.BeginObject("hitTest");
+        json.Integer("hitAreas", static_cast<long long>(hitAreas.size()));
+        if (hitAreas.empty())
+        {
+            json.Null("callsPerSecond");
+        }
+        else
+        {
+            long long hits = 0;
+            const double start = Now();
+            for (const std::string& hitArea : hitAreas)
+            {
+                for (const std::pair<float, float>& point : points)
+                {
+                    hits += model->HitTest(hitArea.c_str(), point.first, point.second) ? 1 : 0;
+                }
+            }
+            const double seconds = Now() - start;
+            json.Number("callsPerSecond", hitAreas.size() * points.size() / std::max(seconds, 1e-9));
+            json.Integer("hits", hits);
+        }
+        json.EndObject();
+
+        long long hits = 0;
+        const double start = Now();
+        for (const std::pair<float, float>& point : points)
+        {
+            model->HitPart(point.first, point.second, false, &hits, CountHit);
+        }
+        const double seconds = Now() - start;
+        json.BeginObject("hitPart");
+        json.Number("callsPerSecond", points.size() / std::max(seconds, 1e-9));
+        json.Integer("hits", hits);
+        json.EndObject();
+    }
+
+    bool ParseOptions(int argc, char** argv, Options* options)
+    {
+        options->resources = LIVE2D_RESOURCES_DIR;
+        options->output = "benchmark.json";
+        options->frames = 300;
+        options->loads = 3;
+        options->draw = true;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (arg == "--resources" && hasValue)
+            {
+                options->resources = argv[++i];
+            }
+            else if (arg == "--output" && hasValue)
+            {
+                options->output = argv[++i];
+            }
+            else if (arg == "--filter" && hasValue)
+            {
+                options->filter = argv[++i];
+            }
+            else if (arg == "--frames" && hasValue)
+            {
+                options->frames = std::max(1, atoi(argv[++i]));
+            }
+            else if (arg == "--loads" && hasValue)
+            {
+                options->loads = std::max(1, atoi(argv[++i]));
+            }
+            else if (arg == "--no-draw")
+            {
+                options->draw = false;
+            }
+            else
+            {
+                fprintf(stderr, "usage: %s [--resources DIR] [--output FILE|-] [--frames N] [--loads N] "
+                                "[--filter NAME] [--no-draw]\n", argv[0]);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+    * @brief Resources/v3 下每个目录中的 *.model3.json，按名称排序
+    */
+    std::vector<std::filesystem::path> FindModels(const std::string& resources, const std::string& filter)
+    {
+        std::vector<std::filesystem::path> models;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(std::filesystem::u8path(resources) / "v3", error))
+        {
+            if (!entry.is_directory())
+            {
+                continue;
+            }
+            for (const auto& file : std::filesystem::directory_iterator(entry.path(), error))
+            {
+                const std::string name = file.path().filename().u8string();
+                const std::string suffix = ".model3.json";
+                if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0 &&
+                    (filter.empty() || entry.path().filename().u8string() == filter))
+                {
+                    models.push_back(file.path());
+                }
+            }
+        }
+        std::sort(models.begin(), models.end());
+        return models;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        return 2;
+    }
+
+    const std::vector<std::filesystem::path> models = FindModels(options.resources, options.filter);
+    if (models.empty())
+    {
+        fprintf(stderr, "no models found under %s/v3\n", options.resources.c_str());
+        return 1;
+    }
+
+    // 渲染器在加载时创建，因此即使不测量 Draw 也需要 GL 上下文
+    HeadlessContext context;
+    if (!context.Create(ViewportSize, ViewportSize))
+    {
+        fprintf(stderr, "failed to create a headless EGL context\n");
+        return 1;
+    }
+
+    live2dLogEnable = false;
+    static LAppAllocator allocator;
+    static Csm::CubismFramework::Option option;
+    option.LogFunction = LAppPal::PrintLn;
+    option.LoggingLevel = Csm::CubismFramework::Option::LogLevel_Warning;
+    Csm::CubismFramework::StartUp(&allocator, &option);
+    Csm::CubismFramework::Initialize();
+    LAppAssetCache::SetEnable(false);
+
+    JsonWriter json;
+    json.BeginObject();
+    json.Integer("version", 1);
+    json.Integer("frames", options.frames);
+    json.Number("deltaTime", DeltaTime);
+    json.BeginObject("context");
+    json.String("renderer", context.GetRenderer());
+    json.String("version", context.GetVersion());
+    json.Integer("width", ViewportSize);
+    json.Integer("height", ViewportSize);
+    json.EndObject();
+
+    json.BeginArray("models");
+    for (const std::filesystem::path& path : models)
+    {
+        const std::string name = path.parent_path().filename().u8string();
+        fprintf(stderr, "%s\n", name.c_str());
+
+        json.BeginObject();
+        json.String("name", name.c_str());
+        json.String("file", path.filename().u8string().c_str());
+
+        LAppModel* model = LoadModel(path.u8string());
+        if (model == NULL)
+        {
+            json.String("error", "failed to load");
+            json.EndObject();
+            continue;
+        }
+        delete model;
+
+        model = BenchmarkLoad(json, path.u8string(), options.loads) ? LoadModel(path.u8string()) : NULL;
+        if (model == NULL)
+        {
+            json.String("error", "failed to load");
+            json.EndObject();
+            continue;
+        }
+        json.Integer("parameters", model->GetParameterCount());
+        json.Integer("parts", model->GetPartCount());
+        json.Integer("drawables", model->GetModel()->GetDrawableCount());
+
+        BenchmarkUpdate(json, model, options.frames);
+        if (options.draw)
+        {
+            BenchmarkDraw(json, model, context, options.frames);
+        }
+        else
+        {
+            json.Null("draw");
+        }
+        BenchmarkHitTest(json, model);
+
+        delete model;
+        json.EndObject();
+    }
+    json.EndArray();
+    json.EndObject();
+
+    LAppAssetCache::WaitForLoader();
+    Csm::CubismFramework::Dispose();
+
+    if (options.output == "-")
+    {
+        fputs(json.GetText().c_str(), stdout);
+        fputs("\n", stdout);
+        return 0;
+    }
+
+    FILE* file = fopen(options.output.c_str(), "w");
+    if (file == NULL)
+    {
+        perror(options.output.c_str());
+        return 1;
+    }
+    fputs(json.GetText().c_str(), file);
+    fputs("\n", file);
+    fclose(file);
+    return 0;
+}
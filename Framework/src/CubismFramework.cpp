@@ -218,11 +218,27 @@ CubismIdManager* CubismFramework::GetIdManager()
     return s_cubismIdManager;
 }
 
+void CubismFramework::BeginSharedAllocation()
+{
+    if (s_allocator)
+    {
+        s_allocator->BeginSharedAllocation();
+    }
+}
+
+void CubismFramework::EndSharedAllocation()
+{
+    if (s_allocator)
+    {
+        s_allocator->EndSharedAllocation();
+    }
+}
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
 void* CubismFramework::Allocate(csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
 {
-    void* address = GetAllocator()->Allocate(size);
+    void* address = GetAllocator()->AllocateWithSource(size, fileName, lineNumber);
 
     CubismLogVerbose("CubismFramework::Allocate(0x%p, %dbytes) %s(%d)", address, size, fileName, lineNumber);
 
@@ -236,7 +252,7 @@ void* CubismFramework::Allocate(csmSizeType size, const csmChar* fileName, csmIn
 
 void* CubismFramework::AllocateAligned(csmSizeType size, csmUint32 alignment, const csmChar* fileName, csmInt32 lineNumber)
 {
-    void* address = GetAllocator()->AllocateAligned(size, alignment);
+    void* address = GetAllocator()->AllocateAlignedWithSource(size, alignment, fileName, lineNumber);
 
     CubismLogVerbose("CubismFramework::AllocateAligned(0x%p, a:%d, %dbytes) %s(%d)", address, alignment, size, fileName, lineNumber);
 
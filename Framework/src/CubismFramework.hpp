@@ -314,6 +314,18 @@ public:
      */
     static CubismIdManager* GetIdManager();
 
+    /**
+     * Marks the start of allocations owned by the Framework rather than by a model.
+     *
+     * Forwards to ICubismAllocator::BeginSharedAllocation(). Must be paired with EndSharedAllocation().
+     */
+    static void BeginSharedAllocation();
+
+    /**
+     * Marks the end of allocations started with BeginSharedAllocation().
+     */
+    static void EndSharedAllocation();
+
 #ifdef CSM_DEBUG_MEMORY_LEAKING
 
     /**
@@ -58,6 +58,7 @@ const csmChar* Parameter = "Parameter";
 const csmChar* SoundPath = "Sound";
 const csmChar* FadeInTime = "FadeInTime";
 const csmChar* FadeOutTime = "FadeOutTime";
+const csmChar* BakeRate = "BakeRate";
 
 // Layout
 const csmChar* CenterX = "CenterX";
@@ -368,6 +369,13 @@ csmFloat32 CubismModelSettingJson::GetMotionFadeOutTimeValue(const csmChar* grou
     return (*_jsonValue[FrequentNode_Motions])[groupName][index][FadeOutTime].ToFloat();
 }
 
+csmFloat32 CubismModelSettingJson::GetMotionBakeRateValue(const csmChar* groupName, csmInt32 index)
+{
+    Utils::Value& node = (*_jsonValue[FrequentNode_Motions])[groupName][index][BakeRate];
+    if (node.IsNull() || node.IsError())return 0.0f;
+    return node.ToFloat();
+}
+
 
 const csmChar* CubismModelSettingJson::GetUserDataFile()
 {
@@ -208,6 +208,16 @@ public:
      */
     csmFloat32 GetMotionFadeOutTimeValue(const csmChar* groupName, csmInt32 index);
 
+    /**
+     * Returns the sampling rate at which the Motion in the Motion Group is baked.
+     *
+     * @param groupName Name to the desired Motion Group
+     * @param index Index to the desired Motion
+     *
+     * @return "BakeRate" of the Motion [Hz]; 0 if it is not set
+     */
+    csmFloat32 GetMotionBakeRateValue(const csmChar* groupName, csmInt32 index);
+
     /**
      * Returns the name of User Data File in the Model.
      *
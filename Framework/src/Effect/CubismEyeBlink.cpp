@@ -36,6 +36,8 @@ CubismEyeBlink::CubismEyeBlink(ICubismModelSetting* modelSetting)
     , _openingSeconds(0.15f)
     , _userTimeSeconds(0.0f)
 {
+    SetRandomSeed(static_cast<csmUint32>(rand()));
+
     if (modelSetting == NULL)
     {
         return;
@@ -50,9 +52,13 @@ CubismEyeBlink::CubismEyeBlink(ICubismModelSetting* modelSetting)
 CubismEyeBlink::~CubismEyeBlink()
 { }
 
-csmFloat32 CubismEyeBlink::DetermineNextBlinkingTiming() const
+csmFloat32 CubismEyeBlink::DetermineNextBlinkingTiming()
 {
-    const csmFloat32 r = static_cast<csmFloat32>(rand()) / RAND_MAX;
+    // xorshift32
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    const csmFloat32 r = static_cast<csmFloat32>(_randomState >> 8) / static_cast<csmFloat32>(0xFFFFFF);
 
     return _userTimeSeconds + (r * (2.0f * _blinkingIntervalSeconds - 1.0f));
 }
@@ -69,6 +75,12 @@ void CubismEyeBlink::SetBlinkingSettings(csmFloat32 closing, csmFloat32 closed,
     _openingSeconds = opening;
 }
 
+void CubismEyeBlink::SetRandomSeed(csmUint32 seed)
+{
+    // xorshift は 0 から抜け出せない
+    _randomState = seed != 0 ? seed : 0x9E3779B9u;
+}
+
 void CubismEyeBlink::SetParameterIds(const csmVector<CubismIdHandle>& parameterIds)
 {
     _parameterIds = parameterIds;
@@ -80,6 +92,16 @@ const csmVector<CubismIdHandle>& CubismEyeBlink::GetParameterIds() const
 }
 
 void CubismEyeBlink::UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSeconds)
+{
+    const csmFloat32 parameterValue = UpdateBlinkingValue(deltaTimeSeconds);
+
+    for (csmUint32 i = 0; i < _parameterIds.GetSize(); ++i)
+    {
+        model->SetParameterValue(_parameterIds[i], parameterValue);
+    }
+}
+
+csmFloat32 CubismEyeBlink::UpdateBlinkingValue(csmFloat32 deltaTimeSeconds)
 {
     _userTimeSeconds += deltaTimeSeconds;
     csmFloat32 parameterValue;
@@ -150,10 +172,7 @@ void CubismEyeBlink::UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSe
         parameterValue = -parameterValue;
     }
 
-    for (csmUint32 i = 0; i < _parameterIds.GetSize(); ++i)
-    {
-        model->SetParameterValue(_parameterIds[i], parameterValue);
-    }
+    return parameterValue;
 }
 
 }}}
@@ -69,6 +69,16 @@ public:
      */
     void            SetBlinkingSettings(csmFloat32 closing, csmFloat32 closed, csmFloat32 opening);
 
+    /**
+     * Seeds the generator that picks the time of the next blink.
+     *
+     * Each instance has its own generator, seeded from rand() on creation, so
+     * blinking is reproducible for a given seed and sequence of time steps.
+     *
+     * @param seed Seed value
+     */
+    void            SetRandomSeed(csmUint32 seed);
+
     /**
      * Sets the collection of parameter IDs to apply blinking.
      *
@@ -91,13 +101,22 @@ public:
      */
     void            UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSeconds);
 
+    /**
+     * Advances the blinking state without touching the model.
+     *
+     * @param deltaTimeSeconds Current time in seconds
+     *
+     * @return Value that UpdateParameters would set to every blinking parameter
+     */
+    csmFloat32      UpdateBlinkingValue(csmFloat32 deltaTimeSeconds);
+
 private:
 
     CubismEyeBlink(ICubismModelSetting* modelSetting);
 
     virtual ~CubismEyeBlink();
 
-    csmFloat32        DetermineNextBlinkingTiming() const;
+    csmFloat32        DetermineNextBlinkingTiming();
 
     csmInt32                    _blinkingState;
     csmVector<CubismIdHandle>   _parameterIds;
@@ -108,6 +127,7 @@ private:
     csmFloat32                  _closedSeconds;
     csmFloat32                  _openingSeconds;
     csmFloat32                  _userTimeSeconds;
+    csmUint32                   _randomState;
 
 };
 
@@ -21,6 +21,27 @@ const csmChar*   FadeIn = "FadeInTime";
 const csmChar*   Link   = "Link";
 const csmChar*   Groups = "Groups";
 const csmChar*   Id     = "Id";
+
+csmBool IsSame(const csmVector<csmFloat32>& a, const csmVector<csmFloat32>& b)
+{
+    for (csmUint32 i = 0; i < a.GetSize(); ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Copy(const csmVector<csmFloat32>& src, csmVector<csmFloat32>& dst)
+{
+    for (csmUint32 i = 0; i < src.GetSize(); ++i)
+    {
+        dst[i] = src[i];
+    }
+}
 }
 
 CubismPose::PartData::PartData()
@@ -63,6 +84,7 @@ void CubismPose::PartData::Initialize(CubismModel* model)
 
 CubismPose::CubismPose() : _fadeTimeSeconds(DefaultFadeInSeconds)
                          , _lastModel(NULL)
+                         , _idle(false)
 { }
 
 CubismPose::~CubismPose()
@@ -176,38 +198,115 @@ void CubismPose::Reset(CubismModel* model)
 
     }
 
+    BuildTables();
 }
 
-void CubismPose::CopyPartOpacities(CubismModel* model)
+void CubismPose::BuildTables()
 {
-    for (csmUint32 groupIndex = 0; groupIndex < _partGroups.GetSize(); ++groupIndex)
-    {
-        PartData& partData = _partGroups[groupIndex];
+    _partSlots.Clear();
+    _parameterIndices.Clear();
+    _slotPartIndices.Clear();
+    _linkSourceSlots.Clear();
+    _linkTargetSlots.Clear();
 
-        if (partData.Link.GetSize() == 0)
-        {
-            continue; // 連動するパラメータはない
-        }
+    for (csmUint32 i = 0; i < _partGroups.GetSize(); ++i)
+    {
+        _partSlots.PushBack(GetSlot(_partGroups[i].PartIndex));
+        _parameterIndices.PushBack(_partGroups[i].ParameterIndex);
+    }
 
-        const csmInt32    partIndex = _partGroups[groupIndex].PartIndex;
-        const csmFloat32  opacity = model->GetPartOpacity(partIndex);
+    // CopyPartOpacities と同じ順序で並べる
+    for (csmUint32 i = 0; i < _partGroups.GetSize(); ++i)
+    {
+        const PartData& partData = _partGroups[i];
 
         for (csmUint32 linkIndex = 0; linkIndex < partData.Link.GetSize(); ++linkIndex)
         {
-            PartData&   linkPart = partData.Link[linkIndex];
-            const csmInt32    linkPartIndex = linkPart.PartIndex;
+            const csmInt32 linkPartIndex = partData.Link[linkIndex].PartIndex;
 
             if (linkPartIndex < 0)
             {
                 continue;
             }
 
-            model->SetPartOpacity(linkPartIndex, opacity);
+            _linkSourceSlots.PushBack(_partSlots[i]);
+            _linkTargetSlots.PushBack(GetSlot(linkPartIndex));
+        }
+    }
+
+    const csmInt32 slotCount = _slotPartIndices.GetSize();
+    const csmInt32 entryCount = _partGroups.GetSize();
+    _opacities.UpdateSize(slotCount, 0.0f, false);
+    _lastOpacities.UpdateSize(slotCount, 0.0f, false);
+    _parameterValues.UpdateSize(entryCount, 0.0f, false);
+    _lastParameterValues.UpdateSize(entryCount, 0.0f, false);
+    _idle = false;
+}
+
+csmInt32 CubismPose::GetSlot(csmInt32 partIndex)
+{
+    for (csmUint32 slot = 0; slot < _slotPartIndices.GetSize(); ++slot)
+    {
+        if (_slotPartIndices[slot] == partIndex)
+        {
+            return slot;
         }
     }
+
+    _slotPartIndices.PushBack(partIndex);
+    return _slotPartIndices.GetSize() - 1;
 }
 
-void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt32 beginIndex, csmInt32 partGroupCount)
+void CubismPose::ReadState(CubismModel* model)
+{
+    // モデルに存在しないパーツ・パラメータは Core の配列の範囲外にあるため、モデル経由で取得する
+    const csmInt32 partCount = model->GetPartCount();
+    const csmInt32 parameterCount = model->GetParameterCount();
+    const csmFloat32* partOpacities = Core::csmGetPartOpacities(model->GetModel());
+    const csmFloat32* parameterValues = Core::csmGetParameterValues(model->GetModel());
+
+    for (csmUint32 slot = 0; slot < _slotPartIndices.GetSize(); ++slot)
+    {
+        const csmInt32 partIndex = _slotPartIndices[slot];
+        _opacities[slot] = (partIndex < partCount) ? partOpacities[partIndex] : model->GetPartOpacity(partIndex);
+    }
+
+    for (csmUint32 i = 0; i < _parameterIndices.GetSize(); ++i)
+    {
+        const csmInt32 paramIndex = _parameterIndices[i];
+        _parameterValues[i] = (paramIndex < parameterCount) ? parameterValues[paramIndex] : model->GetParameterValue(paramIndex);
+    }
+}
+
+void CubismPose::WritePartOpacities(CubismModel* model)
+{
+    const csmInt32 partCount = model->GetPartCount();
+    csmFloat32* partOpacities = Core::csmGetPartOpacities(model->GetModel());
+
+    for (csmUint32 slot = 0; slot < _slotPartIndices.GetSize(); ++slot)
+    {
+        const csmInt32 partIndex = _slotPartIndices[slot];
+
+        if (partIndex < partCount)
+        {
+            partOpacities[partIndex] = _opacities[slot];
+        }
+        else
+        {
+            model->SetPartOpacity(partIndex, _opacities[slot]);
+        }
+    }
+}
+
+void CubismPose::CopyPartOpacities()
+{
+    for (csmUint32 i = 0; i < _linkSourceSlots.GetSize(); ++i)
+    {
+        _opacities[_linkTargetSlots[i]] = _opacities[_linkSourceSlots[i]];
+    }
+}
+
+csmBool CubismPose::DoFade(csmFloat32 deltaTimeSeconds, csmInt32 beginIndex, csmInt32 partGroupCount)
 {
     csmInt32    visiblePartIndex = -1;
     csmFloat32  newOpacity = 1.0f;
@@ -218,10 +317,7 @@ void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt3
     // 現在、表示状態になっているパーツを取得
     for (csmInt32 i = beginIndex; i < beginIndex + partGroupCount; ++i)
     {
-        const csmInt32 partIndex = _partGroups[i].PartIndex;
-        const csmInt32 paramIndex = _partGroups[i].ParameterIndex;
-
-        if (model->GetParameterValue(paramIndex) > Epsilon)
+        if (_parameterValues[i] > Epsilon)
         {
             if (visiblePartIndex >= 0)
             {
@@ -235,7 +331,7 @@ void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt3
                 continue;
             }
 
-            newOpacity = model->GetPartOpacity(partIndex);
+            newOpacity = _opacities[_partSlots[i]];
 
             // 新しい不透明度を計算
             newOpacity += (deltaTimeSeconds / _fadeTimeSeconds);
@@ -256,17 +352,17 @@ void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt3
     //  表示パーツ、非表示パーツの不透明度を設定する
     for (csmInt32 i = beginIndex; i < beginIndex + partGroupCount; ++i)
     {
-        const csmInt32 partsIndex = _partGroups[i].PartIndex;
+        const csmInt32 slot = _partSlots[i];
 
         //  表示パーツの設定
         if (visiblePartIndex == i)
         {
-            model->SetPartOpacity(partsIndex, newOpacity); // 先に設定
+            _opacities[slot] = newOpacity; // 先に設定
         }
         // 非表示パーツの設定
         else
         {
-            csmFloat32 opacity = model->GetPartOpacity(partsIndex);
+            csmFloat32 opacity = _opacities[slot];
             csmFloat32 a1;          // 計算によって求められる不透明度
 
             if (newOpacity < Phi)
@@ -291,9 +387,11 @@ void CubismPose::DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt3
                 opacity = a1; // 計算の不透明度よりも大きければ（濃ければ）不透明度を上げる
             }
 
-            model->SetPartOpacity(partsIndex, opacity);
+            _opacities[slot] = opacity;
         }
     }
+
+    return newOpacity == 1.0f;
 }
 
 void CubismPose::UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSeconds)
@@ -313,18 +411,38 @@ void CubismPose::UpdateParameters(CubismModel* model, csmFloat32 deltaTimeSecond
         deltaTimeSeconds = 0.0f;
     }
 
+    ReadState(model);
+
+    // フェードが完了していれば、入力が前回と同じ限り結果も同じなので何もしない
+    if (_idle && IsSame(_opacities, _lastOpacities) && IsSame(_parameterValues, _lastParameterValues))
+    {
+        return;
+    }
+
+    Copy(_opacities, _lastOpacities);
+    Copy(_parameterValues, _lastParameterValues);
+
+    csmBool settled = true;
     csmInt32 beginIndex = 0;
 
     for (csmUint32 i = 0; i < _partGroupCounts.GetSize(); i++)
     {
         const csmInt32 partGroupCount = _partGroupCounts[i];
 
-        DoFade(model, deltaTimeSeconds, beginIndex, partGroupCount);
+        if (!DoFade(deltaTimeSeconds, beginIndex, partGroupCount))
+        {
+            settled = false;
+        }
 
         beginIndex += partGroupCount;
     }
 
-    CopyPartOpacities(model);
+    CopyPartOpacities();
+
+    WritePartOpacities(model);
+
+    // 表示パーツが不透明になり、今回の更新で何も変わらなければ、次回以降も経過時間によらず変わらない
+    _idle = settled && IsSame(_opacities, _lastOpacities);
 }
 
 }}}
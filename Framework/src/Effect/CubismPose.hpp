@@ -75,6 +75,9 @@ public:
     /**
      * Updates the parameters of the model.
      *
+     * Once every fade has finished, the update is skipped until a controlling parameter
+     * or one of the pose's part opacities changes.
+     *
      * @param model Model to update
      * @param deltaTimeSeconds Current time in seconds
      */
@@ -94,14 +97,51 @@ private:
 
     virtual ~CubismPose();
 
-    void                CopyPartOpacities(CubismModel* model);
+    /**
+     * Compiles the part groups and links into flat index tables.
+     *
+     * Every distinct part used by the pose gets one slot in _opacities, so that
+     * DoFade and CopyPartOpacities see each other's writes exactly as they would on the model.
+     * Called by Reset after the part and parameter indices have been initialized.
+     */
+    void                BuildTables();
+
+    csmInt32            GetSlot(csmInt32 partIndex);
+
+    /**
+     * Gathers the pose's part opacities and controlling parameter values from the model.
+     */
+    void                ReadState(CubismModel* model);
+
+    /**
+     * Writes the pose's part opacities back to the model.
+     */
+    void                WritePartOpacities(CubismModel* model);
+
+    void                CopyPartOpacities();
 
-    void                DoFade(CubismModel* model, csmFloat32 deltaTimeSeconds, csmInt32 beginIndex, csmInt32 partGroupCount);
+    /**
+     * Fades one part group.
+     *
+     * @return true if the visible part is fully opaque
+     */
+    csmBool             DoFade(csmFloat32 deltaTimeSeconds, csmInt32 beginIndex, csmInt32 partGroupCount);
 
     csmVector<PartData>             _partGroups;
     csmVector<csmInt32>             _partGroupCounts;
     csmFloat32                      _fadeTimeSeconds;
     CubismModel*                    _lastModel;
+
+    csmVector<csmInt32>             _partSlots;             ///< Opacity slot of each entry in _partGroups
+    csmVector<csmInt32>             _parameterIndices;      ///< Parameter index of each entry in _partGroups
+    csmVector<csmInt32>             _slotPartIndices;       ///< Part index of each opacity slot
+    csmVector<csmInt32>             _linkSourceSlots;       ///< Slot copied from, in CopyPartOpacities order
+    csmVector<csmInt32>             _linkTargetSlots;       ///< Slot copied to
+    csmVector<csmFloat32>           _opacities;             ///< Working part opacities, one per slot
+    csmVector<csmFloat32>           _parameterValues;       ///< Controlling parameter values, one per entry
+    csmVector<csmFloat32>           _lastOpacities;         ///< Opacities read at the start of the previous update
+    csmVector<csmFloat32>           _lastParameterValues;   ///< Parameter values read at the start of the previous update
+    csmBool                         _idle;                  ///< The previous update settled and changed nothing
 };
 
 }}}
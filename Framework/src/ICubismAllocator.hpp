@@ -57,5 +57,54 @@ public:
      */
     virtual void DeallocateAligned(void* alignedMemory) = 0;
 
+    /**
+     * (For debugging) Allocates the memory, passing the call site through.
+     *
+     * Called instead of Allocate() when CSM_DEBUG_MEMORY_LEAKING is defined.
+     * The default implementation ignores the call site.
+     *
+     * @param size Desired amount of memory in bytes
+     * @param fileName Name of source code that called
+     * @param lineNumber Number of line of source code that called
+     *
+     * @return Pointer to the allocated memory if succeeded; otherwise `0`
+     */
+    virtual void* AllocateWithSource(const csmSizeType size, const csmChar* /*fileName*/, csmInt32 /*lineNumber*/)
+    {
+        return Allocate(size);
+    }
+
+    /**
+     * (For debugging) Allocates the memory with specified alignment, passing the call site through.
+     *
+     * Called instead of AllocateAligned() when CSM_DEBUG_MEMORY_LEAKING is defined.
+     * The default implementation ignores the call site.
+     *
+     * @param size Desired amount of memory in bytes
+     * @param alignment Desired alignment of memory in bytes
+     * @param fileName Name of source code that called
+     * @param lineNumber Number of line of source code that called
+     *
+     * @return Pointer to the allocated memory if succeeded; otherwise `0`
+     */
+    virtual void* AllocateAlignedWithSource(const csmSizeType size, const csmUint32 alignment, const csmChar* /*fileName*/, csmInt32 /*lineNumber*/)
+    {
+        return AllocateAligned(size, alignment);
+    }
+
+    /**
+     * Marks the start of allocations owned by the Framework itself rather than by a model,
+     * such as ids interned in CubismIdManager. Calls may nest.
+     *
+     * Allocators that group memory per model can use this to keep such allocations out of
+     * the group. The default implementation does nothing.
+     */
+    virtual void BeginSharedAllocation() {}
+
+    /**
+     * Marks the end of allocations started with BeginSharedAllocation().
+     */
+    virtual void EndSharedAllocation() {}
+
 };
 }}}
@@ -193,6 +193,17 @@ public:
      */
     virtual csmFloat32 GetMotionFadeOutTimeValue(const csmChar* groupName, csmInt32 index) = 0;
 
+    /**
+     * Returns the sampling rate at which the Motion in the Motion Group is baked.
+     * See CubismMotion::Bake.
+     *
+     * @param groupName Name to the desired Motion Group
+     * @param index Index to the desired Motion
+     *
+     * @return "BakeRate" of the Motion [Hz]; 0 if it is not set
+     */
+    virtual csmFloat32 GetMotionBakeRateValue(const csmChar* groupName, csmInt32 index) = 0;
+
     /**
      * Returns the name of User Data File in the Model.
      *
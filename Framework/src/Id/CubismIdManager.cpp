@@ -53,11 +53,14 @@ csmBool CubismIdManager::IsExist(const csmString& id) const
 }
 csmBool CubismIdManager::IsExist(const csmChar* id) const
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     return (FindId(id) != NULL);
 }
 
 const CubismId* CubismIdManager::RegisterId(const csmChar* id)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     CubismId* result = NULL;
 
     if ((result = FindId(id)) != NULL)
@@ -65,8 +68,11 @@ const CubismId* CubismIdManager::RegisterId(const csmChar* id)
         return result;
     }
 
+    // IDはモデルを跨いで共有されるため、モデル単位のメモリ領域に置かない
+    CubismFramework::BeginSharedAllocation();
     result = CSM_NEW CubismId(id);
     _ids.PushBack(result);
+    CubismFramework::EndSharedAllocation();
 
     return result;
 }
@@ -10,6 +10,7 @@
 #include "Type/CubismBasicType.hpp"
 #include "Type/csmString.hpp"
 #include "Type/csmVector.hpp"
+#include <mutex>
 
 namespace Live2D { namespace Cubism { namespace Framework {
 
@@ -17,6 +18,8 @@ struct CubismId;
 
 /**
  * Handles ID names.
+ *
+ * Thread-safe, so that motions and other assets can be parsed on loader threads.
  */
 class CubismIdManager
 {
@@ -112,6 +115,7 @@ private:
     CubismId* FindId(const csmChar* id) const;
 
     csmVector<CubismId*> _ids;
+    mutable std::mutex _mutex;
 };
 
 }}}
@@ -0,0 +1,62 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismDrawableSnapshot.hpp"
+#include <string.h>
+#include "CubismModel.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+CubismDrawableSnapshot::CubismDrawableSnapshot()
+    : _drawableCount(0)
+{ }
+
+void CubismDrawableSnapshot::Capture(const CubismModel& model)
+{
+    const Core::csmModel* coreModel = model.GetModel();
+    const csmInt32 drawableCount = Core::csmGetDrawableCount(coreModel);
+    const csmInt32* vertexCounts = Core::csmGetDrawableVertexCounts(coreModel);
+
+    if (_drawableCount != drawableCount)
+    {
+        // 頂点は全Drawable分を一つのバッファに詰める
+        csmInt32 vertexTotal = 0;
+        _vertexOffsets.Resize(drawableCount);
+        for (csmInt32 i = 0; i < drawableCount; ++i)
+        {
+            _vertexOffsets[i] = vertexTotal;
+            vertexTotal += vertexCounts[i];
+        }
+
+        _vertexPositions.Resize(vertexTotal);
+        _opacities.Resize(drawableCount);
+        _renderOrders.Resize(drawableCount);
+        _dynamicFlags.Resize(drawableCount);
+        _multiplyColors.Resize(drawableCount);
+        _screenColors.Resize(drawableCount);
+        _drawableCount = drawableCount;
+    }
+
+    if (drawableCount == 0)
+    {
+        return;
+    }
+
+    const Core::csmVector2** vertexPositions = Core::csmGetDrawableVertexPositions(coreModel);
+    for (csmInt32 i = 0; i < drawableCount; ++i)
+    {
+        memcpy(_vertexPositions.GetPtr() + _vertexOffsets[i], vertexPositions[i], sizeof(Core::csmVector2) * vertexCounts[i]);
+    }
+
+    memcpy(_opacities.GetPtr(), Core::csmGetDrawableOpacities(coreModel), sizeof(csmFloat32) * drawableCount);
+    memcpy(_renderOrders.GetPtr(), Core::csmGetDrawableRenderOrders(coreModel), sizeof(csmInt32) * drawableCount);
+    memcpy(_dynamicFlags.GetPtr(), Core::csmGetDrawableDynamicFlags(coreModel), sizeof(Core::csmFlags) * drawableCount);
+    memcpy(_multiplyColors.GetPtr(), Core::csmGetDrawableMultiplyColors(coreModel), sizeof(Core::csmVector4) * drawableCount);
+    memcpy(_screenColors.GetPtr(), Core::csmGetDrawableScreenColors(coreModel), sizeof(Core::csmVector4) * drawableCount);
+}
+
+}}}
@@ -0,0 +1,76 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmVector.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+class CubismModel;
+
+/**
+ * Copy of the per-frame drawable state produced by csmUpdateModel.
+ *
+ * Holds vertex positions, opacities, render orders, dynamic flags and the
+ * multiply/screen colors from Core. While a snapshot is attached with
+ * CubismModel::SetDrawableSnapshot(), the corresponding getters of the model
+ * read from it, so a renderer can draw one frame while the next one is being
+ * computed on another thread. Everything else the renderer reads (indices,
+ * UVs, masks, constant flags) does not change after the model is created.
+ */
+class CubismDrawableSnapshot
+{
+public:
+    CubismDrawableSnapshot();
+
+    /**
+     * Copies the current drawable state of the model.
+     *
+     * Reads Core directly, so it is valid to capture a model that has a
+     * snapshot attached. Buffers are allocated on the first capture only.
+     *
+     * @param model model updated by CubismModel::Update()
+     */
+    void Capture(const CubismModel& model);
+
+    /**
+     * Checks whether Capture() has been called.
+     */
+    csmBool IsCaptured() const { return _drawableCount > 0; }
+
+    const Core::csmVector2* GetVertexPositions(csmInt32 drawableIndex) const
+    {
+        return &_vertexPositions[0] + _vertexOffsets[drawableIndex];
+    }
+
+    const csmFloat32* GetOpacities() const { return &_opacities[0]; }
+
+    const csmInt32* GetRenderOrders() const { return &_renderOrders[0]; }
+
+    const Core::csmFlags* GetDynamicFlags() const { return &_dynamicFlags[0]; }
+
+    const Core::csmVector4* GetMultiplyColors() const { return &_multiplyColors[0]; }
+
+    const Core::csmVector4* GetScreenColors() const { return &_screenColors[0]; }
+
+private:
+    CubismDrawableSnapshot(const CubismDrawableSnapshot&);
+    CubismDrawableSnapshot& operator=(const CubismDrawableSnapshot&);
+
+    csmInt32 _drawableCount;
+    csmVector<Core::csmVector2> _vertexPositions;
+    csmVector<csmInt32> _vertexOffsets;
+    csmVector<csmFloat32> _opacities;
+    csmVector<csmInt32> _renderOrders;
+    csmVector<Core::csmFlags> _dynamicFlags;
+    csmVector<Core::csmVector4> _multiplyColors;
+    csmVector<Core::csmVector4> _screenColors;
+};
+
+}}}
@@ -12,32 +12,46 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
 CubismMoc* CubismMoc::Create(const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency)
 {
-    CubismMoc* cubismMoc = NULL;
-
     void* alignedBuffer = CSM_MALLOC_ALLIGNED(size, Core::csmAlignofMoc);
     memcpy(alignedBuffer, mocBytes, size);
 
+    CubismMoc* cubismMoc = CreateInPlace(alignedBuffer, size, shouldCheckMocConsistency, NULL, NULL);
+
+    if (cubismMoc == NULL)
+    {
+        CSM_FREE_ALLIGNED(alignedBuffer);
+    }
+
+    return cubismMoc;
+}
+
+CubismMoc* CubismMoc::CreateInPlace(void* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency,
+                                    ReleaseBufferFunction releaseBuffer, void* userData)
+{
+    CubismMoc* cubismMoc = NULL;
+
     if (shouldCheckMocConsistency)
     {
         // .moc3の整合性を確認
-        csmBool consistency = HasMocConsistency(alignedBuffer, size);
+        csmBool consistency = HasMocConsistency(buffer, size);
         if (!consistency)
         {
-            CSM_FREE_ALLIGNED(alignedBuffer);
-
             // 整合性が確認できなければ処理しない
             CubismLogError("Inconsistent MOC3.");
             return cubismMoc;
         }
     }
 
-    Core::csmMoc* moc = Core::csmReviveMocInPlace(alignedBuffer, size);
-    const Core::csmMocVersion version = Core::csmGetMocVersion(alignedBuffer, size);
+    Core::csmMoc* moc = Core::csmReviveMocInPlace(buffer, size);
+    const Core::csmMocVersion version = Core::csmGetMocVersion(buffer, size);
 
     if (moc)
     {
         cubismMoc = CSM_NEW CubismMoc(moc);
         cubismMoc->_mocVersion = version;
+        cubismMoc->_mocSize = size;
+        cubismMoc->_releaseBuffer = releaseBuffer;
+        cubismMoc->_releaseBufferUserData = userData;
     }
 
     return cubismMoc;
@@ -45,12 +59,26 @@ CubismMoc* CubismMoc::Create(const csmByte* mocBytes, csmSizeInt size, csmBool s
 
 void CubismMoc::Delete(CubismMoc* moc)
 {
+    if (moc == NULL || moc->_referenceCount.fetch_sub(1) > 1)
+    {
+        return;
+    }
+
     CSM_DELETE_SELF(CubismMoc, moc);
 }
 
+void CubismMoc::Retain()
+{
+    _referenceCount.fetch_add(1);
+}
+
 CubismMoc::CubismMoc(Core::csmMoc* moc)
                         : _moc(moc)
+                        , _mocSize(0)
+                        , _releaseBuffer(NULL)
+                        , _releaseBufferUserData(NULL)
                         , _modelCount(0)
+                        , _referenceCount(1)
                         , _mocVersion(0)
 { }
 
@@ -58,7 +86,14 @@ CubismMoc::~CubismMoc()
 {
     CSM_ASSERT(_modelCount == 0);
 
-    CSM_FREE_ALLIGNED(_moc);
+    if (_releaseBuffer != NULL)
+    {
+        _releaseBuffer(_moc, _mocSize, _releaseBufferUserData);
+    }
+    else
+    {
+        CSM_FREE_ALLIGNED(_moc);
+    }
 }
 
 CubismModel* CubismMoc::CreateModel()
@@ -9,6 +9,8 @@
 
 #include "CubismFramework.hpp"
 
+#include <atomic>
+
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismModel;
@@ -30,13 +32,45 @@ public:
      */
     static CubismMoc* Create(const csmByte* mocBytes, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
 
+    /**
+     * Function that releases a buffer passed to CreateInPlace().
+     */
+    typedef void (*ReleaseBufferFunction)(void* buffer, csmSizeInt size, void* userData);
+
+    /**
+     * Makes an instance by reviving the MOC directly in the given buffer, without copying it.
+     *
+     * The buffer must be writable and aligned to 'csmAlignofMoc', e.g. a private (copy-on-write)
+     * file mapping. On success the instance takes ownership of the buffer and calls
+     * releaseBuffer when destroyed; on failure the buffer is left to the caller.
+     *
+     * @param buffer Buffer containing the loaded MOC file
+     * @param size Size of the buffer in bytes
+     * @param shouldCheckMocConsistency true to check the consistency of the MOC file
+     * @param releaseBuffer Function that releases the buffer
+     * @param userData Value passed to releaseBuffer
+     *
+     * @return Created instance, or NULL on failure
+     */
+    static CubismMoc* CreateInPlace(void* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency,
+                                    ReleaseBufferFunction releaseBuffer, void* userData);
+
     /**
      * Destroys an instance.
      *
+     * If Retain() was called, only releases one reference; the instance is destroyed
+     * with the last one.
+     *
      * @param moc `CubismMoc` instance to be destroyed
      */
     static void Delete(CubismMoc* moc);
 
+    /**
+     * Adds a reference so that the instance can be shared by several owners.
+     * Each call must be balanced by a call to Delete().
+     */
+    void Retain();
+
     /**
      * Makes a model instance.
      *
@@ -91,7 +125,11 @@ private:
     virtual ~CubismMoc();
 
     Core::csmMoc*     _moc;
+    csmSizeInt        _mocSize;
+    ReleaseBufferFunction _releaseBuffer;
+    void*             _releaseBufferUserData;
     csmInt32          _modelCount;
+    std::atomic<csmInt32> _referenceCount;
     csmUint32         _mocVersion;
 };
 
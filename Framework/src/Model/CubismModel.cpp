@@ -6,6 +6,7 @@
  */
 
 #include "CubismModel.hpp"
+#include "CubismDrawableSnapshot.hpp"
 #include "Rendering/CubismRenderer.hpp"
 #include "Id/CubismId.hpp"
 #include "Id/CubismIdManager.hpp"
@@ -27,6 +28,7 @@ CubismModel::CubismModel(Core::csmModel* model)
     , _isOverwrittenModelScreenColors(false)
     , _isOverwrittenCullings(false)
     , _modelOpacity(1.0f)
+    , _drawableSnapshot(NULL)
 { }
 
 CubismModel::~CubismModel()
@@ -496,6 +498,11 @@ csmInt32 CubismModel::GetPartCount() const
 
 const csmInt32* CubismModel::GetDrawableRenderOrders() const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetRenderOrders();
+    }
+
     const csmInt32* renderOrders = Core::csmGetDrawableRenderOrders(_model);
     return renderOrders;
 }
@@ -537,6 +544,11 @@ const csmUint16* CubismModel::GetDrawableVertexIndices(csmInt32 drawableIndex) c
 
 const Core::csmVector2* CubismModel::GetDrawableVertexPositions(csmInt32 drawableIndex) const
 {
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetVertexPositions(drawableIndex);
+    }
+
     const Core::csmVector2** verticesArray = Core::csmGetDrawableVertexPositions(_model);
     return verticesArray[drawableIndex];
 }
@@ -549,19 +561,19 @@ const Core::csmVector2* CubismModel::GetDrawableVertexUvs(csmInt32 drawableIndex
 
 csmFloat32 CubismModel::GetDrawableOpacity(csmInt32 drawableIndex) const
 {
-    const csmFloat32* opacities = Core::csmGetDrawableOpacities(_model);
+    const csmFloat32* opacities = _drawableSnapshot != NULL ? _drawableSnapshot->GetOpacities() : Core::csmGetDrawableOpacities(_model);
     return opacities[drawableIndex];
 }
 
 Core::csmVector4 CubismModel::GetDrawableMultiplyColor(csmInt32 drawableIndex) const
 {
-    const Core::csmVector4* multiplyColors = Core::csmGetDrawableMultiplyColors(_model);
+    const Core::csmVector4* multiplyColors = _drawableSnapshot != NULL ? _drawableSnapshot->GetMultiplyColors() : Core::csmGetDrawableMultiplyColors(_model);
     return multiplyColors[drawableIndex];
 }
 
 Core::csmVector4 CubismModel::GetDrawableScreenColor(csmInt32 drawableIndex) const
 {
-    const Core::csmVector4* screenColors = Core::csmGetDrawableScreenColors(_model);
+    const Core::csmVector4* screenColors = _drawableSnapshot != NULL ? _drawableSnapshot->GetScreenColors() : Core::csmGetDrawableScreenColors(_model);
     return screenColors[drawableIndex];
 }
 
@@ -572,43 +584,43 @@ csmInt32 CubismModel::GetDrawableParentPartIndex(csmUint32 drawableIndex) const
 
 csmBool CubismModel::GetDrawableDynamicFlagIsVisible(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmIsVisible)!=0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagVisibilityDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmVisibilityDidChange)!=0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagOpacityDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmOpacityDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagDrawOrderDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmDrawOrderDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagRenderOrderDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmRenderOrderDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagVertexPositionsDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmVertexPositionsDidChange) != 0 ? true : false;
 }
 
 csmBool CubismModel::GetDrawableDynamicFlagBlendColorDidChange(csmInt32 drawableIndex) const
 {
-    const Core::csmFlags* dynamicFlags = Core::csmGetDrawableDynamicFlags(_model);
+    const Core::csmFlags* dynamicFlags = GetDrawableDynamicFlags();
     return IsBitSet(dynamicFlags[drawableIndex], Core::csmBlendColorDidChange) != 0 ? true : false;
 }
 
@@ -912,6 +924,26 @@ Core::csmModel* CubismModel::GetModel() const
     return _model;
 }
 
+void CubismModel::SetDrawableSnapshot(const CubismDrawableSnapshot* snapshot)
+{
+    _drawableSnapshot = snapshot;
+}
+
+const CubismDrawableSnapshot* CubismModel::GetDrawableSnapshot() const
+{
+    return _drawableSnapshot;
+}
+
+const Core::csmFlags* CubismModel::GetDrawableDynamicFlags() const
+{
+    if (_drawableSnapshot != NULL)
+    {
+        return _drawableSnapshot->GetDynamicFlags();
+    }
+
+    return Core::csmGetDrawableDynamicFlags(_model);
+}
+
 csmBool CubismModel::IsUsingMasking() const
 {
     for (csmInt32 d = 0; d < Core::csmGetDrawableCount(_model); ++d)
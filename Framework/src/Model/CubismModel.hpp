@@ -17,6 +17,7 @@
 namespace Live2D { namespace Cubism { namespace Framework {
 
 class CubismMoc;
+class CubismDrawableSnapshot;
 
 /**
  * Handles models created from MOC data.
@@ -841,6 +842,22 @@ public:
 
     Core::csmModel*     GetModel() const;
 
+    /**
+     * Attaches a drawable snapshot.
+     *
+     * While attached, vertex positions, opacities, render orders, dynamic flags and
+     * Core multiply/screen colors are read from the snapshot instead of Core.
+     * The snapshot must outlive the attachment.
+     *
+     * @param snapshot snapshot to read from, or NULL to read from Core again
+     */
+    void SetDrawableSnapshot(const CubismDrawableSnapshot* snapshot);
+
+    /**
+     * Returns the attached drawable snapshot, or NULL.
+     */
+    const CubismDrawableSnapshot* GetDrawableSnapshot() const;
+
 private:
     CubismModel(Core::csmModel* model);
 
@@ -851,6 +868,8 @@ private:
 
     void Initialize();
 
+    const Core::csmFlags* GetDrawableDynamicFlags() const;
+
     void SetPartColor(
         csmUint32 partIndex,
         csmFloat32 r, csmFloat32 g, csmFloat32 b, csmFloat32 a,
@@ -893,6 +912,7 @@ private:
     csmBool _isOverwrittenModelMultiplyColors;
     csmBool _isOverwrittenModelScreenColors;
     csmBool _isOverwrittenCullings;
+    const CubismDrawableSnapshot* _drawableSnapshot;
 };
 
 }}}
@@ -79,14 +79,23 @@ void CubismUserModel::SetAcceleration(csmFloat32 x, csmFloat32 y, csmFloat32 z)
 
 void CubismUserModel::LoadModel(const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency)
 {
-    _moc = CubismMoc::Create(buffer, size, shouldCheckMocConsistency);
+    CubismMoc* moc = CubismMoc::Create(buffer, size, shouldCheckMocConsistency);
 
-    if (_moc == NULL)
+    if (moc == NULL)
     {
         CubismLogError("Failed to CubismMoc::Create().");
         return;
     }
 
+    LoadModelFromMoc(moc);
+    CubismMoc::Delete(moc);
+}
+
+void CubismUserModel::LoadModelFromMoc(CubismMoc* moc)
+{
+    moc->Retain();
+    _moc = moc;
+
     _model = _moc->CreateModel();
 
     if (_model == NULL)
@@ -113,6 +113,15 @@ public:
      */
     virtual void            LoadModel(const csmByte* buffer, csmSizeInt size, csmBool shouldCheckMocConsistency = false);
 
+    /**
+     * Creates the model from an already revived MOC shared with other models.
+     *
+     * A reference to the MOC is kept until this model is destroyed.
+     *
+     * @param moc Revived MOC
+     */
+    virtual void            LoadModelFromMoc(CubismMoc* moc);
+
     /**
      * Loads motion from a motion file.
      * If a fade value is defined in model3.json, the fade value defined in motion3.json will be overwritten.
@@ -43,6 +43,15 @@ CubismExpressionMotion* CubismExpressionMotion::Create(const csmByte* buffer, cs
     return expression;
 }
 
+CubismExpressionMotion* CubismExpressionMotion::Clone() const
+{
+    CubismExpressionMotion* expression = CSM_NEW CubismExpressionMotion();
+    expression->_parameters = _parameters;
+    expression->_fadeInSeconds = _fadeInSeconds;
+    expression->_fadeOutSeconds = _fadeOutSeconds;
+    return expression;
+}
+
 void CubismExpressionMotion::DoUpdateParameters(CubismModel* model, csmFloat32 userTimeSeconds, csmFloat32 weight, CubismMotionQueueEntry* motionQueueEntry)
 {
     for (csmUint32 i = 0; i < _parameters.GetSize(); ++i)
@@ -100,7 +109,7 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
         const csmFloat32 currentParameterValue = expressionParameterValue.OverwriteValue =
             model->GetParameterValue(expressionParameterValue.ParameterId);
 
-        csmVector<ExpressionParameter> expressionParameters = GetExpressionParameters();
+        const csmVector<ExpressionParameter>& expressionParameters = _parameters;
         csmInt32 parameterIndex = -1;
         for (csmInt32 j = 0; j < expressionParameters.GetSize(); ++j)
         {
@@ -140,9 +149,9 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
         }
 
         // 値を計算
-        csmFloat32 value = expressionParameters.At(parameterIndex).Value;
+        csmFloat32 value = expressionParameters[parameterIndex].Value;
         csmFloat32 newAdditiveValue, newMultiplyValue, newSetValue;
-        switch (expressionParameters.At(parameterIndex).BlendType) {
+        switch (expressionParameters[parameterIndex].BlendType) {
         case Additive:
             newAdditiveValue = value;
             newMultiplyValue = DefaultMultiplyValue;
@@ -175,7 +184,127 @@ void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, c
     }
 }
 
-csmVector<CubismExpressionMotion::ExpressionParameter> CubismExpressionMotion::GetExpressionParameters()
+void CubismExpressionMotion::CalculateExpressionParameters(CubismModel* model, csmFloat32 userTimeSeconds, CubismMotionQueueEntry* motionQueueEntry,
+    CubismExpressionMotionManager::ExpressionParameterBuffer* parameterBuffer, csmInt32 expressionIndex, csmFloat32 fadeWeight)
+{
+    if (motionQueueEntry == NULL || parameterBuffer == NULL)
+    {
+        return;
+    }
+
+    if (!motionQueueEntry->IsAvailable())
+    {
+        return;
+    }
+
+    // CubismExpressionMotion._fadeWeight は廃止予定です。
+    // 互換性のために処理は残りますが、実際には使用しておりません。
+    _fadeWeight = UpdateFadeWeight(motionQueueEntry, userTimeSeconds);
+
+    const csmVector<csmInt32>& parameterIndices = GetParameterIndices(model, motionQueueEntry);
+    csmInt32* slots = parameterBuffer->Slots.GetPtr();
+
+    // この表情が設定するパラメータに、表情内の位置を記録する（重複時は先頭を優先）
+    for (csmUint32 i = 0; i < parameterIndices.GetSize(); ++i)
+    {
+        const csmInt32 parameterIndex = parameterIndices[i];
+        if (parameterIndex >= 0 && slots[parameterIndex] == CubismExpressionMotionManager::ExpressionParameterBuffer::SlotNotInExpression)
+        {
+            slots[parameterIndex] = static_cast<csmInt32>(i);
+        }
+    }
+
+    const csmInt32* activeIndices = parameterBuffer->ActiveIndices.GetPtr();
+    csmFloat32* additiveValues = parameterBuffer->AdditiveValues.GetPtr();
+    csmFloat32* multiplyValues = parameterBuffer->MultiplyValues.GetPtr();
+    csmFloat32* overwriteValues = parameterBuffer->OverwriteValues.GetPtr();
+
+    // モデルに適用する値を計算
+    for (csmUint32 i = 0; i < parameterBuffer->ActiveIndices.GetSize(); ++i)
+    {
+        const csmInt32 parameterIndex = activeIndices[i];
+        const csmInt32 slot = slots[parameterIndex];
+        const csmFloat32 currentParameterValue = model->GetParameterValue(parameterIndex);
+
+        // 再生中のExpressionが参照していないパラメータは初期値を適用
+        if (slot < 0)
+        {
+            if (expressionIndex == 0)
+            {
+                additiveValues[parameterIndex] = DefaultAdditiveValue;
+                multiplyValues[parameterIndex] = DefaultMultiplyValue;
+                overwriteValues[parameterIndex] = currentParameterValue;
+            }
+            else
+            {
+                additiveValues[parameterIndex] = CalculateValue(additiveValues[parameterIndex], DefaultAdditiveValue, fadeWeight);
+                multiplyValues[parameterIndex] = CalculateValue(multiplyValues[parameterIndex], DefaultMultiplyValue, fadeWeight);
+                overwriteValues[parameterIndex] = CalculateValue(currentParameterValue, currentParameterValue, fadeWeight);
+            }
+            continue;
+        }
+
+        // 値を計算
+        const csmFloat32 value = _parameters[slot].Value;
+        csmFloat32 newAdditiveValue, newMultiplyValue, newSetValue;
+        switch (_parameters[slot].BlendType) {
+        case Multiply:
+            newAdditiveValue = DefaultAdditiveValue;
+            newMultiplyValue = value;
+            newSetValue = currentParameterValue;
+            break;
+        case Overwrite:
+            newAdditiveValue = DefaultAdditiveValue;
+            newMultiplyValue = DefaultMultiplyValue;
+            newSetValue = value;
+            break;
+        case Additive:
+        default:
+            newAdditiveValue = value;
+            newMultiplyValue = DefaultMultiplyValue;
+            newSetValue = currentParameterValue;
+            break;
+        }
+
+        if (expressionIndex == 0) {
+            additiveValues[parameterIndex] = newAdditiveValue;
+            multiplyValues[parameterIndex] = newMultiplyValue;
+            overwriteValues[parameterIndex] = newSetValue;
+        }
+        else {
+            additiveValues[parameterIndex] = (additiveValues[parameterIndex] * (1.0f - fadeWeight)) + newAdditiveValue * fadeWeight;
+            multiplyValues[parameterIndex] = (multiplyValues[parameterIndex] * (1.0f - fadeWeight)) + newMultiplyValue * fadeWeight;
+            overwriteValues[parameterIndex] = (currentParameterValue * (1.0f - fadeWeight)) + newSetValue * fadeWeight;
+        }
+    }
+
+    for (csmUint32 i = 0; i < parameterIndices.GetSize(); ++i)
+    {
+        if (parameterIndices[i] >= 0)
+        {
+            slots[parameterIndices[i]] = CubismExpressionMotionManager::ExpressionParameterBuffer::SlotNotInExpression;
+        }
+    }
+}
+
+const csmVector<csmInt32>& CubismExpressionMotion::GetParameterIndices(CubismModel* model, CubismMotionQueueEntry* motionQueueEntry) const
+{
+    csmVector<csmInt32>& parameterIndices = motionQueueEntry->GetParameterIndices();
+
+    if (parameterIndices.GetSize() != _parameters.GetSize())
+    {
+        parameterIndices.UpdateSize(0);
+        parameterIndices.PrepareCapacity(_parameters.GetSize());
+        for (csmUint32 i = 0; i < _parameters.GetSize(); ++i)
+        {
+            parameterIndices.PushBack(_parameters[i].ParameterId != NULL ? model->GetParameterIndex(_parameters[i].ParameterId) : -1);
+        }
+    }
+
+    return parameterIndices;
+}
+
+const csmVector<CubismExpressionMotion::ExpressionParameter>& CubismExpressionMotion::GetExpressionParameters() const
 {
     return _parameters;
 }
@@ -50,6 +50,13 @@ public:
      */
     static CubismExpressionMotion* Create(const csmByte* buf, csmSizeInt size);
 
+    /**
+     * Makes a copy of this expression with its parameters and fade times.
+     *
+     * @return created instance
+     */
+    CubismExpressionMotion* Clone() const;
+
     /**
      * Updates the model parameters.
      *
@@ -72,10 +79,37 @@ public:
     void CalculateExpressionParameters(CubismModel* model, csmFloat32 userTimeSeconds, CubismMotionQueueEntry* motionQueueEntry,
         csmVector<CubismExpressionMotionManager::ExpressionParameterValue>* expressionParameterValues, csmInt32 expressionIndex, csmFloat32 fadeWeight);
 
+    /**
+     * Computes the parameters related to the model's facial expressions into dense per-parameter arrays.
+     *
+     * Does not allocate; every parameter of this expression must already be active in the buffer.
+     *
+     * @param model model to update
+     * @param userTimeSeconds cumulative delta time in seconds
+     * @param motionQueueEntry motion managed by the CubismMotionQueueManager
+     * @param parameterBuffer blend state of the parameters, indexed by parameter index
+     * @param expressionIndex index of the facial expression
+     * @param fadeWeight weight of the facial expression fade
+     */
+    void CalculateExpressionParameters(CubismModel* model, csmFloat32 userTimeSeconds, CubismMotionQueueEntry* motionQueueEntry,
+        CubismExpressionMotionManager::ExpressionParameterBuffer* parameterBuffer, csmInt32 expressionIndex, csmFloat32 fadeWeight);
+
+    /**
+     * Returns the model parameter index of each parameter of the facial expression.
+     *
+     * Resolved on the first call for the entry and kept in it; IDs not set are -1.
+     *
+     * @param model model the entry plays on
+     * @param motionQueueEntry motion managed by the CubismMotionQueueManager
+     *
+     * @return parameter indices in the order of GetExpressionParameters()
+     */
+    const csmVector<csmInt32>& GetParameterIndices(CubismModel* model, CubismMotionQueueEntry* motionQueueEntry) const;
+
     /**
      * Returns the parameters referenced by the facial expression.
      */
-    csmVector<ExpressionParameter> GetExpressionParameters();
+    const csmVector<ExpressionParameter>& GetExpressionParameters() const;
 
     /**
      * Returns the current fade weight value of the facial expression.
@@ -16,19 +16,11 @@ namespace Live2D { namespace Cubism { namespace Framework {
 CubismExpressionMotionManager::CubismExpressionMotionManager()
     : _currentPriority(0)
     , _reservePriority(0)
-    , _expressionParameterValues(CSM_NEW csmVector<ExpressionParameterValue>())
     , _fadeWeights(CSM_NEW csmVector<csmFloat32>())
 { }
 
 CubismExpressionMotionManager::~CubismExpressionMotionManager()
 {
-    if(_expressionParameterValues)
-    {
-        CSM_DELETE(_expressionParameterValues);
-
-        _expressionParameterValues = NULL;
-    }
-
     if (_fadeWeights)
     {
         CSM_DELETE(_fadeWeights);
@@ -90,6 +82,17 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
         _fadeWeights->PushBack(0.0f);
     }
 
+    // パラメータインデックスで引く配列を一度だけモデルのパラメータ数まで確保する
+    if (_parameterBuffer.Slots.GetSize() < static_cast<csmUint32>(model->GetParameterCount()))
+    {
+        const csmInt32 parameterCount = model->GetParameterCount();
+        _parameterBuffer.Slots.UpdateSize(parameterCount, ExpressionParameterBuffer::SlotUnused);
+        _parameterBuffer.AdditiveValues.UpdateSize(parameterCount, CubismExpressionMotion::DefaultAdditiveValue);
+        _parameterBuffer.MultiplyValues.UpdateSize(parameterCount, CubismExpressionMotion::DefaultMultiplyValue);
+        _parameterBuffer.OverwriteValues.UpdateSize(parameterCount, 0.0f);
+        _parameterBuffer.ActiveIndices.PrepareCapacity(parameterCount);
+    }
+
     // ------- 処理を行う --------
     // 既にモーションがあれば終了フラグを立てる
     for (csmVector<CubismMotionQueueEntry*>::iterator ite = motions->Begin(); ite != motions->End();)
@@ -106,47 +109,21 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
 
         if (expressionMotion == NULL)
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = motions->Erase(ite);          // 削除
             continue;
         }
 
-        csmVector<CubismExpressionMotion::ExpressionParameter> expressionParameters = expressionMotion->GetExpressionParameters();
         if (motionQueueEntry->IsAvailable())
         {
             // 再生中のExpressionが参照しているパラメータをすべてリストアップ
-            for (csmInt32 i = 0; i < expressionParameters.GetSize(); ++i)
+            const csmVector<csmInt32>& parameterIndices = expressionMotion->GetParameterIndices(model, motionQueueEntry);
+            for (csmUint32 i = 0; i < parameterIndices.GetSize(); ++i)
             {
-                if (expressionParameters[i].ParameterId == NULL)
-                {
-                    continue;
-                }
-
-                csmInt32 index = -1;
-                // リストにパラメータIDが存在するか検索
-                for (csmInt32 j = 0; j < _expressionParameterValues->GetSize(); ++j)
-                {
-                    if (_expressionParameterValues->At(j).ParameterId != expressionParameters[i].ParameterId)
-                    {
-                        continue;
-                    }
-
-                    index = j;
-                    break;
-                }
-
-                if (index >= 0)
+                if (parameterIndices[i] >= 0)
                 {
-                    continue;
+                    ActivateParameter(parameterIndices[i], model->GetParameterValue(parameterIndices[i]));
                 }
-
-                // パラメータがリストに存在しないなら新規追加
-                ExpressionParameterValue item;
-                item.ParameterId = expressionParameters[i].ParameterId;
-                item.AdditiveValue = CubismExpressionMotion::DefaultAdditiveValue;
-                item.MultiplyValue = CubismExpressionMotion::DefaultMultiplyValue;
-                item.OverwriteValue = model->GetParameterValue(item.ParameterId);
-                _expressionParameterValues->PushBack(item);
             }
         }
 
@@ -155,7 +132,7 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
 
         SetFadeWeight(expressionIndex, expressionMotion->UpdateFadeWeight(motionQueueEntry, _userTimeSeconds));
         expressionMotion->CalculateExpressionParameters(model, _userTimeSeconds, motionQueueEntry,
-            _expressionParameterValues, expressionIndex, GetFadeWeight(expressionIndex));
+            &_parameterBuffer, expressionIndex, GetFadeWeight(expressionIndex));
 
         expressionWeight += expressionMotion->GetFadeInTime() == 0.0f
             ? 1.0f
@@ -184,7 +161,7 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
             for (csmInt32 i = motions->GetSize()-2; i >= 0; i--)
             {
                 CubismMotionQueueEntry* motionQueueEntry = motions->At(i);
-                CSM_DELETE(motionQueueEntry);
+                ReleaseMotionQueueEntry(motionQueueEntry);
                 motions->Remove(i);
                 _fadeWeights->Remove(i);
             }
@@ -197,19 +174,49 @@ csmBool CubismExpressionMotionManager::UpdateMotion(CubismModel* model, csmFloat
     }
 
     // モデルに各値を適用
-    for (csmInt32 i = 0; i < _expressionParameterValues->GetSize(); ++i)
+    const csmInt32* activeIndices = _parameterBuffer.ActiveIndices.GetPtr();
+    csmFloat32* additiveValues = _parameterBuffer.AdditiveValues.GetPtr();
+    csmFloat32* multiplyValues = _parameterBuffer.MultiplyValues.GetPtr();
+    const csmFloat32* overwriteValues = _parameterBuffer.OverwriteValues.GetPtr();
+    for (csmUint32 i = 0; i < _parameterBuffer.ActiveIndices.GetSize(); ++i)
     {
-        model->SetParameterValue(_expressionParameterValues->At(i).ParameterId,
-            (_expressionParameterValues->At(i).OverwriteValue + _expressionParameterValues->At(i).AdditiveValue) * _expressionParameterValues->At(i).MultiplyValue,
+        const csmInt32 parameterIndex = activeIndices[i];
+
+        model->SetParameterValue(parameterIndex,
+            (overwriteValues[parameterIndex] + additiveValues[parameterIndex]) * multiplyValues[parameterIndex],
             expressionWeight);
 
-        _expressionParameterValues->At(i).AdditiveValue = CubismExpressionMotion::DefaultAdditiveValue;
-        _expressionParameterValues->At(i).MultiplyValue = CubismExpressionMotion::DefaultMultiplyValue;
+        additiveValues[parameterIndex] = CubismExpressionMotion::DefaultAdditiveValue;
+        multiplyValues[parameterIndex] = CubismExpressionMotion::DefaultMultiplyValue;
     }
 
     return updated;
 }
 
+void CubismExpressionMotionManager::ActivateParameter(csmInt32 parameterIndex, csmFloat32 currentValue)
+{
+    // モデルに存在しないパラメータのインデックスはパラメータ数以降に振られる
+    if (static_cast<csmUint32>(parameterIndex) >= _parameterBuffer.Slots.GetSize())
+    {
+        const csmInt32 size = parameterIndex + 1;
+        _parameterBuffer.Slots.UpdateSize(size, ExpressionParameterBuffer::SlotUnused);
+        _parameterBuffer.AdditiveValues.UpdateSize(size, CubismExpressionMotion::DefaultAdditiveValue);
+        _parameterBuffer.MultiplyValues.UpdateSize(size, CubismExpressionMotion::DefaultMultiplyValue);
+        _parameterBuffer.OverwriteValues.UpdateSize(size, 0.0f);
+    }
+
+    if (_parameterBuffer.Slots[parameterIndex] != ExpressionParameterBuffer::SlotUnused)
+    {
+        return;
+    }
+
+    _parameterBuffer.Slots[parameterIndex] = ExpressionParameterBuffer::SlotNotInExpression;
+    _parameterBuffer.AdditiveValues[parameterIndex] = CubismExpressionMotion::DefaultAdditiveValue;
+    _parameterBuffer.MultiplyValues[parameterIndex] = CubismExpressionMotion::DefaultMultiplyValue;
+    _parameterBuffer.OverwriteValues[parameterIndex] = currentValue;
+    _parameterBuffer.ActiveIndices.PushBack(parameterIndex);
+}
+
 csmFloat32 CubismExpressionMotionManager::GetFadeWeight(csmInt32 index)
 {
     if (index < 0 || _fadeWeights->GetSize() < 1 || _fadeWeights->GetSize() <= index)
@@ -30,6 +30,27 @@ public:
         csmFloat32          OverwriteValue;     ///< Overwritten value
     };
 
+    /**
+     * Blend state of the parameters referenced by the playing expressions.
+     *
+     * The value arrays are indexed by parameter index and only grow when an expression
+     * references a parameter for the first time, so a steady-state update does not allocate.
+     */
+    struct ExpressionParameterBuffer
+    {
+        enum
+        {
+            SlotUnused = -2,            ///< Parameter not referenced by any expression so far
+            SlotNotInExpression = -1,   ///< Referenced parameter that the current expression does not set
+        };
+
+        csmVector<csmInt32>   ActiveIndices;    ///< Referenced parameter indices, in first-use order
+        csmVector<csmInt32>   Slots;            ///< Index into the current expression's parameters, or one of the Slot values above
+        csmVector<csmFloat32> AdditiveValues;   ///< Added value
+        csmVector<csmFloat32> MultiplyValues;   ///< Multiplied value
+        csmVector<csmFloat32> OverwriteValues;  ///< Overwritten value
+    };
+
     /**
      * Constructor
      */
@@ -108,8 +129,13 @@ private:
      */
     void SetFadeWeight(csmInt32 index, csmFloat32 expressionFadeWeight);
 
+    /**
+     * Adds a parameter to the buffer the first time it is referenced.
+     */
+    void ActivateParameter(csmInt32 parameterIndex, csmFloat32 currentValue);
+
     // Values of each parameter to be applied to the model
-    csmVector<ExpressionParameterValue>* _expressionParameterValues;
+    ExpressionParameterBuffer _parameterBuffer;
 
     // Weights of the currently playing expression
     csmVector<csmFloat32>* _fadeWeights;
@@ -7,9 +7,10 @@
 
 #include "CubismMotion.hpp"
 #include <float.h>
+#include <math.h>
 #include "CubismFramework.hpp"
 #include "CubismMotionInternal.hpp"
-#include "CubismMotionJson.hpp"
+#include "CubismMotionJsonReader.hpp"
 #include "CubismMotionQueueManager.hpp"
 #include "CubismMotionQueueEntry.hpp"
 #include "Math/CubismMath.hpp"
@@ -22,9 +23,6 @@ namespace {
 
 const csmChar* EffectNameEyeBlink = "EyeBlink";
 const csmChar* EffectNameLipSync  = "LipSync";
-const csmChar* TargetNameModel = "Model";
-const csmChar* TargetNameParameter = "Parameter";
-const csmChar* TargetNamePartOpacity = "PartOpacity";
 
 // Id
 const csmChar* IdNameOpacity = "Opacity";
@@ -214,7 +212,7 @@ csmFloat32 CorrectEndPoint(
     }
 }
 
-csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time, const csmBool isCorrection, const csmFloat32 endTime)
+csmFloat32 EvaluateSegments(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time, const csmBool isCorrection, const csmFloat32 endTime)
 {
     // Find segment to evaluate.
     const CubismMotionCurve& curve = motionData->Curves[index];
@@ -264,6 +262,70 @@ csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 inde
     return segment.Evaluate(&motionData->Points[segment.BasePointIndex], time);
 }
 
+csmFloat32 SampleBakedCurve(const CubismMotionData* motionData, const csmInt32 index, const csmInt32 offset, const csmFloat32 time)
+{
+    const csmFloat32 position = time * motionData->BakeRate;
+    const csmInt32 sample = static_cast<csmInt32>(position);
+    const csmFloat32 minimum = motionData->BakedMinimums[index];
+    const csmFloat32 scale = motionData->BakedScales[index];
+
+    if (sample >= motionData->BakedSampleCount - 1)
+    {
+        return minimum + motionData->BakedSamples[offset + motionData->BakedSampleCount - 1] * scale;
+    }
+
+    const csmFloat32 t = position - static_cast<csmFloat32>(sample);
+    const csmFloat32 a = motionData->BakedSamples[offset + sample];
+    const csmFloat32 b = motionData->BakedSamples[offset + sample + 1];
+
+    return minimum + (a + (b - a) * t) * scale;
+}
+
+csmFloat32 EvaluateCurve(const CubismMotionData* motionData, const csmInt32 index, csmFloat32 time, const csmBool isCorrection, const csmFloat32 endTime)
+{
+    // 最後の制御点より後はループ終端の補正を受けるため、テーブルを使わない
+    if (motionData->BakedSampleCount > 0 && time >= 0.0f && time <= motionData->BakedEndTime)
+    {
+        const csmInt32 offset = motionData->BakedCurveOffsets[index];
+        if (offset >= 0)
+        {
+            return SampleBakedCurve(motionData, index, offset, time);
+        }
+    }
+
+    return EvaluateSegments(motionData, index, time, isCorrection, endTime);
+}
+
+/**
+ * Whether a curve can be replaced by samples; stepped segments would be smeared
+ * by interpolation.
+ *
+ * @param outEndTime time of the last control point of the curve
+ */
+csmBool IsCurveBakeable(const CubismMotionData* motionData, const csmInt32 index, csmFloat32* outEndTime)
+{
+    const CubismMotionCurve& curve = motionData->Curves[index];
+    if (curve.SegmentCount <= 0)
+    {
+        return false;
+    }
+
+    csmInt32 lastPoint = 0;
+    for (csmInt32 i = curve.BaseSegmentIndex; i < curve.BaseSegmentIndex + curve.SegmentCount; ++i)
+    {
+        const CubismMotionSegment& segment = motionData->Segments[i];
+        if (segment.SegmentType == CubismMotionSegmentType_Stepped || segment.SegmentType == CubismMotionSegmentType_InverseStepped)
+        {
+            return false;
+        }
+
+        lastPoint = segment.BasePointIndex + (segment.SegmentType == CubismMotionSegmentType_Bezier ? 3 : 1);
+    }
+
+    *outEndTime = motionData->Points[lastPoint].Time;
+    return true;
+}
+
 }
 
 CubismMotion::CubismMotion()
@@ -280,7 +342,10 @@ CubismMotion::CubismMotion()
 
 CubismMotion::~CubismMotion()
 {
-    CSM_DELETE(_motionData);
+    if (_motionData != NULL && _motionData->ReferenceCount.fetch_sub(1) == 1)
+    {
+        CSM_DELETE(_motionData);
+    }
 }
 
 CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler, BeganMotionCallback onBeganMotionHandler)
@@ -299,6 +364,164 @@ CubismMotion* CubismMotion::Create(const csmByte* buffer, csmSizeInt size, Finis
     return ret;
 }
 
+CubismMotion* CubismMotion::Clone(FinishedMotionCallback onFinishedMotionHandler, BeganMotionCallback onBeganMotionHandler) const
+{
+    CubismMotion* ret = CSM_NEW CubismMotion();
+
+    _motionData->ReferenceCount.fetch_add(1);
+    ret->_motionData = _motionData;
+    ret->_sourceFrameRate = _sourceFrameRate;
+    ret->_loopDurationSeconds = _loopDurationSeconds;
+    ret->_motionBehavior = _motionBehavior;
+    ret->_fadeInSeconds = _fadeInSeconds;
+    ret->_fadeOutSeconds = _fadeOutSeconds;
+    ret->_weight = _weight;
+    ret->_isLoop = _isLoop;
+    ret->_isLoopFadeIn = _isLoopFadeIn;
+    ret->_previousLoopState = _previousLoopState;
+    ret->_eyeBlinkParameterIds = _eyeBlinkParameterIds;
+    ret->_lipSyncParameterIds = _lipSyncParameterIds;
+    ret->_onFinishedMotion = onFinishedMotionHandler;
+    ret->_onBeganMotion = onBeganMotionHandler;
+
+    return ret;
+}
+
+void CubismMotion::MakeMotionDataUnique()
+{
+    if (_motionData->ReferenceCount.load() == 1)
+    {
+        return;
+    }
+
+    CubismMotionData* data = CSM_NEW CubismMotionData;
+    data->Duration = _motionData->Duration;
+    data->Loop = _motionData->Loop;
+    data->CurveCount = _motionData->CurveCount;
+    data->EventCount = _motionData->EventCount;
+    data->Fps = _motionData->Fps;
+    data->Curves = _motionData->Curves;
+    data->Segments = _motionData->Segments;
+    data->Points = _motionData->Points;
+    data->Events = _motionData->Events;
+    data->BakeRate = _motionData->BakeRate;
+    data->BakedSampleCount = _motionData->BakedSampleCount;
+    data->BakedEndTime = _motionData->BakedEndTime;
+    data->BakeError = _motionData->BakeError;
+    data->BakedCurveOffsets = _motionData->BakedCurveOffsets;
+    data->BakedMinimums = _motionData->BakedMinimums;
+    data->BakedScales = _motionData->BakedScales;
+    data->BakedSamples = _motionData->BakedSamples;
+
+    if (_motionData->ReferenceCount.fetch_sub(1) == 1)
+    {
+        CSM_DELETE(_motionData);
+    }
+    _motionData = data;
+}
+
+void CubismMotion::Bake(csmFloat32 sampleRate)
+{
+    MakeMotionDataUnique();
+
+    CubismMotionData* data = _motionData;
+    data->BakeRate = 0.0f;
+    data->BakedSampleCount = 0;
+    data->BakedEndTime = 0.0f;
+    data->BakeError = 0.0f;
+    data->BakedCurveOffsets.Clear();
+    data->BakedMinimums.Clear();
+    data->BakedScales.Clear();
+    data->BakedSamples.Clear();
+
+    if (sampleRate <= 0.0f || data->Duration <= 0.0f)
+    {
+        return;
+    }
+
+    // サンプル i は時刻 i / sampleRate、最後のサンプルは Duration 以降の終端値
+    const csmInt32 sampleCount = static_cast<csmInt32>(ceilf(data->Duration * sampleRate)) + 1;
+    csmVector<csmFloat32> values;
+    values.UpdateSize(sampleCount, 0.0f, false);
+
+    data->BakedCurveOffsets.PrepareCapacity(data->CurveCount);
+    data->BakedMinimums.PrepareCapacity(data->CurveCount);
+    data->BakedScales.PrepareCapacity(data->CurveCount);
+
+    csmFloat32 endTime = data->Duration;
+    for (csmInt32 c = 0; c < data->CurveCount; ++c)
+    {
+        csmFloat32 curveEndTime;
+        if (!IsCurveBakeable(data, c, &curveEndTime))
+        {
+            data->BakedCurveOffsets.PushBack(-1);
+            data->BakedMinimums.PushBack(0.0f);
+            data->BakedScales.PushBack(0.0f);
+            continue;
+        }
+
+        csmFloat32 minimum = FLT_MAX;
+        csmFloat32 maximum = -FLT_MAX;
+        for (csmInt32 i = 0; i < sampleCount; ++i)
+        {
+            values[i] = EvaluateSegments(data, c, static_cast<csmFloat32>(i) / sampleRate, false, data->Duration);
+            minimum = CubismMath::Min(minimum, values[i]);
+            maximum = CubismMath::Max(maximum, values[i]);
+        }
+
+        const csmFloat32 scale = (maximum - minimum) / 65535.0f;
+        const csmInt32 offset = static_cast<csmInt32>(data->BakedSamples.GetSize());
+        for (csmInt32 i = 0; i < sampleCount; ++i)
+        {
+            const csmFloat32 level = scale > 0.0f ? (values[i] - minimum) / scale + 0.5f : 0.0f;
+            data->BakedSamples.PushBack(static_cast<csmUint16>(CubismMath::Min(level, 65535.0f)));
+        }
+
+        data->BakedCurveOffsets.PushBack(offset);
+        data->BakedMinimums.PushBack(minimum);
+        data->BakedScales.PushBack(scale);
+        endTime = CubismMath::Min(endTime, curveEndTime);
+    }
+
+    data->BakeRate = sampleRate;
+    data->BakedSampleCount = sampleCount;
+    data->BakedEndTime = endTime;
+
+    // 各区間の 4 点で元の曲線との差を測る
+    csmFloat32 error = 0.0f;
+    for (csmInt32 c = 0; c < data->CurveCount; ++c)
+    {
+        const csmInt32 offset = data->BakedCurveOffsets[c];
+        if (offset < 0)
+        {
+            continue;
+        }
+
+        for (csmInt32 i = 0; i < sampleCount * 4; ++i)
+        {
+            const csmFloat32 time = static_cast<csmFloat32>(i) / (sampleRate * 4.0f);
+            if (time > endTime)
+            {
+                break;
+            }
+
+            const csmFloat32 exact = EvaluateSegments(data, c, time, false, data->Duration);
+            error = CubismMath::Max(error, CubismMath::AbsF(SampleBakedCurve(data, c, offset, time) - exact));
+        }
+    }
+    data->BakeError = error;
+}
+
+csmFloat32 CubismMotion::GetBakeRate() const
+{
+    return _motionData->BakeRate;
+}
+
+csmFloat32 CubismMotion::GetBakeError() const
+{
+    return _motionData->BakeError;
+}
+
 csmFloat32 CubismMotion::GetDuration()
 {
     return _isLoop ? -1.0f : _loopDurationSeconds;
@@ -607,194 +830,77 @@ void CubismMotion::Parse(const csmByte* motionJson, const csmSizeInt size)
 {
     _motionData = CSM_NEW CubismMotionData;
 
-    CubismMotionJson* json = CSM_NEW CubismMotionJson(motionJson, size);
+    CubismMotionJsonReader reader(motionJson, size);
 
-    if (!json->IsValid())
+    if (!reader.Read(_motionData))
     {
-        CSM_DELETE(json);
+        CubismLogError("Failed to parse motion3.json : %s", reader.GetError());
+        CSM_DELETE(_motionData);
+        _motionData = CSM_NEW CubismMotionData;
         return;
     }
 
-#if _DEBUG
-    json->HasConsistency();
-#endif // _DEBUG
-
-    _motionData->Duration = json->GetMotionDuration();
-    _motionData->Loop = json->IsMotionLoop();
-    _motionData->CurveCount = json->GetMotionCurveCount();
-    _motionData->Fps = json->GetMotionFps();
-    _motionData->EventCount = json->GetEventCount();
-
-    csmBool areBeziersRestricted = json->GetEvaluationOptionFlag( EvaluationOptionFlag_AreBeziersRestricted );
+    csmBool areBeziersRestricted = reader.IsBeziersRestricted();
 
-    if (json->IsExistMotionFadeInTime())
+    if (reader.IsExistMotionFadeInTime())
     {
-        _fadeInSeconds = (json->GetMotionFadeInTime() < 0.0f)
+        _fadeInSeconds = (reader.GetMotionFadeInTime() < 0.0f)
                              ? 1.0f
-                             : json->GetMotionFadeInTime();
+                             : reader.GetMotionFadeInTime();
     }
     else
     {
         _fadeInSeconds = 1.0f;
     }
 
-    if (json->IsExistMotionFadeOutTime())
+    if (reader.IsExistMotionFadeOutTime())
     {
-        _fadeOutSeconds = (json->GetMotionFadeOutTime() < 0.0f)
+        _fadeOutSeconds = (reader.GetMotionFadeOutTime() < 0.0f)
                               ? 1.0f
-                              : json->GetMotionFadeOutTime();
+                              : reader.GetMotionFadeOutTime();
     }
     else
     {
         _fadeOutSeconds = 1.0f;
     }
 
-    _motionData->Curves.UpdateSize(_motionData->CurveCount, CubismMotionCurve(), true);
-    _motionData->Segments.UpdateSize(json->GetMotionTotalSegmentCount(), CubismMotionSegment(), true);
-    _motionData->Points.UpdateSize(json->GetMotionTotalPointCount(), CubismMotionPoint(), true);
-    _motionData->Events.UpdateSize(_motionData->EventCount, CubismMotionEvent(), true);
-
-    csmInt32 totalPointCount = 0;
-    csmInt32 totalSegmentCount = 0;
-
-    // Curves
-    for (csmInt32 curveCount = 0; curveCount < _motionData->CurveCount; ++curveCount)
+    // Segments
+    for (csmUint32 i = 0; i < _motionData->Segments.GetSize(); ++i)
     {
-        if (strcmp(json->GetMotionCurveTarget(curveCount), TargetNameModel) == 0)
-        {
-            _motionData->Curves[curveCount].Type = CubismMotionCurveTarget_Model;
-        }
-        else if (strcmp(json->GetMotionCurveTarget(curveCount), TargetNameParameter) == 0)
-        {
-            _motionData->Curves[curveCount].Type = CubismMotionCurveTarget_Parameter;
-        }
-        else if (strcmp(json->GetMotionCurveTarget(curveCount), TargetNamePartOpacity) == 0)
-        {
-            _motionData->Curves[curveCount].Type = CubismMotionCurveTarget_PartOpacity;
-        }
-        else
-        {
-            CubismLogWarning("Warning : Unable to get segment type from Curve! The number of \"CurveCount\" may be incorrect!");
-        }
-
-        _motionData->Curves[curveCount].Id = json->GetMotionCurveId(curveCount);
+        CubismMotionSegment& segment = _motionData->Segments[i];
 
-        _motionData->Curves[curveCount].BaseSegmentIndex = totalSegmentCount;
-
-        _motionData->Curves[curveCount].FadeInTime =
-                (json->IsExistMotionCurveFadeInTime(curveCount))
-                    ? json->GetMotionCurveFadeInTime(curveCount)
-                    : -1.0f ;
-        _motionData->Curves[curveCount].FadeOutTime =
-                (json->IsExistMotionCurveFadeOutTime(curveCount))
-                    ? json->GetMotionCurveFadeOutTime(curveCount)
-                    : -1.0f;
-
-        // Segments
-        for (csmInt32 segmentPosition = 0; segmentPosition < json->GetMotionCurveSegmentCount(curveCount);)
+        switch (segment.SegmentType)
         {
-            if (segmentPosition == 0)
+        case CubismMotionSegmentType_Linear:
+            segment.Evaluate = LinearEvaluate;
+            break;
+        case CubismMotionSegmentType_Bezier:
+            if (areBeziersRestricted || UseOldBeziersCurveMotion)
             {
-                _motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount;
-
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, segmentPosition);
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, segmentPosition + 1);
-
-                totalPointCount += 1;
-                segmentPosition += 2;
+                segment.Evaluate = BezierEvaluate;
             }
             else
             {
-                _motionData->Segments[totalSegmentCount].BasePointIndex = totalPointCount - 1;
-            }
-
-            const csmInt32 segment = static_cast<csmInt32>(json->GetMotionCurveSegment(curveCount, segmentPosition));
-
-            switch (segment)
-            {
-            case CubismMotionSegmentType_Linear: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Linear;
-                _motionData->Segments[totalSegmentCount].Evaluate = LinearEvaluate;
-
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
-
-                totalPointCount += 1;
-                segmentPosition += 3;
-
-                break;
-            }
-            case CubismMotionSegmentType_Bezier: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Bezier;
-                if (areBeziersRestricted || UseOldBeziersCurveMotion) {
-                    _motionData->Segments[totalSegmentCount].Evaluate = BezierEvaluate;
-                }
-                else
-                {
-                    _motionData->Segments[totalSegmentCount].Evaluate = BezierEvaluateCardanoInterpretation;
-                }
-
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
-
-                _motionData->Points[totalPointCount + 1].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 3));
-                _motionData->Points[totalPointCount + 1].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 4));
-
-                _motionData->Points[totalPointCount + 2].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 5));
-                _motionData->Points[totalPointCount + 2].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 6));
-
-                totalPointCount += 3;
-                segmentPosition += 7;
-
-                break;
-            }
-            case CubismMotionSegmentType_Stepped: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_Stepped;
-                _motionData->Segments[totalSegmentCount].Evaluate = SteppedEvaluate;
-
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
-
-                totalPointCount += 1;
-                segmentPosition += 3;
-
-                break;
+                segment.Evaluate = BezierEvaluateCardanoInterpretation;
             }
-            case CubismMotionSegmentType_InverseStepped: {
-                _motionData->Segments[totalSegmentCount].SegmentType = CubismMotionSegmentType_InverseStepped;
-                _motionData->Segments[totalSegmentCount].Evaluate = InverseSteppedEvaluate;
-
-                _motionData->Points[totalPointCount].Time = json->GetMotionCurveSegment(curveCount, (segmentPosition + 1));
-                _motionData->Points[totalPointCount].Value = json->GetMotionCurveSegment(curveCount, (segmentPosition + 2));
-
-                totalPointCount += 1;
-                segmentPosition += 3;
-
-                break;
-            }
-            default: {
-                CSM_ASSERT(0);
-                break;
-            }
-            }
-
-            ++_motionData->Curves[curveCount].SegmentCount;
-            ++totalSegmentCount;
+            break;
+        case CubismMotionSegmentType_Stepped:
+            segment.Evaluate = SteppedEvaluate;
+            break;
+        case CubismMotionSegmentType_InverseStepped:
+            segment.Evaluate = InverseSteppedEvaluate;
+            break;
+        default:
+            CSM_ASSERT(0);
+            break;
         }
     }
-
-
-    for (csmInt32 userdatacount = 0; userdatacount < json->GetEventCount(); ++userdatacount)
-    {
-        _motionData->Events[userdatacount].FireTime = json->GetEventTime(userdatacount);
-        _motionData->Events[userdatacount].Value = json->GetEventValue(userdatacount);
-    }
-
-    CSM_DELETE(json);
 }
 
 void CubismMotion::SetParameterFadeInTime(CubismIdHandle parameterId, csmFloat32 value)
 {
+    MakeMotionDataUnique();
+
     csmVector<CubismMotionCurve>& curves = _motionData->Curves;
 
     for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
@@ -809,6 +915,8 @@ void CubismMotion::SetParameterFadeInTime(CubismIdHandle parameterId, csmFloat32
 
 void CubismMotion::SetParameterFadeOutTime(CubismIdHandle parameterId, csmFloat32 value)
 {
+    MakeMotionDataUnique();
+
     csmVector<CubismMotionCurve>& curves = _motionData->Curves;
 
     for (csmInt16 i = 0; i < _motionData->CurveCount; ++i)
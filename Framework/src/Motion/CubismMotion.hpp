@@ -44,6 +44,48 @@ public:
      */
     static CubismMotion* Create(const csmByte* buffer, csmSizeInt size, FinishedMotionCallback onFinishedMotionHandler = NULL, BeganMotionCallback onBeganMotionHandler = NULL);
 
+    /**
+     * Makes an instance that shares the parsed curves of this motion.
+     *
+     * Fade times, loop settings and effect IDs are copied; playback state is not.
+     * The curve data is copied on the first per-parameter fade change, so clones
+     * never affect each other.
+     *
+     * @param onFinishedMotionHandler callback function for when motion playback ends
+     * @param onBeganMotionHandler callback function for when motion playback starts
+     *
+     * @return created instance
+     */
+    CubismMotion* Clone(FinishedMotionCallback onFinishedMotionHandler = NULL, BeganMotionCallback onBeganMotionHandler = NULL) const;
+
+    /**
+     * Samples the curves at a fixed rate into 16-bit quantized tables.
+     *
+     * Afterwards curves are evaluated by linear interpolation between two
+     * samples instead of searching segments and solving Bezier segments.
+     * Curves with stepped segments are left unbaked, as are the times past the
+     * last control point, where the loop correction applies. The largest deviation from the exact curves,
+     * measured at four points per sample interval while baking, is returned by
+     * GetBakeError(); it is bounded by the quantization step (range / 65535) plus
+     * the curvature of the segments over one interval.
+     *
+     * Bake before cloning: the tables belong to the curve data shared with clones,
+     * so a shared motion first gets its own copy of the curves.
+     *
+     * @param sampleRate samples per second; 0 or less removes the tables
+     */
+    void Bake(csmFloat32 sampleRate);
+
+    /**
+     * Returns the rate passed to Bake(), or 0 if the motion is not baked.
+     */
+    csmFloat32 GetBakeRate() const;
+
+    /**
+     * Returns the largest deviation of the baked curves measured while baking.
+     */
+    csmFloat32 GetBakeError() const;
+
     /**
      * Updates the model parameters.
      *
@@ -217,6 +259,8 @@ private:
 
     void Parse(const csmByte* motionJson, const csmSizeInt size);
 
+    void MakeMotionDataUnique();
+
     csmFloat32      _sourceFrameRate;
     csmFloat32      _loopDurationSeconds;
     MotionBehavior  _motionBehavior;
@@ -9,6 +9,8 @@
 
 #include "CubismFramework.hpp"
 
+#include <atomic>
+
 namespace Live2D { namespace Cubism { namespace Framework {
 
 /**
@@ -130,6 +132,11 @@ struct CubismMotionData
         , CurveCount(0)
         , EventCount(0)
         , Fps(0.0f)
+        , BakeRate(0.0f)
+        , BakedSampleCount(0)
+        , BakedEndTime(0.0f)
+        , BakeError(0.0f)
+        , ReferenceCount(1)
     { }
 
     csmFloat32 Duration;                            ///< Motion length [seconds]
@@ -141,6 +148,15 @@ struct CubismMotionData
     csmVector<CubismMotionSegment> Segments;        ///< Segment collection
     csmVector<CubismMotionPoint> Points;            ///< Control point collection
     csmVector<CubismMotionEvent> Events;            ///< User data event collection
+    csmFloat32 BakeRate;                            ///< Sampling rate of the baked curves [Hz]; 0 if not baked
+    csmInt32 BakedSampleCount;                      ///< Number of samples per baked curve
+    csmFloat32 BakedEndTime;                        ///< Earliest last point time of the baked curves; later times are evaluated from segments
+    csmFloat32 BakeError;                           ///< Largest deviation of the baked curves measured while baking
+    csmVector<csmInt32> BakedCurveOffsets;          ///< Per curve, index of its first sample in BakedSamples; -1 if evaluated from segments
+    csmVector<csmFloat32> BakedMinimums;            ///< Per curve, value of quantized sample 0
+    csmVector<csmFloat32> BakedScales;              ///< Per curve, value step of one quantization level
+    csmVector<csmUint16> BakedSamples;              ///< Quantized samples of all baked curves
+    std::atomic<csmInt32> ReferenceCount;           ///< Number of CubismMotion instances sharing this data
 };
 
 }}}
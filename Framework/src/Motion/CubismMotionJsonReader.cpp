@@ -0,0 +1,841 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "CubismMotionJsonReader.hpp"
+#include <string.h>
+#include "Type/csmVector.hpp"
+#include "Id/CubismId.hpp"
+#include "CubismMotionInternal.hpp"
+#include "Id/CubismIdManager.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+namespace {
+// JSON keys
+const csmChar* Meta = "Meta";
+const csmChar* Duration = "Duration";
+const csmChar* Loop = "Loop";
+const csmChar* AreBeziersRestricted = "AreBeziersRestricted";
+const csmChar* CurveCount = "CurveCount";
+const csmChar* Fps = "Fps";
+const csmChar* TotalSegmentCount = "TotalSegmentCount";
+const csmChar* TotalPointCount = "TotalPointCount";
+const csmChar* Curves = "Curves";
+const csmChar* Target = "Target";
+const csmChar* Id = "Id";
+const csmChar* FadeInTime = "FadeInTime";
+const csmChar* FadeOutTime = "FadeOutTime";
+const csmChar* Segments = "Segments";
+const csmChar* UserData = "UserData";
+const csmChar* UserDataCount = "UserDataCount";
+const csmChar* Time = "Time";
+const csmChar* Value = "Value";
+
+const csmChar* TargetNameModel = "Model";
+const csmChar* TargetNameParameter = "Parameter";
+const csmChar* TargetNamePartOpacity = "PartOpacity";
+
+csmBool KeyEquals(const csmChar* key, csmInt32 length, const csmChar* name)
+{
+    return strncmp(key, name, length) == 0 && name[length] == '\0';
+}
+}
+
+CubismMotionJsonReader::CubismMotionJsonReader(const csmByte* buffer, csmSizeInt size)
+    : _buffer(reinterpret_cast<const csmChar*>(buffer))
+    , _length(static_cast<csmInt32>(size))
+    , _position(0)
+    , _error(NULL)
+    , _areBeziersRestricted(false)
+    , _hasFadeInTime(false)
+    , _hasFadeOutTime(false)
+    , _fadeInTime(0.0f)
+    , _fadeOutTime(0.0f)
+    , _metaCurveCount(-1)
+    , _metaSegmentCount(-1)
+    , _metaPointCount(-1)
+    , _metaEventCount(-1)
+{ }
+
+csmBool CubismMotionJsonReader::Read(CubismMotionData* motionData)
+{
+    if (_buffer == NULL)
+    {
+        _error = "buffer is null";
+        return false;
+    }
+
+    // UTF-8 BOM
+    if (_length >= 3 && static_cast<csmUint8>(_buffer[0]) == 0xEF
+        && static_cast<csmUint8>(_buffer[1]) == 0xBB && static_cast<csmUint8>(_buffer[2]) == 0xBF)
+    {
+        _position = 3;
+    }
+
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (_position < _length && _buffer[_position] == '}')
+    {
+        _position++;
+    }
+    else
+    {
+        for (;;)
+        {
+            const csmChar* key;
+            csmInt32 keyLength;
+            if (!ReadKey(&key, &keyLength))
+            {
+                return false;
+            }
+
+            csmBool ok;
+            if (KeyEquals(key, keyLength, Meta))
+            {
+                ok = ReadMeta(motionData);
+            }
+            else if (KeyEquals(key, keyLength, Curves))
+            {
+                ok = ReadCurves(motionData);
+            }
+            else if (KeyEquals(key, keyLength, UserData))
+            {
+                ok = ReadUserData(motionData);
+            }
+            else
+            {
+                ok = SkipValue();
+            }
+
+            if (!ok)
+            {
+                return false;
+            }
+
+            SkipWhitespace();
+            if (_position < _length && _buffer[_position] == ',')
+            {
+                _position++;
+                continue;
+            }
+            if (!Expect('}'))
+            {
+                return false;
+            }
+            break;
+        }
+    }
+
+    const csmInt32 curveCount = static_cast<csmInt32>(motionData->Curves.GetSize());
+    if (_metaCurveCount >= 0 && curveCount != _metaCurveCount)
+    {
+        CubismLogWarning("The number of curves does not match the metadata.");
+    }
+    if (_metaSegmentCount >= 0 && static_cast<csmInt32>(motionData->Segments.GetSize()) != _metaSegmentCount)
+    {
+        CubismLogWarning("The number of segment does not match the metadata.");
+    }
+    if (_metaPointCount >= 0 && static_cast<csmInt32>(motionData->Points.GetSize()) != _metaPointCount)
+    {
+        CubismLogWarning("The number of point does not match the metadata.");
+    }
+
+    motionData->CurveCount = static_cast<csmInt16>(curveCount);
+    motionData->EventCount = static_cast<csmInt32>(motionData->Events.GetSize());
+
+    return true;
+}
+
+void CubismMotionJsonReader::SkipWhitespace()
+{
+    while (_position < _length)
+    {
+        switch (_buffer[_position])
+        {
+        case ' ': case '\t': case '\r': case '\n':
+            _position++;
+            break;
+        default:
+            return;
+        }
+    }
+}
+
+csmBool CubismMotionJsonReader::Expect(csmChar c)
+{
+    SkipWhitespace();
+    if (_position >= _length || _buffer[_position] != c)
+    {
+        _error = "unexpected character";
+        return false;
+    }
+    _position++;
+    return true;
+}
+
+csmBool CubismMotionJsonReader::ReadKey(const csmChar** outKey, csmInt32* outLength)
+{
+    if (!Expect('\"'))
+    {
+        return false;
+    }
+
+    // Keys of motion3.json never contain escapes, so they are compared in place.
+    const csmInt32 begin = _position;
+    while (_position < _length && _buffer[_position] != '\"')
+    {
+        if (_buffer[_position] == '\\')
+        {
+            _error = "escaped key not supported";
+            return false;
+        }
+        _position++;
+    }
+    if (_position >= _length)
+    {
+        _error = "illegal end of key";
+        return false;
+    }
+
+    *outKey = _buffer + begin;
+    *outLength = _position - begin;
+    _position++;
+
+    return Expect(':');
+}
+
+csmBool CubismMotionJsonReader::ReadString(csmString& outValue)
+{
+    if (!Expect('\"'))
+    {
+        return false;
+    }
+
+    csmInt32 chunkStart = _position;
+    for (; _position < _length; _position++)
+    {
+        const csmChar c = _buffer[_position];
+        if (c == '\"')
+        {
+            outValue.Append(_buffer + chunkStart, _position - chunkStart);
+            _position++;
+            return true;
+        }
+        if (c != '\\')
+        {
+            continue;
+        }
+
+        outValue.Append(_buffer + chunkStart, _position - chunkStart);
+        _position++;
+        if (_position >= _length)
+        {
+            break;
+        }
+        switch (_buffer[_position])
+        {
+        case 'b': outValue.Append(1, '\b'); break;
+        case 'f': outValue.Append(1, '\f'); break;
+        case 'n': outValue.Append(1, '\n'); break;
+        case 'r': outValue.Append(1, '\r'); break;
+        case 't': outValue.Append(1, '\t'); break;
+        case 'u':
+            _error = "parse string/unicode escape not supported";
+            return false;
+        default: outValue.Append(1, _buffer[_position]); break;
+        }
+        chunkStart = _position + 1;
+    }
+
+    _error = "parse string/illegal end";
+    return false;
+}
+
+csmBool CubismMotionJsonReader::ReadNumber(csmFloat32* outValue)
+{
+    SkipWhitespace();
+
+    // Accumulated in single precision the same way as CubismJson::ParseNumeric, so that
+    // the values are bit-identical to those read through CubismMotionJson.
+    csmFloat32 value = 0.0f;
+    csmFloat32 decimalMultiplier = 0.1f;
+    csmInt32 exponent = 0;
+    csmBool isNegative = false;
+    csmBool hasDigits = false;
+
+    if (_position < _length && (_buffer[_position] == '-' || _buffer[_position] == '+'))
+    {
+        isNegative = _buffer[_position] == '-';
+        _position++;
+    }
+    while (_position < _length && _buffer[_position] >= '0' && _buffer[_position] <= '9')
+    {
+        value = value * 10 + (_buffer[_position] - '0');
+        hasDigits = true;
+        _position++;
+    }
+    if (_position < _length && _buffer[_position] == '.')
+    {
+        _position++;
+        while (_position < _length && _buffer[_position] >= '0' && _buffer[_position] <= '9')
+        {
+            value += (_buffer[_position] - '0') * decimalMultiplier;
+            decimalMultiplier *= 0.1f;
+            hasDigits = true;
+            _position++;
+        }
+    }
+    if (!hasDigits)
+    {
+        _error = "non-numeric charactor found";
+        return false;
+    }
+    if (_position < _length && (_buffer[_position] == 'e' || _buffer[_position] == 'E'))
+    {
+        _position++;
+        csmBool negativeExponent = false;
+        if (_position < _length && (_buffer[_position] == '-' || _buffer[_position] == '+'))
+        {
+            negativeExponent = _buffer[_position] == '-';
+            _position++;
+        }
+        csmInt32 e = 0;
+        while (_position < _length && _buffer[_position] >= '0' && _buffer[_position] <= '9')
+        {
+            if (e < 1000)
+            {
+                e = e * 10 + (_buffer[_position] - '0');
+            }
+            _position++;
+        }
+        exponent = negativeExponent ? -e : e;
+    }
+
+    // CubismJson does not accept exponents; they are applied on top of the value read above.
+    double result = value;
+    double scale = 1.0;
+    double base = 10.0;
+    for (csmInt32 e = exponent < 0 ? -exponent : exponent; e > 0; e >>= 1)
+    {
+        if (e & 1)
+        {
+            scale *= base;
+        }
+        base *= base;
+    }
+    result = exponent < 0 ? result / scale : result * scale;
+
+    *outValue = static_cast<csmFloat32>(isNegative ? -result : result);
+    return true;
+}
+
+csmBool CubismMotionJsonReader::ReadBoolean(csmBool* outValue)
+{
+    SkipWhitespace();
+    if (_position + 4 <= _length && strncmp(_buffer + _position, "true", 4) == 0)
+    {
+        *outValue = true;
+        _position += 4;
+        return true;
+    }
+    if (_position + 5 <= _length && strncmp(_buffer + _position, "false", 5) == 0)
+    {
+        *outValue = false;
+        _position += 5;
+        return true;
+    }
+
+    _error = "boolean expected";
+    return false;
+}
+
+csmBool CubismMotionJsonReader::SkipValue()
+{
+    SkipWhitespace();
+    if (_position >= _length)
+    {
+        _error = "illegal end of value";
+        return false;
+    }
+
+    switch (_buffer[_position])
+    {
+    case '\"': {
+        for (_position++; _position < _length; _position++)
+        {
+            if (_buffer[_position] == '\\')
+            {
+                _position++;
+            }
+            else if (_buffer[_position] == '\"')
+            {
+                _position++;
+                return true;
+            }
+        }
+        _error = "parse string/illegal end";
+        return false;
+    }
+    case '{':
+    case '[': {
+        const csmChar close = _buffer[_position] == '{' ? '}' : ']';
+        const csmBool isObject = close == '}';
+        _position++;
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == close)
+        {
+            _position++;
+            return true;
+        }
+        for (;;)
+        {
+            if (isObject)
+            {
+                const csmChar* key;
+                csmInt32 keyLength;
+                if (!ReadKey(&key, &keyLength))
+                {
+                    return false;
+                }
+            }
+            if (!SkipValue())
+            {
+                return false;
+            }
+            SkipWhitespace();
+            if (_position < _length && _buffer[_position] == ',')
+            {
+                _position++;
+                continue;
+            }
+            return Expect(close);
+        }
+    }
+    case 't':
+    case 'f': {
+        csmBool dummy;
+        return ReadBoolean(&dummy);
+    }
+    case 'n':
+        if (_position + 4 <= _length && strncmp(_buffer + _position, "null", 4) == 0)
+        {
+            _position += 4;
+            return true;
+        }
+        _error = "parse null";
+        return false;
+    default: {
+        csmFloat32 dummy;
+        return ReadNumber(&dummy);
+    }
+    }
+}
+
+csmBool CubismMotionJsonReader::ReadMeta(CubismMotionData* motionData)
+{
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (_position < _length && _buffer[_position] == '}')
+    {
+        _position++;
+        return true;
+    }
+
+    for (;;)
+    {
+        const csmChar* key;
+        csmInt32 keyLength;
+        if (!ReadKey(&key, &keyLength))
+        {
+            return false;
+        }
+
+        csmFloat32 number;
+        csmBool ok = true;
+        if (KeyEquals(key, keyLength, Duration))
+        {
+            ok = ReadNumber(&motionData->Duration);
+        }
+        else if (KeyEquals(key, keyLength, Fps))
+        {
+            ok = ReadNumber(&motionData->Fps);
+        }
+        else if (KeyEquals(key, keyLength, Loop))
+        {
+            csmBool loop;
+            ok = ReadBoolean(&loop);
+            motionData->Loop = loop;
+        }
+        else if (KeyEquals(key, keyLength, AreBeziersRestricted))
+        {
+            ok = ReadBoolean(&_areBeziersRestricted);
+        }
+        else if (KeyEquals(key, keyLength, CurveCount))
+        {
+            ok = ReadNumber(&number);
+            _metaCurveCount = static_cast<csmInt32>(number);
+            motionData->Curves.PrepareCapacity(_metaCurveCount);
+        }
+        else if (KeyEquals(key, keyLength, TotalSegmentCount))
+        {
+            ok = ReadNumber(&number);
+            _metaSegmentCount = static_cast<csmInt32>(number);
+            motionData->Segments.PrepareCapacity(_metaSegmentCount);
+        }
+        else if (KeyEquals(key, keyLength, TotalPointCount))
+        {
+            ok = ReadNumber(&number);
+            _metaPointCount = static_cast<csmInt32>(number);
+            motionData->Points.PrepareCapacity(_metaPointCount);
+        }
+        else if (KeyEquals(key, keyLength, UserDataCount))
+        {
+            ok = ReadNumber(&number);
+            _metaEventCount = static_cast<csmInt32>(number);
+            motionData->Events.PrepareCapacity(_metaEventCount);
+        }
+        else if (KeyEquals(key, keyLength, FadeInTime))
+        {
+            ok = ReadNumber(&_fadeInTime);
+            _hasFadeInTime = true;
+        }
+        else if (KeyEquals(key, keyLength, FadeOutTime))
+        {
+            ok = ReadNumber(&_fadeOutTime);
+            _hasFadeOutTime = true;
+        }
+        else
+        {
+            ok = SkipValue();
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == ',')
+        {
+            _position++;
+            continue;
+        }
+        return Expect('}');
+    }
+}
+
+csmBool CubismMotionJsonReader::ReadCurves(CubismMotionData* motionData)
+{
+    if (!Expect('['))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (_position < _length && _buffer[_position] == ']')
+    {
+        _position++;
+        return true;
+    }
+
+    for (;;)
+    {
+        if (!ReadCurve(motionData))
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == ',')
+        {
+            _position++;
+            continue;
+        }
+        return Expect(']');
+    }
+}
+
+csmBool CubismMotionJsonReader::ReadCurve(CubismMotionData* motionData)
+{
+    if (!Expect('{'))
+    {
+        return false;
+    }
+
+    const csmInt32 curveIndex = static_cast<csmInt32>(motionData->Curves.GetSize());
+    motionData->Curves.PushBack(CubismMotionCurve());
+    CubismMotionCurve& curve = motionData->Curves[curveIndex];
+    curve.BaseSegmentIndex = static_cast<csmInt32>(motionData->Segments.GetSize());
+    curve.FadeInTime = -1.0f;
+    curve.FadeOutTime = -1.0f;
+
+    SkipWhitespace();
+    if (_position < _length && _buffer[_position] == '}')
+    {
+        _position++;
+        return true;
+    }
+
+    for (;;)
+    {
+        const csmChar* key;
+        csmInt32 keyLength;
+        if (!ReadKey(&key, &keyLength))
+        {
+            return false;
+        }
+
+        csmBool ok = true;
+        if (KeyEquals(key, keyLength, Target))
+        {
+            csmString target;
+            ok = ReadString(target);
+            if (target == TargetNameModel)
+            {
+                curve.Type = CubismMotionCurveTarget_Model;
+            }
+            else if (target == TargetNameParameter)
+            {
+                curve.Type = CubismMotionCurveTarget_Parameter;
+            }
+            else if (target == TargetNamePartOpacity)
+            {
+                curve.Type = CubismMotionCurveTarget_PartOpacity;
+            }
+            else
+            {
+                CubismLogWarning("Warning : Unable to get segment type from Curve! The number of \"CurveCount\" may be incorrect!");
+            }
+        }
+        else if (KeyEquals(key, keyLength, Id))
+        {
+            csmString id;
+            ok = ReadString(id);
+            curve.Id = CubismFramework::GetIdManager()->GetId(id);
+        }
+        else if (KeyEquals(key, keyLength, FadeInTime))
+        {
+            ok = ReadNumber(&curve.FadeInTime);
+        }
+        else if (KeyEquals(key, keyLength, FadeOutTime))
+        {
+            ok = ReadNumber(&curve.FadeOutTime);
+        }
+        else if (KeyEquals(key, keyLength, Segments))
+        {
+            ok = ReadSegments(motionData, curveIndex);
+        }
+        else
+        {
+            ok = SkipValue();
+        }
+
+        if (!ok)
+        {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == ',')
+        {
+            _position++;
+            continue;
+        }
+        return Expect('}');
+    }
+}
+
+csmBool CubismMotionJsonReader::ReadSegments(CubismMotionData* motionData, csmInt32 curveIndex)
+{
+    if (!Expect('['))
+    {
+        return false;
+    }
+
+    csmVector<CubismMotionSegment>& segments = motionData->Segments;
+    csmVector<CubismMotionPoint>& points = motionData->Points;
+
+    // The flat array is [t0, v0, type, ...points, type, ...points, ...]
+    csmFloat32 values[6];
+    csmInt32 valueCount = 0;
+    csmInt32 expected = 2;
+    csmInt32 segmentType = -1;
+    csmBool isFirstPoint = true;
+
+    SkipWhitespace();
+    if (_position < _length && _buffer[_position] == ']')
+    {
+        _position++;
+        return true;
+    }
+
+    for (;;)
+    {
+        csmFloat32 number;
+        if (!ReadNumber(&number))
+        {
+            return false;
+        }
+
+        if (segmentType < 0 && !isFirstPoint)
+        {
+            segmentType = static_cast<csmInt32>(number);
+            switch (segmentType)
+            {
+            case CubismMotionSegmentType_Linear:
+            case CubismMotionSegmentType_Stepped:
+            case CubismMotionSegmentType_InverseStepped:
+                expected = 2;
+                break;
+            case CubismMotionSegmentType_Bezier:
+                expected = 6;
+                break;
+            default:
+                CSM_ASSERT(0);
+                _error = "unknown segment type";
+                return false;
+            }
+        }
+        else
+        {
+            values[valueCount++] = number;
+        }
+
+        if (valueCount == expected)
+        {
+            if (!isFirstPoint)
+            {
+                CubismMotionSegment segment;
+                segment.BasePointIndex = static_cast<csmInt32>(points.GetSize()) - 1;
+                segment.SegmentType = segmentType;
+                segments.PushBack(segment);
+                ++motionData->Curves[curveIndex].SegmentCount;
+            }
+
+            for (csmInt32 i = 0; i < valueCount; i += 2)
+            {
+                CubismMotionPoint point;
+                point.Time = values[i];
+                point.Value = values[i + 1];
+                points.PushBack(point);
+            }
+
+            isFirstPoint = false;
+            segmentType = -1;
+            valueCount = 0;
+        }
+
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == ',')
+        {
+            _position++;
+            continue;
+        }
+        break;
+    }
+
+    if (valueCount != 0 || segmentType >= 0)
+    {
+        _error = "incomplete segment";
+        return false;
+    }
+
+    return Expect(']');
+}
+
+csmBool CubismMotionJsonReader::ReadUserData(CubismMotionData* motionData)
+{
+    if (!Expect('['))
+    {
+        return false;
+    }
+
+    SkipWhitespace();
+    if (_position < _length && _buffer[_position] == ']')
+    {
+        _position++;
+        return true;
+    }
+
+    for (;;)
+    {
+        if (!Expect('{'))
+        {
+            return false;
+        }
+
+        const csmInt32 eventIndex = static_cast<csmInt32>(motionData->Events.GetSize());
+        motionData->Events.PushBack(CubismMotionEvent());
+
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == '}')
+        {
+            _position++;
+        }
+        else
+        {
+            for (;;)
+            {
+                const csmChar* key;
+                csmInt32 keyLength;
+                if (!ReadKey(&key, &keyLength))
+                {
+                    return false;
+                }
+
+                csmBool ok;
+                if (KeyEquals(key, keyLength, Time))
+                {
+                    ok = ReadNumber(&motionData->Events[eventIndex].FireTime);
+                }
+                else if (KeyEquals(key, keyLength, Value))
+                {
+                    ok = ReadString(motionData->Events[eventIndex].Value);
+                }
+                else
+                {
+                    ok = SkipValue();
+                }
+
+                if (!ok)
+                {
+                    return false;
+                }
+
+                SkipWhitespace();
+                if (_position < _length && _buffer[_position] == ',')
+                {
+                    _position++;
+                    continue;
+                }
+                if (!Expect('}'))
+                {
+                    return false;
+                }
+                break;
+            }
+        }
+
+        SkipWhitespace();
+        if (_position < _length && _buffer[_position] == ',')
+        {
+            _position++;
+            continue;
+        }
+        return Expect(']');
+    }
+}
+
+}}}
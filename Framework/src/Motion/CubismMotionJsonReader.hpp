@@ -0,0 +1,110 @@
+/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include "CubismFramework.hpp"
+#include "Type/csmString.hpp"
+
+namespace Live2D { namespace Cubism { namespace Framework {
+
+struct CubismMotionData;
+
+/**
+ * Single-pass reader for motion3.json files.
+ *
+ * Unlike CubismMotionJson, no intermediate JSON tree is built: curves, segments,
+ * points and user data events are written straight into CubismMotionData while
+ * the buffer is scanned. The vectors are sized from the counts found in the Meta
+ * block, and grow on demand if Meta is missing or comes after Curves.
+ */
+class CubismMotionJsonReader
+{
+public:
+    /**
+     * Constructor
+     *
+     * @param buffer buffer containing the loaded motion file
+     * @param size size of the buffer in bytes
+     */
+    CubismMotionJsonReader(const csmByte* buffer, csmSizeInt size);
+
+    /**
+     * Reads the whole file into motionData.
+     *
+     * Segment evaluation functions are not assigned here; the caller selects them
+     * from CubismMotionSegment::SegmentType.
+     *
+     * @param motionData destination; must be freshly constructed
+     *
+     * @return true if the file was read successfully; otherwise false.
+     */
+    csmBool Read(CubismMotionData* motionData);
+
+    /**
+     * Returns the error message of the last Read(), or NULL.
+     */
+    const csmChar* GetError() const { return _error; }
+
+    /**
+     * Checks whether Meta.AreBeziersRestricted was set.
+     */
+    csmBool IsBeziersRestricted() const { return _areBeziersRestricted; }
+
+    /**
+     * Checks whether Meta.FadeInTime was present.
+     */
+    csmBool IsExistMotionFadeInTime() const { return _hasFadeInTime; }
+
+    /**
+     * Checks whether Meta.FadeOutTime was present.
+     */
+    csmBool IsExistMotionFadeOutTime() const { return _hasFadeOutTime; }
+
+    /**
+     * Returns Meta.FadeInTime.
+     */
+    csmFloat32 GetMotionFadeInTime() const { return _fadeInTime; }
+
+    /**
+     * Returns Meta.FadeOutTime.
+     */
+    csmFloat32 GetMotionFadeOutTime() const { return _fadeOutTime; }
+
+private:
+    void SkipWhitespace();
+    csmBool Expect(csmChar c);
+    csmBool ReadKey(const csmChar** outKey, csmInt32* outLength);
+    csmBool ReadString(csmString& outValue);
+    csmBool ReadNumber(csmFloat32* outValue);
+    csmBool ReadBoolean(csmBool* outValue);
+    csmBool SkipValue();
+
+    csmBool ReadMeta(CubismMotionData* motionData);
+    csmBool ReadCurves(CubismMotionData* motionData);
+    csmBool ReadCurve(CubismMotionData* motionData);
+    csmBool ReadSegments(CubismMotionData* motionData, csmInt32 curveIndex);
+    csmBool ReadUserData(CubismMotionData* motionData);
+
+    const csmChar* _buffer;
+    csmInt32 _length;
+    csmInt32 _position;
+    const csmChar* _error;
+
+    csmBool _areBeziersRestricted;
+    csmBool _hasFadeInTime;
+    csmBool _hasFadeOutTime;
+    csmFloat32 _fadeInTime;
+    csmFloat32 _fadeOutTime;
+
+    csmInt32 _metaCurveCount;
+    csmInt32 _metaSegmentCount;
+    csmInt32 _metaPointCount;
+    csmInt32 _metaEventCount;
+};
+
+}}}
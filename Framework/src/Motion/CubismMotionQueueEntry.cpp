@@ -37,6 +37,30 @@ CubismMotionQueueEntry::~CubismMotionQueueEntry()
     }
 }
 
+void CubismMotionQueueEntry::Reset()
+{
+    if (_autoDelete && _motion)
+    {
+        ACubismMotion::Delete(_motion);
+    }
+
+    _autoDelete = false;
+    _motion = NULL;
+    _available = true;
+    _finished = false;
+    _started = false;
+    _startTimeSeconds = -1.0f;
+    _fadeInStartTimeSeconds = 0.0f;
+    _endTimeSeconds = -1.0f;
+    _stateTimeSeconds = 0.0f;
+    _stateWeight = 0.0f;
+    _lastEventCheckSeconds = 0.0f;
+    _motionQueueEntryHandle = InvalidMotionQueueEntryHandleValue;
+    _fadeOutSeconds = 0.0f;
+    _IsTriggeredFadeOut = false;
+    _parameterIndices.UpdateSize(0);
+}
+
 void CubismMotionQueueEntry::SetFadeout(csmFloat32 fadeOutSeconds)
 {
     _fadeOutSeconds = fadeOutSeconds;
@@ -156,4 +180,9 @@ ACubismMotion* CubismMotionQueueEntry::GetCubismMotion()
     return _motion;
 }
 
+csmVector<csmInt32>& CubismMotionQueueEntry::GetParameterIndices()
+{
+    return _parameterIndices;
+}
+
 }}}
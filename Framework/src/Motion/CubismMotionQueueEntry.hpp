@@ -186,7 +186,24 @@ public:
 
     ACubismMotion* GetCubismMotion();
 
+    /**
+     * Returns the parameter indices resolved by the motion for the model this entry plays on.
+     *
+     * Empty until the motion fills it on first use; kept until the entry is returned to
+     * the CubismMotionQueueManager so that the per-frame update does not look up parameter IDs again.
+     *
+     * @return parameter indices, in the order defined by the motion
+     */
+    csmVector<csmInt32>& GetParameterIndices();
+
 private:
+    /**
+     * Returns the entry to its initial state so that the CubismMotionQueueManager can reuse it.
+     *
+     * Deletes the motion if it was started with autoDelete. Buffers keep their capacity.
+     */
+    void        Reset();
+
     csmBool         _autoDelete;
     ACubismMotion*  _motion;
 
@@ -203,6 +220,8 @@ private:
     csmBool         _IsTriggeredFadeOut;
 
     CubismMotionQueueEntryHandle  _motionQueueEntryHandle;
+
+    csmVector<csmInt32> _parameterIndices;
 };
 
 }}}
@@ -14,6 +14,25 @@ namespace Live2D { namespace Cubism { namespace Framework {
 
 const CubismMotionQueueEntryHandle InvalidMotionQueueEntryHandleValue = reinterpret_cast<CubismMotionQueueEntryHandle*>(-1);
 
+namespace {
+
+// ハンドルの下位半分にプールのスロット番号、上位半分にスロットの世代を格納する
+const csmUint32 HandleIndexBits = sizeof(CubismMotionQueueEntryHandle) * 4;
+const csmSizeType HandleIndexMask = (static_cast<csmSizeType>(1) << HandleIndexBits) - 1;
+const csmUint32 HandleGenerationMask = static_cast<csmUint32>(HandleIndexMask);
+
+CubismMotionQueueEntryHandle MakeHandle(csmSizeType slot, csmUint32 generation)
+{
+    return reinterpret_cast<CubismMotionQueueEntryHandle>((static_cast<csmSizeType>(generation) << HandleIndexBits) | slot);
+}
+
+csmSizeType GetHandleSlot(CubismMotionQueueEntryHandle handle)
+{
+    return reinterpret_cast<csmSizeType>(handle) & HandleIndexMask;
+}
+
+}
+
 CubismMotionQueueManager::CubismMotionQueueManager()
     : _userTimeSeconds(0.0f)
     , _eventCallback(NULL)
@@ -22,13 +41,67 @@ CubismMotionQueueManager::CubismMotionQueueManager()
 
 CubismMotionQueueManager::~CubismMotionQueueManager()
 {
-    for (csmUint32 i = 0; i < _motions.GetSize(); ++i)
+    // 再生中のエントリもプールに含まれる
+    for (csmUint32 i = 0; i < _entryPool.GetSize(); ++i)
+    {
+        CSM_DELETE(_entryPool[i]);
+    }
+}
+
+CubismMotionQueueEntry* CubismMotionQueueManager::AcquireMotionQueueEntry()
+{
+    csmInt32 slot;
+
+    if (_freeEntries.GetSize() > 0)
+    {
+        slot = _freeEntries[_freeEntries.GetSize() - 1];
+        _freeEntries.UpdateSize(_freeEntries.GetSize() - 1);
+    }
+    else
     {
-        if (_motions[i])
+        // 全ビットが立ったスロット番号は InvalidMotionQueueEntryHandleValue と重なるため使わない
+        if (_entryPool.GetSize() >= HandleIndexMask)
         {
-            CSM_DELETE(_motions[i]);
+            return NULL;
         }
+
+        slot = _entryPool.GetSize();
+        _entryPool.PushBack(CSM_NEW CubismMotionQueueEntry(), false);
+        _entryGenerations.PushBack(0, false);
+
+        // 空きリストはプール全体を収められるように確保しておき、エントリの返却では確保しない
+        _freeEntries.PrepareCapacity(_entryPool.GetSize());
+    }
+
+    // 世代は 1 から始まるので、ハンドルが NULL になることはない
+    csmUint32 generation = (_entryGenerations[slot] + 1) & HandleGenerationMask;
+    if (generation == 0)
+    {
+        generation = 1;
     }
+    _entryGenerations[slot] = generation;
+
+    CubismMotionQueueEntry* motionQueueEntry = _entryPool[slot];
+    motionQueueEntry->_motionQueueEntryHandle = MakeHandle(slot, generation);
+
+    return motionQueueEntry;
+}
+
+void CubismMotionQueueManager::ReleaseMotionQueueEntry(CubismMotionQueueEntry* motionQueueEntry)
+{
+    if (motionQueueEntry == NULL || motionQueueEntry->_motionQueueEntryHandle == InvalidMotionQueueEntryHandleValue)
+    {
+        return;
+    }
+
+    const csmSizeType slot = GetHandleSlot(motionQueueEntry->_motionQueueEntryHandle);
+    if (slot >= _entryPool.GetSize() || _entryPool[static_cast<csmInt32>(slot)] != motionQueueEntry)
+    {
+        return;
+    }
+
+    motionQueueEntry->Reset();
+    _freeEntries.PushBack(static_cast<csmInt32>(slot), false);
 }
 
 CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion* motion, csmBool autoDelete)
@@ -52,7 +125,17 @@ CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion
         motionQueueEntry->SetFadeout(motionQueueEntry->_motion->GetFadeOutTime());
     }
 
-    motionQueueEntry = CSM_NEW CubismMotionQueueEntry(); // 終了時に破棄する
+    motionQueueEntry = AcquireMotionQueueEntry(); // 終了時にプールへ戻す
+    if (motionQueueEntry == NULL)
+    {
+        if (autoDelete)
+        {
+            ACubismMotion::Delete(motion);
+        }
+
+        return InvalidMotionQueueEntryHandleValue;
+    }
+
     motionQueueEntry->_autoDelete = autoDelete;
     motionQueueEntry->_motion = motion;
 
@@ -86,7 +169,17 @@ CubismMotionQueueEntryHandle CubismMotionQueueManager::StartMotion(ACubismMotion
         motionQueueEntry->SetFadeout(motionQueueEntry->_motion->GetFadeOutTime());
     }
 
-    motionQueueEntry = CSM_NEW CubismMotionQueueEntry(); // 終了時に破棄する
+    motionQueueEntry = AcquireMotionQueueEntry(); // 終了時にプールへ戻す
+    if (motionQueueEntry == NULL)
+    {
+        if (autoDelete)
+        {
+            ACubismMotion::Delete(motion);
+        }
+
+        return InvalidMotionQueueEntryHandleValue;
+    }
+
     motionQueueEntry->_autoDelete = autoDelete;
     motionQueueEntry->_motion = motion;
 
@@ -116,7 +209,7 @@ csmBool CubismMotionQueueManager::DoUpdateMotion(CubismModel* model, csmFloat32
 
         if (motion == NULL)
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = _motions.Erase(ite);          // 削除
 
             continue;
@@ -142,7 +235,7 @@ csmBool CubismMotionQueueManager::DoUpdateMotion(CubismModel* model, csmFloat32
         // ----- 終了済みの処理があれば削除する ------
         if (motionQueueEntry->IsFinished())
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = _motions.Erase(ite);          // 削除
         }
         else
@@ -166,25 +259,25 @@ csmVector<CubismMotionQueueEntry*>* CubismMotionQueueManager::GetCubismMotionQue
 
 CubismMotionQueueEntry* CubismMotionQueueManager::GetCubismMotionQueueEntry(CubismMotionQueueEntryHandle motionQueueEntryNumber)
 {
-    //------- 処理を行う --------
-    //既にモーションがあれば終了フラグを立てる
-
-    for (csmVector<CubismMotionQueueEntry*>::iterator ite = _motions.Begin(); ite != _motions.End(); ++ite)
+    if (motionQueueEntryNumber == NULL || motionQueueEntryNumber == InvalidMotionQueueEntryHandleValue)
     {
-        CubismMotionQueueEntry* motionQueueEntry = *ite;
+        return NULL;
+    }
 
-        if (motionQueueEntry == NULL)
-        {
-            continue;
-        }
+    const csmSizeType slot = GetHandleSlot(motionQueueEntryNumber);
+    if (slot >= _entryPool.GetSize())
+    {
+        return NULL;
+    }
 
-        if (motionQueueEntry->_motionQueueEntryHandle == motionQueueEntryNumber)
-        {
-            return motionQueueEntry;
-        }
+    // スロットが再利用されていれば世代が一致しない
+    CubismMotionQueueEntry* motionQueueEntry = _entryPool[static_cast<csmInt32>(slot)];
+    if (motionQueueEntry->_motionQueueEntryHandle != motionQueueEntryNumber)
+    {
+        return NULL;
     }
 
-    return NULL;
+    return motionQueueEntry;
 }
 
 csmBool CubismMotionQueueManager::IsFinished()
@@ -206,7 +299,7 @@ csmBool CubismMotionQueueManager::IsFinished()
 
         if (motion == NULL)
         {
-            CSM_DELETE(motionQueueEntry);
+            ReleaseMotionQueueEntry(motionQueueEntry);
             ite = _motions.Erase(ite);          // 削除
             continue;
         }
@@ -227,24 +320,9 @@ csmBool CubismMotionQueueManager::IsFinished()
 
 csmBool CubismMotionQueueManager::IsFinished(CubismMotionQueueEntryHandle motionQueueEntryNumber)
 {
-    // 既にモーションがあれば終了フラグを立てる
+    const CubismMotionQueueEntry* motionQueueEntry = GetCubismMotionQueueEntry(motionQueueEntryNumber);
 
-    for (csmVector<CubismMotionQueueEntry*>::iterator ite = _motions.Begin(); ite != _motions.End(); ite++)
-    {
-        CubismMotionQueueEntry* motionQueueEntry = *ite;
-
-        if (motionQueueEntry == NULL)
-        {
-            continue;
-        }
-
-        if (motionQueueEntry->_motionQueueEntryHandle == motionQueueEntryNumber && !motionQueueEntry->IsFinished())
-        {
-            return false;
-        }
-    }
-
-    return true;
+    return motionQueueEntry == NULL || motionQueueEntry->IsFinished();
 }
 
 void CubismMotionQueueManager::StopAllMotions()
@@ -264,7 +342,7 @@ void CubismMotionQueueManager::StopAllMotions()
         }
 
         // ----- 終了済みの処理があれば削除する ------
-        CSM_DELETE(motionQueueEntry);
+        ReleaseMotionQueueEntry(motionQueueEntry);
         ite = _motions.Erase(ite); //削除
     }
 }
@@ -26,6 +26,11 @@ extern const CubismMotionQueueEntryHandle InvalidMotionQueueEntryHandleValue;
  * Handles the management of motion playback.<br>
  * Used for playing subclasses of ACubismMotion such as CubismMotion.
  *
+ * Queue entries are kept in a pool and reused, so starting a motion does not allocate once
+ * the pool has grown to the number of motions playing at the same time.<br>
+ * A handle encodes the pool slot and the slot's generation: looking it up is O(1), and a
+ * handle kept after its motion ended no longer matches once the slot is reused.
+ *
  * @note If a different motion is started with StartMotion() during playback,
  *       it transitions smoothly to the new motion, interrupting the old one.<br>
  *       When different motions such as facial expressions and body motions are played together,<br>
@@ -103,13 +108,16 @@ public:
      *
      * @param motionQueueEntryNumber identifier of the motion to retrieve
      *
-     * @return reference to the CubismMotionQueueEntry
+     * @return reference to the CubismMotionQueueEntry<br>
+     *         NULL if the handle is invalid or its motion has already ended.
      */
     CubismMotionQueueEntry* GetCubismMotionQueueEntry(CubismMotionQueueEntryHandle motionQueueEntryNumber);
 
     /**
      * Returns a pointer to the array of CubismMotionQueueEntry.
      *
+     * The entries belong to the pool of this manager; remove them with ReleaseMotionQueueEntry(), not CSM_DELETE.
+     *
      * @return pointer to the array of CubismMotionQueueEntry
      */
     csmVector<CubismMotionQueueEntry*>* GetCubismMotionQueueEntries();
@@ -125,11 +133,30 @@ public:
 protected:
     virtual csmBool     DoUpdateMotion(CubismModel* model, csmFloat32 userTimeSeconds);
 
+    /**
+     * Returns an entry to the pool and invalidates its handle.
+     *
+     * The caller must also remove the entry from the array returned by GetCubismMotionQueueEntries().
+     *
+     * @param motionQueueEntry entry to release
+     */
+    void        ReleaseMotionQueueEntry(CubismMotionQueueEntry* motionQueueEntry);
+
 
     csmFloat32 _userTimeSeconds;
 
 private:
+    /**
+     * Takes an entry from the pool, or creates one if all are in use, and assigns it a new handle.
+     *
+     * @return entry; NULL if the handle space is exhausted
+     */
+    CubismMotionQueueEntry* AcquireMotionQueueEntry();
+
     csmVector<CubismMotionQueueEntry*>      _motions;
+    csmVector<CubismMotionQueueEntry*>      _entryPool;         ///< All entries created by this manager, indexed by slot
+    csmVector<csmUint32>                    _entryGenerations;  ///< Generation of each slot, advanced every time the slot is reused
+    csmVector<csmInt32>                     _freeEntries;       ///< Slots whose entries are not playing
 
     CubismMotionEventFunction         _eventCallback;
     void*                             _eventCustomData;
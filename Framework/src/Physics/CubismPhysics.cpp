@@ -535,6 +535,20 @@ void CubismPhysics::Delete(CubismPhysics* physics)
     CSM_DELETE_SELF(CubismPhysics, physics);
 }
 
+CubismPhysics* CubismPhysics::Clone() const
+{
+    CubismPhysics* ret = CSM_NEW CubismPhysics();
+
+    ret->_physicsRig = CSM_NEW CubismPhysicsRig(*_physicsRig);
+    ret->_options = _options;
+    ret->_currentRigOutputs = _currentRigOutputs;
+    ret->_previousRigOutputs = _previousRigOutputs;
+    ret->_currentRemainTime = _currentRemainTime;
+    ret->_isJsonValid = _isJsonValid;
+
+    return ret;
+}
+
 void CubismPhysics::Parse(const csmByte* physicsJson, csmSizeInt size)
 {
     _physicsRig = CSM_NEW CubismPhysicsRig;
@@ -64,6 +64,16 @@ public:
      */
     static void Delete(CubismPhysics* physics);
 
+    /**
+     * @brief インスタンスの複製
+     *
+     * リグ、オプション、物理点の状態をすべてコピーした独立したインスタンスを作成する。
+     * 同じ physics3.json を使う複数のモデルで、解析結果を使い回すために使う。
+     *
+     * @return  作成されたインスタンス
+     */
+    CubismPhysics* Clone() const;
+
     /**
      * @brief パラメータのリセット
      *
@@ -128,6 +128,10 @@ void CubismOffscreenSurface_OpenGLES2::DestroyOffscreenSurface()
         glDeleteFramebuffers(1, &_renderTexture);
         _renderTexture = 0;
     }
+
+    // サイズも戻し、サイズを比べて作り直す側（CubismRenderer_OpenGLES2::DoDrawModel）に再生成させる
+    _bufferWidth = 0;
+    _bufferHeight = 0;
 }
 
 GLuint CubismOffscreenSurface_OpenGLES2::GetRenderTexture() const
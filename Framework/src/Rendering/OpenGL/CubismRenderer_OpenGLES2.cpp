@@ -50,6 +50,7 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
     {
         return;
     }
+    renderer->_drawStats.masks += usingClipCount;
 
     // マスク作成処理
     // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
@@ -59,6 +60,7 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
     _currentMaskBuffer = renderer->GetMaskBuffer(0);
     // ----- マスク描画処理 -----
     _currentMaskBuffer->BeginDraw(lastFBO);
+    renderer->_drawStats.targetSwitches++;
 
     renderer->PreDraw(); // バッファをクリアする
 
@@ -104,6 +106,7 @@ void CubismClippingManager_OpenGLES2::SetupClippingContext(CubismModel& model, C
             _currentMaskBuffer = clipContextOffscreenSurface;
             // マスク用RenderTextureをactiveにセット
             _currentMaskBuffer->BeginDraw(lastFBO);
+            renderer->_drawStats.targetSwitches++;
 
             // バッファをクリアする。
             renderer->PreDraw();
@@ -432,7 +435,11 @@ void CubismRenderer::StaticRelease()
 CubismRenderer_OpenGLES2::CubismRenderer_OpenGLES2() : _clippingManager(NULL)
                                                      , _clippingContextBufferForMask(NULL)
                                                      , _clippingContextBufferForDraw(NULL)
+                                                     , _maskHook(NULL)
+                                                     , _maskHookContext(NULL)
 {
+    _drawStats = DrawStats();
+
     // テクスチャ対応マップの容量を確保しておく.
     _textures.PrepareCapacity(32, true);
 }
@@ -532,6 +539,8 @@ void CubismRenderer_OpenGLES2::PreDraw()
 
 void CubismRenderer_OpenGLES2::DoDrawModel()
 {
+    _drawStats = DrawStats();
+
     //------------ クリッピングマスク・バッファ前処理方式の場合 ------------
     if (_clippingManager != NULL)
     {
@@ -554,7 +563,15 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
         }
         else
         {
+           if (_maskHook != NULL)
+           {
+               _maskHook(_maskHookContext, true);
+           }
            _clippingManager->SetupClippingContext(*GetModel(), this, _rendererProfile._lastFBO, _rendererProfile._lastViewport);
+           if (_maskHook != NULL)
+           {
+               _maskHook(_maskHookContext, false);
+           }
         }
     }
 
@@ -589,8 +606,16 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
 
         if (clipContext != NULL && IsUsingHighPrecisionMask()) // マスクを書く必要がある
         {
+            if (_maskHook != NULL)
+            {
+                _maskHook(_maskHookContext, true);
+            }
+
             if(clipContext->_isUsing) // 書くことになっていた
             {
+                _drawStats.masks++;
+                _drawStats.targetSwitches++;
+
                 // 生成したOffscreenSurfaceと同じサイズでビューポートを設定
                 glViewport(0, 0, _clippingManager->GetClippingMaskBufferSize().X, _clippingManager->GetClippingMaskBufferSize().Y);
 
@@ -636,6 +661,11 @@ void CubismRenderer_OpenGLES2::DoDrawModel()
 
                 PreDraw(); // バッファをクリアする
             }
+
+            if (_maskHook != NULL)
+            {
+                _maskHook(_maskHookContext, false);
+            }
         }
 
         // クリッピングマスクをセットする
@@ -687,6 +717,11 @@ void CubismRenderer_OpenGLES2::DrawMeshOpenGL(const CubismModel& model, const cs
         csmUint16* indexArray = const_cast<csmUint16*>(model.GetDrawableVertexIndices(index));
         glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, indexArray);
     }
+    _drawStats.drawCalls++;
+    if (IsGeneratingMask())
+    {
+        _drawStats.maskDrawCalls++;
+    }
 
     // 後処理
     glUseProgram(0);
@@ -752,6 +787,22 @@ CubismOffscreenSurface_OpenGLES2* CubismRenderer_OpenGLES2::GetMaskBuffer(csmInt
     return &_offscreenSurfaces[index];
 }
 
+csmInt32 CubismRenderer_OpenGLES2::GetMaskBufferCount() const
+{
+    return static_cast<csmInt32>(_offscreenSurfaces.GetSize());
+}
+
+const CubismRenderer_OpenGLES2::DrawStats& CubismRenderer_OpenGLES2::GetDrawStats() const
+{
+    return _drawStats;
+}
+
+void CubismRenderer_OpenGLES2::SetMaskHook(MaskHook hook, void* context)
+{
+    _maskHook = hook;
+    _maskHookContext = context;
+}
+
 void CubismRenderer_OpenGLES2::SetClippingContextBufferForMask(CubismClippingContext_OpenGLES2* clip)
 {
     _clippingContextBufferForMask = clip;
@@ -179,6 +179,24 @@ class CubismRenderer_OpenGLES2 : public CubismRenderer
     friend class CubismShader_OpenGLES2;
 
 public:
+    /**
+     * @brief  直前の DrawModel で発行した描画の統計
+     */
+    struct DrawStats
+    {
+        csmUint32 drawCalls;        ///< glDrawElements の回数（マスク生成を含む）
+        csmUint32 maskDrawCalls;    ///< そのうちマスク生成のための回数
+        csmUint32 masks;            ///< 生成したクリッピングマスクの数
+        csmUint32 targetSwitches;   ///< マスク用フレームバッファへの切り替え回数
+    };
+
+    /**
+     * @brief  マスク生成の前後に呼ばれるフック
+     *
+     * @param[in]  begin -> 生成の開始時は true、終了時は false
+     */
+    typedef void (*MaskHook)(void* context, csmBool begin);
+
     /**
      * @brief    レンダラの初期化処理を実行する<br>
      *           引数に渡したモデルからレンダラの初期化処理に必要な情報を取り出すことができる
@@ -239,6 +257,24 @@ public:
      */
     CubismOffscreenSurface_OpenGLES2* GetMaskBuffer(csmInt32 index);
 
+    /**
+     * @brief  作成済みのクリッピングマスクのバッファの数を取得する
+     *
+     * @return マスクを使わないモデル、または初回描画前は0
+     *
+     */
+    csmInt32 GetMaskBufferCount() const;
+
+    /**
+     * @brief  直前の DrawModel の描画統計を取得する
+     */
+    const DrawStats& GetDrawStats() const;
+
+    /**
+     * @brief  マスク生成の前後に呼ばれるフックを設定する。NULL で解除
+     */
+    void SetMaskHook(MaskHook hook, void* context);
+
 protected:
     /**
      * @brief   コンストラクタ
@@ -378,6 +414,10 @@ private:
     CubismClippingContext_OpenGLES2* _clippingContextBufferForDraw;  ///< 画面上描画するためのクリッピングコンテキスト
 
     csmVector<CubismOffscreenSurface_OpenGLES2>   _offscreenSurfaces;          ///< マスク描画用のフレームバッファ
+
+    DrawStats _drawStats;                                            ///< 直前の DrawModel の描画統計
+    MaskHook _maskHook;                                              ///< マスク生成の前後に呼ぶフック
+    void* _maskHookContext;
 };
 
 }}}}
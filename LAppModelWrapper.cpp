@@ -2,14 +2,32 @@
 
 #include <LAppModel.hpp>
 #include <CubismFramework.hpp>
+#include <Motion/CubismMotionInternal.hpp>
+#include <Motion/CubismMotionJson.hpp>
+#include <Motion/CubismMotionJsonReader.hpp>
 #include <LAppPal.hpp>
 #include <LAppAllocator.hpp>
+#include <LAppAssetCache.hpp>
+#include <LAppCrowdRenderer.hpp>
+#include <LAppV2Kernels.hpp>
+#include <LAppV2MocReader.hpp>
+#include <LAppWorkerPool.hpp>
 #include <Log.hpp>
+#include <algorithm>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 #include <mutex>
 #include <chrono>
 
+// 缓冲区协议自 3.11 起属于受限 API，数组视图只在此后的版本中提供
+#include <patchlevel.h>
+#if PY_VERSION_HEX >= 0x030B0000
+#define Py_LIMITED_API 0x030B0000
+#define LIVE2D_ARRAY_VIEW
+#else
 #define Py_LIMITED_API
+#endif
 #include <Python.h>
 
 #ifdef WIN32
@@ -23,6 +41,15 @@
 static LAppAllocator _cubismAllocator;
 static Csm::CubismFramework::Option _cubismOption;
 
+// updateAll 的工作线程与流水线的模拟线程不持有 GIL，动作回调先记下，之后在持有 GIL 的线程上按顺序执行
+struct DeferredMotionCallback
+{
+    PyObject* callee;
+    std::string group;
+    int no;
+    bool started;
+};
+
 struct PyLAppModelObject
 {
     PyObject_HEAD
@@ -30,8 +57,60 @@ struct PyLAppModelObject
     std::string lastExpression;
     time_t expStartedAt;
     time_t fadeout;
+    std::vector<DeferredMotionCallback> pipelineCallbacks; // 流水线模式下模拟线程记下的回调
+    Py_ssize_t viewExports; // 数组视图导出且尚未释放的缓冲区数
+    Py_ssize_t writableViewExports; // 其中可写的个数，存在时 updateAll 算出的绘制数据可能在 Draw 之前被改写
 };
 
+static thread_local std::vector<DeferredMotionCallback>* t_deferredCallbacks = nullptr;
+
+static void RunDeferredCallbacks(std::vector<DeferredMotionCallback>& callbacks)
+{
+    for (size_t i = 0; i < callbacks.size(); i++)
+    {
+        DeferredMotionCallback& callback = callbacks[i];
+        PyObject* result = callback.started
+                               ? PyObject_CallFunction(callback.callee, "si", callback.group.c_str(), callback.no)
+                               : PyObject_CallFunction(callback.callee, nullptr);
+        if (result != nullptr)
+            Py_DECREF(result);
+        else
+            PyErr_WriteUnraisable(callback.callee);
+        Py_DECREF(callback.callee);
+    }
+    callbacks.clear();
+}
+
+static void PipelineHook(void* context, Csm::csmBool enter)
+{
+    PyLAppModelObject* self = static_cast<PyLAppModelObject*>(context);
+    t_deferredCallbacks = enter ? &self->pipelineCallbacks : nullptr;
+}
+
+// 流水线模式下模拟线程可能正在更新模型，访问模型前先等这一步完成，再执行其间记下的回调
+static void SyncPipeline(PyLAppModelObject* self)
+{
+    if (!self->model->IsPipelineEnabled())
+    {
+        return;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    self->model->WaitPipeline();
+    Py_END_ALLOW_THREADS
+
+    // 回调中可能再次访问模型
+    std::vector<DeferredMotionCallback> callbacks;
+    callbacks.swap(self->pipelineCallbacks);
+    RunDeferredCallbacks(callbacks);
+}
+
+// 表情的 fadeout 按模型时间计时，Update(dt) 驱动时同样可复现
+static time_t ModelTimeMillis(PyLAppModelObject* self)
+{
+    return static_cast<time_t>(self->model->GetElapsedSeconds() * 1000.0);
+}
+
 // LAppModel()
 static int PyLAppModel_init(PyLAppModelObject* self, PyObject* args, PyObject* kwds)
 {
@@ -39,6 +118,9 @@ static int PyLAppModel_init(PyLAppModelObject* self, PyObject* args, PyObject* k
     // 结构体绕过了构造函数，
     // 其底层char数组指针可能未指向可用空间，导致访问出错
     new (&self->lastExpression) std::string(""); 
+    new (&self->pipelineCallbacks) std::vector<DeferredMotionCallback>();
+    self->viewExports = 0;
+    self->writableViewExports = 0;
     self->expStartedAt = -1;
     self->fadeout = -1;
     Info("[M] allocate cpp LAppModel(at=%p)", self->model);
@@ -50,20 +132,38 @@ static void PyLAppModel_dealloc(PyLAppModelObject* self)
     Info("[M] deallocate: cpp LAppModel(at=%p)", self->model);
     self->lastExpression.~basic_string();
     delete self->model;
+    // 模拟线程已结束，未执行的回调只释放引用
+    for (size_t i = 0; i < self->pipelineCallbacks.size(); i++)
+    {
+        Py_DECREF(self->pipelineCallbacks[i].callee);
+    }
+    self->pipelineCallbacks.~vector();
     Info("[M] deallocate: PyLAppModelObject(at=%p)", self);
     PyObject_Free(self);
 }
 
 // LAppModel->LoadAssets
-static PyObject* PyLAppModel_LoadModelJson(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_LoadModelJson(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    SyncPipeline(self);
+
     const char* fileName;
-    if (!PyArg_ParseTuple(args, "s", &fileName))
+    int preloadMotions = 1;
+
+    static char* kwlist[] = {(char*)"fileName", (char*)"preloadMotions", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|p", kwlist, &fileName, &preloadMotions))
+    {
+        return NULL;
+    }
+
+    // 与 bytearray 改变大小时相同，重新加载会释放视图指向的内存
+    if (self->viewExports > 0)
     {
+        PyErr_SetString(PyExc_BufferError, "cannot reload the model while array views are exported");
         return NULL;
     }
 
-    self->model->LoadModelJson(fileName);
+    self->model->LoadModelJson(fileName, preloadMotions != 0);
 
     Py_RETURN_NONE;
 }
@@ -96,6 +196,11 @@ void OnMotionStartedCallback(ACubismMotion* motion)
     {
         return;
     }
+    if (t_deferredCallbacks != nullptr)
+    {
+        t_deferredCallbacks->push_back({(PyObject*)motion->onStartedCallee, motion->group, motion->no, true});
+        return;
+    }
     PyGILState_STATE state = PyGILState_Ensure();
     PyObject* s_call = (PyObject*)motion->onStartedCallee;
     PyObject* result = PyObject_CallFunction(s_call, "si", motion->group.c_str(), motion->no);
@@ -111,6 +216,11 @@ void OnMotionFinishedCallback(ACubismMotion* motion)
     {
         return;
     }
+    if (t_deferredCallbacks != nullptr)
+    {
+        t_deferredCallbacks->push_back({(PyObject*)motion->onFinishedCallee, std::string(), 0, false});
+        return;
+    }
     PyGILState_STATE state = PyGILState_Ensure();
     PyObject* f_call = (PyObject*)motion->onFinishedCallee;
     PyObject* result = PyObject_CallFunction(f_call, nullptr);
@@ -141,8 +251,16 @@ static PyObject* MakeCallee(PyObject* callback)
     return callback;
 }
 
+// 动作句柄以整数交给 Python，InvalidMotionQueueEntryHandleValue 对应 -1
+static PyObject* MotionHandleToPy(Csm::CubismMotionQueueEntryHandle handle)
+{
+    return PyLong_FromSsize_t(reinterpret_cast<Py_ssize_t>(handle));
+}
+
 static PyObject* PyLAppModel_StartMotion(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    SyncPipeline(self);
+
     const char* group;
     int no, priority;
     PyObject* onStartHandler = nullptr;
@@ -159,17 +277,19 @@ static PyObject* PyLAppModel_StartMotion(PyLAppModelObject* self, PyObject* args
     }
 
 
-    Csm::CubismMotionQueueEntryHandle _ = self->model->StartMotion(group, no, priority,
-                                                                   MakeCallee(onStartHandler),
-                                                                   OnMotionStartedCallback,
-                                                                   MakeCallee(onFinishHandler),
-                                                                   OnMotionFinishedCallback);
+    Csm::CubismMotionQueueEntryHandle handle = self->model->StartMotion(group, no, priority,
+                                                                        MakeCallee(onStartHandler),
+                                                                        OnMotionStartedCallback,
+                                                                        MakeCallee(onFinishHandler),
+                                                                        OnMotionFinishedCallback);
 
-    Py_RETURN_NONE;
+    return MotionHandleToPy(handle);
 }
 
 static PyObject* PyLAppModel_StartRandomMotion(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    SyncPipeline(self);
+
     const char* group = nullptr;
     int priority = 3;
 
@@ -185,17 +305,261 @@ static PyObject* PyLAppModel_StartRandomMotion(PyLAppModelObject* self, PyObject
         return NULL;
     }
 
-    self->model->StartRandomMotion(group, priority,
-                                   MakeCallee(onStartHandler),
-                                   OnMotionStartedCallback,
-                                   MakeCallee(onFinishHandler),
-                                   OnMotionFinishedCallback);
+    Csm::CubismMotionQueueEntryHandle handle = self->model->StartRandomMotion(group, priority,
+                                                                              MakeCallee(onStartHandler),
+                                                                              OnMotionStartedCallback,
+                                                                              MakeCallee(onFinishHandler),
+                                                                              OnMotionFinishedCallback);
+
+    return MotionHandleToPy(handle);
+}
+
+static PyObject* PyLAppModel_PrefetchMotion(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* group;
+    int no;
+    if (!PyArg_ParseTuple(args, "si", &group, &no))
+    {
+        return NULL;
+    }
+
+    self->model->PrefetchMotion(group, no);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_PrefetchGroup(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* group;
+    if (!PyArg_ParseTuple(args, "s", &group))
+    {
+        return NULL;
+    }
+
+    self->model->PrefetchGroup(group);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetMotionBakeRate(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* group;
+    float rate;
+    if (!PyArg_ParseTuple(args, "sf", &group, &rate))
+    {
+        return NULL;
+    }
+
+    self->model->SetMotionBakeRate(group, rate);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetMotionBakeError(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* group;
+    int no;
+    if (!PyArg_ParseTuple(args, "si", &group, &no))
+    {
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(self->model->GetMotionBakeError(group, no));
+}
+
+static PyObject* PyLAppModel_AddMotionLayer(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    const char* name;
+    int additive = 0;
+    float weight = 1.0f;
+
+    static char* kwlist[] = {(char*)"name", (char*)"additive", (char*)"weight", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|pf", kwlist, &name, &additive, &weight))
+    {
+        return NULL;
+    }
+
+    self->model->AddMotionLayer(name, additive != 0, weight);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_RemoveMotionLayer(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name))
+    {
+        return NULL;
+    }
+
+    self->model->RemoveMotionLayer(name);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetMotionLayerWeight(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* name;
+    float weight;
+    if (!PyArg_ParseTuple(args, "sf", &name, &weight))
+    {
+        return NULL;
+    }
+
+    if (!self->model->SetMotionLayerWeight(name, weight))
+    {
+        PyErr_Format(PyExc_KeyError, "motion layer '%s' not found", name);
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetMotionLayerMask(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* name;
+    PyObject* paramIds = Py_None;
+    if (!PyArg_ParseTuple(args, "s|O", &name, &paramIds))
+    {
+        return NULL;
+    }
+
+    // 先把 id 转成 UTF-8 字节串并持有，直到掩码设置完成
+    std::vector<PyObject*> bytes;
+    std::vector<const char*> ids;
+    bool failed = false;
+    if (!Py_IsNone(paramIds))
+    {
+        const Py_ssize_t count = PySequence_Size(paramIds);
+        if (count < 0)
+        {
+            return NULL;
+        }
+
+        for (Py_ssize_t i = 0; i < count && !failed; i++)
+        {
+            PyObject* item = PySequence_GetItem(paramIds, i);
+            PyObject* utf8 = item != NULL ? PyUnicode_AsUTF8String(item) : NULL;
+            Py_XDECREF(item);
+            if (utf8 == NULL)
+            {
+                failed = true;
+                break;
+            }
+            bytes.push_back(utf8);
+            ids.push_back(PyBytes_AsString(utf8));
+        }
+    }
+
+    bool found = true;
+    if (!failed)
+    {
+        found = self->model->SetMotionLayerMask(name, ids.data(), static_cast<int>(ids.size()));
+    }
+
+    for (PyObject* utf8 : bytes)
+    {
+        Py_DECREF(utf8);
+    }
+
+    if (failed)
+    {
+        return NULL;
+    }
+
+    if (!found)
+    {
+        PyErr_Format(PyExc_KeyError, "motion layer '%s' not found", name);
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_StartLayerMotion(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    const char* layer;
+    const char* group;
+    int no;
+    PyObject* onStartHandler = nullptr;
+    PyObject* onFinishHandler = nullptr;
+
+    static char* kwlist[] = {
+        (char*)"layer", (char*)"group", (char*)"no", (char*)"onStartMotionHandler", (char*)"onFinishMotionHandler",
+        NULL
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "ssi|OO", kwlist, &layer, &group, &no, &onStartHandler,
+                                     &onFinishHandler))
+    {
+        return NULL;
+    }
+
+    Csm::CubismMotionQueueEntryHandle handle = self->model->StartLayerMotion(layer, group, no,
+                                                                             MakeCallee(onStartHandler),
+                                                                             OnMotionStartedCallback,
+                                                                             MakeCallee(onFinishHandler),
+                                                                             OnMotionFinishedCallback);
+
+    return MotionHandleToPy(handle);
+}
+
+static PyObject* PyLAppModel_IsLayerMotionFinished(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* layer;
+    Py_ssize_t handle = -1;
+    if (!PyArg_ParseTuple(args, "s|n", &layer, &handle))
+    {
+        return NULL;
+    }
+
+    if (self->model->IsLayerMotionFinished(layer, reinterpret_cast<Csm::CubismMotionQueueEntryHandle>(handle)))
+    {
+        Py_RETURN_TRUE;
+    }
+
+    Py_RETURN_FALSE;
+}
+
+static PyObject* PyLAppModel_StopLayerMotions(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const char* layer;
+    if (!PyArg_ParseTuple(args, "s", &layer))
+    {
+        return NULL;
+    }
+
+    self->model->StopLayerMotions(layer);
 
     Py_RETURN_NONE;
 }
+
 #include <iostream>
 static PyObject* PyLAppModel_SetExpression(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    SyncPipeline(self);
+
     const char* expressionID;
     int fadeout = -1;
 
@@ -210,8 +574,7 @@ static PyObject* PyLAppModel_SetExpression(PyLAppModelObject* self, PyObject* ar
 
     if (fadeout >= 0)
     {
-        auto now = std::chrono::system_clock::now();
-        self->expStartedAt = std::chrono::time_point_cast<std::chrono::milliseconds>(now).time_since_epoch().count();
+        self->expStartedAt = ModelTimeMillis(self);
     }
     else
     {
@@ -227,6 +590,8 @@ static PyObject* PyLAppModel_SetExpression(PyLAppModelObject* self, PyObject* ar
 
 static PyObject* PyLAppModel_ResetExpression(PyLAppModelObject* self, PyObject* args)
 {
+    SyncPipeline(self);
+
     self->fadeout = -1;
     self->expStartedAt = -1;
     if (self->lastExpression != "")
@@ -240,6 +605,8 @@ static PyObject* PyLAppModel_ResetExpression(PyLAppModelObject* self, PyObject*
 
 static PyObject* PyLAppModel_SetRandomExpression(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
 {
+    SyncPipeline(self);
+
     int fadeout = -1;
     char* kwlist[] = {(char*)"fadeout", NULL};
 
@@ -256,8 +623,7 @@ static PyObject* PyLAppModel_SetRandomExpression(PyLAppModelObject* self, PyObje
 
     if (self->fadeout >= 0)
     {
-        auto now = std::chrono::system_clock::now();
-        self->expStartedAt = std::chrono::time_point_cast<std::chrono::milliseconds>(now).time_since_epoch().count();
+        self->expStartedAt = ModelTimeMillis(self);
     }
     else
     {
@@ -272,6 +638,8 @@ typedef Live2D::Cubism::Framework::csmString csmString;
 
 static PyObject* PyLAppModel_HitTest(PyLAppModelObject* self, PyObject* args)
 {
+    SyncPipeline(self);
+
     const char* hitAreaName;
     float x, y;
     if (!(PyArg_ParseTuple(args, "sff", &hitAreaName, &x, &y)))
@@ -289,6 +657,8 @@ static PyObject* PyLAppModel_HitTest(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_HasMocConsistencyFromFile(PyLAppModelObject* self, PyObject* args)
 {
+    SyncPipeline(self);
+
     const char* mocFileName;
     if (!(PyArg_ParseTuple(args, "s", &mocFileName)))
     {
@@ -305,6 +675,8 @@ static PyObject* PyLAppModel_HasMocConsistencyFromFile(PyLAppModelObject* self,
 
 static PyObject* PyLAppModel_Drag(PyLAppModelObject* self, PyObject* args)
 {
+    SyncPipeline(self);
+
     float mx, my;
     if (!(PyArg_ParseTuple(args, "ff", &mx, &my)))
     {
@@ -318,7 +690,31 @@ static PyObject* PyLAppModel_Drag(PyLAppModelObject* self, PyObject* args)
 
 static PyObject* PyLAppModel_IsMotionFinished(PyLAppModelObject* self, PyObject* args)
 {
-    if (self->model->IsMotionFinished())
+    SyncPipeline(self);
+
+    PyObject* handleObject = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &handleObject))
+    {
+        return NULL;
+    }
+
+    bool finished;
+    if (handleObject == Py_None)
+    {
+        finished = self->model->IsMotionFinished();
+    }
+    else
+    {
+        const Py_ssize_t handle = PyLong_AsSsize_t(handleObject);
+        if (handle == -1 && PyErr_Occurred())
+        {
+            return NULL;
+        }
+
+        finished = self->model->IsMotionFinished(reinterpret_cast<Csm::CubismMotionQueueEntryHandle>(handle));
+    }
+
+    if (finished)
     {
         Py_RETURN_TRUE;
     }
@@ -435,13 +831,11 @@ static PyObject* PyLAppModel_AddIndexParamValue(PyLAppModelObject* self, PyObjec
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_Update(PyLAppModelObject* self, PyObject* args)
+static void UpdateExpressionFadeout(PyLAppModelObject* self)
 {
     if (self->fadeout >= 0)
     {
-        auto now = std::chrono::system_clock::now();
-        auto value = std::chrono::time_point_cast<std::chrono::milliseconds>(now).time_since_epoch().count();
-        time_t elapsed = value - self->expStartedAt;
+        time_t elapsed = ModelTimeMillis(self) - self->expStartedAt;
         if (elapsed >= self->fadeout)
         {
             if (self->lastExpression != "")
@@ -457,454 +851,2853 @@ static PyObject* PyLAppModel_Update(PyLAppModelObject* self, PyObject* args)
             self->fadeout = -1;
         }
     }
-
-    self->model->Update();
-
-    Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_SetAutoBreathEnable(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_Update(PyLAppModelObject* self, PyObject* args)
 {
-    bool enable;
+    SyncPipeline(self);
 
-    if (PyArg_ParseTuple(args, "b", &enable) < 0)
+    PyObject* dt = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &dt))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    self->model->SetAutoBreathEnable(enable);
+    UpdateExpressionFadeout(self);
+
+    if (dt == Py_None)
+    {
+        self->model->Update();
+    }
+    else
+    {
+        const double deltaTimeSeconds = PyFloat_AsDouble(dt);
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+        self->model->Update(static_cast<float>(deltaTimeSeconds));
+    }
 
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_SetAutoBlinkEnable(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_Tick(PyLAppModelObject* self, PyObject* args)
 {
-    bool enable;
-
-    if (PyArg_ParseTuple(args, "b", &enable) < 0)
+    int steps;
+    float dt;
+    if (!PyArg_ParseTuple(args, "if", &steps, &dt))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    self->model->SetAutoBlinkEnable(enable);
+    for (int i = 0; i < steps; i++)
+    {
+        // 流水线模式下 Update 只是让模拟线程开始这一步，下一步之前须等它结束，并执行其间记下的动作回调
+        SyncPipeline(self);
+        UpdateExpressionFadeout(self);
+        self->model->Update(dt);
+    }
 
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetParameterCount(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_SetRandomSeed(PyLAppModelObject* self, PyObject* args)
 {
-    return PyLong_FromLong(self->model->GetParameterCount());
-}
+    SyncPipeline(self);
 
-static PyObject* module_live2d_v3_params = nullptr;
-static PyObject* typeobject_live2d_v3_parameter = nullptr;
+    unsigned long seed;
+    if (!PyArg_ParseTuple(args, "k", &seed))
+    {
+        return NULL;
+    }
 
-static PyObject* CreatePyParameter(const char* id, int type, float value, float maxValue, float minValue,
-                                   float defaultValue)
+    self->model->SetRandomSeed(static_cast<Csm::csmUint32>(seed));
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetPipelineEnable(PyLAppModelObject* self, PyObject* args)
 {
-    PyObject* instance = PyObject_CallObject(typeobject_live2d_v3_parameter, NULL);
-    if (instance == NULL)
+    int enable;
+    if (!PyArg_ParseTuple(args, "p", &enable))
     {
-        PyErr_Print();
         return NULL;
     }
-    PyObject* py_id = PyUnicode_FromString(id);
-    PyObject* py_type = PyLong_FromLong(type);
-    PyObject* py_val = PyLong_FromLong(value);
-    PyObject* py_max = PyLong_FromLong(maxValue);
-    PyObject* py_min = PyLong_FromLong(minValue);
-    PyObject* py_def = PyFloat_FromDouble(defaultValue);
 
-    PyObject_SetAttrString(instance, "id", py_id);
-    PyObject_SetAttrString(instance, "type", py_type);
-    PyObject_SetAttrString(instance, "value", py_val);
-    PyObject_SetAttrString(instance, "max", py_max);
-    PyObject_SetAttrString(instance, "min", py_min);
-    PyObject_SetAttrString(instance, "default", py_def);
+    if (enable)
+    {
+        self->model->SetPipelineEnable(true, PipelineHook, self);
+    }
+    else
+    {
+        SyncPipeline(self);
+        self->model->SetPipelineEnable(false);
+    }
 
-    Py_DECREF(py_id);
-    Py_DECREF(py_type);
-    Py_DECREF(py_val);
-    Py_DECREF(py_max);
-    Py_DECREF(py_min);
-    Py_DECREF(py_def);
-    return instance;
+    Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetParameter(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_GetPipelineStats(PyLAppModelObject* self, PyObject* args)
 {
-    int index;
-    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    LAppUpdatePipeline::Stats stats;
+    self->model->GetPipelineStats(stats);
+
+    return Py_BuildValue("{s:K,s:f,s:f,s:f,s:f}",
+                         "steps", (unsigned long long)stats.steps,
+                         "stepMs", stats.stepMs,
+                         "waitMs", stats.waitMs,
+                         "latencyMs", stats.latencyMs,
+                         "stepsPerSecond", stats.stepsPerSecond);
+}
+
+static PyObject* PyLAppModel_SetProfilerEnable(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int enable;
+    int window = 240;
+    if (!PyArg_ParseTuple(args, "p|i", &enable, &window))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    const char* id;
-    int type;
-    float value, maxValue, minValue, defaultValue;
-    self->model->GetParameter(index, id, type, value, maxValue, minValue, defaultValue);
+    if (window <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "window must be positive");
+        return NULL;
+    }
 
-    return CreatePyParameter(id, type, value, maxValue, minValue, defaultValue);
+    self->model->GetProfiler().SetEnable(enable, window);
+
+    Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetParamIds(PyLAppModelObject* self, PyObject* args)
+static PyObject* BuildProfileSummary(const LAppProfiler::Summary& summary)
 {
-    const int size = self->model->GetParameterCount();
-    PyObject* list = PyList_New(size);
-    const char* id;
-    int type;
-    float value, maxValue, minValue, defaultValue;
-    for (int i = 0; i < size; i++)
+    return Py_BuildValue("{s:K,s:f,s:f,s:f,s:f,s:f}",
+                         "count", (unsigned long long)summary.count,
+                         "mean", summary.mean,
+                         "p50", summary.p50,
+                         "p95", summary.p95,
+                         "p99", summary.p99,
+                         "max", summary.max);
+}
+
+static PyObject* PyLAppModel_GetProfile(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const LAppProfiler& profiler = self->model->GetProfiler();
+    PyObject* stages = PyDict_New();
+    PyObject* counters = PyDict_New();
+    if (stages == NULL || counters == NULL)
     {
-        self->model->GetParameter(i, id, type, value, maxValue, minValue, defaultValue);
-        PyObject* str = Py_BuildValue("s", id);
-        PyList_SetItem(list, i, str);
+        Py_XDECREF(stages);
+        Py_XDECREF(counters);
+        return NULL;
     }
-    return list;
+
+    // 没有样本的阶段（例如模型没有物理）不出现在结果中
+    LAppProfiler::Summary summary;
+    for (int i = 0; i < LAppProfiler::Stage_Count; i++)
+    {
+        if (!profiler.GetStageSummary(i, &summary))
+        {
+            continue;
+        }
+        PyObject* item = BuildProfileSummary(summary);
+        if (item == NULL || PyDict_SetItemString(stages, LAppProfiler::GetStageName(i), item) < 0)
+        {
+            Py_XDECREF(item);
+            Py_DECREF(stages);
+            Py_DECREF(counters);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+    for (int i = 0; i < LAppProfiler::Counter_Count; i++)
+    {
+        if (!profiler.GetCounterSummary(i, &summary))
+        {
+            continue;
+        }
+        PyObject* item = BuildProfileSummary(summary);
+        if (item == NULL || PyDict_SetItemString(counters, LAppProfiler::GetCounterName(i), item) < 0)
+        {
+            Py_XDECREF(item);
+            Py_DECREF(stages);
+            Py_DECREF(counters);
+            return NULL;
+        }
+        Py_DECREF(item);
+    }
+
+    return Py_BuildValue("{s:O,s:i,s:N,s:N}",
+                         "enabled", profiler.IsEnabled() ? Py_True : Py_False,
+                         "window", profiler.GetWindow(),
+                         "stages", stages,
+                         "counters", counters);
 }
 
-static PyObject* PyLAppModel_GetParameterValue(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_ResetProfile(PyLAppModelObject* self, PyObject* args)
 {
-    int index;
-    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    SyncPipeline(self);
+    self->model->GetProfiler().Reset();
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_StartProfileTrace(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int maxEvents = 1000000;
+    if (!PyArg_ParseTuple(args, "|i", &maxEvents))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    return PyFloat_FromDouble(self->model->GetParameterValue(index));
+    self->model->GetProfiler().StartTrace(maxEvents);
+
+    Py_RETURN_NONE;
 }
 
-// GetPartCount() -> int
-static PyObject* PyLAppModel_GetPartCount(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_SaveProfileTrace(PyLAppModelObject* self, PyObject* args)
 {
-    return PyLong_FromLong(self->model->GetPartCount());
+    SyncPipeline(self);
+
+    const char* path;
+    if (!PyArg_ParseTuple(args, "s", &path))
+    {
+        return NULL;
+    }
+
+    LAppProfiler& profiler = self->model->GetProfiler();
+    if (!profiler.IsTracing())
+    {
+        PyErr_SetString(PyExc_RuntimeError, "profile trace is not started");
+        return NULL;
+    }
+
+    const int count = profiler.StopTrace(path);
+    if (count < 0)
+    {
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return NULL;
+    }
+
+    return PyLong_FromLong(count);
 }
 
-// GetPartId(index: int) -> str
-static PyObject* PyLAppModel_GetPartId(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_OpenLipSyncStream(PyLAppModelObject* self, PyObject* args)
 {
-    int index;
-    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    SyncPipeline(self);
+
+    int sampleRate;
+    int channels = 1;
+    float bufferSeconds = 0.5f;
+    if (!PyArg_ParseTuple(args, "i|if", &sampleRate, &channels, &bufferSeconds))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    return PyUnicode_FromString(self->model->GetPartId(index).GetRawString());
+    if (sampleRate <= 0 || channels <= 0 || bufferSeconds <= 0.0f)
+    {
+        PyErr_SetString(PyExc_ValueError, "sampleRate, channels and bufferSeconds must be positive");
+        return NULL;
+    }
+
+    self->model->GetLipSync().OpenStream(sampleRate, channels, bufferSeconds);
+
+    Py_RETURN_NONE;
 }
 
-// GetPartIds() -> tuple[str]
-static PyObject* PyLAppModel_GetPartIds(PyLAppModelObject* self, PyObject* args)
+// 推入样本只写环形缓冲区，可以与模拟线程同时进行，不等待流水线
+static PyObject* PyLAppModel_FeedLipSync(PyLAppModelObject* self, PyObject* args)
 {
-    const int size = self->model->GetPartCount();
+    PyObject* object;
+    const char* format = "int16";
+    if (!PyArg_ParseTuple(args, "O|s", &object, &format))
+    {
+        return NULL;
+    }
 
-    PyObject* list = PyList_New(size);
+    LAppLipSync::SampleFormat sampleFormat;
+    Py_ssize_t sampleSize;
+    if (strcmp(format, "int16") == 0)
+    {
+        sampleFormat = LAppLipSync::SampleFormat_Int16;
+        sampleSize = 2;
+    }
+    else if (strcmp(format, "float32") == 0)
+    {
+        sampleFormat = LAppLipSync::SampleFormat_Float32;
+        sampleSize = 4;
+    }
+    else
+    {
+        PyErr_SetString(PyExc_ValueError, "format must be 'int16' or 'float32'");
+        return NULL;
+    }
 
-    for (int i = 0; i < size; ++i)
+    const void* data = NULL;
+    Py_ssize_t size = 0;
+    PyObject* bytes = NULL;
+#ifdef LIVE2D_ARRAY_VIEW
+    // bytes、bytearray、array、numpy 数组等经缓冲区协议直接读取；不连续的缓冲区退回到下面复制一次
+    Py_buffer view;
+    bool hasView = false;
+    if (PyObject_CheckBuffer(object))
     {
-        PyList_SetItem(list, i, PyUnicode_FromString(self->model->GetPartId(i).GetRawString()));
+        if (PyObject_GetBuffer(object, &view, PyBUF_C_CONTIGUOUS) == 0)
+        {
+            hasView = true;
+            data = view.buf;
+            size = view.len;
+        }
+        else if (PyErr_ExceptionMatches(PyExc_BufferError))
+        {
+            PyErr_Clear();
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+    if (!hasView)
+#endif
+    {
+        // 3.11 之前的受限 API 没有缓冲区协议，bytes 以外的对象先复制为 bytes
+        if (PyBytes_Check(object))
+        {
+            Py_INCREF(object);
+            bytes = object;
+        }
+        else
+        {
+            bytes = PyBytes_FromObject(object);
+        }
+        if (bytes == NULL)
+        {
+            return NULL;
+        }
+
+        char* buffer;
+        if (PyBytes_AsStringAndSize(bytes, &buffer, &size) < 0)
+        {
+            Py_DECREF(bytes);
+            return NULL;
+        }
+        data = buffer;
     }
 
-    return list;
+    LAppLipSync& lipSync = self->model->GetLipSync();
+    const Py_ssize_t frameSize = sampleSize * lipSync.GetChannelCount();
+    const Py_ssize_t frames = std::min<Py_ssize_t>(size / frameSize, INT_MAX);
+    const int fed = lipSync.Feed(data, static_cast<int>(frames), sampleFormat);
+#ifdef LIVE2D_ARRAY_VIEW
+    if (hasView)
+    {
+        PyBuffer_Release(&view);
+    }
+#endif
+    Py_XDECREF(bytes);
+
+    return PyLong_FromLong(fed);
 }
 
-// SetPartOpacity(id: str, opacity: float) -> None
-static PyObject* PyLAppModel_SetPartOpacity(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_StartLipSyncWav(PyLAppModelObject* self, PyObject* args)
 {
-    int index;
-    float opacity;
-    if (PyArg_ParseTuple(args, "if", &index, &opacity) < 0)
+    SyncPipeline(self);
+
+    const char* filePath;
+    if (!PyArg_ParseTuple(args, "s", &filePath))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    self->model->SetPartOpacity(index, opacity);
+    if (self->model->GetLipSync().LoadWav(filePath))
+    {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+static PyObject* PyLAppModel_StopLipSync(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    self->model->GetLipSync().Stop();
+
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_HitPart(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_SetLipSyncGain(PyLAppModelObject* self, PyObject* args)
 {
-    float x, y;
-    bool topOnly = false;
-    if (PyArg_ParseTuple(args, "ff|b", &x, &y, &topOnly) < 0)
+    SyncPipeline(self);
+
+    float gain;
+    if (!PyArg_ParseTuple(args, "f", &gain))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    PyObject* list = PyList_New(0);
-    self->model->HitPart(x, y, topOnly, list, [](void* collector, const char* paramId)
-    {
-        PyList_Append((PyObject*)collector, PyUnicode_FromString(paramId));
-    });
+    self->model->GetLipSync().SetGain(gain);
 
-    return list;
+    Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_SetPartMultiplyColor(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_SetLipSyncVowelEnable(PyLAppModelObject* self, PyObject* args)
 {
-    int index;
-    float r, g, b, a;
-    if (PyArg_ParseTuple(args, "iffff", &index, &r, &g, &b, &a) < 0)
+    SyncPipeline(self);
+
+    int enable;
+    if (!PyArg_ParseTuple(args, "p", &enable))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
-    self->model->SetPartMultiplyColor(index, r, g, b, a);
+
+    self->model->GetLipSync().SetVowelEnable(enable != 0);
+
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetPartMultiplyColor(PyLAppModelObject* self, PyObject* args)
+static PyObject* PyLAppModel_GetLipSyncValue(PyLAppModelObject* self, PyObject* args)
 {
-    int index;
-    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    SyncPipeline(self);
+
+    return PyFloat_FromDouble(self->model->GetLipSync().GetValue());
+}
+
+static PyObject* PyLAppModel_GetLipSyncVowels(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    float weights[LAppLipSync::Vowel_Count];
+    self->model->GetLipSync().GetVowelWeights(weights);
+
+    return Py_BuildValue("(fffff)", weights[0], weights[1], weights[2], weights[3], weights[4]);
+}
+
+static PyObject* PyLAppModel_BindParameterChannel(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    PyObject* paramIds;
+    float weight = 1.0f;
+    int capacity = 64;
+    if (!PyArg_ParseTuple(args, "O|fi", &paramIds, &weight, &capacity))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    float r, g, b, a;
-    self->model->GetPartMultiplyColor(index, r, g, b, a);
-    return Py_BuildValue("ffff", r, g, b, a);
+    if (capacity <= 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "capacity must be positive");
+        return NULL;
+    }
+
+    const Py_ssize_t count = PySequence_Size(paramIds);
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    // id 只在绑定时解析一次，之后每帧只传数值
+    std::vector<PyObject*> bytes;
+    std::vector<const char*> ids;
+    bool failed = false;
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* item = PySequence_GetItem(paramIds, i);
+        PyObject* utf8 = item != NULL ? PyUnicode_AsUTF8String(item) : NULL;
+        Py_XDECREF(item);
+        if (utf8 == NULL)
+        {
+            failed = true;
+            break;
+        }
+        bytes.push_back(utf8);
+        ids.push_back(PyBytes_AsString(utf8));
+    }
+
+    if (!failed)
+    {
+        self->model->BindParameterChannel(ids.data(), static_cast<int>(ids.size()), weight, capacity);
+    }
+
+    for (PyObject* utf8 : bytes)
+    {
+        Py_DECREF(utf8);
+    }
+
+    if (failed)
+    {
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_SetPartScreenColor(PyLAppModelObject* self, PyObject* args)
-{
-    int index;
-    float r, g, b, a;
-    if (PyArg_ParseTuple(args, "iffff", &index, &r, &g, &b, &a) < 0)
+// 写入通道是无锁的，可以在捕捉线程上调用，不等待流水线
+static PyObject* PyLAppModel_PushParameterFrame(PyLAppModelObject* self, PyObject* args)
+{
+    PyObject* values;
+    PyObject* timestamp = Py_None;
+    if (!PyArg_ParseTuple(args, "O|O", &values, &timestamp))
+    {
+        return NULL;
+    }
+
+    LAppParameterChannel& channel = self->model->GetParameterChannel();
+    const Py_ssize_t count = PySequence_Size(values);
+    if (count < 0)
+    {
+        return NULL;
+    }
+    if (count != channel.GetSlotCount())
+    {
+        PyErr_Format(PyExc_ValueError, "expected %d values, got %zd", channel.GetSlotCount(), count);
+        return NULL;
+    }
+
+    double time = LAppPal::GetCurrentTimePoint();
+    if (!Py_IsNone(timestamp))
+    {
+        time = PyFloat_AsDouble(timestamp);
+        if (time == -1.0 && PyErr_Occurred())
+        {
+            return NULL;
+        }
+    }
+
+    std::vector<float> frame(static_cast<size_t>(count));
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* item = PySequence_GetItem(values, i);
+        if (item == NULL)
+        {
+            return NULL;
+        }
+        frame[i] = static_cast<float>(PyFloat_AsDouble(item));
+        Py_DECREF(item);
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+    }
+
+    if (channel.Push(frame.data(), time))
+    {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+static PyObject* PyLAppModel_SetParameterChannelFilter(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    const char* filter = "none";
+    float timeConstant = 0.1f;
+    float minCutoff = 1.0f;
+    float beta = 0.0f;
+    float dCutoff = 1.0f;
+    static char* kwlist[] = {
+        (char*)"filter", (char*)"timeConstant", (char*)"minCutoff", (char*)"beta", (char*)"dCutoff", NULL
+    };
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|sffff", kwlist, &filter, &timeConstant, &minCutoff, &beta,
+                                     &dCutoff))
+    {
+        return NULL;
+    }
+
+    LAppParameterChannel::FilterType type;
+    if (strcmp(filter, "none") == 0)
+    {
+        type = LAppParameterChannel::FilterType_None;
+    }
+    else if (strcmp(filter, "ema") == 0)
+    {
+        type = LAppParameterChannel::FilterType_Ema;
+    }
+    else if (strcmp(filter, "oneEuro") == 0)
+    {
+        type = LAppParameterChannel::FilterType_OneEuro;
+    }
+    else
+    {
+        PyErr_SetString(PyExc_ValueError, "filter must be 'none', 'ema' or 'oneEuro'");
+        return NULL;
+    }
+
+    self->model->GetParameterChannel().SetFilter(type, timeConstant, minCutoff, beta, dCutoff);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetParameterChannelDelay(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    PyObject* seconds = Py_None;
+    if (!PyArg_ParseTuple(args, "|O", &seconds))
+    {
+        return NULL;
+    }
+
+    float delay = -1.0f;
+    if (!Py_IsNone(seconds))
+    {
+        delay = static_cast<float>(PyFloat_AsDouble(seconds));
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+        if (delay < 0.0f)
+        {
+            PyErr_SetString(PyExc_ValueError, "delay must not be negative");
+            return NULL;
+        }
+    }
+
+    self->model->GetParameterChannel().SetDelay(delay);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetParameterChannelDroppedFrames(PyLAppModelObject* self, PyObject* args)
+{
+    return PyLong_FromUnsignedLongLong(self->model->GetParameterChannel().GetDroppedFrames());
+}
+
+// 预先按 id 解析好下标的一组参数，每帧一次调用写入整组数值
+struct PyParameterPlanObject
+{
+    PyObject_HEAD
+    PyLAppModelObject* owner; // 持有模型的引用，plan 存活期间模型不会被释放
+    LAppParameterPlan* plan;
+};
+
+static PyObject* s_parameterPlanType = nullptr;
+
+// 读取长度为 count 的浮点数组，float32 缓冲区直接使用，其余类型转换后存入 storage
+class FloatArrayArgument
+{
+public:
+    FloatArrayArgument()
+        : _data(NULL)
+        , _hasView(false)
+    {
+    }
+
+    ~FloatArrayArgument()
+    {
+#ifdef LIVE2D_ARRAY_VIEW
+        if (_hasView)
+        {
+            PyBuffer_Release(&_view);
+        }
+#endif
+    }
+
+    bool Read(PyObject* obj, Py_ssize_t count)
+    {
+#ifdef LIVE2D_ARRAY_VIEW
+        if (PyObject_CheckBuffer(obj))
+        {
+            if (PyObject_GetBuffer(obj, &_view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+            {
+                return false;
+            }
+            _hasView = true;
+
+            const char* format = _view.format != NULL ? _view.format : "B";
+            if (format[0] == '@' || format[0] == '=')
+            {
+                format++;
+            }
+            if ((strcmp(format, "f") == 0 || strcmp(format, "d") == 0) && _view.itemsize == (format[0] == 'f' ? 4 : 8))
+            {
+                const Py_ssize_t length = _view.len / _view.itemsize;
+                if (length != count)
+                {
+                    PyErr_Format(PyExc_ValueError, "expected %zd values, got %zd", count, length);
+                    return false;
+                }
+                if (format[0] == 'f')
+                {
+                    _data = static_cast<const float*>(_view.buf);
+                    return true;
+                }
+                const double* values = static_cast<const double*>(_view.buf);
+                _storage.assign(values, values + count);
+                _data = _storage.data();
+                return true;
+            }
+
+            // 其他元素类型按序列逐个转换
+            PyBuffer_Release(&_view);
+            _hasView = false;
+        }
+#endif
+
+        const Py_ssize_t length = PySequence_Size(obj);
+        if (length < 0)
+        {
+            return false;
+        }
+        if (length != count)
+        {
+            PyErr_Format(PyExc_ValueError, "expected %zd values, got %zd", count, length);
+            return false;
+        }
+
+        _storage.resize(static_cast<size_t>(count));
+        for (Py_ssize_t i = 0; i < count; i++)
+        {
+            PyObject* item = PySequence_GetItem(obj, i);
+            if (item == NULL)
+            {
+                return false;
+            }
+            _storage[i] = static_cast<float>(PyFloat_AsDouble(item));
+            Py_DECREF(item);
+            if (PyErr_Occurred())
+            {
+                return false;
+            }
+        }
+        _data = _storage.data();
+        return true;
+    }
+
+    const float* GetData() const
+    {
+        return _data;
+    }
+
+private:
+    FloatArrayArgument(const FloatArrayArgument&);
+    FloatArrayArgument& operator=(const FloatArrayArgument&);
+
+    const float* _data;
+    std::vector<float> _storage;
+    bool _hasView;
+#ifdef LIVE2D_ARRAY_VIEW
+    Py_buffer _view;
+#endif
+};
+
+// 流水线模式下写入会排队到下一步，因此不等待模拟线程
+static PyObject* PyParameterPlan_set(PyParameterPlanObject* self, PyObject* args, PyObject* kwargs)
+{
+    PyObject* values;
+    PyObject* weights = NULL;
+    static char* kwlist[] = {(char*)"values", (char*)"weights", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", kwlist, &values, &weights))
+    {
+        return NULL;
+    }
+
+    const Py_ssize_t count = self->plan->GetCount();
+    FloatArrayArgument valueArray;
+    if (!valueArray.Read(values, count))
+    {
+        return NULL;
+    }
+
+    float weight = 1.0f;
+    FloatArrayArgument weightArray;
+    if (weights != NULL && PySequence_Check(weights))
+    {
+        if (!weightArray.Read(weights, count))
+        {
+            return NULL;
+        }
+    }
+    else if (weights != NULL)
+    {
+        weight = static_cast<float>(PyFloat_AsDouble(weights));
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+    }
+
+    self->owner->model->SetParameterValues(*self->plan, valueArray.GetData(), weightArray.GetData(), weight);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyParameterPlan_add(PyParameterPlanObject* self, PyObject* args, PyObject* kwargs)
+{
+    PyObject* values;
+    float weight = 1.0f;
+    static char* kwlist[] = {(char*)"values", (char*)"weight", NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|f", kwlist, &values, &weight))
+    {
+        return NULL;
+    }
+
+    FloatArrayArgument valueArray;
+    if (!valueArray.Read(values, self->plan->GetCount()))
+    {
+        return NULL;
+    }
+
+    self->owner->model->AddParameterValues(*self->plan, valueArray.GetData(), weight);
+
+    Py_RETURN_NONE;
+}
+
+static Py_ssize_t PyParameterPlan_len(PyParameterPlanObject* self)
+{
+    return self->plan->GetCount();
+}
+
+static void PyParameterPlan_dealloc(PyParameterPlanObject* self)
+{
+    delete self->plan;
+    Py_DECREF((PyObject*)self->owner);
+    PyObject_Free(self);
+}
+
+static PyMethodDef PyParameterPlan_methods[] = {
+    {"set", (PyCFunction)(void (*)(void))PyParameterPlan_set, METH_VARARGS | METH_KEYWORDS, ""},
+    {"add", (PyCFunction)(void (*)(void))PyParameterPlan_add, METH_VARARGS | METH_KEYWORDS, ""},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyType_Slot PyParameterPlan_slots[] = {
+    {Py_tp_methods, (void*)PyParameterPlan_methods},
+    {Py_sq_length, (void*)PyParameterPlan_len},
+    {Py_tp_dealloc, (void*)PyParameterPlan_dealloc},
+    {0, NULL}
+};
+
+static PyType_Spec PyParameterPlan_spec = {
+    "live2d.ParameterPlan",
+    sizeof(PyParameterPlanObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyParameterPlan_slots,
+};
+
+static PyObject* PyLAppModel_BindParameters(PyLAppModelObject* self, PyObject* args)
+{
+    PyObject* paramIds;
+    if (!PyArg_ParseTuple(args, "O", &paramIds))
+    {
+        return NULL;
+    }
+
+    const Py_ssize_t count = PySequence_Size(paramIds);
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    std::vector<PyObject*> bytes;
+    std::vector<const char*> ids;
+    bool failed = false;
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* item = PySequence_GetItem(paramIds, i);
+        PyObject* utf8 = item != NULL ? PyUnicode_AsUTF8String(item) : NULL;
+        Py_XDECREF(item);
+        if (utf8 == NULL)
+        {
+            failed = true;
+            break;
+        }
+        bytes.push_back(utf8);
+        ids.push_back(PyBytes_AsString(utf8));
+    }
+
+    PyParameterPlanObject* plan = NULL;
+    if (!failed)
+    {
+        plan = (PyParameterPlanObject*)PyObject_Malloc(sizeof(PyParameterPlanObject));
+        if (plan == NULL)
+        {
+            PyErr_NoMemory();
+        }
+        else
+        {
+            PyObject_Init((PyObject*)plan, (PyTypeObject*)s_parameterPlanType);
+            Py_INCREF((PyObject*)self);
+            plan->owner = self;
+            plan->plan = new LAppParameterPlan();
+            self->model->BindParameterPlan(*plan->plan, ids.data(), static_cast<int>(ids.size()));
+        }
+    }
+
+    for (PyObject* utf8 : bytes)
+    {
+        Py_DECREF(utf8);
+    }
+
+    return (PyObject*)plan;
+}
+
+#ifdef LIVE2D_ARRAY_VIEW
+// 直接指向 Core 内存的数组视图，通过缓冲区协议交给 numpy 等，不复制
+enum ArrayViewKind
+{
+    ArrayView_ParameterValues,
+    ArrayView_ParameterMinimumValues,
+    ArrayView_ParameterMaximumValues,
+    ArrayView_ParameterDefaultValues,
+    ArrayView_PartOpacities,
+    ArrayView_DrawableOpacities,
+    ArrayView_DrawableRenderOrders,
+    ArrayView_DrawableVertexPositions,
+};
+
+struct PyArrayViewObject
+{
+    PyObject_HEAD
+    PyLAppModelObject* owner; // 持有模型的引用，视图存活期间模型不会被释放
+    int kind;
+    int index;                // 顶点坐标所属的 drawable
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+};
+
+static PyObject* s_arrayViewType = nullptr;
+
+static int PyArrayView_getbuffer(PyArrayViewObject* self, Py_buffer* view, int flags)
+{
+    // 导出时等待模拟线程，之后读到的是最近完成的一步
+    SyncPipeline(self->owner);
+
+    Csm::CubismModel* model = self->owner->model->GetModel();
+    if (model == NULL)
+    {
+        PyErr_SetString(PyExc_BufferError, "model is not loaded");
+        return -1;
+    }
+    Live2D::Cubism::Core::csmModel* core = model->GetModel();
+
+    void* data = NULL;
+    bool writable = false;
+    bool isInt = false;
+    int ndim = 1;
+    Py_ssize_t count = 0;
+    switch (self->kind)
+    {
+    case ArrayView_ParameterValues:
+        data = Live2D::Cubism::Core::csmGetParameterValues(core);
+        count = Live2D::Cubism::Core::csmGetParameterCount(core);
+        writable = true;
+        break;
+    case ArrayView_ParameterMinimumValues:
+        data = (void*)Live2D::Cubism::Core::csmGetParameterMinimumValues(core);
+        count = Live2D::Cubism::Core::csmGetParameterCount(core);
+        break;
+    case ArrayView_ParameterMaximumValues:
+        data = (void*)Live2D::Cubism::Core::csmGetParameterMaximumValues(core);
+        count = Live2D::Cubism::Core::csmGetParameterCount(core);
+        break;
+    case ArrayView_ParameterDefaultValues:
+        data = (void*)Live2D::Cubism::Core::csmGetParameterDefaultValues(core);
+        count = Live2D::Cubism::Core::csmGetParameterCount(core);
+        break;
+    case ArrayView_PartOpacities:
+        data = Live2D::Cubism::Core::csmGetPartOpacities(core);
+        count = Live2D::Cubism::Core::csmGetPartCount(core);
+        writable = true;
+        break;
+    case ArrayView_DrawableOpacities:
+        data = (void*)Live2D::Cubism::Core::csmGetDrawableOpacities(core);
+        count = Live2D::Cubism::Core::csmGetDrawableCount(core);
+        break;
+    case ArrayView_DrawableRenderOrders:
+        data = (void*)Live2D::Cubism::Core::csmGetDrawableRenderOrders(core);
+        count = Live2D::Cubism::Core::csmGetDrawableCount(core);
+        isInt = true;
+        break;
+    default:
+        if (self->index >= Live2D::Cubism::Core::csmGetDrawableCount(core))
+        {
+            PyErr_SetString(PyExc_BufferError, "drawable index out of range");
+            return -1;
+        }
+        data = (void*)Live2D::Cubism::Core::csmGetDrawableVertexPositions(core)[self->index];
+        count = Live2D::Cubism::Core::csmGetDrawableVertexCounts(core)[self->index];
+        ndim = 2;
+        break;
+    }
+
+    if ((flags & PyBUF_WRITABLE) && !writable)
+    {
+        PyErr_SetString(PyExc_BufferError, "array view is read-only");
+        return -1;
+    }
+
+    self->shape[0] = count;
+    self->shape[1] = 2;
+    self->strides[0] = ndim == 2 ? 2 * sizeof(float) : sizeof(float);
+    self->strides[1] = sizeof(float);
+
+    view->buf = data;
+    view->obj = (PyObject*)self;
+    Py_INCREF(view->obj);
+    view->len = count * ndim * sizeof(float);
+    view->readonly = writable ? 0 : 1;
+    view->itemsize = sizeof(float);
+    view->format = (flags & PyBUF_FORMAT) ? (char*)(isInt ? "i" : "f") : NULL;
+    view->ndim = ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+
+    self->owner->viewExports++;
+    if (writable)
+    {
+        self->owner->writableViewExports++;
+        self->owner->model->InvalidateDrawables();
+    }
+    return 0;
+}
+
+static void PyArrayView_releasebuffer(PyArrayViewObject* self, Py_buffer* Py_UNUSED(view))
+{
+    self->owner->viewExports--;
+    if (self->kind == ArrayView_ParameterValues || self->kind == ArrayView_PartOpacities)
+    {
+        self->owner->writableViewExports--;
+        self->owner->model->InvalidateDrawables();
+    }
+}
+
+static void PyArrayView_dealloc(PyArrayViewObject* self)
+{
+    Py_DECREF((PyObject*)self->owner);
+    PyObject_Free(self);
+}
+
+static PyType_Slot PyArrayView_slots[] = {
+    {Py_bf_getbuffer, (void*)PyArrayView_getbuffer},
+    {Py_bf_releasebuffer, (void*)PyArrayView_releasebuffer},
+    {Py_tp_dealloc, (void*)PyArrayView_dealloc},
+    {0, NULL}
+};
+
+static PyType_Spec PyArrayView_spec = {
+    "live2d.ArrayView",
+    sizeof(PyArrayViewObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyArrayView_slots,
+};
+
+static PyObject* CreateArrayView(PyLAppModelObject* self, int kind, int index = 0)
+{
+    if (self->model->GetModel() == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "model is not loaded");
+        return NULL;
+    }
+
+    PyArrayViewObject* view = (PyArrayViewObject*)PyObject_Malloc(sizeof(PyArrayViewObject));
+    if (view == NULL)
+    {
+        return PyErr_NoMemory();
+    }
+    PyObject_Init((PyObject*)view, (PyTypeObject*)s_arrayViewType);
+    Py_INCREF((PyObject*)self);
+    view->owner = self;
+    view->kind = kind;
+    view->index = index;
+    return (PyObject*)view;
+}
+
+static PyObject* PyLAppModel_GetParameterValuesView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_ParameterValues);
+}
+
+static PyObject* PyLAppModel_GetParameterMinimumValuesView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_ParameterMinimumValues);
+}
+
+static PyObject* PyLAppModel_GetParameterMaximumValuesView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_ParameterMaximumValues);
+}
+
+static PyObject* PyLAppModel_GetParameterDefaultValuesView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_ParameterDefaultValues);
+}
+
+static PyObject* PyLAppModel_GetPartOpacitiesView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_PartOpacities);
+}
+
+static PyObject* PyLAppModel_GetDrawableOpacitiesView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_DrawableOpacities);
+}
+
+static PyObject* PyLAppModel_GetDrawableRenderOrdersView(PyLAppModelObject* self, PyObject* args)
+{
+    return CreateArrayView(self, ArrayView_DrawableRenderOrders);
+}
+
+static PyObject* PyLAppModel_GetDrawableVertexPositionsView(PyLAppModelObject* self, PyObject* args)
+{
+    int index;
+    if (!PyArg_ParseTuple(args, "i", &index))
+    {
+        return NULL;
+    }
+
+    Csm::CubismModel* model = self->model->GetModel();
+    if (model != NULL && (index < 0 || index >= model->GetDrawableCount()))
+    {
+        PyErr_SetString(PyExc_IndexError, "drawable index out of range");
+        return NULL;
+    }
+
+    return CreateArrayView(self, ArrayView_DrawableVertexPositions, index);
+}
+#endif
+
+static PyObject* PyLAppModel_SetAutoBreathEnable(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    bool enable;
+
+    if (PyArg_ParseTuple(args, "b", &enable) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    self->model->SetAutoBreathEnable(enable);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetAutoBlinkEnable(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    bool enable;
+
+    if (PyArg_ParseTuple(args, "b", &enable) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    self->model->SetAutoBlinkEnable(enable);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_SetProceduralEffectsEnable(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int enable;
+    if (!PyArg_ParseTuple(args, "p", &enable))
+    {
+        return NULL;
+    }
+
+    self->model->SetProceduralEffectsEnable(enable != 0);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetParameterCount(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    return PyLong_FromLong(self->model->GetParameterCount());
+}
+
+static PyObject* module_live2d_v3_params = nullptr;
+static PyObject* typeobject_live2d_v3_parameter = nullptr;
+
+static PyObject* CreatePyParameter(const char* id, int type, float value, float maxValue, float minValue,
+                                   float defaultValue)
+{
+    PyObject* instance = PyObject_CallObject(typeobject_live2d_v3_parameter, NULL);
+    if (instance == NULL)
+    {
+        PyErr_Print();
+        return NULL;
+    }
+    PyObject* py_id = PyUnicode_FromString(id);
+    PyObject* py_type = PyLong_FromLong(type);
+    PyObject* py_val = PyLong_FromLong(value);
+    PyObject* py_max = PyLong_FromLong(maxValue);
+    PyObject* py_min = PyLong_FromLong(minValue);
+    PyObject* py_def = PyFloat_FromDouble(defaultValue);
+
+    PyObject_SetAttrString(instance, "id", py_id);
+    PyObject_SetAttrString(instance, "type", py_type);
+    PyObject_SetAttrString(instance, "value", py_val);
+    PyObject_SetAttrString(instance, "max", py_max);
+    PyObject_SetAttrString(instance, "min", py_min);
+    PyObject_SetAttrString(instance, "default", py_def);
+
+    Py_DECREF(py_id);
+    Py_DECREF(py_type);
+    Py_DECREF(py_val);
+    Py_DECREF(py_max);
+    Py_DECREF(py_min);
+    Py_DECREF(py_def);
+    return instance;
+}
+
+static PyObject* PyLAppModel_GetParameter(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    const char* id;
+    int type;
+    float value, maxValue, minValue, defaultValue;
+    self->model->GetParameter(index, id, type, value, maxValue, minValue, defaultValue);
+
+    return CreatePyParameter(id, type, value, maxValue, minValue, defaultValue);
+}
+
+static PyObject* PyLAppModel_GetParamIds(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const int size = self->model->GetParameterCount();
+    PyObject* list = PyList_New(size);
+    const char* id;
+    int type;
+    float value, maxValue, minValue, defaultValue;
+    for (int i = 0; i < size; i++)
+    {
+        self->model->GetParameter(i, id, type, value, maxValue, minValue, defaultValue);
+        PyObject* str = Py_BuildValue("s", id);
+        PyList_SetItem(list, i, str);
+    }
+    return list;
+}
+
+static PyObject* PyLAppModel_GetParameterValue(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(self->model->GetParameterValue(index));
+}
+
+// GetPartCount() -> int
+static PyObject* PyLAppModel_GetPartCount(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    return PyLong_FromLong(self->model->GetPartCount());
+}
+
+// GetPartId(index: int) -> str
+static PyObject* PyLAppModel_GetPartId(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    return PyUnicode_FromString(self->model->GetPartId(index).GetRawString());
+}
+
+// GetPartIds() -> tuple[str]
+static PyObject* PyLAppModel_GetPartIds(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    const int size = self->model->GetPartCount();
+
+    PyObject* list = PyList_New(size);
+
+    for (int i = 0; i < size; ++i)
+    {
+        PyList_SetItem(list, i, PyUnicode_FromString(self->model->GetPartId(i).GetRawString()));
+    }
+
+    return list;
+}
+
+// SetPartOpacity(id: str, opacity: float) -> None
+static PyObject* PyLAppModel_SetPartOpacity(PyLAppModelObject* self, PyObject* args)
+{
+    int index;
+    float opacity;
+    if (PyArg_ParseTuple(args, "if", &index, &opacity) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    self->model->SetPartOpacity(index, opacity);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_HitPart(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    float x, y;
+    bool topOnly = false;
+    if (PyArg_ParseTuple(args, "ff|b", &x, &y, &topOnly) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    PyObject* list = PyList_New(0);
+    self->model->HitPart(x, y, topOnly, list, [](void* collector, const char* paramId)
+    {
+        PyList_Append((PyObject*)collector, PyUnicode_FromString(paramId));
+    });
+
+    return list;
+}
+
+static PyObject* PyLAppModel_SetPartMultiplyColor(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+    float r, g, b, a;
+    if (PyArg_ParseTuple(args, "iffff", &index, &r, &g, &b, &a) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+    self->model->SetPartMultiplyColor(index, r, g, b, a);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetPartMultiplyColor(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    float r, g, b, a;
+    self->model->GetPartMultiplyColor(index, r, g, b, a);
+    return Py_BuildValue("ffff", r, g, b, a);
+}
+
+static PyObject* PyLAppModel_SetPartScreenColor(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+    float r, g, b, a;
+    if (PyArg_ParseTuple(args, "iffff", &index, &r, &g, &b, &a) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+    self->model->SetPartScreenColor(index, r, g, b, a);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetPartScreenColor(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    int index;
+
+    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    {
+        PyErr_SetString(PyExc_TypeError, "Invalid param");
+        return NULL;
+    }
+
+    float r, g, b, a;
+    self->model->GetPartScreenColor(index, r, g, b, a);
+
+    return Py_BuildValue("ffff", r, g, b, a);
+}
+
+static PyObject* PyLAppModel_StopAllMotions(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    self->model->StopAllMotions();
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_ResetParameters(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    self->model->ResetParameters();
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_ResetPose(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    self->model->ResetPose();
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyLAppModel_GetExpressionIds(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    PyObject* list = PyList_New(0);
+    self->model->GetExpressionIds(list, [](void* collector, const char* expId){
+        PyObject* list = (PyObject*) collector;
+        PyList_Append(list, Py_BuildValue("s", expId));
+    });
+    return list;
+}
+
+static PyObject* PyLAppModel_GetMotionGroups(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+{
+    SyncPipeline(self);
+
+    PyObject* dict = PyDict_New();
+    self->model->GetMotionGroups(dict, [](void* collector, const char* group, int count){
+        PyObject* dict = (PyObject*) collector;
+        PyDict_SetItem(dict, Py_BuildValue("s", group), Py_BuildValue("i", count));
+    });
+    return dict;
+}
+
+static void SetDictInt64(PyObject* dict, const char* key, long long value)
+{
+    PyObject* item = PyLong_FromLongLong(value);
+    PyDict_SetItemString(dict, key, item);
+    Py_DECREF(item);
+}
+
+static PyObject* PyLAppModel_GetMemoryStats(PyLAppModelObject* self, PyObject* args)
+{
+    SyncPipeline(self);
+
+    LAppModel::MemoryStats stats;
+    self->model->GetMemoryStats(stats);
+
+    PyObject* dict = PyDict_New();
+    long long total = 0;
+    for (int i = 0; i < LAppMemoryAccount::Category_Count; ++i)
+    {
+        SetDictInt64(dict, LAppMemoryAccount::GetCategoryName(i), stats.categoryBytes[i]);
+        total += stats.categoryBytes[i];
+    }
+    SetDictInt64(dict, "total", total);
+    SetDictInt64(dict, "textures", stats.textureBytes);
+    SetDictInt64(dict, "masks", stats.maskBytes);
+    SetDictInt64(dict, "loadPeak", stats.loadPeakBytes);
+    return dict;
+}
+
+// 包装模块方法的方法列表
+static PyMethodDef PyLAppModel_methods[] = {
+    {"LoadModelJson", (PyCFunction)PyLAppModel_LoadModelJson, METH_VARARGS | METH_KEYWORDS, ""},
+    {"Resize", (PyCFunction)PyLAppModel_Resize, METH_VARARGS, ""},
+    {"Draw", (PyCFunction)PyLAppModel_Draw, METH_VARARGS, ""},
+    {"StartMotion", (PyCFunction)PyLAppModel_StartMotion, METH_VARARGS | METH_KEYWORDS, ""},
+    {"StartRandomMotion", (PyCFunction)PyLAppModel_StartRandomMotion, METH_VARARGS | METH_KEYWORDS, ""},
+    {"PrefetchMotion", (PyCFunction)PyLAppModel_PrefetchMotion, METH_VARARGS, ""},
+    {"PrefetchGroup", (PyCFunction)PyLAppModel_PrefetchGroup, METH_VARARGS, ""},
+    {"SetMotionBakeRate", (PyCFunction)PyLAppModel_SetMotionBakeRate, METH_VARARGS, ""},
+    {"GetMotionBakeError", (PyCFunction)PyLAppModel_GetMotionBakeError, METH_VARARGS, ""},
+
+    {"AddMotionLayer", (PyCFunction)PyLAppModel_AddMotionLayer, METH_VARARGS | METH_KEYWORDS, ""},
+    {"RemoveMotionLayer", (PyCFunction)PyLAppModel_RemoveMotionLayer, METH_VARARGS, ""},
+    {"SetMotionLayerWeight", (PyCFunction)PyLAppModel_SetMotionLayerWeight, METH_VARARGS, ""},
+    {"SetMotionLayerMask", (PyCFunction)PyLAppModel_SetMotionLayerMask, METH_VARARGS, ""},
+    {"StartLayerMotion", (PyCFunction)PyLAppModel_StartLayerMotion, METH_VARARGS | METH_KEYWORDS, ""},
+    {"IsLayerMotionFinished", (PyCFunction)PyLAppModel_IsLayerMotionFinished, METH_VARARGS, ""},
+    {"StopLayerMotions", (PyCFunction)PyLAppModel_StopLayerMotions, METH_VARARGS, ""},
+
+    {"SetExpression", (PyCFunction)PyLAppModel_SetExpression, METH_VARARGS | METH_KEYWORDS, ""},
+    {"SetRandomExpression", (PyCFunction)PyLAppModel_SetRandomExpression, METH_VARARGS | METH_KEYWORDS, ""},
+    {"ResetExpression", (PyCFunction)PyLAppModel_ResetExpression, METH_VARARGS, ""},
+
+    {"HitTest", (PyCFunction)PyLAppModel_HitTest, METH_VARARGS, "Get the name of the area being hit."},
+    {"HasMocConsistencyFromFile", (PyCFunction)PyLAppModel_HasMocConsistencyFromFile, METH_VARARGS, ""},
+    {"Drag", (PyCFunction)PyLAppModel_Drag, METH_VARARGS, ""},
+    {"IsMotionFinished", (PyCFunction)PyLAppModel_IsMotionFinished, METH_VARARGS, ""},
+    {"SetOffset", (PyCFunction)PyLAppModel_SetOffset, METH_VARARGS, ""},
+    {"SetScale", (PyCFunction)PyLAppModel_SetScale, METH_VARARGS, ""},
+    {"Rotate", (PyCFunction)PyLAppModel_Rotate, METH_VARARGS, ""},
+    {"Update", (PyCFunction)PyLAppModel_Update, METH_VARARGS, ""},
+    {"Tick", (PyCFunction)PyLAppModel_Tick, METH_VARARGS, ""},
+    {"SetRandomSeed", (PyCFunction)PyLAppModel_SetRandomSeed, METH_VARARGS, ""},
+    {"SetPipelineEnable", (PyCFunction)PyLAppModel_SetPipelineEnable, METH_VARARGS, ""},
+    {"GetPipelineStats", (PyCFunction)PyLAppModel_GetPipelineStats, METH_VARARGS, ""},
+
+    {"SetProfilerEnable", (PyCFunction)PyLAppModel_SetProfilerEnable, METH_VARARGS, ""},
+    {"GetProfile", (PyCFunction)PyLAppModel_GetProfile, METH_VARARGS, ""},
+    {"ResetProfile", (PyCFunction)PyLAppModel_ResetProfile, METH_VARARGS, ""},
+    {"StartProfileTrace", (PyCFunction)PyLAppModel_StartProfileTrace, METH_VARARGS, ""},
+    {"SaveProfileTrace", (PyCFunction)PyLAppModel_SaveProfileTrace, METH_VARARGS, ""},
+
+    {"OpenLipSyncStream", (PyCFunction)PyLAppModel_OpenLipSyncStream, METH_VARARGS, ""},
+    {"FeedLipSync", (PyCFunction)PyLAppModel_FeedLipSync, METH_VARARGS, ""},
+    {"StartLipSyncWav", (PyCFunction)PyLAppModel_StartLipSyncWav, METH_VARARGS, ""},
+    {"StopLipSync", (PyCFunction)PyLAppModel_StopLipSync, METH_VARARGS, ""},
+    {"SetLipSyncGain", (PyCFunction)PyLAppModel_SetLipSyncGain, METH_VARARGS, ""},
+    {"SetLipSyncVowelEnable", (PyCFunction)PyLAppModel_SetLipSyncVowelEnable, METH_VARARGS, ""},
+    {"GetLipSyncValue", (PyCFunction)PyLAppModel_GetLipSyncValue, METH_VARARGS, ""},
+    {"GetLipSyncVowels", (PyCFunction)PyLAppModel_GetLipSyncVowels, METH_VARARGS, ""},
+
+    {"BindParameterChannel", (PyCFunction)PyLAppModel_BindParameterChannel, METH_VARARGS, ""},
+    {"PushParameterFrame", (PyCFunction)PyLAppModel_PushParameterFrame, METH_VARARGS, ""},
+    {"SetParameterChannelFilter", (PyCFunction)PyLAppModel_SetParameterChannelFilter, METH_VARARGS | METH_KEYWORDS, ""},
+    {"SetParameterChannelDelay", (PyCFunction)PyLAppModel_SetParameterChannelDelay, METH_VARARGS, ""},
+    {"GetParameterChannelDroppedFrames", (PyCFunction)PyLAppModel_GetParameterChannelDroppedFrames, METH_VARARGS, ""},
+
+    {"BindParameters", (PyCFunction)PyLAppModel_BindParameters, METH_VARARGS, ""},
+
+#ifdef LIVE2D_ARRAY_VIEW
+    {"GetParameterValuesView", (PyCFunction)PyLAppModel_GetParameterValuesView, METH_VARARGS, ""},
+    {"GetParameterMinimumValuesView", (PyCFunction)PyLAppModel_GetParameterMinimumValuesView, METH_VARARGS, ""},
+    {"GetParameterMaximumValuesView", (PyCFunction)PyLAppModel_GetParameterMaximumValuesView, METH_VARARGS, ""},
+    {"GetParameterDefaultValuesView", (PyCFunction)PyLAppModel_GetParameterDefaultValuesView, METH_VARARGS, ""},
+    {"GetPartOpacitiesView", (PyCFunction)PyLAppModel_GetPartOpacitiesView, METH_VARARGS, ""},
+    {"GetDrawableOpacitiesView", (PyCFunction)PyLAppModel_GetDrawableOpacitiesView, METH_VARARGS, ""},
+    {"GetDrawableRenderOrdersView", (PyCFunction)PyLAppModel_GetDrawableRenderOrdersView, METH_VARARGS, ""},
+    {"GetDrawableVertexPositionsView", (PyCFunction)PyLAppModel_GetDrawableVertexPositionsView, METH_VARARGS, ""},
+#endif
+
+    {"SetAutoBreathEnable", (PyCFunction)PyLAppModel_SetAutoBreathEnable, METH_VARARGS, ""},
+    {"SetAutoBlinkEnable", (PyCFunction)PyLAppModel_SetAutoBlinkEnable, METH_VARARGS, ""},
+    {"SetProceduralEffectsEnable", (PyCFunction)PyLAppModel_SetProceduralEffectsEnable, METH_VARARGS, ""},
+
+    {"SetParameterValue", (PyCFunction)PyLAppModel_SetParameterValue, METH_VARARGS, ""},
+    {"SetIndexParamValue", (PyCFunction)PyLAppModel_SetIndexParamValue, METH_VARARGS, ""},
+    {"AddParameterValue", (PyCFunction)PyLAppModel_AddParameterValue, METH_VARARGS, ""},
+    {"AddIndexParamValue", (PyCFunction)PyLAppModel_AddIndexParamValue, METH_VARARGS, ""},
+    {"GetParameterCount", (PyCFunction)PyLAppModel_GetParameterCount, METH_VARARGS, ""},
+    {"GetParameter", (PyCFunction)PyLAppModel_GetParameter, METH_VARARGS, ""},
+    {"GetParamIds", (PyCFunction)PyLAppModel_GetParamIds, METH_VARARGS, ""},
+    {"GetParameterValue", (PyCFunction)PyLAppModel_GetParameterValue, METH_VARARGS, ""},
+
+    {"GetPartCount", (PyCFunction)PyLAppModel_GetPartCount, METH_VARARGS, ""},
+    {"GetPartId", (PyCFunction)PyLAppModel_GetPartId, METH_VARARGS, ""},
+    {"GetPartIds", (PyCFunction)PyLAppModel_GetPartIds, METH_VARARGS, ""},
+    {"SetPartOpacity", (PyCFunction)PyLAppModel_SetPartOpacity, METH_VARARGS, ""},
+    {"HitPart", (PyCFunction)PyLAppModel_HitPart, METH_VARARGS, ""},
+
+    {"SetPartMultiplyColor", (PyCFunction)PyLAppModel_SetPartMultiplyColor, METH_VARARGS, ""},
+    {"GetPartMultiplyColor", (PyCFunction)PyLAppModel_GetPartMultiplyColor, METH_VARARGS, ""},
+
+    {"SetPartScreenColor", (PyCFunction)PyLAppModel_SetPartScreenColor, METH_VARARGS, ""},
+    {"GetPartScreenColor", (PyCFunction)PyLAppModel_GetPartScreenColor, METH_VARARGS, ""},
+
+    // 复位
+    {"StopAllMotions", (PyCFunction)PyLAppModel_StopAllMotions, METH_VARARGS | METH_KEYWORDS, ""},
+    {"ResetParameters", (PyCFunction)PyLAppModel_ResetParameters, METH_VARARGS | METH_KEYWORDS, ""},
+    {"ResetPose", (PyCFunction)PyLAppModel_ResetPose, METH_VARARGS | METH_KEYWORDS, ""},
+
+    {"GetExpressionIds", (PyCFunction)PyLAppModel_GetExpressionIds, METH_VARARGS | METH_KEYWORDS, ""},
+    {"GetMotionGroups", (PyCFunction)PyLAppModel_GetMotionGroups, METH_VARARGS | METH_KEYWORDS, ""},
+    {"GetMemoryStats", (PyCFunction)PyLAppModel_GetMemoryStats, METH_VARARGS, ""},
+
+    {NULL} // 方法列表结束的标志
+};
+
+static PyObject* PyLAppModel_new(PyTypeObject* type, PyObject* args, PyObject* kwds)
+{
+    PyObject* self = (PyObject*)PyObject_Malloc(sizeof(PyLAppModelObject));
+    PyObject_Init(self, type);
+    return self;
+}
+
+static PyType_Slot PyLAppModel_slots[] = {
+    {Py_tp_new, (void*)PyLAppModel_new},
+    {Py_tp_init, (void*)PyLAppModel_init},
+    {Py_tp_dealloc, (void*)PyLAppModel_dealloc},
+    {Py_tp_methods, (void*)PyLAppModel_methods},
+    {0, NULL}
+};
+
+static PyType_Spec PyLAppModel_spec = {
+    "live2d.LAppModel",
+    sizeof(PyLAppModelObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyLAppModel_slots,
+};
+
+static PyObject* live2d_init(PyObject* self, PyObject* args, PyObject* kwds)
+{
+    static const char* kwlist[] = {"allocator", NULL};
+    const char* allocatorName = "default";
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", (char**)kwlist, &allocatorName))
+    {
+        return NULL;
+    }
+
+    LAppAllocator::AllocatorType allocatorType;
+    if (!LAppAllocator::ParseType(allocatorName, &allocatorType))
+    {
+        PyErr_Format(PyExc_ValueError, "unknown allocator: %s", allocatorName);
+        return NULL;
+    }
+
+    // 分配器只能在 StartUp 之前切换
+    if (Csm::CubismFramework::IsStarted())
+    {
+        if (allocatorType != LAppAllocator::GetType())
+        {
+            Warn("live2d is already initialized with allocator `%s`, `%s` is ignored.",
+                 LAppAllocator::GetTypeName(LAppAllocator::GetType()), allocatorName);
+        }
+    }
+    else
+    {
+        LAppAllocator::SetType(allocatorType);
+    }
+
+    _cubismOption.LogFunction = LAppPal::PrintLn;
+    _cubismOption.LoggingLevel = Csm::CubismFramework::Option::LogLevel_Verbose;
+
+    Csm::CubismFramework::StartUp(&_cubismAllocator, &_cubismOption);
+    Csm::CubismFramework::Initialize();
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_dispose()
+{
+    // 加载线程仍可能在使用 IdManager
+    LAppAssetCache::WaitForLoader();
+    Csm::CubismFramework::Dispose();
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_get_allocator_stats(PyObject* self, PyObject* args)
+{
+    LAppAllocator::Stats stats;
+    LAppAllocator::GetStats(&stats);
+
+    std::vector<LAppAllocator::SiteStats> siteStats;
+    LAppAllocator::GetSiteStats(siteStats);
+
+    PyObject* sites = PyList_New(siteStats.size());
+    for (size_t i = 0; i < siteStats.size(); ++i)
+    {
+        const LAppAllocator::SiteStats& site = siteStats[i];
+        PyList_SetItem(sites, i, Py_BuildValue("(siKKK)",
+                                               site.fileName ? site.fileName : "",
+                                               site.lineNumber,
+                                               (unsigned long long)site.allocations,
+                                               (unsigned long long)site.liveCount,
+                                               (unsigned long long)site.liveBytes));
+    }
+
+    return Py_BuildValue("{s:s,s:K,s:K,s:K,s:K,s:N}",
+                         "allocator", LAppAllocator::GetTypeName(LAppAllocator::GetType()),
+                         "liveBytes", (unsigned long long)stats.liveBytes,
+                         "peakBytes", (unsigned long long)stats.peakBytes,
+                         "allocations", (unsigned long long)stats.allocations,
+                         "deallocations", (unsigned long long)stats.deallocations,
+                         "sites", sites);
+}
+
+static PyObject* live2d_set_asset_cache_enable(PyObject* self, PyObject* args)
+{
+    int enable;
+    if (!PyArg_ParseTuple(args, "p", &enable))
+    {
+        return NULL;
+    }
+
+    LAppAssetCache::SetEnable(enable != 0);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_get_asset_cache_stats(PyObject* self, PyObject* args)
+{
+    LAppAssetCache::Stats stats;
+    LAppAssetCache::GetStats(&stats);
+
+    return Py_BuildValue("{s:i,s:i,s:i,s:i,s:i,s:K,s:K}",
+                         "mocs", stats.mocs,
+                         "motions", stats.motions,
+                         "expressions", stats.expressions,
+                         "physics", stats.physics,
+                         "textures", stats.textures,
+                         "hits", (unsigned long long)stats.hits,
+                         "misses", (unsigned long long)stats.misses);
+}
+
+static PyObject* s_lappModelType = nullptr;
+
+struct UpdateAllBatch
+{
+    std::vector<LAppModel*> models;
+    std::vector<std::vector<DeferredMotionCallback>> callbacks;
+    bool hasDeltaTime;
+    float deltaTimeSeconds;
+};
+
+static void UpdateAllTask(void* context, Csm::csmInt32 index)
+{
+    UpdateAllBatch* batch = static_cast<UpdateAllBatch*>(context);
+    LAppModel* model = batch->models[index];
+
+    t_deferredCallbacks = &batch->callbacks[index];
+    if (batch->hasDeltaTime)
+    {
+        model->Update(batch->deltaTimeSeconds);
+    }
+    else
+    {
+        model->Update();
+    }
+    model->UpdateDrawables();
+    t_deferredCallbacks = nullptr;
+}
+
+static PyObject* live2d_update_all(PyObject* self, PyObject* args)
+{
+    PyObject* models;
+    PyObject* dt = Py_None;
+    if (!PyArg_ParseTuple(args, "O|O", &models, &dt))
+    {
+        return NULL;
+    }
+
+    UpdateAllBatch batch;
+    batch.hasDeltaTime = dt != Py_None;
+    batch.deltaTimeSeconds = 0.0f;
+    if (batch.hasDeltaTime)
+    {
+        batch.deltaTimeSeconds = static_cast<float>(PyFloat_AsDouble(dt));
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+    }
+
+    PyObject* iterator = PyObject_GetIter(models);
+    if (iterator == NULL)
+    {
+        return NULL;
+    }
+
+    // 批次结束前一直持有模型的引用
+    std::vector<PyObject*> objects;
+    auto releaseObjects = [&objects]() {
+        for (size_t i = 0; i < objects.size(); i++)
+        {
+            Py_DECREF(objects[i]);
+        }
+    };
+
+    PyObject* item;
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        objects.push_back(item);
+        if (!PyObject_IsInstance(item, s_lappModelType))
+        {
+            PyErr_SetString(PyExc_TypeError, "updateAll expects LAppModel objects");
+            break;
+        }
+        batch.models.push_back(((PyLAppModelObject*)item)->model);
+    }
+    Py_DECREF(iterator);
+    if (PyErr_Occurred())
+    {
+        releaseObjects();
+        return NULL;
+    }
+
+    std::vector<LAppModel*> sorted(batch.models);
+    std::sort(sorted.begin(), sorted.end());
+    if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+    {
+        releaseObjects();
+        PyErr_SetString(PyExc_ValueError, "the same model appears more than once");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        SyncPipeline((PyLAppModelObject*)objects[i]);
+        UpdateExpressionFadeout((PyLAppModelObject*)objects[i]);
+    }
+
+    batch.callbacks.resize(batch.models.size());
+
+    Py_BEGIN_ALLOW_THREADS
+    LAppWorkerPool::Run(static_cast<Csm::csmInt32>(batch.models.size()), UpdateAllTask, &batch);
+    Py_END_ALLOW_THREADS
+
+    for (size_t i = 0; i < batch.callbacks.size(); i++)
+    {
+        RunDeferredCallbacks(batch.callbacks[i]);
+        if (((PyLAppModelObject*)objects[i])->writableViewExports > 0)
+        {
+            batch.models[i]->InvalidateDrawables();
+        }
+    }
+    releaseObjects();
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_set_update_thread_count(PyObject* self, PyObject* args)
+{
+    int count;
+    if (!PyArg_ParseTuple(args, "i", &count))
+    {
+        return NULL;
+    }
+
+    if (count < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "thread count must be at least 1");
+        return NULL;
+    }
+
+    LAppWorkerPool::SetThreadCount(count);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_get_update_thread_count(PyObject* self, PyObject* args)
+{
+    return PyLong_FromLong(LAppWorkerPool::GetThreadCount());
+}
+
+struct PyCrowdObject
+{
+    PyObject_HEAD
+    LAppCrowdRenderer* crowd;
+    std::vector<PyObject*> models; // 持有各实例的引用
+};
+
+static void PyCrowd_ReleaseModels(PyCrowdObject* self)
+{
+    for (size_t i = 0; i < self->models.size(); i++)
+    {
+        Py_DECREF(self->models[i]);
+    }
+    self->models.clear();
+}
+
+// Crowd(models)
+static int PyCrowd_init(PyCrowdObject* self, PyObject* args, PyObject* kwds)
+{
+    PyObject* models;
+    if (!PyArg_ParseTuple(args, "O", &models))
+    {
+        return -1;
+    }
+
+    PyObject* iterator = PyObject_GetIter(models);
+    if (iterator == NULL)
+    {
+        return -1;
+    }
+
+    std::vector<PyObject*> objects;
+    std::vector<LAppModel*> instances;
+    PyObject* item;
+    while ((item = PyIter_Next(iterator)) != NULL)
+    {
+        objects.push_back(item);
+        if (!PyObject_IsInstance(item, s_lappModelType))
+        {
+            PyErr_SetString(PyExc_TypeError, "Crowd expects LAppModel objects");
+            break;
+        }
+        instances.push_back(((PyLAppModelObject*)item)->model);
+    }
+    Py_DECREF(iterator);
+
+    if (!PyErr_Occurred() && !self->crowd->SetInstances(instances.data(), static_cast<Csm::csmInt32>(instances.size())))
+    {
+        PyErr_SetString(PyExc_ValueError, "crowd instances must be loaded from the same model");
+    }
+    if (PyErr_Occurred())
+    {
+        for (size_t i = 0; i < objects.size(); i++)
+        {
+            Py_DECREF(objects[i]);
+        }
+        return -1;
+    }
+
+    PyCrowd_ReleaseModels(self);
+    self->models.swap(objects);
+    return 0;
+}
+
+static PyObject* PyCrowd_Draw(PyCrowdObject* self, PyObject* args)
+{
+    self->crowd->Draw();
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyCrowd_GetDrawStats(PyCrowdObject* self, PyObject* args)
+{
+    const LAppCrowdRenderer::DrawStats& stats = self->crowd->GetDrawStats();
+    return Py_BuildValue("{s:i,s:i,s:i,s:O}",
+                         "instances", stats.instances,
+                         "drawCalls", stats.drawCalls,
+                         "maskDrawCalls", stats.maskDrawCalls,
+                         "instanced", stats.instanced ? Py_True : Py_False);
+}
+
+static PyObject* PyCrowd_SetMaskAtlasSize(PyCrowdObject* self, PyObject* args)
+{
+    int size;
+    if (!PyArg_ParseTuple(args, "i", &size))
+    {
+        return NULL;
+    }
+
+    if (size < 1)
+    {
+        PyErr_SetString(PyExc_ValueError, "mask atlas size must be at least 1");
+        return NULL;
+    }
+
+    self->crowd->SetMaskAtlasSize(size);
+    Py_RETURN_NONE;
+}
+
+static PyObject* PyCrowd_new(PyTypeObject* type, PyObject* args, PyObject* kwds)
+{
+    PyCrowdObject* self = (PyCrowdObject*)PyObject_Malloc(sizeof(PyCrowdObject));
+    PyObject_Init((PyObject*)self, type);
+    new (&self->models) std::vector<PyObject*>();
+    self->crowd = new LAppCrowdRenderer();
+    return (PyObject*)self;
+}
+
+static void PyCrowd_dealloc(PyCrowdObject* self)
+{
+    delete self->crowd;
+    PyCrowd_ReleaseModels(self);
+    self->models.~vector();
+    PyObject_Free(self);
+}
+
+static PyMethodDef PyCrowd_methods[] = {
+    {"Draw", (PyCFunction)PyCrowd_Draw, METH_VARARGS, ""},
+    {"GetDrawStats", (PyCFunction)PyCrowd_GetDrawStats, METH_VARARGS, ""},
+    {"SetMaskAtlasSize", (PyCFunction)PyCrowd_SetMaskAtlasSize, METH_VARARGS, ""},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyType_Slot PyCrowd_slots[] = {
+    {Py_tp_new, (void*)PyCrowd_new},
+    {Py_tp_init, (void*)PyCrowd_init},
+    {Py_tp_dealloc, (void*)PyCrowd_dealloc},
+    {Py_tp_methods, (void*)PyCrowd_methods},
+    {0, NULL}
+};
+
+static PyType_Spec PyCrowd_spec = {
+    "live2d.Crowd",
+    sizeof(PyCrowdObject),
+    0,
+    Py_TPFLAGS_DEFAULT,
+    PyCrowd_slots,
+};
+
+static PyObject* live2d_glew_init()
+{
+    Warn("`glewInit` might be a misleading name as `glew` has been replaced with `glad` in live2d-py. Please use `glInit()` instead.");
+    if (!gladLoadGL())
+    {
+        Error("Can't initilize glad.");
+    }
+    // LAppPal::UpdateTime();
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_glInit()
+{
+    if (!gladLoadGL())
+    {
+        Error("Can't initilize glad.");
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_clear_buffer(PyObject* self, PyObject* args)
+{
+    // 默认为黑色
+    float r = 0.0, g = 0.0, b = 0.0, a = 0.0;
+
+    // 解析传入的参数，允许指定颜色
+    if (!PyArg_ParseTuple(args, "|ffff", &r, &g, &b, &a))
+    {
+        return NULL;
+    }
+
+    // 设置清屏颜色
+    glClearColor(r, g, b, a);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glClearDepth(1.0);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_set_log_enable(PyObject* self, PyObject* args)
+{
+    bool enable;
+    if (!PyArg_ParseTuple(args, "b", &enable))
+    {
+        PyErr_SetString(PyExc_TypeError, "invalid param");
+        return NULL;
+    }
+
+    live2dLogEnable = enable;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_log_enable(PyObject* self, PyObject* args)
+{
+    if (live2dLogEnable)
+        Py_RETURN_TRUE;
+    Py_RETURN_FALSE;
+}
+
+static PyObject* s_logSink = NULL;
+
+/**
+ * 在日志的后台线程（或调用 flushLog 的线程）上执行，取得 GIL 后调用 Python 的 sink
+ */
+static void PythonLogSink(void* userData, const LogRecord* record)
+{
+    PyGILState_STATE state = PyGILState_Ensure();
+
+    PyObject* message;
+    if (record->suppressed > 0)
+    {
+        message = PyUnicode_FromFormat("%s (%u similar messages suppressed)", record->message, record->suppressed);
+    }
+    else
+    {
+        message = PyUnicode_DecodeUTF8(record->message, strlen(record->message), "replace");
+    }
+
+    // sink 可能在调用中以 setLogSink 替换自己，调用期间另外持有引用
+    PyObject* sink = (PyObject*)userData;
+    Py_INCREF(sink);
+    PyObject* result = NULL;
+    if (message != NULL)
+    {
+        result = PyObject_CallFunction(sink, "iNsi", (int)record->level, message, record->file, record->line);
+    }
+    if (result == NULL)
+    {
+        PyErr_WriteUnraisable(sink);
+    }
+    Py_XDECREF(result);
+    Py_DECREF(sink);
+
+    PyGILState_Release(state);
+}
+
+/**
+ * 替换 sink 时须释放 GIL：后台线程可能正持有 sink 的锁等待 GIL
+ */
+static void SetPythonLogSink(PyObject* sink)
+{
+    PyObject* previous = s_logSink;
+    Py_XINCREF(sink);
+    s_logSink = sink;
+
+    Py_BEGIN_ALLOW_THREADS
+    if (sink != NULL)
+    {
+        LogSetSink(PythonLogSink, sink);
+    }
+    else
+    {
+        LogSetSink(NULL, NULL);
+    }
+    Py_END_ALLOW_THREADS
+
+    Py_XDECREF(previous);
+}
+
+static PyObject* live2d_set_log_sink(PyObject* self, PyObject* args)
+{
+    PyObject* sink;
+    if (!PyArg_ParseTuple(args, "O", &sink))
+    {
+        return NULL;
+    }
+
+    if (sink != Py_None && !PyCallable_Check(sink))
+    {
+        PyErr_SetString(PyExc_TypeError, "sink must be callable or None");
+        return NULL;
+    }
+
+    SetPythonLogSink(sink == Py_None ? NULL : sink);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_set_log_level(PyObject* self, PyObject* args)
+{
+    int level;
+    if (!PyArg_ParseTuple(args, "i", &level))
+    {
+        return NULL;
+    }
+
+    LogSetLevel((LogLevel)level);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_get_log_level(PyObject* self, PyObject* args)
+{
+    return PyLong_FromLong(LogGetLevel());
+}
+
+static PyObject* live2d_set_log_rate_limit(PyObject* self, PyObject* args)
+{
+    int perSecond;
+    if (!PyArg_ParseTuple(args, "i", &perSecond))
+    {
+        return NULL;
+    }
+
+    if (perSecond < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "rate limit must not be negative");
+        return NULL;
+    }
+
+    LogSetRateLimit(perSecond);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_flush_log(PyObject* self, PyObject* args)
+{
+    Py_BEGIN_ALLOW_THREADS
+    LogFlush();
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+/**
+ * 解释器退出前取出剩余的日志并移除 Python 的 sink
+ */
+static PyObject* live2d_shutdown_log(PyObject* self, PyObject* args)
+{
+    Py_BEGIN_ALLOW_THREADS
+    LogFlush();
+    Py_END_ALLOW_THREADS
+
+    SetPythonLogSink(NULL);
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef live2d_shutdown_log_def = {"_shutdownLog", (PyCFunction)live2d_shutdown_log, METH_NOARGS, ""};
+
+/**
+ * live2d.v2 的原生加速，由 live2d/v2/core/util/ut_native.py 调用，不属于公开接口
+ */
+static const char* const PackedPointsName = "live2d.PackedPoints";
+
+struct PackedPoints
+{
+    Py_ssize_t count;
+    Py_ssize_t length;
+    std::vector<double> values;
+};
+
+static std::vector<double> s_v2Source;
+static std::vector<double> s_v2Grid;
+static std::vector<double> s_v2Output;
+static std::vector<double> s_v2T;
+static std::vector<Csm::csmInt32> s_v2Indices;
+
+static void PackedPointsDestructor(PyObject* capsule)
+{
+    delete static_cast<PackedPoints*>(PyCapsule_GetPointer(capsule, PackedPointsName));
+}
+
+/**
+ * 读取序列的前 count 个数，列表直接取元素
+ */
+static bool ReadDoubles(PyObject* sequence, Py_ssize_t count, double* out)
+{
+    const Py_ssize_t length = PySequence_Size(sequence);
+    if (length < 0)
+    {
+        return false;
+    }
+    if (length < count)
+    {
+        PyErr_Format(PyExc_IndexError, "expected at least %zd values, got %zd", count, length);
+        return false;
+    }
+
+    const bool isList = PyList_Check(sequence);
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* item = isList ? PyList_GetItem(sequence, i) : PySequence_GetItem(sequence, i);
+        if (item == NULL)
+        {
+            return false;
+        }
+        out[i] = PyFloat_AsDouble(item);
+        if (!isList)
+        {
+            Py_DECREF(item);
+        }
+        if (out[i] == -1.0 && PyErr_Occurred())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool WriteDouble(PyObject* sequence, Py_ssize_t index, double value)
+{
+    PyObject* item = PyFloat_FromDouble(value);
+    if (item == NULL)
+    {
+        return false;
+    }
+    if (PyList_Check(sequence))
+    {
+        return PyList_SetItem(sequence, index, item) == 0;
+    }
+    const int result = PySequence_SetItem(sequence, index, item);
+    Py_DECREF(item);
+    return result == 0;
+}
+
+/**
+ * 写回 k = offset, offset + step, ... < end 处的点，与 Python 实现中循环的取点方式相同
+ */
+static bool WriteStridedPoints(PyObject* dst, const double* values, Py_ssize_t offset, Py_ssize_t end,
+                               Py_ssize_t step)
+{
+    for (Py_ssize_t k = offset; k < end; k += step)
+    {
+        if (!WriteDouble(dst, k, values[k]) || !WriteDouble(dst, k + 1, values[k + 1]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 读取 transformPoints 的源点，返回需要的长度（最后一个点的 y 之后），没有点时为 0
+ */
+static bool ReadStridedSource(PyObject* src, int pointCount, int offset, int step, Py_ssize_t* outLength)
+{
+    if (step <= 0 || offset < 0)
+    {
+        PyErr_SetString(PyExc_ValueError, "invalid point offset or step");
+        return false;
+    }
+
+    const Py_ssize_t end = static_cast<Py_ssize_t>(pointCount) * step;
+    Py_ssize_t length = 0;
+    if (offset < end)
+    {
+        length = offset + (end - 1 - offset) / step * step + 2;
+    }
+
+    s_v2Source.resize(static_cast<size_t>(length));
+    s_v2Output.resize(static_cast<size_t>(length));
+    *outLength = length;
+    return ReadDoubles(src, length, s_v2Source.data());
+}
+
+static PyObject* live2d_v2_pack_points(PyObject* self, PyObject* args)
+{
+    PyObject* points;
+    if (!PyArg_ParseTuple(args, "O", &points))
+    {
+        return NULL;
+    }
+
+    const Py_ssize_t count = PySequence_Size(points);
+    if (count < 0)
+    {
+        return NULL;
+    }
+
+    std::unique_ptr<PackedPoints> packed(new PackedPoints());
+    packed->count = count;
+    packed->length = 0;
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* pivot = PySequence_GetItem(points, i);
+        if (pivot == NULL)
+        {
+            return NULL;
+        }
+
+        const Py_ssize_t length = PySequence_Size(pivot);
+        if (i == 0 && length >= 0)
+        {
+            packed->length = length;
+            packed->values.resize(static_cast<size_t>(count * length));
+        }
+        const bool ok = length == packed->length &&
+                        ReadDoubles(pivot, length, packed->values.data() + i * packed->length);
+        Py_DECREF(pivot);
+        if (!ok)
+        {
+            if (!PyErr_Occurred())
+            {
+                PyErr_SetString(PyExc_ValueError, "all pivots must have the same number of values");
+            }
+            return NULL;
+        }
+    }
+
+    PyObject* capsule = PyCapsule_New(packed.get(), PackedPointsName, PackedPointsDestructor);
+    if (capsule != NULL)
+    {
+        packed.release();
+    }
+    return capsule;
+}
+
+static PyObject* live2d_v2_interpolate_points(PyObject* self, PyObject* args)
+{
+    PyObject* capsule;
+    PyObject* indices;
+    PyObject* t;
+    int dimension;
+    int pointCount;
+    PyObject* dst;
+    int offset;
+    int step;
+    if (!PyArg_ParseTuple(args, "OOOiiOii", &capsule, &indices, &t, &dimension, &pointCount, &dst, &offset, &step))
+    {
+        return NULL;
+    }
+
+    PackedPoints* packed = static_cast<PackedPoints*>(PyCapsule_GetPointer(capsule, PackedPointsName));
+    if (packed == NULL)
+    {
+        return NULL;
+    }
+
+    const Py_ssize_t valueCount = static_cast<Py_ssize_t>(pointCount) * 2;
+    if (dimension < 0 || dimension > 16 || pointCount < 0 || valueCount > packed->length)
+    {
+        PyErr_SetString(PyExc_ValueError, "invalid interpolation arguments");
+        return NULL;
+    }
+
+    const int pivotCount = 1 << dimension;
+    if (PySequence_Size(indices) < pivotCount)
+    {
+        PyErr_SetString(PyExc_IndexError, "too few pivot indices");
+        return NULL;
+    }
+    s_v2Indices.resize(pivotCount);
+    for (int i = 0; i < pivotCount; i++)
+    {
+        PyObject* item = PySequence_GetItem(indices, i);
+        if (item == NULL)
+        {
+            return NULL;
+        }
+        const long index = PyLong_AsLong(item);
+        Py_DECREF(item);
+        if (index == -1 && PyErr_Occurred())
+        {
+            return NULL;
+        }
+        if (index < 0 || index >= packed->count)
+        {
+            PyErr_SetString(PyExc_IndexError, "pivot index out of range");
+            return NULL;
+        }
+        s_v2Indices[i] = static_cast<Csm::csmInt32>(index);
+    }
+
+    s_v2T.resize(dimension > 0 ? dimension : 1);
+    if (!ReadDoubles(t, dimension, s_v2T.data()))
+    {
+        return NULL;
+    }
+
+    s_v2Output.resize(static_cast<size_t>(valueCount));
+    LAppV2Kernels::InterpolatePoints(packed->values.data(), static_cast<Csm::csmInt32>(packed->length),
+                                     s_v2Indices.data(), s_v2T.data(), dimension,
+                                     static_cast<Csm::csmInt32>(valueCount), s_v2Output.data());
+
+    Py_ssize_t position = offset;
+    for (Py_ssize_t i = 0; i < valueCount; i += 2)
+    {
+        if (!WriteDouble(dst, position, s_v2Output[i]) || !WriteDouble(dst, position + 1, s_v2Output[i + 1]))
+        {
+            return NULL;
+        }
+        position += step;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* live2d_v2_transform_warp_points(PyObject* self, PyObject* args)
+{
+    PyObject* src;
+    PyObject* dst;
+    int pointCount;
+    int offset;
+    int step;
+    PyObject* grid;
+    int row;
+    int col;
+    if (!PyArg_ParseTuple(args, "OOiiiOii", &src, &dst, &pointCount, &offset, &step, &grid, &row, &col))
+    {
+        return NULL;
+    }
+
+    Py_ssize_t length;
+    if (row < 0 || col < 0 || !ReadStridedSource(src, pointCount, offset, step, &length))
+    {
+        if (!PyErr_Occurred())
+        {
+            PyErr_SetString(PyExc_ValueError, "invalid grid size");
+        }
+        return NULL;
+    }
+
+    const Py_ssize_t gridLength = static_cast<Py_ssize_t>(row + 1) * (col + 1) * 2;
+    s_v2Grid.resize(static_cast<size_t>(gridLength));
+    if (!ReadDoubles(grid, gridLength, s_v2Grid.data()))
+    {
+        return NULL;
+    }
+
+    if (!LAppV2Kernels::TransformWarpPoints(s_v2Source.data(), s_v2Output.data(), pointCount, offset, step,
+                                            s_v2Grid.data(), row, col))
+    {
+        PyErr_SetString(PyExc_RuntimeError, "error @BDBoxGrid");
+        return NULL;
+    }
+
+    if (!WriteStridedPoints(dst, s_v2Output.data(), offset, static_cast<Py_ssize_t>(pointCount) * step, step))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
-    self->model->SetPartScreenColor(index, r, g, b, a);
 
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetPartScreenColor(PyLAppModelObject* self, PyObject* args)
+static PyObject* live2d_v2_transform_affine_points(PyObject* self, PyObject* args)
 {
-    int index;
-
-    if (PyArg_ParseTuple(args, "i", &index) < 0)
+    PyObject* src;
+    PyObject* dst;
+    int pointCount;
+    int offset;
+    int step;
+    double m00, m01, m10, m11, tx, ty;
+    if (!PyArg_ParseTuple(args, "OOiiidddddd", &src, &dst, &pointCount, &offset, &step,
+                          &m00, &m01, &m10, &m11, &tx, &ty))
     {
-        PyErr_SetString(PyExc_TypeError, "Invalid param");
         return NULL;
     }
 
-    float r, g, b, a;
-    self->model->GetPartScreenColor(index, r, g, b, a);
-
-    return Py_BuildValue("ffff", r, g, b, a);
-}
+    Py_ssize_t length;
+    if (!ReadStridedSource(src, pointCount, offset, step, &length))
+    {
+        return NULL;
+    }
 
-static PyObject* PyLAppModel_StopAllMotions(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
-{
-    self->model->StopAllMotions();
-    Py_RETURN_NONE;
-}
+    LAppV2Kernels::TransformAffinePoints(s_v2Source.data(), s_v2Output.data(), pointCount, offset, step,
+                                         m00, m01, m10, m11, tx, ty);
 
-static PyObject* PyLAppModel_ResetParameters(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
-{
-    self->model->ResetParameters();
-    Py_RETURN_NONE;
-}
+    if (!WriteStridedPoints(dst, s_v2Output.data(), offset, static_cast<Py_ssize_t>(pointCount) * step, step))
+    {
+        return NULL;
+    }
 
-static PyObject* PyLAppModel_ResetPose(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
-{
-    self->model->ResetPose();
     Py_RETURN_NONE;
 }
 
-static PyObject* PyLAppModel_GetExpressionIds(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+template <typename T>
+static PyObject* VectorToBytes(const std::vector<T>& values)
 {
-    PyObject* list = PyList_New(0);
-    self->model->GetExpressionIds(list, [](void* collector, const char* expId){
-        PyObject* list = (PyObject*) collector;
-        PyList_Append(list, Py_BuildValue("s", expId));
-    });
-    return list;
+    return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(values.data()),
+                                     static_cast<Py_ssize_t>(values.size() * sizeof(T)));
 }
 
-static PyObject* PyLAppModel_GetMotionGroups(PyLAppModelObject* self, PyObject* args, PyObject* kwargs)
+// LAppProceduralEffects::Sin 逐个作用于 float 序列，供测试对照误差
+static PyObject* live2d_effects_sin(PyObject* self, PyObject* args)
 {
-    PyObject* dict = PyDict_New();
-    self->model->GetMotionGroups(dict, [](void* collector, const char* group, int count){
-        PyObject* dict = (PyObject*) collector;
-        PyDict_SetItem(dict, Py_BuildValue("s", group), Py_BuildValue("i", count));
-    });
-    return dict;
-}
-
-// 包装模块方法的方法列表
-static PyMethodDef PyLAppModel_methods[] = {
-    {"LoadModelJson", (PyCFunction)PyLAppModel_LoadModelJson, METH_VARARGS, ""},
-    {"Resize", (PyCFunction)PyLAppModel_Resize, METH_VARARGS, ""},
-    {"Draw", (PyCFunction)PyLAppModel_Draw, METH_VARARGS, ""},
-    {"StartMotion", (PyCFunction)PyLAppModel_StartMotion, METH_VARARGS | METH_KEYWORDS, ""},
-    {"StartRandomMotion", (PyCFunction)PyLAppModel_StartRandomMotion, METH_VARARGS | METH_KEYWORDS, ""},
+    PyObject* values;
+    if (!PyArg_ParseTuple(args, "O", &values))
+    {
+        return NULL;
+    }
 
-    {"SetExpression", (PyCFunction)PyLAppModel_SetExpression, METH_VARARGS | METH_KEYWORDS, ""},
-    {"SetRandomExpression", (PyCFunction)PyLAppModel_SetRandomExpression, METH_VARARGS | METH_KEYWORDS, ""},
-    {"ResetExpression", (PyCFunction)PyLAppModel_ResetExpression, METH_VARARGS, ""},
+    const Py_ssize_t count = PySequence_Size(values);
+    if (count < 0)
+    {
+        return NULL;
+    }
 
-    {"HitTest", (PyCFunction)PyLAppModel_HitTest, METH_VARARGS, "Get the name of the area being hit."},
-    {"HasMocConsistencyFromFile", (PyCFunction)PyLAppModel_HasMocConsistencyFromFile, METH_VARARGS, ""},
-    {"Drag", (PyCFunction)PyLAppModel_Drag, METH_VARARGS, ""},
-    {"IsMotionFinished", (PyCFunction)PyLAppModel_IsMotionFinished, METH_VARARGS, ""},
-    {"SetOffset", (PyCFunction)PyLAppModel_SetOffset, METH_VARARGS, ""},
-    {"SetScale", (PyCFunction)PyLAppModel_SetScale, METH_VARARGS, ""},
-    {"Rotate", (PyCFunction)PyLAppModel_Rotate, METH_VARARGS, ""},
-    {"Update", (PyCFunction)PyLAppModel_Update, METH_VARARGS, ""},
+    std::vector<float> x(count);
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* item = PySequence_GetItem(values, i);
+        if (item == NULL)
+        {
+            return NULL;
+        }
+        x[i] = static_cast<float>(PyFloat_AsDouble(item));
+        Py_DECREF(item);
+        if (PyErr_Occurred())
+        {
+            return NULL;
+        }
+    }
 
-    {"SetAutoBreathEnable", (PyCFunction)PyLAppModel_SetAutoBreathEnable, METH_VARARGS, ""},
-    {"SetAutoBlinkEnable", (PyCFunction)PyLAppModel_SetAutoBlinkEnable, METH_VARARGS, ""},
+    LAppProceduralEffects::Sin(x.data(), x.data(), static_cast<Csm::csmInt32>(count));
 
-    {"SetParameterValue", (PyCFunction)PyLAppModel_SetParameterValue, METH_VARARGS, ""},
-    {"SetIndexParamValue", (PyCFunction)PyLAppModel_SetIndexParamValue, METH_VARARGS, ""},
-    {"AddParameterValue", (PyCFunction)PyLAppModel_AddParameterValue, METH_VARARGS, ""},
-    {"AddIndexParamValue", (PyCFunction)PyLAppModel_AddIndexParamValue, METH_VARARGS, ""},
-    {"GetParameterCount", (PyCFunction)PyLAppModel_GetParameterCount, METH_VARARGS, ""},
-    {"GetParameter", (PyCFunction)PyLAppModel_GetParameter, METH_VARARGS, ""},
-    {"GetParamIds", (PyCFunction)PyLAppModel_GetParamIds, METH_VARARGS, ""},
-    {"GetParameterValue", (PyCFunction)PyLAppModel_GetParameterValue, METH_VARARGS, ""},
+    PyObject* result = PyList_New(count);
+    if (result == NULL)
+    {
+        return NULL;
+    }
+    for (Py_ssize_t i = 0; i < count; i++)
+    {
+        PyObject* item = PyFloat_FromDouble(x[i]);
+        if (item == NULL || PyList_SetItem(result, i, item) < 0)
+        {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+    return result;
+}
 
-    {"GetPartCount", (PyCFunction)PyLAppModel_GetPartCount, METH_VARARGS, ""},
-    {"GetPartId", (PyCFunction)PyLAppModel_GetPartId, METH_VARARGS, ""},
-    {"GetPartIds", (PyCFunction)PyLAppModel_GetPartIds, METH_VARARGS, ""},
-    {"SetPartOpacity", (PyCFunction)PyLAppModel_SetPartOpacity, METH_VARARGS, ""},
-    {"HitPart", (PyCFunction)PyLAppModel_HitPart, METH_VARARGS, ""},
+struct MotionJsonMeta
+{
+    bool beziersRestricted;
+    bool hasFadeInTime;
+    bool hasFadeOutTime;
+    float fadeInTime;
+    float fadeOutTime;
+};
 
-    {"SetPartMultiplyColor", (PyCFunction)PyLAppModel_SetPartMultiplyColor, METH_VARARGS, ""},
-    {"GetPartMultiplyColor", (PyCFunction)PyLAppModel_GetPartMultiplyColor, METH_VARARGS, ""},
+// 按改写前 CubismMotion::Parse 的做法经由 CubismMotionJson 的 JSON 树读取，作为流式读取的对照
+static bool ReadMotionJsonTree(const Csm::csmByte* buffer, Csm::csmSizeInt size,
+                               Csm::CubismMotionData* data, MotionJsonMeta* meta)
+{
+    using namespace Csm;
 
-    {"SetPartScreenColor", (PyCFunction)PyLAppModel_SetPartScreenColor, METH_VARARGS, ""},
-    {"GetPartScreenColor", (PyCFunction)PyLAppModel_GetPartScreenColor, METH_VARARGS, ""},
+    CubismMotionJson json(buffer, size);
+    if (!json.IsValid())
+    {
+        return false;
+    }
 
-    // 复位
-    {"StopAllMotions", (PyCFunction)PyLAppModel_StopAllMotions, METH_VARARGS | METH_KEYWORDS, ""},
-    {"ResetParameters", (PyCFunction)PyLAppModel_ResetParameters, METH_VARARGS | METH_KEYWORDS, ""},
-    {"ResetPose", (PyCFunction)PyLAppModel_ResetPose, METH_VARARGS | METH_KEYWORDS, ""},
+    data->Duration = json.GetMotionDuration();
+    data->Loop = json.IsMotionLoop();
+    data->CurveCount = json.GetMotionCurveCount();
+    data->Fps = json.GetMotionFps();
+    data->EventCount = json.GetEventCount();
+    meta->beziersRestricted = json.GetEvaluationOptionFlag(EvaluationOptionFlag_AreBeziersRestricted);
+    meta->hasFadeInTime = json.IsExistMotionFadeInTime();
+    meta->fadeInTime = meta->hasFadeInTime ? json.GetMotionFadeInTime() : 0.0f;
+    meta->hasFadeOutTime = json.IsExistMotionFadeOutTime();
+    meta->fadeOutTime = meta->hasFadeOutTime ? json.GetMotionFadeOutTime() : 0.0f;
+
+    for (csmInt32 i = 0; i < data->CurveCount; i++)
+    {
+        CubismMotionCurve curve;
+        const csmChar* target = json.GetMotionCurveTarget(i);
+        if (strcmp(target, "Model") == 0)
+        {
+            curve.Type = CubismMotionCurveTarget_Model;
+        }
+        else if (strcmp(target, "Parameter") == 0)
+        {
+            curve.Type = CubismMotionCurveTarget_Parameter;
+        }
+        else if (strcmp(target, "PartOpacity") == 0)
+        {
+            curve.Type = CubismMotionCurveTarget_PartOpacity;
+        }
+        curve.Id = json.GetMotionCurveId(i);
+        curve.BaseSegmentIndex = static_cast<csmInt32>(data->Segments.GetSize());
+        curve.FadeInTime = json.IsExistMotionCurveFadeInTime(i) ? json.GetMotionCurveFadeInTime(i) : -1.0f;
+        curve.FadeOutTime = json.IsExistMotionCurveFadeOutTime(i) ? json.GetMotionCurveFadeOutTime(i) : -1.0f;
 
-    {"GetExpressionIds", (PyCFunction)PyLAppModel_GetExpressionIds, METH_VARARGS | METH_KEYWORDS, ""},
-    {"GetMotionGroups", (PyCFunction)PyLAppModel_GetMotionGroups, METH_VARARGS | METH_KEYWORDS, ""},
+        const csmInt32 count = json.GetMotionCurveSegmentCount(i);
+        for (csmInt32 position = 0; position < count;)
+        {
+            if (position == 0)
+            {
+                data->Points.PushBack(CubismMotionPoint());
+                data->Points[data->Points.GetSize() - 1].Time = json.GetMotionCurveSegment(i, 0);
+                data->Points[data->Points.GetSize() - 1].Value = json.GetMotionCurveSegment(i, 1);
+                position += 2;
+            }
 
-    {NULL} // 方法列表结束的标志
-};
+            CubismMotionSegment segment;
+            segment.BasePointIndex = static_cast<csmInt32>(data->Points.GetSize()) - 1;
+            segment.SegmentType = static_cast<csmInt32>(json.GetMotionCurveSegment(i, position));
 
-static PyObject* PyLAppModel_new(PyTypeObject* type, PyObject* args, PyObject* kwds)
-{
-    PyObject* self = (PyObject*)PyObject_Malloc(sizeof(PyLAppModelObject));
-    PyObject_Init(self, type);
-    return self;
-}
+            csmInt32 pointCount;
+            switch (segment.SegmentType)
+            {
+            case CubismMotionSegmentType_Linear:
+            case CubismMotionSegmentType_Stepped:
+            case CubismMotionSegmentType_InverseStepped:
+                pointCount = 1;
+                break;
+            case CubismMotionSegmentType_Bezier:
+                pointCount = 3;
+                break;
+            default:
+                return false;
+            }
 
-static PyType_Slot PyLAppModel_slots[] = {
-    {Py_tp_new, (void*)PyLAppModel_new},
-    {Py_tp_init, (void*)PyLAppModel_init},
-    {Py_tp_dealloc, (void*)PyLAppModel_dealloc},
-    {Py_tp_methods, (void*)PyLAppModel_methods},
-    {0, NULL}
-};
+            for (csmInt32 k = 0; k < pointCount; k++)
+            {
+                data->Points.PushBack(CubismMotionPoint());
+                data->Points[data->Points.GetSize() - 1].Time = json.GetMotionCurveSegment(i, position + 1 + 2 * k);
+                data->Points[data->Points.GetSize() - 1].Value = json.GetMotionCurveSegment(i, position + 2 + 2 * k);
+            }
+            position += 1 + 2 * pointCount;
 
-static PyType_Spec PyLAppModel_spec = {
-    "live2d.LAppModel",
-    sizeof(PyLAppModelObject),
-    0,
-    Py_TPFLAGS_DEFAULT,
-    PyLAppModel_slots,
-};
+            data->Segments.PushBack(segment);
+            curve.SegmentCount++;
+        }
 
-static PyObject* live2d_init()
-{
-    _cubismOption.LogFunction = LAppPal::PrintLn;
-    _cubismOption.LoggingLevel = Csm::CubismFramework::Option::LogLevel_Verbose;
+        data->Curves.PushBack(curve);
+    }
 
-    Csm::CubismFramework::StartUp(&_cubismAllocator, &_cubismOption);
-    Csm::CubismFramework::Initialize();
-    Py_RETURN_NONE;
+    for (csmInt32 i = 0; i < data->EventCount; i++)
+    {
+        CubismMotionEvent event;
+        event.FireTime = json.GetEventTime(i);
+        event.Value = json.GetEventValue(i);
+        data->Events.PushBack(event);
+    }
+    return true;
 }
 
-static PyObject* live2d_dispose()
+static PyObject* OptionalFloat(bool exists, float value)
 {
-    Csm::CubismFramework::Dispose();
-    Py_RETURN_NONE;
+    if (!exists)
+    {
+        Py_RETURN_NONE;
+    }
+    return PyFloat_FromDouble(value);
 }
 
-static PyObject* live2d_glew_init()
+static PyObject* MotionDataToDict(const Csm::CubismMotionData& data, const MotionJsonMeta& meta)
 {
-    Warn("`glewInit` might be a misleading name as `glew` has been replaced with `glad` in live2d-py. Please use `glInit()` instead.");
-    if (!gladLoadGL())
+    PyObject* curves = PyList_New(data.Curves.GetSize());
+    PyObject* segments = PyList_New(data.Segments.GetSize());
+    PyObject* points = PyList_New(data.Points.GetSize());
+    PyObject* events = PyList_New(data.Events.GetSize());
+    bool ok = curves != NULL && segments != NULL && points != NULL && events != NULL;
+
+    for (Csm::csmUint32 i = 0; ok && i < data.Curves.GetSize(); i++)
     {
-        Error("Can't initilize glad.");
+        const Csm::CubismMotionCurve& curve = data.Curves[i];
+        PyObject* item = Py_BuildValue("(isffii)", static_cast<int>(curve.Type),
+                                       curve.Id->GetString().GetRawString(), curve.FadeInTime, curve.FadeOutTime,
+                                       curve.BaseSegmentIndex, curve.SegmentCount);
+        ok = item != NULL && PyList_SetItem(curves, i, item) == 0;
+    }
+    for (Csm::csmUint32 i = 0; ok && i < data.Segments.GetSize(); i++)
+    {
+        PyObject* item = Py_BuildValue("(ii)", data.Segments[i].SegmentType, data.Segments[i].BasePointIndex);
+        ok = item != NULL && PyList_SetItem(segments, i, item) == 0;
+    }
+    for (Csm::csmUint32 i = 0; ok && i < data.Points.GetSize(); i++)
+    {
+        PyObject* item = Py_BuildValue("(ff)", data.Points[i].Time, data.Points[i].Value);
+        ok = item != NULL && PyList_SetItem(points, i, item) == 0;
+    }
+    for (Csm::csmUint32 i = 0; ok && i < data.Events.GetSize(); i++)
+    {
+        PyObject* item = Py_BuildValue("(fs)", data.Events[i].FireTime, data.Events[i].Value.GetRawString());
+        ok = item != NULL && PyList_SetItem(events, i, item) == 0;
     }
-    // LAppPal::UpdateTime();
-    Py_RETURN_NONE;
-}
 
-static PyObject* live2d_glInit()
-{
-    if (!gladLoadGL())
+    if (!ok)
     {
-        Error("Can't initilize glad.");
+        Py_XDECREF(curves);
+        Py_XDECREF(segments);
+        Py_XDECREF(points);
+        Py_XDECREF(events);
+        return NULL;
     }
-    Py_RETURN_NONE;
+
+    return Py_BuildValue("{s:f,s:i,s:f,s:i,s:i,s:O,s:N,s:N,s:N,s:N,s:N,s:N}",
+                         "duration", data.Duration, "loop", static_cast<int>(data.Loop), "fps", data.Fps,
+                         "curveCount", static_cast<int>(data.CurveCount), "eventCount", data.EventCount,
+                         "beziersRestricted", meta.beziersRestricted ? Py_True : Py_False,
+                         "fadeInTime", OptionalFloat(meta.hasFadeInTime, meta.fadeInTime),
+                         "fadeOutTime", OptionalFloat(meta.hasFadeOutTime, meta.fadeOutTime),
+                         "curves", curves, "segments", segments, "points", points, "events", events);
 }
 
-static PyObject* live2d_clear_buffer(PyObject* self, PyObject* args)
+// 读取 motion3.json 的内容，tree 为真时经由 JSON 树读取，供测试对照两种读取的结果
+static PyObject* live2d_read_motion_json(PyObject* self, PyObject* args)
 {
-    // 默认为黑色
-    float r = 0.0, g = 0.0, b = 0.0, a = 0.0;
+    PyObject* buf;
+    int tree = 0;
+    if (!PyArg_ParseTuple(args, "O|p", &buf, &tree))
+    {
+        return NULL;
+    }
 
-    // 解析传入的参数，允许指定颜色
-    if (!PyArg_ParseTuple(args, "|ffff", &r, &g, &b, &a))
+    char* bytes;
+    Py_ssize_t size;
+    if (PyBytes_AsStringAndSize(buf, &bytes, &size) < 0)
     {
         return NULL;
     }
 
-    // 设置清屏颜色
-    glClearColor(r, g, b, a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glClearDepth(1.0);
+    const Csm::csmByte* buffer = reinterpret_cast<const Csm::csmByte*>(bytes);
+    Csm::CubismMotionData data;
+    MotionJsonMeta meta;
+    if (tree)
+    {
+        if (!ReadMotionJsonTree(buffer, static_cast<Csm::csmSizeInt>(size), &data, &meta))
+        {
+            PyErr_SetString(PyExc_ValueError, "invalid motion3.json");
+            return NULL;
+        }
+    }
+    else
+    {
+        Csm::CubismMotionJsonReader reader(buffer, static_cast<Csm::csmSizeInt>(size));
+        if (!reader.Read(&data))
+        {
+            PyErr_SetString(PyExc_ValueError, reader.GetError() != NULL ? reader.GetError() : "invalid motion3.json");
+            return NULL;
+        }
+        meta.beziersRestricted = reader.IsBeziersRestricted();
+        meta.hasFadeInTime = reader.IsExistMotionFadeInTime();
+        meta.fadeInTime = meta.hasFadeInTime ? reader.GetMotionFadeInTime() : 0.0f;
+        meta.hasFadeOutTime = reader.IsExistMotionFadeOutTime();
+        meta.fadeOutTime = meta.hasFadeOutTime ? reader.GetMotionFadeOutTime() : 0.0f;
+    }
 
-    Py_RETURN_NONE;
+    return MotionDataToDict(data, meta);
 }
 
-static PyObject* live2d_set_log_enable(PyObject* self, PyObject* args)
+// 返回 (formatVersion, tokens, int32s, float32s, float64s)，后四项为按本机字节序存放的 bytes
+static PyObject* live2d_v2_decode_moc(PyObject* self, PyObject* args)
 {
-    bool enable;
-    if (!PyArg_ParseTuple(args, "b", &enable))
+    PyObject* buf;
+    if (!PyArg_ParseTuple(args, "O", &buf))
     {
-        PyErr_SetString(PyExc_TypeError, "invalid param");
         return NULL;
     }
 
-    live2dLogEnable = enable;
+    char* data;
+    Py_ssize_t size;
+    if (PyBytes_AsStringAndSize(buf, &data, &size) < 0)
+    {
+        return NULL;
+    }
 
-    Py_RETURN_NONE;
-}
+    // bytes 不可变且由参数持有，解码期间可以释放 GIL
+    LAppV2MocReader reader;
+    bool ok;
+    Py_BEGIN_ALLOW_THREADS
+    ok = reader.Read(reinterpret_cast<const Csm::csmUint8*>(data), static_cast<Csm::csmSizeType>(size));
+    Py_END_ALLOW_THREADS
 
-static PyObject* live2d_log_enable(PyObject* self, PyObject* args)
-{
-    if (live2dLogEnable)
-        Py_RETURN_TRUE;
-    Py_RETURN_FALSE;
+    if (!ok)
+    {
+        PyErr_SetString(PyExc_RuntimeError, reader.GetError().c_str());
+        return NULL;
+    }
+
+    return Py_BuildValue("(iNNNN)", reader.GetFormatVersion(), VectorToBytes(reader.GetTokens()),
+                         VectorToBytes(reader.GetInt32s()), VectorToBytes(reader.GetFloat32s()),
+                         VectorToBytes(reader.GetFloat64s()));
 }
 
 // 定义live2d模块的方法
 static PyMethodDef live2d_methods[] = {
-    {"init", (PyCFunction)live2d_init, METH_VARARGS, ""},
+    {"init", (PyCFunction)live2d_init, METH_VARARGS | METH_KEYWORDS, ""},
     {"dispose", (PyCFunction)live2d_dispose, METH_VARARGS, ""},
     {"glewInit", (PyCFunction)live2d_glew_init, METH_VARARGS, ""},
     {"glInit", (PyCFunction)live2d_glew_init, METH_VARARGS, ""},
     {"clearBuffer", (PyCFunction)live2d_clear_buffer, METH_VARARGS, ""},
     {"setLogEnable", (PyCFunction)live2d_set_log_enable, METH_VARARGS, ""},
     {"logEnable", (PyCFunction)live2d_log_enable, METH_VARARGS, ""},
+    {"setLogSink", (PyCFunction)live2d_set_log_sink, METH_VARARGS, ""},
+    {"setLogLevel", (PyCFunction)live2d_set_log_level, METH_VARARGS, ""},
+    {"getLogLevel", (PyCFunction)live2d_get_log_level, METH_VARARGS, ""},
+    {"setLogRateLimit", (PyCFunction)live2d_set_log_rate_limit, METH_VARARGS, ""},
+    {"flushLog", (PyCFunction)live2d_flush_log, METH_VARARGS, ""},
+    {"getAllocatorStats", (PyCFunction)live2d_get_allocator_stats, METH_VARARGS, ""},
+    {"setAssetCacheEnable", (PyCFunction)live2d_set_asset_cache_enable, METH_VARARGS, ""},
+    {"getAssetCacheStats", (PyCFunction)live2d_get_asset_cache_stats, METH_VARARGS, ""},
+    {"updateAll", (PyCFunction)live2d_update_all, METH_VARARGS, ""},
+    {"setUpdateThreadCount", (PyCFunction)live2d_set_update_thread_count, METH_VARARGS, ""},
+    {"getUpdateThreadCount", (PyCFunction)live2d_get_update_thread_count, METH_VARARGS, ""},
+    {"_v2PackPoints", (PyCFunction)live2d_v2_pack_points, METH_VARARGS, ""},
+    {"_v2InterpolatePoints", (PyCFunction)live2d_v2_interpolate_points, METH_VARARGS, ""},
+    {"_v2TransformWarpPoints", (PyCFunction)live2d_v2_transform_warp_points, METH_VARARGS, ""},
+    {"_v2TransformAffinePoints", (PyCFunction)live2d_v2_transform_affine_points, METH_VARARGS, ""},
+    {"_v2DecodeMoc", (PyCFunction)live2d_v2_decode_moc, METH_VARARGS, ""},
+    {"_effectsSin", (PyCFunction)live2d_effects_sin, METH_VARARGS, ""},
+    {"_readMotionJson", (PyCFunction)live2d_read_motion_json, METH_VARARGS, ""},
     {NULL, NULL, 0, NULL}
 };
 
@@ -940,6 +3733,33 @@ PyMODINIT_FUNC PyInit_live2d(void)
         Py_DECREF(m);
         return NULL;
     }
+    s_lappModelType = lappmodel_type;
+
+    s_parameterPlanType = PyType_FromSpec(&PyParameterPlan_spec);
+    if (s_parameterPlanType == NULL || PyModule_AddObject(m, "ParameterPlan", s_parameterPlanType) < 0)
+    {
+        Py_XDECREF(s_parameterPlanType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    PyObject* crowdType = PyType_FromSpec(&PyCrowd_spec);
+    if (crowdType == NULL || PyModule_AddObject(m, "Crowd", crowdType) < 0)
+    {
+        Py_XDECREF(crowdType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+#ifdef LIVE2D_ARRAY_VIEW
+    s_arrayViewType = PyType_FromSpec(&PyArrayView_spec);
+    if (s_arrayViewType == NULL || PyModule_AddObject(m, "ArrayView", s_arrayViewType) < 0)
+    {
+        Py_XDECREF(s_arrayViewType);
+        Py_DECREF(m);
+        return NULL;
+    }
+#endif
 
     // assume that module `params` is already imported in `live2d/v3/__init__.py`
     module_live2d_v3_params = PyImport_AddModule("live2d.v3.params");
@@ -958,6 +3778,23 @@ PyMODINIT_FUNC PyInit_live2d(void)
         return NULL;
     }
 
+    // Python 的 sink 须在解释器销毁前移除
+    PyObject* atexitModule = PyImport_ImportModule("atexit");
+    PyObject* shutdownLog = PyCFunction_New(&live2d_shutdown_log_def, NULL);
+    PyObject* registered = NULL;
+    if (atexitModule != NULL && shutdownLog != NULL)
+    {
+        registered = PyObject_CallMethod(atexitModule, "register", "O", shutdownLog);
+    }
+    Py_XDECREF(registered);
+    Py_XDECREF(shutdownLog);
+    Py_XDECREF(atexitModule);
+    if (registered == NULL)
+    {
+        Py_DECREF(m);
+        return NULL;
+    }
+
 #ifdef CSM_TARGET_WIN_GL
     // windows 下强制utf-8
     SetConsoleOutputCP(65001);
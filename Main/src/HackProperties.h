@@ -31,5 +31,13 @@
         SetParameterValue(index, value, weight);\
         _savedParameters[index] = _parameterValues[index];\
     }\
+    void StoreAndSaveParameterValues(const int* indices, const float* values, int count)\
+    {\
+        for (int i = 0; i < count; ++i)\
+        {\
+            _parameterValues[indices[i]] = values[i];\
+            _savedParameters[indices[i]] = values[i];\
+        }\
+    }\
 
 #endif // HACKPROPERTIES_H
@@ -7,48 +7,697 @@
 
 #include "LAppAllocator.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+
 using namespace Csm;
 
+namespace {
+
+// 每个块前的头部，大小同时保证了 malloc 的默认对齐
+const csmSizeType HeaderSize = 16;
+
+enum BlockKind
+{
+    BlockKind_Heap,
+    BlockKind_Tracked,
+    BlockKind_Pool,
+    BlockKind_Arena,
+
+    BlockKind_Mask = 0x7f,
+    BlockFlag_Accounted = 0x80,  ///< 头部前还有 AccountPrefix
+};
+
+struct BlockHeader
+{
+    void* owner;          ///< BlockKind_Tracked: TrackingSite*, BlockKind_Arena: LAppArena*
+    csmUint32 size;       ///< 请求的字节数
+    csmUint16 offset;     ///< 用户指针到原始分配起点的距离
+    csmUint8 kind;        ///< BlockKind | BlockFlag_Accounted
+    csmUint8 sizeClass;   ///< BlockKind_Pool 的分级下标
+};
+
+static_assert(sizeof(BlockHeader) <= HeaderSize, "BlockHeader must fit in HeaderSize");
+
+inline BlockHeader* GetHeader(void* memory)
+{
+    return reinterpret_cast<BlockHeader*>(static_cast<csmByte*>(memory) - HeaderSize);
+}
+
+// 记入 LAppMemoryAccount 的块在头部之前另带的信息
+const csmSizeType AccountPrefixSize = 16;
+
+struct AccountPrefix
+{
+    LAppMemoryAccount* account;
+    csmInt32 category;
+};
+
+static_assert(sizeof(AccountPrefix) <= AccountPrefixSize, "AccountPrefix must fit in AccountPrefixSize");
+
+inline AccountPrefix* GetAccountPrefix(void* memory)
+{
+    return reinterpret_cast<AccountPrefix*>(static_cast<csmByte*>(memory) - HeaderSize - AccountPrefixSize);
+}
+
+inline csmByte* AlignUp(csmByte* address, csmSizeType alignment)
+{
+    const size_t value = reinterpret_cast<size_t>(address);
+    return reinterpret_cast<csmByte*>((value + alignment - 1) & ~(alignment - 1));
+}
+
+inline void WriteHeader(csmByte* raw, csmByte* user, csmSizeType size, BlockKind kind, csmUint8 sizeClass, void* owner)
+{
+    BlockHeader* header = GetHeader(user);
+    header->owner = owner;
+    header->size = static_cast<csmUint32>(size);
+    header->offset = static_cast<csmUint16>(user - raw);
+    header->kind = static_cast<csmUint8>(kind);
+    header->sizeClass = sizeClass;
+}
+
+LAppAllocator::AllocatorType s_type = LAppAllocator::AllocatorType_Default;
+
+thread_local LAppArena* t_arena = NULL;
+thread_local LAppMemoryAccount* t_account = NULL;
+thread_local csmInt32 t_category = 0;
+thread_local csmInt32 t_sharedDepth = 0;
+
+//--------- heap ------------
+
+void* AllocateFromHeap(csmSizeType size, csmUint32 alignment, csmSizeType prefixSize, BlockKind kind, void* owner)
+{
+    csmByte* raw;
+    csmByte* user;
+
+    if (alignment <= HeaderSize)
+    {
+        raw = static_cast<csmByte*>(malloc(size + prefixSize + HeaderSize));
+        if (!raw)
+        {
+            return NULL;
+        }
+        user = raw + prefixSize + HeaderSize;
+    }
+    else
+    {
+        raw = static_cast<csmByte*>(malloc(size + prefixSize + HeaderSize + alignment - 1));
+        if (!raw)
+        {
+            return NULL;
+        }
+        user = AlignUp(raw + prefixSize + HeaderSize, alignment);
+    }
+
+    WriteHeader(raw, user, size, kind, 0, owner);
+    return user;
+}
+
+inline void FreeToHeap(void* memory)
+{
+    free(static_cast<csmByte*>(memory) - GetHeader(memory)->offset);
+}
+
+//--------- pool ------------
+
+const csmUint32 PoolClassSizes[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+const csmUint32 PoolClassCount = sizeof(PoolClassSizes) / sizeof(PoolClassSizes[0]);
+const csmUint32 PoolMaxSize = 256;
+const csmSizeType PoolPageSize = 64 * 1024;
+
+struct PoolFreeBlock
+{
+    PoolFreeBlock* next;
+};
+
+// 各线程独立的空闲链表，分配和释放都不加锁。
+// 块可以在别的线程释放，此时归入释放线程的链表；页从不归还系统。
+struct PoolCache
+{
+    PoolFreeBlock* heads[PoolClassCount];
+};
+
+thread_local PoolCache t_poolCache = {};
+
+inline csmUint32 GetPoolClass(csmSizeType size)
+{
+    csmUint32 sizeClass = 0;
+    while (PoolClassSizes[sizeClass] < size)
+    {
+        ++sizeClass;
+    }
+    return sizeClass;
+}
+
+csmBool RefillPool(csmUint32 sizeClass)
+{
+    csmByte* page = static_cast<csmByte*>(malloc(PoolPageSize));
+    if (!page)
+    {
+        return false;
+    }
+
+    const csmSizeType blockSize = HeaderSize + PoolClassSizes[sizeClass];
+    const csmSizeType blockCount = PoolPageSize / blockSize;
+
+    PoolFreeBlock* head = t_poolCache.heads[sizeClass];
+    for (csmSizeType i = blockCount; i > 0; --i)
+    {
+        PoolFreeBlock* block = reinterpret_cast<PoolFreeBlock*>(page + (i - 1) * blockSize);
+        block->next = head;
+        head = block;
+    }
+    t_poolCache.heads[sizeClass] = head;
+
+    return true;
+}
+
+void* AllocateFromPool(csmSizeType size, csmSizeType prefixSize)
+{
+    const csmUint32 sizeClass = GetPoolClass(size + prefixSize);
+
+    if (!t_poolCache.heads[sizeClass] && !RefillPool(sizeClass))
+    {
+        return NULL;
+    }
+
+    PoolFreeBlock* block = t_poolCache.heads[sizeClass];
+    t_poolCache.heads[sizeClass] = block->next;
+
+    csmByte* raw = reinterpret_cast<csmByte*>(block);
+    csmByte* user = raw + prefixSize + HeaderSize;
+    WriteHeader(raw, user, size, BlockKind_Pool, static_cast<csmUint8>(sizeClass), NULL);
+    return user;
+}
+
+inline void FreeToPool(void* memory)
+{
+    const csmUint32 sizeClass = GetHeader(memory)->sizeClass;
+    PoolFreeBlock* block = reinterpret_cast<PoolFreeBlock*>(static_cast<csmByte*>(memory) - GetHeader(memory)->offset);
+    block->next = t_poolCache.heads[sizeClass];
+    t_poolCache.heads[sizeClass] = block;
+}
+
+//--------- tracking ------------
+
+struct TrackingSite
+{
+    const csmChar* fileName;
+    csmInt32 lineNumber;
+    std::atomic<csmUint64> allocations;
+    std::atomic<csmUint64> liveCount;
+    std::atomic<csmUint64> liveBytes;
+};
+
+std::mutex s_siteMutex;
+std::map<std::pair<const csmChar*, csmInt32>, TrackingSite*> s_sites;
+
+std::atomic<csmUint64> s_liveBytes(0);
+std::atomic<csmUint64> s_peakBytes(0);
+std::atomic<csmUint64> s_allocations(0);
+std::atomic<csmUint64> s_deallocations(0);
+
+TrackingSite* FindSite(const csmChar* fileName, csmInt32 lineNumber)
+{
+    std::lock_guard<std::mutex> lock(s_siteMutex);
+
+    TrackingSite*& site = s_sites[std::make_pair(fileName, lineNumber)];
+    if (!site)
+    {
+        // 调用点在进程内一直有效，块头部直接引用它
+        site = new TrackingSite();
+        site->fileName = fileName;
+        site->lineNumber = lineNumber;
+        site->allocations = 0;
+        site->liveCount = 0;
+        site->liveBytes = 0;
+    }
+    return site;
+}
+
+void* AllocateTracked(csmSizeType size, csmUint32 alignment, csmSizeType prefixSize, const csmChar* fileName, csmInt32 lineNumber)
+{
+    TrackingSite* site = FindSite(fileName, lineNumber);
+    void* memory = AllocateFromHeap(size, alignment, prefixSize, BlockKind_Tracked, site);
+    if (!memory)
+    {
+        return NULL;
+    }
+
+    site->allocations.fetch_add(1, std::memory_order_relaxed);
+    site->liveCount.fetch_add(1, std::memory_order_relaxed);
+    site->liveBytes.fetch_add(size, std::memory_order_relaxed);
+
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    const csmUint64 live = s_liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    csmUint64 peak = s_peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !s_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+
+    return memory;
+}
+
+void FreeTracked(void* memory)
+{
+    const BlockHeader* header = GetHeader(memory);
+    TrackingSite* site = static_cast<TrackingSite*>(header->owner);
+
+    site->liveCount.fetch_sub(1, std::memory_order_relaxed);
+    site->liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    s_liveBytes.fetch_sub(header->size, std::memory_order_relaxed);
+    s_deallocations.fetch_add(1, std::memory_order_relaxed);
+
+    FreeToHeap(memory);
+}
+
+const csmSizeType ArenaChunkSize = 64 * 1024;
+const csmSizeType ArenaChunkHeaderSize = 32;
+
+}
+
+struct LAppArena::Chunk
+{
+    Chunk* next;
+    csmSizeType capacity;
+    csmSizeType used;
+
+    csmByte* GetData()
+    {
+        return reinterpret_cast<csmByte*>(this) + ArenaChunkHeaderSize;
+    }
+};
+
+//--------- LAppArena ------------
+
+LAppArena::LAppArena()
+    : _chunks(NULL), _references(1), _reservedBytes(0), _usedBytes(0)
+{
+    static_assert(sizeof(Chunk) <= ArenaChunkHeaderSize, "Chunk must fit in ArenaChunkHeaderSize");
+}
+
+LAppArena::~LAppArena()
+{
+    while (_chunks)
+    {
+        Chunk* next = _chunks->next;
+        free(_chunks);
+        _chunks = next;
+    }
+}
+
+void* LAppArena::Allocate(csmSizeType size, csmUint32 alignment, csmSizeType prefixSize)
+{
+    if (alignment < HeaderSize)
+    {
+        alignment = HeaderSize;
+    }
+
+    Chunk* chunk = _chunks;
+    csmByte* start = NULL;
+    csmByte* user = NULL;
+
+    if (chunk)
+    {
+        start = chunk->GetData() + chunk->used;
+        user = AlignUp(start + prefixSize + HeaderSize, alignment);
+        if (user + size > chunk->GetData() + chunk->capacity)
+        {
+            chunk = NULL;
+        }
+    }
+
+    if (!chunk)
+    {
+        const csmSizeType required = size + prefixSize + HeaderSize + alignment;
+        const csmSizeType capacity = required > ArenaChunkSize / 4 ? required : ArenaChunkSize;
+
+        chunk = static_cast<Chunk*>(malloc(ArenaChunkHeaderSize + capacity));
+        if (!chunk)
+        {
+            return NULL;
+        }
+        chunk->capacity = capacity;
+        chunk->used = 0;
+        _reservedBytes.fetch_add(ArenaChunkHeaderSize + capacity, std::memory_order_relaxed);
+
+        // 大块单独成块并挂在当前块之后，不打断当前块的顺序分配
+        if (_chunks && capacity != ArenaChunkSize)
+        {
+            chunk->next = _chunks->next;
+            _chunks->next = chunk;
+        }
+        else
+        {
+            chunk->next = _chunks;
+            _chunks = chunk;
+        }
+
+        start = chunk->GetData();
+        user = AlignUp(start + prefixSize + HeaderSize, alignment);
+    }
+
+    const csmSizeType used = static_cast<csmSizeType>(user + size - chunk->GetData());
+    _usedBytes.fetch_add(used - chunk->used, std::memory_order_relaxed);
+    chunk->used = used;
+
+    WriteHeader(start, user, size, BlockKind_Arena, 0, this);
+    _references.fetch_add(1, std::memory_order_relaxed);
+    return user;
+}
+
+void LAppArena::Free(void* memory)
+{
+    // 只有正在向本 arena 分配的线程才能回退指针，其他线程只减少计数
+    if (t_arena == this && _chunks)
+    {
+        const BlockHeader* header = GetHeader(memory);
+        csmByte* user = static_cast<csmByte*>(memory);
+        csmByte* top = _chunks->GetData() + _chunks->used;
+
+        if (user + header->size == top)
+        {
+            const csmSizeType used = static_cast<csmSizeType>(user - header->offset - _chunks->GetData());
+            _usedBytes.fetch_sub(_chunks->used - used, std::memory_order_relaxed);
+            _chunks->used = used;
+        }
+    }
+
+    Unreference();
+}
+
+void LAppArena::Unreference()
+{
+    if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
+void LAppArena::Release()
+{
+    Unreference();
+}
+
+csmSizeType LAppArena::GetReservedBytes() const
+{
+    return _reservedBytes.load(std::memory_order_relaxed);
+}
+
+csmSizeType LAppArena::GetUsedBytes() const
+{
+    return _usedBytes.load(std::memory_order_relaxed);
+}
+
+//--------- LAppAllocator ------------
+
+LAppAllocator::ArenaScope::ArenaScope(LAppArena* arena)
+    : _previous(t_arena)
+{
+    if (arena)
+    {
+        t_arena = arena;
+    }
+}
+
+LAppAllocator::ArenaScope::~ArenaScope()
+{
+    t_arena = _previous;
+}
+
+LAppAllocator::AccountScope::AccountScope(LAppMemoryAccount* account, csmInt32 category)
+    : _previousAccount(t_account), _previousCategory(t_category)
+{
+    if (account)
+    {
+        t_account = account;
+        t_category = category;
+    }
+}
+
+LAppAllocator::AccountScope::~AccountScope()
+{
+    t_account = _previousAccount;
+    t_category = _previousCategory;
+}
+
+void LAppAllocator::SetType(AllocatorType type)
+{
+    s_type = type;
+}
+
+LAppAllocator::AllocatorType LAppAllocator::GetType()
+{
+    return s_type;
+}
+
+csmBool LAppAllocator::ParseType(const csmChar* name, AllocatorType* outType)
+{
+    const AllocatorType types[] = { AllocatorType_Default, AllocatorType_Pool, AllocatorType_Arena, AllocatorType_Tracking };
+
+    for (csmUint32 i = 0; i < sizeof(types) / sizeof(types[0]); ++i)
+    {
+        if (strcmp(name, GetTypeName(types[i])) == 0)
+        {
+            *outType = types[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+const csmChar* LAppAllocator::GetTypeName(AllocatorType type)
+{
+    switch (type)
+    {
+    case AllocatorType_Pool:
+        return "pool";
+    case AllocatorType_Arena:
+        return "arena";
+    case AllocatorType_Tracking:
+        return "tracking";
+    default:
+        return "default";
+    }
+}
+
+LAppArena* LAppAllocator::CreateArena()
+{
+    if (s_type != AllocatorType_Arena)
+    {
+        return NULL;
+    }
+    return new LAppArena();
+}
+
+void LAppAllocator::GetStats(Stats* outStats)
+{
+    outStats->liveBytes = s_liveBytes.load(std::memory_order_relaxed);
+    outStats->peakBytes = s_peakBytes.load(std::memory_order_relaxed);
+    outStats->allocations = s_allocations.load(std::memory_order_relaxed);
+    outStats->deallocations = s_deallocations.load(std::memory_order_relaxed);
+}
+
+void LAppAllocator::GetSiteStats(std::vector<SiteStats>& outStats)
+{
+    outStats.clear();
+
+    std::lock_guard<std::mutex> lock(s_siteMutex);
+
+    for (std::map<std::pair<const csmChar*, csmInt32>, TrackingSite*>::const_iterator iter = s_sites.begin(); iter != s_sites.end(); ++iter)
+    {
+        const TrackingSite* site = iter->second;
+        SiteStats stats;
+        stats.fileName = site->fileName;
+        stats.lineNumber = site->lineNumber;
+        stats.allocations = site->allocations.load(std::memory_order_relaxed);
+        stats.liveCount = site->liveCount.load(std::memory_order_relaxed);
+        stats.liveBytes = site->liveBytes.load(std::memory_order_relaxed);
+        outStats.push_back(stats);
+    }
+
+    std::sort(outStats.begin(), outStats.end(), [](const SiteStats& a, const SiteStats& b) {
+        return a.liveBytes > b.liveBytes;
+    });
+}
+
+void* LAppAllocator::AllocateBlock(csmSizeType size, csmUint32 alignment, const csmChar* fileName, csmInt32 lineNumber)
+{
+    const csmBool shared = t_sharedDepth > 0;
+    LAppMemoryAccount* account = shared ? NULL : t_account;
+    const csmSizeType prefixSize = account ? AccountPrefixSize : 0;
+
+    void* memory = NULL;
+
+    if (t_arena && !shared)
+    {
+        memory = t_arena->Allocate(size, alignment, prefixSize);
+    }
+    else if (s_type == AllocatorType_Pool && size + prefixSize <= PoolMaxSize && alignment <= HeaderSize)
+    {
+        memory = AllocateFromPool(size, prefixSize);
+    }
+    else if (s_type == AllocatorType_Tracking)
+    {
+        memory = AllocateTracked(size, alignment, prefixSize, fileName, lineNumber);
+    }
+    else
+    {
+        memory = AllocateFromHeap(size, alignment, prefixSize, BlockKind_Heap, NULL);
+    }
+
+    if (memory && account)
+    {
+        account->Attach(memory, t_category);
+    }
+
+    return memory;
+}
+
 void* LAppAllocator::Allocate(const csmSizeType  size)
 {
-    return malloc(size);
+    return AllocateBlock(size, 0, NULL, 0);
 }
 
 void LAppAllocator::Deallocate(void* memory)
 {
-    free(memory);
+    if (!memory)
+    {
+        return;
+    }
+
+    BlockHeader* header = GetHeader(memory);
+
+    if (header->kind & BlockFlag_Accounted)
+    {
+        GetAccountPrefix(memory)->account->Detach(memory);
+    }
+
+    switch (header->kind & BlockKind_Mask)
+    {
+    case BlockKind_Pool:
+        FreeToPool(memory);
+        break;
+    case BlockKind_Arena:
+        static_cast<LAppArena*>(header->owner)->Free(memory);
+        break;
+    case BlockKind_Tracked:
+        FreeTracked(memory);
+        break;
+    default:
+        FreeToHeap(memory);
+        break;
+    }
 }
 
 void* LAppAllocator::AllocateAligned(const csmSizeType size, const csmUint32 alignment)
 {
-    size_t offset, shift, alignedAddress;
-    void* allocation;
-    void** preamble;
+    return AllocateBlock(size, alignment, NULL, 0);
+}
+
+void LAppAllocator::DeallocateAligned(void* alignedMemory)
+{
+    // 对齐块与普通块共用同一种头部
+    Deallocate(alignedMemory);
+}
 
-    offset = alignment - 1 + sizeof(void*);
+void* LAppAllocator::AllocateWithSource(const csmSizeType size, const csmChar* fileName, csmInt32 lineNumber)
+{
+    return AllocateBlock(size, 0, fileName, lineNumber);
+}
 
-    allocation = Allocate(size + static_cast<csmUint32>(offset));
+void* LAppAllocator::AllocateAlignedWithSource(const csmSizeType size, const csmUint32 alignment, const csmChar* fileName, csmInt32 lineNumber)
+{
+    return AllocateBlock(size, alignment, fileName, lineNumber);
+}
 
-    alignedAddress = reinterpret_cast<size_t>(allocation) + sizeof(void*);
+void LAppAllocator::BeginSharedAllocation()
+{
+    ++t_sharedDepth;
+}
 
-    shift = alignedAddress % alignment;
+void LAppAllocator::EndSharedAllocation()
+{
+    --t_sharedDepth;
+}
 
-    if (shift)
+//--------- LAppMemoryAccount ------------
+
+LAppMemoryAccount::LAppMemoryAccount()
+    : _references(1)
+{
+    for (csmInt32 i = 0; i < Category_Count; ++i)
     {
-        alignedAddress += (alignment - shift);
+        _bytes[i] = 0;
     }
+}
 
-    preamble = reinterpret_cast<void**>(alignedAddress);
-    preamble[-1] = allocation;
+LAppMemoryAccount* LAppMemoryAccount::Create()
+{
+    return new LAppMemoryAccount();
+}
 
-    return reinterpret_cast<void*>(alignedAddress);
+const csmChar* LAppMemoryAccount::GetCategoryName(csmInt32 category)
+{
+    switch (category)
+    {
+    case Category_Model:
+        return "model";
+    case Category_Motions:
+        return "motions";
+    case Category_Expressions:
+        return "expressions";
+    case Category_Physics:
+        return "physics";
+    case Category_Pose:
+        return "pose";
+    case Category_UserData:
+        return "userData";
+    case Category_Renderer:
+        return "renderer";
+    default:
+        return "other";
+    }
 }
 
-void LAppAllocator::DeallocateAligned(void* alignedMemory)
+void LAppMemoryAccount::Release()
+{
+    Unreference();
+}
+
+csmInt64 LAppMemoryAccount::GetBytes(csmInt32 category) const
+{
+    return _bytes[category].load(std::memory_order_relaxed);
+}
+
+void LAppMemoryAccount::Attach(void* memory, csmInt32 category)
+{
+    BlockHeader* header = GetHeader(memory);
+    AccountPrefix* prefix = GetAccountPrefix(memory);
+
+    prefix->account = this;
+    prefix->category = category;
+    header->kind |= BlockFlag_Accounted;
+
+    _bytes[category].fetch_add(header->size, std::memory_order_relaxed);
+    _references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LAppMemoryAccount::Detach(void* memory)
 {
-    void** preamble;
+    const AccountPrefix* prefix = GetAccountPrefix(memory);
 
-    preamble = static_cast<void**>(alignedMemory);
+    _bytes[prefix->category].fetch_sub(GetHeader(memory)->size, std::memory_order_relaxed);
+    Unreference();
+}
 
-    Deallocate(preamble[-1]);
+void LAppMemoryAccount::Unreference()
+{
+    if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
 }
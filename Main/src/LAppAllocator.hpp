@@ -10,15 +10,128 @@
 #include <CubismFramework.hpp>
 #include <ICubismAllocator.hpp>
 
+#include <atomic>
+#include <vector>
+
+class LAppArena;
+class LAppMemoryAccount;
+
 /**
 * @brief メモリアロケーションを実装するクラス。
 *
 * メモリ確保・解放処理のインターフェースの実装。
 * フレームワークから呼び出される。
 *
+* 所有するブロックの前に 16 バイトのヘッダを置き、解放時はヘッダに記録された
+* 確保元へ戻す。そのため途中で AllocatorType を切り替えても既存のブロックは正しく解放される。
 */
 class LAppAllocator : public Csm::ICubismAllocator
 {
+public:
+    /**
+    * @brief 分配器后端
+    */
+    enum AllocatorType
+    {
+        AllocatorType_Default,  ///< malloc/free
+        AllocatorType_Pool,     ///< 线程本地的分级内存池，用于大量的小块分配
+        AllocatorType_Arena,    ///< 每个模型一块 arena，加载期间的分配在模型销毁时整体释放
+        AllocatorType_Tracking, ///< malloc/free，并统计存活字节数、峰值及各调用点的分配次数
+    };
+
+    /**
+    * @brief 全局分配统计，仅在 AllocatorType_Tracking 下累计
+    */
+    struct Stats
+    {
+        Csm::csmUint64 liveBytes;
+        Csm::csmUint64 peakBytes;
+        Csm::csmUint64 allocations;
+        Csm::csmUint64 deallocations;
+    };
+
+    /**
+    * @brief 单个调用点的分配统计
+    *
+    * 调用点来自 CSM_DEBUG_MEMORY_LEAKING 下 CSM_MALLOC 传入的 __FILE__/__LINE__，
+    * 未定义时所有分配都计入 fileName 为 NULL 的同一项。
+    */
+    struct SiteStats
+    {
+        const Csm::csmChar* fileName;
+        Csm::csmInt32 lineNumber;
+        Csm::csmUint64 allocations;
+        Csm::csmUint64 liveCount;
+        Csm::csmUint64 liveBytes;
+    };
+
+    /**
+    * @brief 在作用域内把当前线程的分配放入指定的 arena
+    *
+    * arena 为 NULL 时不做任何事。可以嵌套。
+    */
+    class ArenaScope
+    {
+    public:
+        explicit ArenaScope(LAppArena* arena);
+        ~ArenaScope();
+
+    private:
+        ArenaScope(const ArenaScope&);
+        ArenaScope& operator=(const ArenaScope&);
+
+        LAppArena* _previous;
+    };
+
+    /**
+    * @brief 在作用域内把当前线程的分配记入指定账户的某一类别
+    *
+    * account 为 NULL 时不做任何事。可以嵌套，最内层的类别生效。
+    */
+    class AccountScope
+    {
+    public:
+        AccountScope(LAppMemoryAccount* account, Csm::csmInt32 category);
+        ~AccountScope();
+
+    private:
+        AccountScope(const AccountScope&);
+        AccountScope& operator=(const AccountScope&);
+
+        LAppMemoryAccount* _previousAccount;
+        Csm::csmInt32 _previousCategory;
+    };
+
+    /**
+    * @brief 设置分配器后端，须在 CubismFramework::StartUp 之前调用
+    */
+    static void SetType(AllocatorType type);
+
+    static AllocatorType GetType();
+
+    /**
+    * @brief 把 "default" / "pool" / "arena" / "tracking" 解析为 AllocatorType
+    *
+    * @return 名称无效时返回 false
+    */
+    static Csm::csmBool ParseType(const Csm::csmChar* name, AllocatorType* outType);
+
+    static const Csm::csmChar* GetTypeName(AllocatorType type);
+
+    /**
+    * @brief 为模型创建 arena，当前后端不是 AllocatorType_Arena 时返回 NULL
+    *
+    * 返回的 arena 用 LAppArena::Release() 释放。
+    */
+    static LAppArena* CreateArena();
+
+    static void GetStats(Stats* outStats);
+
+    /**
+    * @brief 取得各调用点的统计，按存活字节数降序
+    */
+    static void GetSiteStats(std::vector<SiteStats>& outStats);
+
     /**
     * @brief  メモリ領域を割り当てる。
     *
@@ -49,4 +162,109 @@ class LAppAllocator : public Csm::ICubismAllocator
     * @param[in]   alignedMemory    解放するメモリ。
     */
     void DeallocateAligned(void* alignedMemory);
+
+    void* AllocateWithSource(const Csm::csmSizeType size, const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+
+    void* AllocateAlignedWithSource(const Csm::csmSizeType size, const Csm::csmUint32 alignment, const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+
+    void BeginSharedAllocation();
+
+    void EndSharedAllocation();
+
+private:
+    static void* AllocateBlock(Csm::csmSizeType size, Csm::csmUint32 alignment, const Csm::csmChar* fileName, Csm::csmInt32 lineNumber);
+};
+
+/**
+* @brief 模型加载期间使用的 bump 分配区
+*
+* 在 LAppAllocator::ArenaScope 内发生的分配从这里顺序切出，单独释放时只减少计数，
+* 若恰好是最后一块则回退指针。所有者调用 Release() 且所有块都已释放后，整块内存一次性归还。
+* 仍被全局对象引用的块（例如 CubismJson 的错误字符串）会让 arena 延迟到它们释放后再归还，
+* 因此不会产生悬空指针。
+*/
+class LAppArena
+{
+public:
+    /**
+    * @brief 所有者放弃 arena
+    */
+    void Release();
+
+    /**
+    * @brief 已向系统申请的字节数
+    */
+    Csm::csmSizeType GetReservedBytes() const;
+
+    /**
+    * @brief 已切出的字节数（含头部与对齐填充）
+    */
+    Csm::csmSizeType GetUsedBytes() const;
+
+private:
+    friend class LAppAllocator;
+
+    struct Chunk;
+
+    LAppArena();
+    ~LAppArena();
+
+    void* Allocate(Csm::csmSizeType size, Csm::csmUint32 alignment, Csm::csmSizeType prefixSize);
+    void Free(void* memory);
+    void Unreference();
+
+    Chunk* _chunks;
+    std::atomic<Csm::csmUint32> _references;  ///< 存活块数 + 所有者持有的 1
+    std::atomic<Csm::csmSizeType> _reservedBytes;
+    std::atomic<Csm::csmSizeType> _usedBytes;
+};
+
+/**
+* @brief 按类别统计某个模型持有的字节数
+*
+* 在 LAppAllocator::AccountScope 内分配的块会在头部前多带 16 字节，记下账户和类别，
+* 释放时从对应类别扣除，因此统计的是实际仍存活的分配，而不是估算值。
+* 与 LAppArena 一样按引用计数释放，所有者析构后仍存活的块不会访问到已释放的账户。
+*/
+class LAppMemoryAccount
+{
+public:
+    enum Category
+    {
+        Category_Other,        ///< 模型设置、眨眼、呼吸等其余部分
+        Category_Model,        ///< CubismMoc 与 CubismModel
+        Category_Motions,
+        Category_Expressions,
+        Category_Physics,
+        Category_Pose,
+        Category_UserData,
+        Category_Renderer,     ///< 渲染器及其裁剪管理器
+        Category_Count,
+    };
+
+    static LAppMemoryAccount* Create();
+
+    static const Csm::csmChar* GetCategoryName(Csm::csmInt32 category);
+
+    /**
+    * @brief 所有者放弃账户
+    */
+    void Release();
+
+    /**
+    * @brief 该类别当前存活的字节数
+    */
+    Csm::csmInt64 GetBytes(Csm::csmInt32 category) const;
+
+private:
+    friend class LAppAllocator;
+
+    LAppMemoryAccount();
+
+    void Attach(void* memory, Csm::csmInt32 category);
+    void Detach(void* memory);
+    void Unreference();
+
+    std::atomic<Csm::csmInt64> _bytes[Category_Count];
+    std::atomic<Csm::csmUint32> _references;  ///< 存活块数 + 所有者持有的 1
 };
@@ -0,0 +1,814 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppAssetCache.hpp"
+
+#include <Model/CubismMoc.hpp>
+#include <Motion/CubismMotion.hpp>
+#include <Motion/CubismExpressionMotion.hpp>
+#include <Physics/CubismPhysics.hpp>
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__APPLE__)
+#include <OpenGL/OpenGL.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include "LAppPal.hpp"
+#include "Log.hpp"
+
+using namespace Live2D::Cubism::Framework;
+
+namespace
+{
+    enum AssetKind
+    {
+        AssetKind_Moc,
+        AssetKind_Motion,
+        AssetKind_Expression,
+        AssetKind_Physics,
+    };
+
+    struct Entry
+    {
+        AssetKind kind;
+        std::string key;        ///< 为空表示未登记到 _entries（缓存关闭时加载的资源）
+        void* asset;
+        Csm::csmInt32 users;
+    };
+
+    struct TextureEntry
+    {
+        std::string key;
+        Csm::csmInt32 width;
+        Csm::csmInt32 height;
+        Csm::csmInt32 users;
+    };
+
+    typedef std::pair<const void*, Csm::csmUint32> TextureName;  ///< GL 上下文 + 纹理 ID
+
+    /**
+    * @brief 文件的修改时间与大小，与上次相同时直接沿用上次算出的内容键，不再读入文件
+    */
+    struct FileStamp
+    {
+        long long modified;
+        Csm::csmUint64 size;
+        std::string contentKey;
+    };
+
+    std::mutex s_mutex;
+    bool s_enabled = true;
+    std::map<std::string, FileStamp> s_fileStamps;  ///< 路径键 -> 上次读入时的文件状态与内容键
+    std::map<std::string, Entry*> s_entries;
+    std::map<const void*, Entry*> s_entriesByAsset;
+    std::map<std::string, TextureName> s_textureKeys;
+    std::map<TextureName, TextureEntry> s_textures;
+    Csm::csmUint64 s_hits = 0;
+    Csm::csmUint64 s_misses = 0;
+
+    /**
+    * @brief 按 8 字节读入的 FNV-1a，只用于区分同一路径下内容是否变化
+    */
+    Csm::csmUint64 HashBytes(const Csm::csmByte* data, Csm::csmSizeInt size)
+    {
+        const Csm::csmUint64 prime = 1099511628211ULL;
+        Csm::csmUint64 hash = 14695981039346656037ULL ^ size;
+
+        Csm::csmSizeInt i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            Csm::csmUint64 word;
+            memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; ++i)
+        {
+            hash = (hash ^ data[i]) * prime;
+        }
+
+        return hash;
+    }
+
+    std::string MakePathKey(char kind, const std::string& path)
+    {
+        std::error_code error;
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(std::filesystem::u8path(path), error);
+        std::string key(1, kind);
+        key += error ? path : canonical.generic_u8string();
+        return key;
+    }
+
+    std::string MakeContentKey(const std::string& pathKey, const Csm::csmByte* data, Csm::csmSizeInt size)
+    {
+        char hash[24];
+        snprintf(hash, sizeof(hash), "#%016llx", static_cast<unsigned long long>(HashBytes(data, size)));
+        return pathKey + hash;
+    }
+
+    /**
+    * @brief 取得文件的修改时间与大小，失败时返回 false，此时总是读入文件
+    */
+    bool StatFile(const std::string& path, FileStamp* outStamp)
+    {
+        std::error_code error;
+        const std::filesystem::path file = std::filesystem::u8path(path);
+        const std::filesystem::file_time_type modified = std::filesystem::last_write_time(file, error);
+        if (error)
+        {
+            return false;
+        }
+        const std::uintmax_t size = std::filesystem::file_size(file, error);
+        if (error)
+        {
+            return false;
+        }
+
+        outStamp->modified = static_cast<long long>(modified.time_since_epoch().count());
+        outStamp->size = static_cast<Csm::csmUint64>(size);
+        return true;
+    }
+
+    /**
+    * @brief 文件状态与上次读入时相同时返回当时的内容键，否则返回空串。须持有 s_mutex
+    */
+    std::string FindContentKey(const std::string& pathKey, bool stamped, const FileStamp& stamp)
+    {
+        if (!stamped)
+        {
+            return std::string();
+        }
+
+        std::map<std::string, FileStamp>::const_iterator it = s_fileStamps.find(pathKey);
+        if (it == s_fileStamps.end() || it->second.modified != stamp.modified || it->second.size != stamp.size)
+        {
+            return std::string();
+        }
+        return it->second.contentKey;
+    }
+
+    /**
+    * @brief 记下读入时的文件状态，之后文件未变化时不再读入与计算哈希。须持有 s_mutex
+    */
+    void RecordContentKey(const std::string& pathKey, bool stamped, const FileStamp& stamp, const std::string& contentKey)
+    {
+        if (!stamped)
+        {
+            s_fileStamps.erase(pathKey);
+            return;
+        }
+
+        FileStamp& record = s_fileStamps[pathKey];
+        record.modified = stamp.modified;
+        record.size = stamp.size;
+        record.contentKey = contentKey;
+    }
+
+    /**
+    * @brief 当前线程的 GL 上下文句柄，纹理只在同一上下文内共享
+    */
+    const void* GetCurrentContext()
+    {
+#if defined(_WIN32)
+        return wglGetCurrentContext();
+#elif defined(__APPLE__)
+        return CGLGetCurrentContext();
+#else
+        typedef void* (*GetContextFunc)();
+        static GetContextFunc glxGetCurrentContext = NULL;
+        static GetContextFunc eglGetCurrentContext = NULL;
+        static bool resolved = false;
+
+        if (!resolved)
+        {
+            // 只查找已被加载的库，不主动引入 GLX 或 EGL
+            void* glx = dlopen("libGL.so.1", RTLD_LAZY | RTLD_NOLOAD);
+            void* egl = dlopen("libEGL.so.1", RTLD_LAZY | RTLD_NOLOAD);
+            glxGetCurrentContext = reinterpret_cast<GetContextFunc>(glx ? dlsym(glx, "glXGetCurrentContext") : NULL);
+            eglGetCurrentContext = reinterpret_cast<GetContextFunc>(egl ? dlsym(egl, "eglGetCurrentContext") : NULL);
+            resolved = true;
+        }
+
+        void* context = glxGetCurrentContext ? glxGetCurrentContext() : NULL;
+        if (context == NULL && eglGetCurrentContext != NULL)
+        {
+            context = eglGetCurrentContext();
+        }
+        return context;
+#endif
+    }
+
+    void DestroyAsset(AssetKind kind, void* asset)
+    {
+        switch (kind)
+        {
+        case AssetKind_Moc:
+            CubismMoc::Delete(static_cast<CubismMoc*>(asset));
+            break;
+        case AssetKind_Motion:
+        case AssetKind_Expression:
+            ACubismMotion::Delete(static_cast<ACubismMotion*>(asset));
+            break;
+        case AssetKind_Physics:
+            CubismPhysics::Delete(static_cast<CubismPhysics*>(asset));
+            break;
+        }
+    }
+
+    /**
+    * @brief 读入的文件内容，mapped 为 true 时来自 LAppPal::MapFile
+    */
+    struct FileSource
+    {
+        Csm::csmByte* data;
+        Csm::csmSizeInt size;
+        bool mapped;
+
+        void Release()
+        {
+            if (mapped)
+            {
+                LAppPal::UnmapFile(data, size);
+            }
+            else
+            {
+                LAppPal::ReleaseBytes(data);
+            }
+            data = NULL;
+        }
+    };
+
+    void UnmapMoc(void* buffer, Csm::csmSizeInt size, void* userData)
+    {
+        LAppPal::UnmapFile(static_cast<Csm::csmByte*>(buffer), size);
+    }
+
+    /**
+    * @brief 按文件查找，未命中时在锁外解析，再重新检查是否已被其他线程登记
+    *
+    * 文件的修改时间与大小与上次读入时相同则直接按上次的内容键查找，不读入文件；
+    * 否则读入并计算哈希，因此文件被替换后会作为新资源加载。
+    * parse 可以接管 source 的内存，此时须把 source.data 置为 NULL。
+    * 同一文件以不同方式解析时用 variant 区分缓存项。
+    */
+    template <class T, class Parse>
+    T* Acquire(AssetKind kind, char tag, const std::string& path, bool map, Parse parse,
+               const std::string& variant = std::string())
+    {
+        const std::string pathKey = MakePathKey(tag, path) + variant;
+        FileStamp stamp;
+        const bool stamped = StatFile(path, &stamp);
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (s_enabled)
+            {
+                std::map<std::string, Entry*>::iterator it = s_entries.find(FindContentKey(pathKey, stamped, stamp));
+                if (it != s_entries.end())
+                {
+                    ++it->second->users;
+                    ++s_hits;
+                    return static_cast<T*>(it->second->asset);
+                }
+            }
+        }
+
+        FileSource source = { NULL, 0, false };
+        if (map)
+        {
+            source.data = LAppPal::MapFile(path, &source.size);
+            source.mapped = source.data != NULL;
+        }
+        if (source.data == NULL)
+        {
+            source.data = LAppPal::LoadFileAsBytes(path, &source.size);
+        }
+        if (source.data == NULL)
+        {
+            return NULL;
+        }
+
+        std::string key = MakeContentKey(pathKey, source.data, source.size);
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (!s_enabled)
+            {
+                key.clear();
+            }
+            else
+            {
+                RecordContentKey(pathKey, stamped, stamp, key);
+                std::map<std::string, Entry*>::iterator it = s_entries.find(key);
+                if (it != s_entries.end())
+                {
+                    ++it->second->users;
+                    ++s_hits;
+                    source.Release();
+                    return static_cast<T*>(it->second->asset);
+                }
+            }
+            ++s_misses;
+        }
+
+        CubismFramework::BeginSharedAllocation();
+        T* asset = parse(source);
+        CubismFramework::EndSharedAllocation();
+        if (source.data != NULL)
+        {
+            source.Release();
+        }
+
+        if (asset == NULL)
+        {
+            return NULL;
+        }
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        if (!key.empty())
+        {
+            std::map<std::string, Entry*>::iterator it = s_entries.find(key);
+            if (it != s_entries.end())
+            {
+                ++it->second->users;
+                DestroyAsset(kind, asset);
+                return static_cast<T*>(it->second->asset);
+            }
+        }
+
+        Entry* entry = new Entry();
+        entry->kind = kind;
+        entry->key = key;
+        entry->asset = asset;
+        entry->users = 1;
+
+        if (!key.empty())
+        {
+            s_entries[key] = entry;
+        }
+        s_entriesByAsset[asset] = entry;
+
+        return asset;
+    }
+}
+
+void LAppAssetCache::SetEnable(bool enable)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_enabled = enable;
+
+    if (!enable)
+    {
+        // 已登记的资源不再被新的模型找到，仍由现有使用者持有到释放为止
+        for (std::map<std::string, Entry*>::iterator it = s_entries.begin(); it != s_entries.end(); ++it)
+        {
+            it->second->key.clear();
+        }
+        s_entries.clear();
+        s_fileStamps.clear();
+
+        for (std::map<TextureName, TextureEntry>::iterator it = s_textures.begin(); it != s_textures.end(); ++it)
+        {
+            it->second.key.clear();
+        }
+        s_textureKeys.clear();
+    }
+}
+
+bool LAppAssetCache::IsEnabled()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_enabled;
+}
+
+void LAppAssetCache::GetStats(Stats* outStats)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    memset(outStats, 0, sizeof(Stats));
+    for (std::map<const void*, Entry*>::const_iterator it = s_entriesByAsset.begin(); it != s_entriesByAsset.end(); ++it)
+    {
+        switch (it->second->kind)
+        {
+        case AssetKind_Moc:
+            ++outStats->mocs;
+            break;
+        case AssetKind_Motion:
+            ++outStats->motions;
+            break;
+        case AssetKind_Expression:
+            ++outStats->expressions;
+            break;
+        case AssetKind_Physics:
+            ++outStats->physics;
+            break;
+        }
+    }
+    outStats->textures = static_cast<Csm::csmInt32>(s_textures.size());
+    outStats->hits = s_hits;
+    outStats->misses = s_misses;
+}
+
+CubismMoc* LAppAssetCache::AcquireMoc(const std::string& path, Csm::csmBool checkConsistency)
+{
+    // 映射的页按页对齐且写时复制，moc 直接在其中复活，只有被 Core 改写的页才会产生私有副本
+    return Acquire<CubismMoc>(AssetKind_Moc, 'M', path, true, [checkConsistency](FileSource& source) {
+        if (!source.mapped)
+        {
+            return CubismMoc::Create(source.data, source.size, checkConsistency);
+        }
+
+        CubismMoc* moc = CubismMoc::CreateInPlace(source.data, source.size, checkConsistency, UnmapMoc, NULL);
+        if (moc != NULL)
+        {
+            source.data = NULL;
+        }
+        return moc;
+    });
+}
+
+const CubismMotion* LAppAssetCache::AcquireMotion(const std::string& path, Csm::csmFloat32 bakeRate)
+{
+    // 烘焙过的模板与未烘焙的分别缓存
+    char variant[24] = "";
+    if (bakeRate > 0.0f)
+    {
+        snprintf(variant, sizeof(variant), "@%g", bakeRate);
+    }
+
+    return Acquire<CubismMotion>(AssetKind_Motion, 'A', path, false, [bakeRate](FileSource& source) {
+        CubismMotion* motion = CubismMotion::Create(source.data, source.size);
+        if (motion != NULL && bakeRate > 0.0f)
+        {
+            motion->Bake(bakeRate);
+        }
+        return motion;
+    }, variant);
+}
+
+const CubismExpressionMotion* LAppAssetCache::AcquireExpression(const std::string& path)
+{
+    return Acquire<CubismExpressionMotion>(AssetKind_Expression, 'E', path, false, [](FileSource& source) {
+        return CubismExpressionMotion::Create(source.data, source.size);
+    });
+}
+
+const CubismPhysics* LAppAssetCache::AcquirePhysics(const std::string& path)
+{
+    return Acquire<CubismPhysics>(AssetKind_Physics, 'P', path, false, [](FileSource& source) {
+        return CubismPhysics::Create(source.data, source.size);
+    });
+}
+
+struct LAppAssetCache::MotionRequest
+{
+    std::string path;
+    Csm::csmFloat32 bakeRate;
+    const CubismMotion* motion;
+    bool ready;
+    bool cancelled;
+};
+
+namespace
+{
+    /**
+    * @brief 后台加载线程的状态
+    *
+    * 线程常驻并分离，状态从不释放，进程退出时线程仍在等待也不会访问到已析构的对象。
+    */
+    struct Loader
+    {
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::condition_variable idle;
+        std::deque<LAppAssetCache::MotionRequest*> queue;
+        bool started;
+        bool busy;
+    };
+
+    Loader* GetLoader()
+    {
+        static Loader* loader = new Loader();
+        return loader;
+    }
+
+    void LoaderMain(Loader* loader)
+    {
+        std::unique_lock<std::mutex> lock(loader->mutex);
+        while (true)
+        {
+            loader->wakeUp.wait(lock, [loader] { return !loader->queue.empty(); });
+
+            LAppAssetCache::MotionRequest* request = loader->queue.front();
+            loader->queue.pop_front();
+
+            if (request->cancelled)
+            {
+                delete request;
+            }
+            else
+            {
+                loader->busy = true;
+                lock.unlock();
+                const CubismMotion* motion = LAppAssetCache::AcquireMotion(request->path, request->bakeRate);
+                lock.lock();
+                loader->busy = false;
+
+                if (request->cancelled)
+                {
+                    delete request;
+                    lock.unlock();
+                    LAppAssetCache::Release(motion);
+                    lock.lock();
+                }
+                else
+                {
+                    request->motion = motion;
+                    request->ready = true;
+                }
+            }
+
+            if (loader->queue.empty())
+            {
+                loader->idle.notify_all();
+            }
+        }
+    }
+}
+
+LAppAssetCache::MotionRequest* LAppAssetCache::RequestMotion(const std::string& path, Csm::csmFloat32 bakeRate)
+{
+    MotionRequest* request = new MotionRequest();
+    request->path = path;
+    request->bakeRate = bakeRate;
+    request->motion = NULL;
+    request->ready = false;
+    request->cancelled = false;
+
+    Loader* loader = GetLoader();
+    std::lock_guard<std::mutex> lock(loader->mutex);
+    loader->queue.push_back(request);
+    if (!loader->started)
+    {
+        loader->started = true;
+        std::thread(LoaderMain, loader).detach();
+    }
+    loader->wakeUp.notify_one();
+
+    return request;
+}
+
+bool LAppAssetCache::IsReady(const MotionRequest* request)
+{
+    Loader* loader = GetLoader();
+    std::lock_guard<std::mutex> lock(loader->mutex);
+    return request->ready;
+}
+
+const CubismMotion* LAppAssetCache::TakeMotion(MotionRequest* request)
+{
+    Loader* loader = GetLoader();
+    {
+        std::lock_guard<std::mutex> lock(loader->mutex);
+        if (!request->ready)
+        {
+            Warn("take a motion request that is still loading: %s", request->path.c_str());
+            request->cancelled = true;
+            return NULL;
+        }
+    }
+
+    const CubismMotion* motion = request->motion;
+    delete request;
+    return motion;
+}
+
+void LAppAssetCache::CancelRequest(MotionRequest* request)
+{
+    if (request == NULL)
+    {
+        return;
+    }
+
+    Loader* loader = GetLoader();
+    {
+        std::lock_guard<std::mutex> lock(loader->mutex);
+        if (!request->ready)
+        {
+            request->cancelled = true;
+            return;
+        }
+    }
+
+    Release(request->motion);
+    delete request;
+}
+
+void LAppAssetCache::WaitForLoader()
+{
+    Loader* loader = GetLoader();
+    std::unique_lock<std::mutex> lock(loader->mutex);
+    loader->idle.wait(lock, [loader] { return loader->queue.empty() && !loader->busy; });
+}
+
+void LAppAssetCache::Release(const void* asset)
+{
+    if (asset == NULL)
+    {
+        return;
+    }
+
+    Entry* entry;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        std::map<const void*, Entry*>::iterator it = s_entriesByAsset.find(asset);
+        if (it == s_entriesByAsset.end())
+        {
+            Warn("release an asset not owned by the cache: %p", asset);
+            return;
+        }
+
+        entry = it->second;
+        if (--entry->users > 0)
+        {
+            return;
+        }
+
+        s_entriesByAsset.erase(it);
+        if (!entry->key.empty())
+        {
+            s_entries.erase(entry->key);
+        }
+    }
+
+    DestroyAsset(entry->kind, entry->asset);
+    delete entry;
+}
+
+Csm::csmUint32 LAppAssetCache::FindTexture(const std::string& path, Csm::csmInt32* outWidth, Csm::csmInt32* outHeight,
+                                           const void** outOwner, std::string* outKey,
+                                           Csm::csmByte** outData, Csm::csmSizeInt* outSize)
+{
+    outKey->clear();
+    *outOwner = NULL;
+    *outData = NULL;
+    *outSize = 0;
+
+    char context[24];
+    snprintf(context, sizeof(context), "@%p", GetCurrentContext());
+    const std::string pathKey = MakePathKey('T', path) + context;
+    FileStamp stamp;
+    const bool stamped = StatFile(path, &stamp);
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_enabled)
+        {
+            std::map<std::string, TextureName>::iterator it = s_textureKeys.find(FindContentKey(pathKey, stamped, stamp));
+            if (it != s_textureKeys.end())
+            {
+                TextureEntry& entry = s_textures[it->second];
+                ++entry.users;
+                ++s_hits;
+                *outWidth = entry.width;
+                *outHeight = entry.height;
+                *outOwner = it->second.first;
+                return it->second.second;
+            }
+        }
+    }
+
+    Csm::csmByte* data = LAppPal::LoadFileAsBytes(path, outSize);
+    if (data == NULL)
+    {
+        return 0;
+    }
+
+    const std::string key = MakeContentKey(pathKey, data, *outSize);
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_enabled)
+    {
+        *outData = data;
+        return 0;
+    }
+
+    RecordContentKey(pathKey, stamped, stamp, key);
+
+    // 只有修改时间变了，内容仍相同
+    std::map<std::string, TextureName>::iterator it = s_textureKeys.find(key);
+    if (it != s_textureKeys.end())
+    {
+        LAppPal::ReleaseBytes(data);
+        *outSize = 0;
+
+        TextureEntry& entry = s_textures[it->second];
+        ++entry.users;
+        ++s_hits;
+        *outWidth = entry.width;
+        *outHeight = entry.height;
+        *outOwner = it->second.first;
+        return it->second.second;
+    }
+
+    ++s_misses;
+    *outData = data;
+    *outKey = key;
+    return 0;
+}
+
+const void* LAppAssetCache::AddTexture(const std::string& key, Csm::csmUint32 textureId, Csm::csmInt32 width, Csm::csmInt32 height)
+{
+    if (key.empty())
+    {
+        return NULL;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_enabled || s_textureKeys.find(key) != s_textureKeys.end())
+    {
+        return NULL;
+    }
+
+    TextureName name(GetCurrentContext(), textureId);
+    if (name.first == NULL)
+    {
+        return NULL;
+    }
+
+    TextureEntry& entry = s_textures[name];
+    entry.key = key;
+    entry.width = width;
+    entry.height = height;
+    entry.users = 1;
+    s_textureKeys[key] = name;
+    return name.first;
+}
+
+bool LAppAssetCache::ReleaseTexture(Csm::csmUint32 textureId, const void* owner)
+{
+    if (owner == NULL)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    std::map<TextureName, TextureEntry>::iterator it = s_textures.find(TextureName(owner, textureId));
+    if (it == s_textures.end())
+    {
+        Warn("release a texture not owned by the cache: %u", textureId);
+        return true;
+    }
+
+    if (--it->second.users == 0)
+    {
+        if (!it->second.key.empty())
+        {
+            s_textureKeys.erase(it->second.key);
+        }
+        s_textures.erase(it);
+
+        // 纹理 ID 只在所属的上下文中有效，换了上下文时删除会删掉别的纹理，只能留给所属上下文销毁时一并释放
+        if (GetCurrentContext() == owner)
+        {
+            GLuint id = textureId;
+            glDeleteTextures(1, &id);
+        }
+        else
+        {
+            Warn("texture %u released outside the GL context that created it, left to that context", textureId);
+        }
+    }
+
+    return true;
+}
+
+Csm::csmInt32 LAppAssetCache::GetTextureUsers(Csm::csmUint32 textureId, const void* owner)
+{
+    if (owner == NULL)
+    {
+        return 1;
+    }
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    std::map<TextureName, TextureEntry>::const_iterator it = s_textures.find(TextureName(owner, textureId));
+    return it != s_textures.end() ? it->second.users : 1;
+}
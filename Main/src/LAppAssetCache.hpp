@@ -0,0 +1,157 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+#include <string>
+
+namespace Live2D { namespace Cubism { namespace Framework {
+class CubismMoc;
+class CubismMotion;
+class CubismExpressionMotion;
+class CubismPhysics;
+}}}
+
+/**
+* @brief 进程内共享的模型资源缓存
+*
+* 同一个 model3.json 加载多次时，moc、动作曲线、表情、物理模板以及 GL 纹理只解析/上传一次。
+* 键为规范化后的路径加文件内容的 64 位哈希，文件被替换后会作为新资源加载。
+* 文件的修改时间与大小与上次读入时相同时沿用上次的哈希，命中时不读入文件。
+* 每个 Acquire 都须以 Release 配对，最后一个使用者释放时资源随之销毁。
+*
+* 表情与物理带有逐实例的状态，缓存中保存的是从未使用过的模板，调用方自行 Clone()；
+* CubismModel、物理质点等实例状态始终由各个模型自己持有。
+* 共享资源在 CubismFramework::BeginSharedAllocation 内创建，不计入任何模型的账户或 arena。
+*/
+class LAppAssetCache
+{
+public:
+    struct Stats
+    {
+        Csm::csmInt32 mocs;
+        Csm::csmInt32 motions;
+        Csm::csmInt32 expressions;
+        Csm::csmInt32 physics;
+        Csm::csmInt32 textures;
+        Csm::csmUint64 hits;
+        Csm::csmUint64 misses;
+    };
+
+    /**
+    * @brief 开关缓存，默认开启
+    *
+    * 关闭后新的 Acquire 每次都重新加载，已缓存的资源在使用者全部释放后销毁。
+    */
+    static void SetEnable(bool enable);
+
+    static bool IsEnabled();
+
+    static void GetStats(Stats* outStats);
+
+    /**
+    * @brief 取得 moc，调用方用 CubismUserModel::LoadModelFromMoc 创建自己的模型
+    *
+    * @return 加载失败时返回 NULL
+    */
+    static Csm::CubismMoc* AcquireMoc(const std::string& path, Csm::csmBool checkConsistency);
+
+    /**
+    * @brief 取得动作模板，调用方用 CubismMotion::Clone 得到可播放的实例
+    *
+    * @param bakeRate 大于 0 时模板先以该采样率 CubismMotion::Bake，与未烘焙的模板分别缓存
+    */
+    static const Csm::CubismMotion* AcquireMotion(const std::string& path, Csm::csmFloat32 bakeRate = 0.0f);
+
+    struct MotionRequest;
+
+    /**
+    * @brief 在后台加载线程上 AcquireMotion，调用方不等待文件读取与解析
+    *
+    * 所有请求由同一个加载线程按提交顺序处理。返回的请求须以 TakeMotion 或 CancelRequest 结束。
+    */
+    static MotionRequest* RequestMotion(const std::string& path, Csm::csmFloat32 bakeRate = 0.0f);
+
+    /**
+    * @brief 请求是否已处理完，无论成功与否
+    */
+    static bool IsReady(const MotionRequest* request);
+
+    /**
+    * @brief 结束已处理完的请求并取得结果，结果须以 Release 配对
+    *
+    * @return 加载失败时返回 NULL
+    */
+    static const Csm::CubismMotion* TakeMotion(MotionRequest* request);
+
+    /**
+    * @brief 放弃请求，尚未处理完时由加载线程在完成后自行释放结果
+    */
+    static void CancelRequest(MotionRequest* request);
+
+    /**
+    * @brief 等待加载线程处理完所有已提交的请求，须在 CubismFramework::Dispose 之前调用
+    */
+    static void WaitForLoader();
+
+    /**
+    * @brief 取得表情模板，调用方用 CubismExpressionMotion::Clone 得到实例
+    */
+    static const Csm::CubismExpressionMotion* AcquireExpression(const std::string& path);
+
+    /**
+    * @brief 取得物理模板，调用方用 CubismPhysics::Clone 得到实例
+    */
+    static const Csm::CubismPhysics* AcquirePhysics(const std::string& path);
+
+    /**
+    * @brief 释放 AcquireMoc / AcquireMotion / AcquireExpression / AcquirePhysics 得到的资源
+    */
+    static void Release(const void* asset);
+
+    /**
+    * @brief 在当前 GL 上下文中查找内容相同的纹理
+    *
+    * @param[in]  path     图片路径
+    * @param[out] outOwner 找到时为纹理所属的 GL 上下文，释放时交给 ReleaseTexture
+    * @param[out] outKey   查找失败时交给 AddTexture 的键
+    * @param[out] outData  查找失败时为读入的文件内容，用 LAppPal::ReleaseBytes 释放；读入失败时为 NULL
+    * @param[out] outSize  outData 的字节数
+    * @return 找到时返回纹理 ID 并增加引用，否则返回 0
+    */
+    static Csm::csmUint32 FindTexture(const std::string& path, Csm::csmInt32* outWidth, Csm::csmInt32* outHeight,
+                                      const void** outOwner, std::string* outKey,
+                                      Csm::csmByte** outData, Csm::csmSizeInt* outSize);
+
+    /**
+    * @brief 登记新上传的纹理，引用计数为 1
+    *
+    * @return 纹理所属的 GL 上下文，未登记（缓存关闭、键为空或没有当前上下文）时返回 NULL
+    */
+    static const void* AddTexture(const std::string& key, Csm::csmUint32 textureId, Csm::csmInt32 width, Csm::csmInt32 height);
+
+    /**
+    * @brief 减少纹理引用，最后一个使用者释放时删除 GL 纹理
+    *
+    * 按取得纹理时记下的所属上下文查找，与释放时的当前上下文无关。
+    * 当前上下文不是所属上下文时不删除，纹理随所属上下文一起销毁。
+    *
+    * @param owner FindTexture 或 AddTexture 返回的所属上下文
+    * @return owner 为 NULL 时返回 false，此时由调用方自行删除
+    */
+    static bool ReleaseTexture(Csm::csmUint32 textureId, const void* owner);
+
+    /**
+    * @brief 纹理当前的引用数
+    *
+    * @param owner FindTexture 或 AddTexture 返回的所属上下文
+    * @return 未登记到缓存（owner 为 NULL 或已不在缓存中）时返回 1
+    */
+    static Csm::csmInt32 GetTextureUsers(Csm::csmUint32 textureId, const void* owner);
+};
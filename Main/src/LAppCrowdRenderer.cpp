@@ -0,0 +1,996 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppCrowdRenderer.hpp"
+
+#include <Rendering/OpenGL/CubismRenderer_OpenGLES2.hpp>
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#include "LAppModel.hpp"
+#include "LAppWorkerPool.hpp"
+#include "Log.hpp"
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 InstanceTexels = 5;  ///< MVP 四列与模型颜色
+    const csmInt32 DrawableTexels = 2;  ///< 乘算色与不透明度、屏幕色与是否可见
+    const csmInt32 MaskTexels = 3;      ///< 模型坐标到图集坐标的缩放与平移、通道、格子的范围
+    const csmFloat32 MaskMargin = 0.05f; ///< 与 CubismClippingManager 相同
+
+    const csmChar* DrawVertexShaderSource =
+        "#version 140\n"
+        "in vec2 a_texCoord;"
+        "out vec2 v_texCoord;"
+        "out vec2 v_clipPos;"
+        "flat out vec4 v_baseColor;"
+        "flat out vec4 v_multiplyColor;"
+        "flat out vec4 v_screenColor;"
+        "flat out vec4 v_channelFlag;"
+        "uniform samplerBuffer s_positions;"
+        "uniform samplerBuffer s_instanceData;"
+        "uniform int u_positionBase;"
+        "uniform int u_vertexCount;"
+        "uniform int u_drawableBase;"
+        "uniform int u_maskBase;"
+        "uniform bool u_premultipliedAlpha;"
+        "void main()"
+        "{"
+        "int instance = gl_InstanceID;"
+        "vec2 position = texelFetch(s_positions, u_positionBase + instance * u_vertexCount + gl_VertexID).xy;"
+        "int block = instance * 5;"
+        "mat4 mvp = mat4(texelFetch(s_instanceData, block), texelFetch(s_instanceData, block + 1),"
+        "                texelFetch(s_instanceData, block + 2), texelFetch(s_instanceData, block + 3));"
+        "vec4 modelColor = texelFetch(s_instanceData, block + 4);"
+        "vec4 multiply = texelFetch(s_instanceData, u_drawableBase + instance * 2);"
+        "vec4 screen = texelFetch(s_instanceData, u_drawableBase + instance * 2 + 1);"
+        "gl_Position = screen.a > 0.5 ? mvp * vec4(position, 0.0, 1.0) : vec4(2.0, 2.0, 2.0, 1.0);"
+        "v_baseColor = vec4(modelColor.rgb, modelColor.a * multiply.a);"
+        "if (u_premultipliedAlpha)"
+        "{"
+        "v_baseColor.rgb = v_baseColor.rgb * v_baseColor.a;"
+        "}"
+        "v_multiplyColor = vec4(multiply.rgb, 1.0);"
+        "v_screenColor = vec4(screen.rgb, 1.0);"
+        "v_texCoord = vec2(a_texCoord.x, 1.0 - a_texCoord.y);"
+        "v_clipPos = vec2(0.0);"
+        "v_channelFlag = vec4(0.0);"
+        "if (u_maskBase >= 0)"
+        "{"
+        "vec4 transform = texelFetch(s_instanceData, u_maskBase + instance * 3);"
+        "v_clipPos = position * transform.xy + transform.zw;"
+        "v_channelFlag = texelFetch(s_instanceData, u_maskBase + instance * 3 + 1);"
+        "}"
+        "}";
+
+    const csmChar* DrawFragmentShaderSource =
+        "#version 140\n"
+        "in vec2 v_texCoord;"
+        "in vec2 v_clipPos;"
+        "flat in vec4 v_baseColor;"
+        "flat in vec4 v_multiplyColor;"
+        "flat in vec4 v_screenColor;"
+        "flat in vec4 v_channelFlag;"
+        "uniform sampler2D s_texture0;"
+        "uniform sampler2D s_maskAtlas;"
+        "uniform int u_maskMode;"
+        "uniform bool u_premultipliedAlpha;"
+        "out vec4 o_color;"
+        "void main()"
+        "{"
+        "vec4 texColor = texture(s_texture0, v_texCoord);"
+        "texColor.rgb = texColor.rgb * v_multiplyColor.rgb;"
+        "vec4 color;"
+        "if (u_premultipliedAlpha)"
+        "{"
+        "texColor.rgb = (texColor.rgb + v_screenColor.rgb * texColor.a) - (texColor.rgb * v_screenColor.rgb);"
+        "color = texColor * v_baseColor;"
+        "}"
+        "else"
+        "{"
+        "texColor.rgb = texColor.rgb + v_screenColor.rgb - (texColor.rgb * v_screenColor.rgb);"
+        "color = texColor * v_baseColor;"
+        "color.rgb = color.rgb * color.a;"
+        "}"
+        "if (u_maskMode != 0)"
+        "{"
+        "vec4 clipMask = (1.0 - texture(s_maskAtlas, v_clipPos)) * v_channelFlag;"
+        "float maskVal = clipMask.r + clipMask.g + clipMask.b + clipMask.a;"
+        "if (u_maskMode == 2)"
+        "{"
+        "maskVal = 1.0 - maskVal;"
+        "}"
+        "color = color * maskVal;"
+        "}"
+        "o_color = color;"
+        "}";
+
+    const csmChar* MaskVertexShaderSource =
+        "#version 140\n"
+        "in vec2 a_texCoord;"
+        "out vec2 v_texCoord;"
+        "out vec2 v_maskPos;"
+        "flat out vec4 v_channelFlag;"
+        "flat out vec4 v_cellBounds;"
+        "uniform samplerBuffer s_positions;"
+        "uniform samplerBuffer s_instanceData;"
+        "uniform int u_positionBase;"
+        "uniform int u_vertexCount;"
+        "uniform int u_maskBase;"
+        "void main()"
+        "{"
+        "int instance = gl_InstanceID;"
+        "vec2 position = texelFetch(s_positions, u_positionBase + instance * u_vertexCount + gl_VertexID).xy;"
+        "vec4 transform = texelFetch(s_instanceData, u_maskBase + instance * 3);"
+        "v_maskPos = position * transform.xy + transform.zw;"
+        "gl_Position = vec4(v_maskPos * 2.0 - 1.0, 0.0, 1.0);"
+        "v_channelFlag = texelFetch(s_instanceData, u_maskBase + instance * 3 + 1);"
+        "v_cellBounds = texelFetch(s_instanceData, u_maskBase + instance * 3 + 2);"
+        "v_texCoord = vec2(a_texCoord.x, 1.0 - a_texCoord.y);"
+        "}";
+
+    const csmChar* MaskFragmentShaderSource =
+        "#version 140\n"
+        "in vec2 v_texCoord;"
+        "in vec2 v_maskPos;"
+        "flat in vec4 v_channelFlag;"
+        "flat in vec4 v_cellBounds;"
+        "uniform sampler2D s_texture0;"
+        "out vec4 o_color;"
+        "void main()"
+        "{"
+        "float isInside = step(v_cellBounds.x, v_maskPos.x) * step(v_cellBounds.y, v_maskPos.y)"
+        "               * step(v_maskPos.x, v_cellBounds.z) * step(v_maskPos.y, v_cellBounds.w);"
+        "o_color = v_channelFlag * texture(s_texture0, v_texCoord).a * isInside;"
+        "}";
+
+    GLuint CompileShader(GLenum type, const csmChar* source)
+    {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+
+        GLint status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE)
+        {
+            GLchar log[1024];
+            glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+            Error("crowd shader compile error: %s", log);
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    GLuint LoadProgram(const csmChar* vertexSource, const csmChar* fragmentSource)
+    {
+        GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+        GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+        if (vertexShader == 0 || fragmentShader == 0)
+        {
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        // 兼容模式下须启用 0 号属性才会绘制，UV 是唯一的顶点属性
+        glBindAttribLocation(program, 0, "a_texCoord");
+        glLinkProgram(program);
+        glDetachShader(program, vertexShader);
+        glDetachShader(program, fragmentShader);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        GLint status;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (status == GL_FALSE)
+        {
+            GLchar log[1024];
+            glGetProgramInfoLog(program, sizeof(log), NULL, log);
+            Error("crowd program link error: %s", log);
+            glDeleteProgram(program);
+            return 0;
+        }
+
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "s_texture0"), 0);
+        glUniform1i(glGetUniformLocation(program, "s_maskAtlas"), 1);
+        glUniform1i(glGetUniformLocation(program, "s_positions"), 2);
+        glUniform1i(glGetUniformLocation(program, "s_instanceData"), 3);
+        return program;
+    }
+
+    /**
+    * @brief 绘制前后保存与恢复的 GL 状态，与 CubismRendererProfile_OpenGLES2 相同并加上纹理缓冲
+    */
+    struct GlState
+    {
+        GLint program;
+        GLint arrayBuffer;
+        GLint elementArrayBuffer;
+        GLint activeTexture;
+        GLint textures[2];
+        GLint bufferTextures[2];
+        GLint vertexAttribArrayEnabled[4];
+        GLboolean scissorTest;
+        GLboolean stencilTest;
+        GLboolean depthTest;
+        GLboolean cullFace;
+        GLboolean blend;
+        GLint frontFace;
+        GLboolean colorMask[4];
+        GLint blending[4];
+        GLint framebuffer;
+        GLint viewport[4];
+
+        void Save()
+        {
+            glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &arrayBuffer);
+            glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementArrayBuffer);
+            glGetIntegerv(GL_ACTIVE_TEXTURE, &activeTexture);
+            for (csmInt32 i = 0; i < 2; i++)
+            {
+                glActiveTexture(GL_TEXTURE0 + i);
+                glGetIntegerv(GL_TEXTURE_BINDING_2D, &textures[i]);
+                glActiveTexture(GL_TEXTURE2 + i);
+                glGetIntegerv(GL_TEXTURE_BINDING_BUFFER, &bufferTextures[i]);
+            }
+            for (csmInt32 i = 0; i < 4; i++)
+            {
+                glGetVertexAttribiv(i, GL_VERTEX_ATTRIB_ARRAY_ENABLED, &vertexAttribArrayEnabled[i]);
+            }
+            scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+            stencilTest = glIsEnabled(GL_STENCIL_TEST);
+            depthTest = glIsEnabled(GL_DEPTH_TEST);
+            cullFace = glIsEnabled(GL_CULL_FACE);
+            blend = glIsEnabled(GL_BLEND);
+            glGetIntegerv(GL_FRONT_FACE, &frontFace);
+            glGetBooleanv(GL_COLOR_WRITEMASK, colorMask);
+            glGetIntegerv(GL_BLEND_SRC_RGB, &blending[0]);
+            glGetIntegerv(GL_BLEND_DST_RGB, &blending[1]);
+            glGetIntegerv(GL_BLEND_SRC_ALPHA, &blending[2]);
+            glGetIntegerv(GL_BLEND_DST_ALPHA, &blending[3]);
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+            glGetIntegerv(GL_VIEWPORT, viewport);
+        }
+
+        void Restore() const
+        {
+            glUseProgram(program);
+            for (csmInt32 i = 0; i < 4; i++)
+            {
+                if (vertexAttribArrayEnabled[i])
+                {
+                    glEnableVertexAttribArray(i);
+                }
+                else
+                {
+                    glDisableVertexAttribArray(i);
+                }
+            }
+            SetEnable(GL_SCISSOR_TEST, scissorTest);
+            SetEnable(GL_STENCIL_TEST, stencilTest);
+            SetEnable(GL_DEPTH_TEST, depthTest);
+            SetEnable(GL_CULL_FACE, cullFace);
+            SetEnable(GL_BLEND, blend);
+            glFrontFace(frontFace);
+            glColorMask(colorMask[0], colorMask[1], colorMask[2], colorMask[3]);
+            glBindBuffer(GL_ARRAY_BUFFER, arrayBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArrayBuffer);
+            for (csmInt32 i = 0; i < 2; i++)
+            {
+                glActiveTexture(GL_TEXTURE2 + i);
+                glBindTexture(GL_TEXTURE_BUFFER, bufferTextures[i]);
+                glActiveTexture(GL_TEXTURE0 + i);
+                glBindTexture(GL_TEXTURE_2D, textures[i]);
+            }
+            glActiveTexture(activeTexture);
+            glBlendFuncSeparate(blending[0], blending[1], blending[2], blending[3]);
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        }
+
+        static void SetEnable(GLenum capability, GLboolean enabled)
+        {
+            if (enabled)
+            {
+                glEnable(capability);
+            }
+            else
+            {
+                glDisable(capability);
+            }
+        }
+    };
+
+    /**
+    * @brief 两个模型的 drawable 是否一一对应：ID、顶点数、索引、纹理与遮罩都相同
+    */
+    csmBool IsSameLayout(const CubismModel* a, const CubismModel* b)
+    {
+        if (a == b)
+        {
+            return true;
+        }
+
+        const csmInt32 drawableCount = a->GetDrawableCount();
+        if (b->GetDrawableCount() != drawableCount)
+        {
+            return false;
+        }
+
+        const csmInt32* aMaskCounts = a->GetDrawableMaskCounts();
+        const csmInt32* bMaskCounts = b->GetDrawableMaskCounts();
+        for (csmInt32 i = 0; i < drawableCount; i++)
+        {
+            const csmInt32 indexCount = a->GetDrawableVertexIndexCount(i);
+            if (a->GetDrawableId(i) != b->GetDrawableId(i) ||
+                a->GetDrawableVertexCount(i) != b->GetDrawableVertexCount(i) ||
+                b->GetDrawableVertexIndexCount(i) != indexCount ||
+                a->GetDrawableTextureIndex(i) != b->GetDrawableTextureIndex(i) ||
+                aMaskCounts[i] != bMaskCounts[i])
+            {
+                return false;
+            }
+            if (memcmp(a->GetDrawableVertexIndices(i), b->GetDrawableVertexIndices(i), sizeof(csmUint16) * indexCount) != 0 ||
+                memcmp(a->GetDrawableMasks()[i], b->GetDrawableMasks()[i], sizeof(csmInt32) * aMaskCounts[i]) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+    * @brief 两组遮罩是否由相同的 drawable 组成，与 CubismClippingManager::FindSameClip 相同不计顺序
+    */
+    csmBool IsSameClip(const std::vector<csmInt32>& clip, const csmInt32* masks, csmInt32 count)
+    {
+        if (static_cast<csmInt32>(clip.size()) != count)
+        {
+            return false;
+        }
+        for (csmInt32 i = 0; i < count; i++)
+        {
+            csmBool found = false;
+            for (csmInt32 j = 0; j < count; j++)
+            {
+                if (masks[j] == clip[i])
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+LAppCrowdRenderer::LAppCrowdRenderer()
+    : _drawableCount(0)
+    , _totalVertexCount(0)
+    , _totalIndexCount(0)
+    , _drawableDataBase(0)
+    , _maskDataBase(0)
+    , _instanceDataTexels(0)
+    , _maskGridSize(1)
+    , _layoutDirty(false)
+    , _maskAtlasSize(2048)
+    , _glReady(false)
+    , _glFailed(false)
+    , _drawProgram(0)
+    , _maskProgram(0)
+    , _uvBuffer(0)
+    , _indexBuffer(0)
+    , _positionBuffer(0)
+    , _positionTexture(0)
+    , _instanceBuffer(0)
+    , _instanceTexture(0)
+    , _maxTextureBufferSize(0)
+{
+    _drawStats = DrawStats();
+}
+
+LAppCrowdRenderer::~LAppCrowdRenderer()
+{
+    ReleaseGl();
+}
+
+csmBool LAppCrowdRenderer::SetInstances(LAppModel* const* models, csmInt32 count)
+{
+    _models.clear();
+    _cubismModels.clear();
+
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        CubismModel* model = models[i]->GetModel();
+        if (model == NULL || !IsSameLayout(models[0]->GetModel(), model))
+        {
+            _models.clear();
+            _cubismModels.clear();
+            return false;
+        }
+        _models.push_back(models[i]);
+        _cubismModels.push_back(model);
+    }
+
+    BuildLayout();
+    return true;
+}
+
+void LAppCrowdRenderer::SetMaskAtlasSize(csmInt32 size)
+{
+    _maskAtlasSize = size > 0 ? size : 1;
+}
+
+csmInt32 LAppCrowdRenderer::GetMaskAtlasSize() const
+{
+    return _maskAtlasSize;
+}
+
+const LAppCrowdRenderer::DrawStats& LAppCrowdRenderer::GetDrawStats() const
+{
+    return _drawStats;
+}
+
+void LAppCrowdRenderer::BuildLayout()
+{
+    const csmInt32 instanceCount = static_cast<csmInt32>(_models.size());
+    _clipContexts.clear();
+    _clipContextOfDrawable.clear();
+    _vertexOffsets.clear();
+    _indexOffsets.clear();
+    _drawableCount = 0;
+    _totalVertexCount = 0;
+    _totalIndexCount = 0;
+    _layoutDirty = true;
+    if (instanceCount == 0)
+    {
+        return;
+    }
+
+    const CubismModel* model = _cubismModels[0];
+    _drawableCount = model->GetDrawableCount();
+    for (csmInt32 i = 0; i < _drawableCount; i++)
+    {
+        _vertexOffsets.push_back(_totalVertexCount);
+        _indexOffsets.push_back(_totalIndexCount);
+        _totalVertexCount += model->GetDrawableVertexCount(i);
+        _totalIndexCount += model->GetDrawableVertexIndexCount(i);
+    }
+
+    // 与 CubismClippingManager::Initialize 相同，使用同一组遮罩的 drawable 共用一个上下文
+    const csmInt32* maskCounts = model->GetDrawableMaskCounts();
+    const csmInt32** masks = model->GetDrawableMasks();
+    for (csmInt32 i = 0; i < _drawableCount; i++)
+    {
+        if (maskCounts[i] <= 0)
+        {
+            _clipContextOfDrawable.push_back(-1);
+            continue;
+        }
+
+        csmInt32 context = -1;
+        for (csmUint32 j = 0; j < _clipContexts.size(); j++)
+        {
+            if (IsSameClip(_clipContexts[j].clippingDrawables, masks[i], maskCounts[i]))
+            {
+                context = static_cast<csmInt32>(j);
+                break;
+            }
+        }
+        if (context < 0)
+        {
+            context = static_cast<csmInt32>(_clipContexts.size());
+            _clipContexts.push_back(ClipContext());
+            _clipContexts.back().clippingDrawables.assign(masks[i], masks[i] + maskCounts[i]);
+        }
+        _clipContexts[context].clippedDrawables.push_back(i);
+        _clipContextOfDrawable.push_back(context);
+    }
+
+    const csmInt32 contextCount = static_cast<csmInt32>(_clipContexts.size());
+    _drawableDataBase = instanceCount * InstanceTexels;
+    _maskDataBase = _drawableDataBase + _drawableCount * instanceCount * DrawableTexels;
+    _instanceDataTexels = _maskDataBase + contextCount * instanceCount * MaskTexels;
+
+    // 每格四个通道各放一个 (上下文, 实例)，格子排成正方形
+    const csmInt32 cellCount = (contextCount * instanceCount + 3) / 4;
+    _maskGridSize = 1;
+    while (_maskGridSize * _maskGridSize < cellCount)
+    {
+        _maskGridSize++;
+    }
+
+    _sortedDrawables.assign(_drawableCount, 0);
+    _positions.assign(static_cast<size_t>(_totalVertexCount) * instanceCount * 2, 0.0f);
+    _instanceData.assign(static_cast<size_t>(_instanceDataTexels) * 4, 0.0f);
+    _visible.assign(static_cast<size_t>(_drawableCount) * instanceCount, 0);
+}
+
+csmBool LAppCrowdRenderer::SetupGl()
+{
+    // 纹理缓冲、实例化绘制与 GLSL 1.40 都需要 OpenGL 3.1
+    if (!GLAD_GL_VERSION_3_1)
+    {
+        Warn("crowd rendering needs OpenGL 3.1, drawing the instances one by one");
+        return false;
+    }
+
+    _drawProgram = LoadProgram(DrawVertexShaderSource, DrawFragmentShaderSource);
+    _maskProgram = LoadProgram(MaskVertexShaderSource, MaskFragmentShaderSource);
+    if (_drawProgram == 0 || _maskProgram == 0)
+    {
+        ReleaseGl();
+        return false;
+    }
+
+    const GLuint programs[2] = {_drawProgram, _maskProgram};
+    for (csmInt32 i = 0; i < 2; i++)
+    {
+        _uniformPositionBase[i] = glGetUniformLocation(programs[i], "u_positionBase");
+        _uniformVertexCount[i] = glGetUniformLocation(programs[i], "u_vertexCount");
+        _uniformMaskBase[i] = glGetUniformLocation(programs[i], "u_maskBase");
+    }
+    _uniformDrawableBase = glGetUniformLocation(_drawProgram, "u_drawableBase");
+    _uniformMaskMode = glGetUniformLocation(_drawProgram, "u_maskMode");
+    _uniformPremultipliedAlpha = glGetUniformLocation(_drawProgram, "u_premultipliedAlpha");
+    glUseProgram(0);
+
+    glGenBuffers(1, &_uvBuffer);
+    glGenBuffers(1, &_indexBuffer);
+    glGenBuffers(1, &_positionBuffer);
+    glGenBuffers(1, &_instanceBuffer);
+
+    // 缓冲对象在首次绑定时才创建，glTexBuffer 之前须先绑定一次
+    glBindBuffer(GL_TEXTURE_BUFFER, _positionBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, _instanceBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // 纹理缓冲绑定的是缓冲对象，之后每帧重新分配存储也不需要再绑定
+    GLint lastTexture;
+    glActiveTexture(GL_TEXTURE2);
+    glGetIntegerv(GL_TEXTURE_BINDING_BUFFER, &lastTexture);
+    glGenTextures(1, &_positionTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, _positionTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, _positionBuffer);
+    glGenTextures(1, &_instanceTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, _instanceTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, _instanceBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, lastTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &_maxTextureBufferSize);
+
+    _layoutDirty = true;
+    return true;
+}
+
+void LAppCrowdRenderer::ReleaseGl()
+{
+    if (_drawProgram != 0)
+    {
+        glDeleteProgram(_drawProgram);
+        _drawProgram = 0;
+    }
+    if (_maskProgram != 0)
+    {
+        glDeleteProgram(_maskProgram);
+        _maskProgram = 0;
+    }
+
+    GLuint buffers[4] = {_uvBuffer, _indexBuffer, _positionBuffer, _instanceBuffer};
+    for (csmInt32 i = 0; i < 4; i++)
+    {
+        if (buffers[i] != 0)
+        {
+            glDeleteBuffers(1, &buffers[i]);
+        }
+    }
+    _uvBuffer = 0;
+    _indexBuffer = 0;
+    _positionBuffer = 0;
+    _instanceBuffer = 0;
+
+    GLuint textures[2] = {_positionTexture, _instanceTexture};
+    for (csmInt32 i = 0; i < 2; i++)
+    {
+        if (textures[i] != 0)
+        {
+            glDeleteTextures(1, &textures[i]);
+        }
+    }
+    _positionTexture = 0;
+    _instanceTexture = 0;
+
+    _maskAtlas.DestroyOffscreenSurface();
+    _glReady = false;
+}
+
+void LAppCrowdRenderer::Draw()
+{
+    _drawStats = DrawStats();
+    _drawStats.instances = static_cast<csmInt32>(_models.size());
+    if (_models.empty())
+    {
+        return;
+    }
+
+    // 重新加载过的实例须重建布局，结构不再一致时放弃所有实例
+    for (csmUint32 i = 0; i < _models.size(); i++)
+    {
+        if (_models[i]->GetModel() != _cubismModels[i])
+        {
+            std::vector<LAppModel*> models(_models);
+            if (!SetInstances(models.data(), static_cast<csmInt32>(models.size())))
+            {
+                Warn("crowd instances no longer share one model, nothing is drawn");
+                _drawStats.instances = 0;
+                return;
+            }
+            break;
+        }
+    }
+
+    for (csmUint32 i = 0; i < _models.size(); i++)
+    {
+        _models[i]->PrepareDraw();
+    }
+
+    if (!_glReady && !_glFailed)
+    {
+        _glReady = SetupGl();
+        _glFailed = !_glReady;
+    }
+
+    const csmInt64 positionTexels = static_cast<csmInt64>(_totalVertexCount) * _models.size();
+    if (!_glReady || positionTexels > _maxTextureBufferSize || _instanceDataTexels > _maxTextureBufferSize)
+    {
+        DrawEach();
+        return;
+    }
+
+    LAppWorkerPool::Run(static_cast<csmInt32>(_models.size()), GatherTask, this);
+
+    DrawInstanced();
+
+    // 绘制交给这里之后，各实例自己的遮罩缓冲不再使用；
+    // 期间单独 Draw 过的实例会重新创建，因此每次都检查，已释放的缓冲不做任何事
+    for (csmUint32 i = 0; i < _models.size(); i++)
+    {
+        _models[i]->ReleaseMaskBuffers();
+    }
+}
+
+void LAppCrowdRenderer::GatherTask(void* context, csmInt32 index)
+{
+    static_cast<LAppCrowdRenderer*>(context)->Gather(index);
+}
+
+void LAppCrowdRenderer::Gather(csmInt32 index)
+{
+    LAppModel* owner = _models[index];
+    const CubismModel* model = _cubismModels[index];
+    const csmInt32 instanceCount = static_cast<csmInt32>(_models.size());
+
+    for (csmInt32 i = 0; i < _drawableCount; i++)
+    {
+        const csmInt32 vertexCount = model->GetDrawableVertexCount(i);
+        const size_t offset = (static_cast<size_t>(_vertexOffsets[i]) * instanceCount + static_cast<size_t>(index) * vertexCount) * 2;
+        memcpy(&_positions[offset], model->GetDrawableVertices(i), sizeof(csmFloat32) * 2 * vertexCount);
+    }
+
+    csmFloat32* instance = &_instanceData[static_cast<size_t>(index) * InstanceTexels * 4];
+    memcpy(instance, owner->GetMvpMatrix().GetArray(), sizeof(csmFloat32) * 16);
+    const Rendering::CubismRenderer::CubismTextureColor modelColor =
+        owner->GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->GetModelColor();
+    instance[16] = modelColor.R;
+    instance[17] = modelColor.G;
+    instance[18] = modelColor.B;
+    instance[19] = modelColor.A;
+
+    for (csmInt32 i = 0; i < _drawableCount; i++)
+    {
+        const csmInt32 slot = i * instanceCount + index;
+        csmFloat32* data = &_instanceData[(static_cast<size_t>(_drawableDataBase) + static_cast<size_t>(slot) * DrawableTexels) * 4];
+        const Rendering::CubismRenderer::CubismTextureColor multiplyColor = model->GetMultiplyColor(i);
+        const Rendering::CubismRenderer::CubismTextureColor screenColor = model->GetScreenColor(i);
+        const csmBool visible = model->GetDrawableDynamicFlagIsVisible(i);
+        data[0] = multiplyColor.R;
+        data[1] = multiplyColor.G;
+        data[2] = multiplyColor.B;
+        data[3] = model->GetDrawableOpacity(i);
+        data[4] = screenColor.R;
+        data[5] = screenColor.G;
+        data[6] = screenColor.B;
+        data[7] = visible ? 1.0f : 0.0f;
+        _visible[slot] = visible ? 1 : 0;
+    }
+
+    // 与 CubismClippingManager 相同，遮罩的范围取被遮罩的 drawable 的外接矩形加上边距
+    const csmFloat32 cellSize = 1.0f / _maskGridSize;
+    for (csmUint32 k = 0; k < _clipContexts.size(); k++)
+    {
+        const std::vector<csmInt32>& clipped = _clipContexts[k].clippedDrawables;
+        csmFloat32 minX = FLT_MAX, minY = FLT_MAX;
+        csmFloat32 maxX = -FLT_MAX, maxY = -FLT_MAX;
+        for (csmUint32 j = 0; j < clipped.size(); j++)
+        {
+            const csmInt32 vertexCount = model->GetDrawableVertexCount(clipped[j]);
+            const csmFloat32* vertices = model->GetDrawableVertices(clipped[j]);
+            for (csmInt32 v = 0; v < vertexCount; v++)
+            {
+                const csmFloat32 x = vertices[v * 2];
+                const csmFloat32 y = vertices[v * 2 + 1];
+                if (x < minX) minX = x;
+                if (x > maxX) maxX = x;
+                if (y < minY) minY = y;
+                if (y > maxY) maxY = y;
+            }
+        }
+
+        const csmInt32 slot = static_cast<csmInt32>(k) * instanceCount + index;
+        const csmInt32 channel = slot % 4;
+        const csmInt32 cell = slot / 4;
+        const csmFloat32 cellX = (cell % _maskGridSize) * cellSize;
+        const csmFloat32 cellY = (cell / _maskGridSize) * cellSize;
+
+        csmFloat32 scaleX = 0.0f;
+        csmFloat32 scaleY = 0.0f;
+        csmFloat32 boundsX = 0.0f;
+        csmFloat32 boundsY = 0.0f;
+        if (minX != FLT_MAX)
+        {
+            const csmFloat32 width = maxX - minX;
+            const csmFloat32 height = maxY - minY;
+            boundsX = minX - width * MaskMargin;
+            boundsY = minY - height * MaskMargin;
+            const csmFloat32 boundsWidth = width * (1.0f + 2.0f * MaskMargin);
+            const csmFloat32 boundsHeight = height * (1.0f + 2.0f * MaskMargin);
+            scaleX = boundsWidth > 0.0f ? cellSize / boundsWidth : 0.0f;
+            scaleY = boundsHeight > 0.0f ? cellSize / boundsHeight : 0.0f;
+        }
+
+        csmFloat32* data = &_instanceData[(static_cast<size_t>(_maskDataBase) + static_cast<size_t>(slot) * MaskTexels) * 4];
+        data[0] = scaleX;
+        data[1] = scaleY;
+        data[2] = cellX - boundsX * scaleX;
+        data[3] = cellY - boundsY * scaleY;
+        for (csmInt32 c = 0; c < 4; c++)
+        {
+            data[4 + c] = c == channel ? 1.0f : 0.0f;
+        }
+        data[8] = cellX;
+        data[9] = cellY;
+        data[10] = cellX + cellSize;
+        data[11] = cellY + cellSize;
+    }
+}
+
+void LAppCrowdRenderer::DrawEach()
+{
+    _drawStats.instanced = false;
+    for (csmUint32 i = 0; i < _models.size(); i++)
+    {
+        _models[i]->Draw();
+
+        const Rendering::CubismRenderer_OpenGLES2::DrawStats& stats =
+            _models[i]->GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->GetDrawStats();
+        _drawStats.drawCalls += stats.drawCalls;
+        _drawStats.maskDrawCalls += stats.maskDrawCalls;
+    }
+}
+
+void LAppCrowdRenderer::DrawInstanced()
+{
+    _drawStats.instanced = true;
+
+    GlState state;
+    state.Save();
+
+    if (_layoutDirty)
+    {
+        // UV 与索引在各实例间相同，只从第一个实例上传一次
+        std::vector<csmFloat32> uvs(static_cast<size_t>(_totalVertexCount) * 2);
+        std::vector<csmUint16> indices(_totalIndexCount);
+        const CubismModel* model = _cubismModels[0];
+        for (csmInt32 i = 0; i < _drawableCount; i++)
+        {
+            memcpy(&uvs[static_cast<size_t>(_vertexOffsets[i]) * 2], model->GetDrawableVertexUvs(i),
+                   sizeof(csmFloat32) * 2 * model->GetDrawableVertexCount(i));
+            if (model->GetDrawableVertexIndexCount(i) > 0)
+            {
+                memcpy(&indices[_indexOffsets[i]], model->GetDrawableVertexIndices(i),
+                       sizeof(csmUint16) * model->GetDrawableVertexIndexCount(i));
+            }
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, _uvBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(csmFloat32) * uvs.size(), uvs.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(csmUint16) * indices.size(), indices.data(), GL_STATIC_DRAW);
+        _layoutDirty = false;
+    }
+
+    // 每帧两次上传，与实例数无关
+    glBindBuffer(GL_TEXTURE_BUFFER, _positionBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(csmFloat32) * _positions.size(), _positions.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, _instanceBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(csmFloat32) * _instanceData.size(), _instanceData.data(), GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    // 与 CubismRenderer_OpenGLES2::PreDraw 相同
+    glDisable(GL_SCISSOR_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glColorMask(1, 1, 1, 1);
+    glFrontFace(GL_CCW);
+
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_BUFFER, _positionTexture);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_BUFFER, _instanceTexture);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _uvBuffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer);
+    glEnableVertexAttribArray(0);
+    for (csmInt32 i = 1; i < 4; i++)
+    {
+        glDisableVertexAttribArray(i);
+    }
+
+    if (!_clipContexts.empty())
+    {
+        DrawMasks();
+        glViewport(state.viewport[0], state.viewport[1], state.viewport[2], state.viewport[3]);
+    }
+
+    const csmInt32 instanceCount = static_cast<csmInt32>(_models.size());
+    const CubismModel* model = _cubismModels[0];
+    Rendering::CubismRenderer_OpenGLES2* renderer = _models[0]->GetRenderer<Rendering::CubismRenderer_OpenGLES2>();
+    const csmMap<csmInt32, GLuint>& textures = renderer->GetBindedTextures();
+
+    // 绘制顺序以第一个实例为准
+    const csmInt32* renderOrders = model->GetDrawableRenderOrders();
+    for (csmInt32 i = 0; i < _drawableCount; i++)
+    {
+        _sortedDrawables[renderOrders[i]] = i;
+    }
+
+    glUseProgram(_drawProgram);
+    glUniform1i(_uniformPremultipliedAlpha, renderer->IsPremultipliedAlpha() ? 1 : 0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, _maskAtlas.GetColorBuffer());
+    glActiveTexture(GL_TEXTURE0);
+
+    for (csmInt32 i = 0; i < _drawableCount; i++)
+    {
+        const csmInt32 drawable = _sortedDrawables[i];
+        const csmInt32 indexCount = model->GetDrawableVertexIndexCount(drawable);
+        const GLuint texture = textures[model->GetDrawableTextureIndex(drawable)];
+        if (indexCount == 0 || texture == 0)
+        {
+            continue;
+        }
+
+        // 所有实例都不显示时不发出绘制
+        const csmUint8* visible = &_visible[static_cast<size_t>(drawable) * instanceCount];
+        csmBool anyVisible = false;
+        for (csmInt32 j = 0; j < instanceCount && !anyVisible; j++)
+        {
+            anyVisible = visible[j] != 0;
+        }
+        if (!anyVisible)
+        {
+            continue;
+        }
+
+        switch (model->GetDrawableBlendMode(drawable))
+        {
+        case Rendering::CubismRenderer::CubismBlendMode_Normal:
+        default:
+            glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            break;
+        case Rendering::CubismRenderer::CubismBlendMode_Additive:
+            glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE);
+            break;
+        case Rendering::CubismRenderer::CubismBlendMode_Multiplicative:
+            glBlendFuncSeparate(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
+            break;
+        }
+
+        GlState::SetEnable(GL_CULL_FACE, model->GetDrawableCulling(drawable) != 0);
+
+        const csmInt32 context = _clipContextOfDrawable[drawable];
+        csmInt32 maskMode = 0;
+        if (context >= 0)
+        {
+            maskMode = model->GetDrawableInvertedMask(drawable) ? 2 : 1;
+        }
+        glUniform1i(_uniformMaskMode, maskMode);
+        glUniform1i(_uniformMaskBase[0], context >= 0 ? _maskDataBase + context * instanceCount * MaskTexels : -1);
+        glUniform1i(_uniformDrawableBase, _drawableDataBase + drawable * instanceCount * DrawableTexels);
+        glUniform1i(_uniformPositionBase[0], _vertexOffsets[drawable] * instanceCount);
+        glUniform1i(_uniformVertexCount[0], model->GetDrawableVertexCount(drawable));
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0,
+                              reinterpret_cast<const void*>(sizeof(csmFloat32) * 2 * static_cast<size_t>(_vertexOffsets[drawable])));
+        glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT,
+                                reinterpret_cast<const void*>(sizeof(csmUint16) * static_cast<size_t>(_indexOffsets[drawable])),
+                                instanceCount);
+        _drawStats.drawCalls++;
+    }
+
+    state.Restore();
+}
+
+void LAppCrowdRenderer::DrawMasks()
+{
+    if (_maskAtlas.GetBufferWidth() != static_cast<csmUint32>(_maskAtlasSize))
+    {
+        _maskAtlas.CreateOffscreenSurface(_maskAtlasSize, _maskAtlasSize);
+    }
+
+    const csmInt32 instanceCount = static_cast<csmInt32>(_models.size());
+    const CubismModel* model = _cubismModels[0];
+    const csmMap<csmInt32, GLuint>& textures = _models[0]->GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->GetBindedTextures();
+
+    glViewport(0, 0, _maskAtlasSize, _maskAtlasSize);
+    _maskAtlas.BeginDraw();
+
+    // 1 为不绘制的区域，遮罩在自己的通道上乘以 (1 - alpha)
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBlendFuncSeparate(GL_ZERO, GL_ONE_MINUS_SRC_COLOR, GL_ZERO, GL_ONE_MINUS_SRC_ALPHA);
+    glUseProgram(_maskProgram);
+
+    for (csmUint32 k = 0; k < _clipContexts.size(); k++)
+    {
+        glUniform1i(_uniformMaskBase[1], _maskDataBase + static_cast<csmInt32>(k) * instanceCount * MaskTexels);
+
+        const std::vector<csmInt32>& clipping = _clipContexts[k].clippingDrawables;
+        for (csmUint32 j = 0; j < clipping.size(); j++)
+        {
+            const csmInt32 drawable = clipping[j];
+            const csmInt32 indexCount = model->GetDrawableVertexIndexCount(drawable);
+            const GLuint texture = textures[model->GetDrawableTextureIndex(drawable)];
+            if (indexCount == 0 || texture == 0)
+            {
+                continue;
+            }
+
+            GlState::SetEnable(GL_CULL_FACE, model->GetDrawableCulling(drawable) != 0);
+            glUniform1i(_uniformPositionBase[1], _vertexOffsets[drawable] * instanceCount);
+            glUniform1i(_uniformVertexCount[1], model->GetDrawableVertexCount(drawable));
+
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0,
+                                  reinterpret_cast<const void*>(sizeof(csmFloat32) * 2 * static_cast<size_t>(_vertexOffsets[drawable])));
+            glDrawElementsInstanced(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT,
+                                    reinterpret_cast<const void*>(sizeof(csmUint16) * static_cast<size_t>(_indexOffsets[drawable])),
+                                    instanceCount);
+            _drawStats.drawCalls++;
+            _drawStats.maskDrawCalls++;
+        }
+    }
+
+    _maskAtlas.EndDraw();
+}
@@ -0,0 +1,155 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <CubismFramework.hpp>
+#include <Model/CubismModel.hpp>
+#include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
+
+#include <vector>
+
+class LAppModel;
+
+/**
+* @brief 把同一模型的多个实例合在一起绘制
+*
+* 各实例仍是独立的 LAppModel，参数、动作与 MVP 各自设置，只有绘制交给这里。
+* UV 与顶点索引在各实例间相同，只上传一次；纹理使用第一个实例绑定的纹理（启用资源缓存时各实例本就是同一份）。
+* 每帧把所有实例的顶点坐标写入一块纹理缓冲，按 drawable 的绘制顺序对每个 drawable 发出一次实例化绘制，
+* 顶点着色器用 gl_InstanceID 与 gl_VertexID 取出该实例的坐标、MVP、不透明度与颜色。
+* 遮罩按 (裁剪上下文, 实例) 在一张共享的图集中各占一格（四个通道各算一格），每个遮罩 drawable 同样只绘制一次。
+* 因此绘制次数只取决于模型，与实例数无关。
+*
+* 与逐个 Draw 的区别：
+* - 绘制顺序取第一个实例的，其他实例由参数改变的绘制顺序不生效
+* - 同一 drawable 的各实例依次绘制，实例之间重叠时后面的实例的 drawable 会与前面的实例交错
+* - 遮罩始终使用图集，不使用高精度遮罩
+*
+* 需要 OpenGL 3.1（纹理缓冲与实例化绘制），不满足时或坐标超出纹理缓冲的上限时退回逐个调用 LAppModel::Draw。
+*/
+class LAppCrowdRenderer
+{
+public:
+    struct DrawStats
+    {
+        Csm::csmInt32 instances;
+        Csm::csmInt32 drawCalls;      ///< 含遮罩的绘制
+        Csm::csmInt32 maskDrawCalls;
+        Csm::csmBool instanced;       ///< false 表示退回了逐个绘制
+    };
+
+    LAppCrowdRenderer();
+
+    ~LAppCrowdRenderer();
+
+    /**
+    * @brief 设置参与绘制的实例，须由同一个模型加载
+    *
+    * @return 模型未加载或 drawable 的结构不一致时返回 false，此时不保留任何实例
+    */
+    Csm::csmBool SetInstances(LAppModel* const* models, Csm::csmInt32 count);
+
+    /**
+    * @brief 遮罩图集的边长（像素），默认 2048；实例与裁剪上下文越多，每格的分辨率越低
+    */
+    void SetMaskAtlasSize(Csm::csmInt32 size);
+
+    Csm::csmInt32 GetMaskAtlasSize() const;
+
+    /**
+    * @brief 绘制所有实例，须在与模型相同的 GL 上下文中调用
+    */
+    void Draw();
+
+    const DrawStats& GetDrawStats() const;
+
+private:
+    /**
+    * @brief 共用同一组遮罩的 drawable，对应 CubismClippingContext
+    */
+    struct ClipContext
+    {
+        std::vector<Csm::csmInt32> clippingDrawables; ///< 作为遮罩绘制的 drawable
+        std::vector<Csm::csmInt32> clippedDrawables;  ///< 被遮罩的 drawable
+    };
+
+    /**
+    * @brief 按 drawable 数目与实例数计算各缓冲的布局
+    */
+    void BuildLayout();
+
+    /**
+    * @brief 创建着色器、缓冲与图集，失败时返回 false 并退回逐个绘制
+    */
+    Csm::csmBool SetupGl();
+
+    void ReleaseGl();
+
+    /**
+    * @brief 把第 index 个实例的顶点、颜色与遮罩变换写入暂存区，各实例之间可以并行
+    */
+    void Gather(Csm::csmInt32 index);
+
+    static void GatherTask(void* context, Csm::csmInt32 index);
+
+    void DrawMasks();
+
+    void DrawInstanced();
+
+    void DrawEach();
+
+    std::vector<LAppModel*> _models;
+    std::vector<Csm::CubismModel*> _cubismModels; ///< 重新加载模型后需要重建
+    DrawStats _drawStats;
+
+    // 以第一个实例为准的静态数据
+    Csm::csmInt32 _drawableCount;
+    std::vector<Csm::csmInt32> _vertexOffsets;    ///< 各 drawable 在所有 drawable 的顶点中的起点
+    std::vector<Csm::csmInt32> _indexOffsets;
+    Csm::csmInt32 _totalVertexCount;
+    Csm::csmInt32 _totalIndexCount;
+    std::vector<ClipContext> _clipContexts;
+    std::vector<Csm::csmInt32> _clipContextOfDrawable; ///< -1 表示不使用遮罩
+    std::vector<Csm::csmInt32> _sortedDrawables;
+
+    // 实例数据中各部分的起点（以 RGBA32F 的 texel 计）
+    Csm::csmInt32 _drawableDataBase;
+    Csm::csmInt32 _maskDataBase;
+    Csm::csmInt32 _instanceDataTexels;
+    Csm::csmInt32 _maskGridSize;                  ///< 图集每边的格数，每格四个通道各放一个 (上下文, 实例)
+    Csm::csmBool _layoutDirty;                    ///< UV 与索引需要重新上传
+
+    std::vector<Csm::csmFloat32> _positions;      ///< [drawable][实例][顶点] 的 xy
+    std::vector<Csm::csmFloat32> _instanceData;
+    std::vector<Csm::csmUint8> _visible;         ///< [drawable][实例]
+
+    Csm::csmInt32 _maskAtlasSize;
+    Csm::Rendering::CubismOffscreenSurface_OpenGLES2 _maskAtlas;
+
+    Csm::csmBool _glReady;
+    Csm::csmBool _glFailed;
+    GLuint _drawProgram;
+    GLuint _maskProgram;
+    GLuint _uvBuffer;
+    GLuint _indexBuffer;
+    GLuint _positionBuffer;
+    GLuint _positionTexture;
+    GLuint _instanceBuffer;
+    GLuint _instanceTexture;
+    GLint _maxTextureBufferSize;
+
+    // uniform 的位置，下标 0 为绘制用，1 为遮罩用
+    GLint _uniformPositionBase[2];
+    GLint _uniformVertexCount[2];
+    GLint _uniformMaskBase[2];
+    GLint _uniformDrawableBase;
+    GLint _uniformMaskMode;
+    GLint _uniformPremultipliedAlpha;
+};
@@ -0,0 +1,589 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppLipSync.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "LAppPal.hpp"
+#include "Log.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAPP_LIPSYNC_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LAPP_LIPSYNC_NEON
+#endif
+
+using namespace Csm;
+
+namespace
+{
+    const csmFloat32 Pi = 3.14159265358979f;
+
+    // 频带覆盖前两个共振峰所在的范围，按对数等间隔排列
+    const csmFloat32 LowestBandHz = 150.0f;
+    const csmFloat32 HighestBandHz = 4000.0f;
+
+    // 各元音第一、第二共振峰的典型频率（Hz），顺序与 LAppLipSync::Vowel 一致
+    const csmFloat32 Formants[LAppLipSync::Vowel_Count][2] =
+    {
+        { 800.0f, 1200.0f }, // a
+        { 300.0f, 2300.0f }, // i
+        { 350.0f, 1400.0f }, // u
+        { 500.0f, 1900.0f }, // e
+        { 500.0f, 850.0f },  // o
+    };
+
+    const csmFloat32 FormantWidthOctaves = 0.35f;
+    const csmFloat32 SecondFormantWeight = 0.7f;
+    const csmFloat32 PreEmphasis = 0.95f;
+
+    const csmFloat32 SilenceRms = 1e-3f;        // 低于此值视为无声，不估计元音
+    const csmFloat32 VowelSharpness = 24.0f;    // 相似度做 softmax 时的系数
+    const csmFloat32 VowelSmoothSeconds = 0.06f;
+    const csmFloat32 StarveHoldSeconds = 0.1f;  // 流短暂断供时保持上一帧的口型
+
+    /**
+    * @brief 平方和，ring 回绕时对两段分别调用
+    */
+    csmFloat32 SumOfSquares(const csmFloat32* samples, csmUint32 count)
+    {
+        csmUint32 i = 0;
+        csmFloat32 sum = 0.0f;
+
+#if defined(LAPP_LIPSYNC_SSE2)
+        __m128 acc0 = _mm_setzero_ps();
+        __m128 acc1 = _mm_setzero_ps();
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128 a = _mm_loadu_ps(samples + i);
+            const __m128 b = _mm_loadu_ps(samples + i + 4);
+            acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+            acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+        }
+        csmFloat32 lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+        sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(LAPP_LIPSYNC_NEON)
+        float32x4_t acc0 = vdupq_n_f32(0.0f);
+        float32x4_t acc1 = vdupq_n_f32(0.0f);
+        for (; i + 8 <= count; i += 8)
+        {
+            const float32x4_t a = vld1q_f32(samples + i);
+            const float32x4_t b = vld1q_f32(samples + i + 4);
+            acc0 = vmlaq_f32(acc0, a, a);
+            acc1 = vmlaq_f32(acc1, b, b);
+        }
+        const float32x4_t acc = vaddq_f32(acc0, acc1);
+        sum = (vgetq_lane_f32(acc, 0) + vgetq_lane_f32(acc, 1)) + (vgetq_lane_f32(acc, 2) + vgetq_lane_f32(acc, 3));
+#endif
+
+        for (; i < count; ++i)
+        {
+            sum += samples[i] * samples[i];
+        }
+        return sum;
+    }
+
+    csmUint16 ReadUint16(const csmByte* p)
+    {
+        return static_cast<csmUint16>(p[0] | (p[1] << 8));
+    }
+
+    csmUint32 ReadUint32(const csmByte* p)
+    {
+        return static_cast<csmUint32>(p[0]) | (static_cast<csmUint32>(p[1]) << 8)
+            | (static_cast<csmUint32>(p[2]) << 16) | (static_cast<csmUint32>(p[3]) << 24);
+    }
+
+    /**
+    * @brief 读取一个样本并转换为 [-1, 1]，float 为 true 时 bytes 须为 4
+    */
+    csmFloat32 DecodeSample(const csmByte* p, csmUint32 bytes, csmBool isFloat)
+    {
+        if (isFloat)
+        {
+            csmFloat32 value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        switch (bytes)
+        {
+        case 1:
+            return (static_cast<csmInt32>(p[0]) - 128) / 128.0f; // 8 位为无符号
+        case 2:
+            return static_cast<csmInt16>(ReadUint16(p)) / 32768.0f;
+        case 3:
+            return static_cast<csmInt32>((static_cast<csmUint32>(p[0]) << 8) | (static_cast<csmUint32>(p[1]) << 16)
+                                         | (static_cast<csmUint32>(p[2]) << 24)) / 2147483648.0f;
+        default:
+            return static_cast<csmInt32>(ReadUint32(p)) / 2147483648.0f;
+        }
+    }
+}
+
+LAppLipSync::LAppLipSync()
+    : _sampleRate(0)
+    , _channels(1)
+    , _sampleCarry(0.0)
+    , _ringMask(0)
+    , _writeCount(0)
+    , _readCount(0)
+    , _streamOpen(false)
+    , _clipPosition(0)
+    , _clipActive(false)
+    , _gain(1.0f)
+    , _rms(0.0f)
+    , _starvedSeconds(0.0f)
+    , _vowelEnabled(false)
+    , _bandCount(0)
+    , _lastSample(0.0f)
+{
+    memset(_bands, 0, sizeof(_bands));
+    memset(_bandEnergy, 0, sizeof(_bandEnergy));
+    memset(_templates, 0, sizeof(_templates));
+    memset(_vowelWeights, 0, sizeof(_vowelWeights));
+}
+
+LAppLipSync::~LAppLipSync()
+{
+}
+
+void LAppLipSync::OpenStream(csmInt32 sampleRate, csmInt32 channels, csmFloat32 bufferSeconds)
+{
+    Stop();
+    Reset(std::max(1, sampleRate));
+    _channels = std::max(1, channels);
+
+    // 容量取不小于所需样本数的 2 的幂，下标用掩码回绕
+    const csmFloat32 seconds = std::max(bufferSeconds, 0.01f);
+    const csmUint32 required = static_cast<csmUint32>(std::ceil(seconds * _sampleRate));
+    csmUint32 capacity = 256;
+    while (capacity < required && capacity < (1u << 26))
+    {
+        capacity <<= 1;
+    }
+
+    _ring.Resize(static_cast<csmInt32>(capacity), 0.0f);
+    _ringMask = capacity - 1;
+    _writeCount.store(0, std::memory_order_relaxed);
+    _readCount.store(0, std::memory_order_relaxed);
+    _streamOpen = true;
+}
+
+csmInt32 LAppLipSync::Feed(const void* data, csmInt32 frameCount, SampleFormat format)
+{
+    if (!_streamOpen || data == NULL || frameCount <= 0)
+    {
+        return 0;
+    }
+
+    const csmUint32 write = _writeCount.load(std::memory_order_relaxed);
+    const csmUint32 read = _readCount.load(std::memory_order_acquire);
+    const csmUint32 space = _ringMask + 1 - (write - read);
+    const csmUint32 frames = std::min(static_cast<csmUint32>(frameCount), space);
+
+    csmFloat32* ring = _ring.GetPtr();
+    const csmFloat32 scale = 1.0f / _channels;
+
+    // 声道取平均混为单声道
+    if (format == SampleFormat_Int16)
+    {
+        const csmInt16* in = static_cast<const csmInt16*>(data);
+        for (csmUint32 i = 0; i < frames; ++i)
+        {
+            csmInt32 sum = 0;
+            for (csmInt32 c = 0; c < _channels; ++c)
+            {
+                sum += *in++;
+            }
+            ring[(write + i) & _ringMask] = sum * scale / 32768.0f;
+        }
+    }
+    else
+    {
+        const csmFloat32* in = static_cast<const csmFloat32*>(data);
+        for (csmUint32 i = 0; i < frames; ++i)
+        {
+            csmFloat32 sum = 0.0f;
+            for (csmInt32 c = 0; c < _channels; ++c)
+            {
+                sum += *in++;
+            }
+            ring[(write + i) & _ringMask] = sum * scale;
+        }
+    }
+
+    _writeCount.store(write + frames, std::memory_order_release);
+    return static_cast<csmInt32>(frames);
+}
+
+csmBool LAppLipSync::LoadWav(const csmChar* filePath)
+{
+    Stop();
+
+    csmSizeInt size = 0;
+    csmByte* bytes = LAppPal::LoadFileAsBytes(filePath, &size);
+    if (bytes == NULL)
+    {
+        return false;
+    }
+
+    csmBool formatFound = false;
+    csmBool isFloat = false;
+    csmUint32 channels = 0;
+    csmUint32 sampleRate = 0;
+    csmUint32 bitsPerSample = 0;
+    csmUint32 blockAlign = 0;
+    const csmByte* data = NULL;
+    csmUint32 dataSize = 0;
+
+    if (size >= 12 && memcmp(bytes, "RIFF", 4) == 0 && memcmp(bytes + 8, "WAVE", 4) == 0)
+    {
+        csmUint32 offset = 12;
+        while (offset + 8 <= size)
+        {
+            const csmByte* chunk = bytes + offset;
+            const csmUint32 chunkSize = std::min(ReadUint32(chunk + 4), static_cast<csmUint32>(size - offset - 8));
+
+            if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16)
+            {
+                csmUint16 tag = ReadUint16(chunk + 8);
+                channels = ReadUint16(chunk + 10);
+                sampleRate = ReadUint32(chunk + 12);
+                blockAlign = ReadUint16(chunk + 20);
+                bitsPerSample = ReadUint16(chunk + 22);
+                if (tag == 0xFFFE && chunkSize >= 40)
+                {
+                    tag = ReadUint16(chunk + 32); // WAVE_FORMAT_EXTENSIBLE 的 SubFormat
+                }
+                isFloat = tag == 3;
+                formatFound = (tag == 1 && bitsPerSample >= 8 && bitsPerSample <= 32 && bitsPerSample % 8 == 0)
+                    || (isFloat && bitsPerSample == 32);
+            }
+            else if (memcmp(chunk, "data", 4) == 0)
+            {
+                data = chunk + 8;
+                dataSize = chunkSize;
+            }
+
+            offset += 8 + chunkSize + (chunkSize & 1);
+        }
+    }
+
+    const csmUint32 sampleBytes = bitsPerSample / 8;
+    if (!formatFound || data == NULL || channels == 0 || sampleRate == 0 || blockAlign < channels * sampleBytes)
+    {
+        Error("unsupported wav file: %s", filePath);
+        LAppPal::ReleaseBytes(bytes);
+        return false;
+    }
+
+    const csmUint32 frameCount = dataSize / blockAlign;
+    _clip.Resize(static_cast<csmInt32>(frameCount), 0.0f);
+
+    csmFloat32 peak = 0.0f;
+    for (csmUint32 i = 0; i < frameCount; ++i)
+    {
+        const csmByte* frame = data + static_cast<csmSizeInt>(i) * blockAlign;
+        csmFloat32 sum = 0.0f;
+        for (csmUint32 c = 0; c < channels; ++c)
+        {
+            sum += DecodeSample(frame + c * sampleBytes, sampleBytes, isFloat);
+        }
+        const csmFloat32 value = sum / channels;
+        _clip[i] = value;
+        peak = std::max(peak, std::fabs(value));
+    }
+    LAppPal::ReleaseBytes(bytes);
+
+    if (peak > 0.0f)
+    {
+        const csmFloat32 scale = 1.0f / peak;
+        for (csmUint32 i = 0; i < frameCount; ++i)
+        {
+            _clip[i] *= scale;
+        }
+    }
+
+    Reset(static_cast<csmInt32>(sampleRate));
+    _clipPosition = 0;
+    _clipActive = frameCount > 0;
+    return _clipActive;
+}
+
+void LAppLipSync::Stop()
+{
+    _streamOpen = false;
+    _ring.Clear();
+    _ringMask = 0;
+    _clipActive = false;
+    _clip.Clear();
+    _clipPosition = 0;
+    _rms = 0.0f;
+    memset(_vowelWeights, 0, sizeof(_vowelWeights));
+}
+
+csmBool LAppLipSync::IsActive() const
+{
+    return _streamOpen || _clipActive;
+}
+
+csmInt32 LAppLipSync::GetChannelCount() const
+{
+    return _channels;
+}
+
+void LAppLipSync::Update(csmFloat32 deltaTimeSeconds)
+{
+    if (!IsActive() || deltaTimeSeconds <= 0.0f)
+    {
+        return;
+    }
+
+    _sampleCarry += static_cast<double>(deltaTimeSeconds) * _sampleRate;
+    const csmUint32 wanted = static_cast<csmUint32>(_sampleCarry);
+    _sampleCarry -= wanted;
+    if (wanted == 0)
+    {
+        return;
+    }
+
+    if (_clipActive)
+    {
+        const csmUint32 count = std::min(wanted, _clip.GetSize() - _clipPosition);
+        Analyze(&_clip[0] + _clipPosition, count, NULL, 0, deltaTimeSeconds);
+        _clipPosition += count;
+        if (_clipPosition >= _clip.GetSize())
+        {
+            // 播放完毕，下一次 Update 起不再驱动口型
+            _clipActive = false;
+            _clip.Clear();
+            _clipPosition = 0;
+        }
+        return;
+    }
+
+    const csmUint32 read = _readCount.load(std::memory_order_relaxed);
+    const csmUint32 available = _writeCount.load(std::memory_order_acquire) - read;
+    const csmUint32 count = std::min(wanted, available);
+
+    if (count == 0)
+    {
+        // 生产者的推送间隔可能比一帧长，短暂断供时保持口型，持续断供才闭嘴
+        _starvedSeconds += deltaTimeSeconds;
+        if (_starvedSeconds >= StarveHoldSeconds)
+        {
+            _rms = 0.0f;
+            memset(_vowelWeights, 0, sizeof(_vowelWeights));
+        }
+        return;
+    }
+    _starvedSeconds = 0.0f;
+
+    const csmUint32 start = read & _ringMask;
+    const csmUint32 firstCount = std::min(count, _ringMask + 1 - start);
+    const csmFloat32* ring = _ring.GetPtr();
+    Analyze(ring + start, firstCount, ring, count - firstCount, deltaTimeSeconds);
+
+    _readCount.store(read + count, std::memory_order_release);
+}
+
+csmFloat32 LAppLipSync::GetValue() const
+{
+    return std::min(1.0f, _rms * _gain);
+}
+
+void LAppLipSync::SetGain(csmFloat32 gain)
+{
+    _gain = std::max(0.0f, gain);
+}
+
+csmFloat32 LAppLipSync::GetGain() const
+{
+    return _gain;
+}
+
+void LAppLipSync::SetVowelEnable(csmBool enable)
+{
+    _vowelEnabled = enable;
+    if (!enable)
+    {
+        memset(_vowelWeights, 0, sizeof(_vowelWeights));
+    }
+}
+
+csmBool LAppLipSync::IsVowelEnabled() const
+{
+    return _vowelEnabled;
+}
+
+void LAppLipSync::GetVowelWeights(csmFloat32* outWeights) const
+{
+    memcpy(outWeights, _vowelWeights, sizeof(_vowelWeights));
+}
+
+void LAppLipSync::Reset(csmInt32 sampleRate)
+{
+    _sampleRate = sampleRate;
+    _sampleCarry = 0.0;
+    _rms = 0.0f;
+    _starvedSeconds = 0.0f;
+    _lastSample = 0.0f;
+    memset(_vowelWeights, 0, sizeof(_vowelWeights));
+
+    // RBJ 带通滤波器，Q 取相邻频带的间隔，高于 0.45 倍采样率的频带略去
+    const csmFloat32 ratio = std::pow(HighestBandHz / LowestBandHz, 1.0f / (MaxBandCount - 1));
+    const csmFloat32 q = std::sqrt(ratio) / (ratio - 1.0f);
+
+    _bandCount = 0;
+    for (csmInt32 i = 0; i < MaxBandCount; ++i)
+    {
+        const csmFloat32 center = LowestBandHz * std::pow(ratio, static_cast<csmFloat32>(i));
+        if (center >= 0.45f * _sampleRate)
+        {
+            break;
+        }
+
+        const csmFloat32 w0 = 2.0f * Pi * center / _sampleRate;
+        const csmFloat32 alpha = std::sin(w0) / (2.0f * q);
+        const csmFloat32 a0 = 1.0f + alpha;
+
+        Band& band = _bands[i];
+        band.b0 = alpha / a0;
+        band.b2 = -alpha / a0;
+        band.a1 = -2.0f * std::cos(w0) / a0;
+        band.a2 = (1.0f - alpha) / a0;
+        band.z1 = 0.0f;
+        band.z2 = 0.0f;
+
+        // 模板：两个共振峰处的对数频率高斯峰
+        for (csmInt32 v = 0; v < Vowel_Count; ++v)
+        {
+            const csmFloat32 d1 = std::log2(center / Formants[v][0]) / FormantWidthOctaves;
+            const csmFloat32 d2 = std::log2(center / Formants[v][1]) / FormantWidthOctaves;
+            _templates[v][i] = std::exp(-0.5f * d1 * d1) + SecondFormantWeight * std::exp(-0.5f * d2 * d2);
+        }
+
+        ++_bandCount;
+    }
+
+    for (csmInt32 v = 0; v < Vowel_Count; ++v)
+    {
+        csmFloat32 norm = 0.0f;
+        for (csmInt32 i = 0; i < _bandCount; ++i)
+        {
+            norm += _templates[v][i] * _templates[v][i];
+        }
+        norm = norm > 0.0f ? 1.0f / std::sqrt(norm) : 0.0f;
+        for (csmInt32 i = 0; i < _bandCount; ++i)
+        {
+            _templates[v][i] *= norm;
+        }
+    }
+}
+
+void LAppLipSync::Analyze(const csmFloat32* first, csmUint32 firstCount,
+                          const csmFloat32* second, csmUint32 secondCount,
+                          csmFloat32 deltaTimeSeconds)
+{
+    const csmUint32 count = firstCount + secondCount;
+    if (count == 0)
+    {
+        return;
+    }
+
+    const csmFloat32 sum = SumOfSquares(first, firstCount) + SumOfSquares(second, secondCount);
+    _rms = std::sqrt(sum / count);
+
+    if (!_vowelEnabled)
+    {
+        return;
+    }
+
+    memset(_bandEnergy, 0, sizeof(_bandEnergy));
+    AnalyzeBands(first, firstCount);
+    AnalyzeBands(second, secondCount);
+    UpdateVowelWeights(count, deltaTimeSeconds);
+}
+
+void LAppLipSync::AnalyzeBands(const csmFloat32* samples, csmUint32 count)
+{
+    for (csmUint32 n = 0; n < count; ++n)
+    {
+        // 预加重抵消语音频谱的高频衰减，使第二共振峰不被第一共振峰淹没
+        const csmFloat32 x = samples[n] - PreEmphasis * _lastSample;
+        _lastSample = samples[n];
+
+        for (csmInt32 i = 0; i < _bandCount; ++i)
+        {
+            Band& band = _bands[i];
+            const csmFloat32 y = band.b0 * x + band.z1;
+            band.z1 = -band.a1 * y + band.z2;
+            band.z2 = band.b2 * x - band.a2 * y;
+            _bandEnergy[i] += y * y;
+        }
+    }
+}
+
+void LAppLipSync::UpdateVowelWeights(csmUint32 count, csmFloat32 deltaTimeSeconds)
+{
+    csmFloat32 target[Vowel_Count] = {};
+
+    if (_rms >= SilenceRms)
+    {
+        // 频带幅度归一化后与各模板求余弦相似度，再做 softmax
+        csmFloat32 amplitude[MaxBandCount];
+        csmFloat32 norm = 0.0f;
+        for (csmInt32 i = 0; i < _bandCount; ++i)
+        {
+            amplitude[i] = std::sqrt(_bandEnergy[i] / count);
+            norm += amplitude[i] * amplitude[i];
+        }
+
+        if (norm > 0.0f)
+        {
+            norm = 1.0f / std::sqrt(norm);
+
+            csmFloat32 similarity[Vowel_Count];
+            csmFloat32 best = -1.0f;
+            for (csmInt32 v = 0; v < Vowel_Count; ++v)
+            {
+                csmFloat32 dot = 0.0f;
+                for (csmInt32 i = 0; i < _bandCount; ++i)
+                {
+                    dot += amplitude[i] * _templates[v][i];
+                }
+                similarity[v] = dot * norm;
+                best = std::max(best, similarity[v]);
+            }
+
+            csmFloat32 total = 0.0f;
+            for (csmInt32 v = 0; v < Vowel_Count; ++v)
+            {
+                target[v] = std::exp(VowelSharpness * (similarity[v] - best));
+                total += target[v];
+            }
+            for (csmInt32 v = 0; v < Vowel_Count; ++v)
+            {
+                target[v] /= total;
+            }
+        }
+    }
+
+    // 一阶平滑，避免元音在相邻帧之间跳动
+    const csmFloat32 t = 1.0f - std::exp(-deltaTimeSeconds / VowelSmoothSeconds);
+    for (csmInt32 v = 0; v < Vowel_Count; ++v)
+    {
+        _vowelWeights[v] += (target[v] - _vowelWeights[v]) * t;
+    }
+}
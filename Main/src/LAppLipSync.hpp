@@ -0,0 +1,156 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Type/csmVector.hpp>
+
+#include <atomic>
+
+/**
+* @brief 口型同步的音频分析
+*
+* 音频有两种来源：OpenStream 之后由 Feed 推入的 PCM 流，以及 LoadWav 读入的整段 wav。
+* 推入的样本混为单声道后写入无锁的环形缓冲区，Update 按模型时间取出对应数量的样本，
+* 以这段样本的 RMS 作为张嘴程度；开启元音分析时再由一组带通滤波器的能量估计 a/i/u/e/o 的权重。
+* 缓冲区满时新样本被丢弃，因此口型落后于音频的时间不超过 bufferSeconds。
+* Feed 可以在另一个线程上与 Update 同时调用，其余方法须在更新模型的线程上调用。
+*/
+class LAppLipSync
+{
+public:
+    enum SampleFormat
+    {
+        SampleFormat_Int16,   ///< 有符号 16 位整数
+        SampleFormat_Float32, ///< [-1, 1] 的 32 位浮点数
+    };
+
+    enum Vowel
+    {
+        Vowel_A,
+        Vowel_I,
+        Vowel_U,
+        Vowel_E,
+        Vowel_O,
+        Vowel_Count,
+    };
+
+    LAppLipSync();
+    ~LAppLipSync();
+
+    /**
+    * @brief 打开 PCM 流，丢弃之前的音频
+    *
+    * @param bufferSeconds 环形缓冲区能容纳的秒数，即口型相对音频的最大延迟
+    */
+    void OpenStream(Csm::csmInt32 sampleRate, Csm::csmInt32 channels, Csm::csmFloat32 bufferSeconds);
+
+    /**
+    * @brief 推入交错排列的 PCM 帧
+    *
+    * @return 写入的帧数，缓冲区已满或没有打开的流时小于 frameCount
+    */
+    Csm::csmInt32 Feed(const void* data, Csm::csmInt32 frameCount, SampleFormat format);
+
+    /**
+    * @brief 读入 wav 文件并从头开始分析，丢弃之前的音频
+    *
+    * 支持 8/16/24/32 位整数与 32 位浮点 PCM，与 WavHandler 一样按峰值归一化。
+    *
+    * @return 文件无法读取或格式不支持时返回 false
+    */
+    Csm::csmBool LoadWav(const Csm::csmChar* filePath);
+
+    /**
+    * @brief 关闭流或 wav，张嘴程度与元音权重归零
+    */
+    void Stop();
+
+    /**
+    * @brief 是否有正在分析的音频，wav 分析完后变为 false，流在 Stop 之前一直有效
+    */
+    Csm::csmBool IsActive() const;
+
+    /**
+    * @brief 打开的流每帧的声道数
+    */
+    Csm::csmInt32 GetChannelCount() const;
+
+    /**
+    * @brief 取出 deltaTimeSeconds 对应的样本并更新分析结果
+    */
+    void Update(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+    * @brief 最近一次 Update 的 RMS 乘以增益，截断到 [0, 1]
+    */
+    Csm::csmFloat32 GetValue() const;
+
+    void SetGain(Csm::csmFloat32 gain);
+
+    Csm::csmFloat32 GetGain() const;
+
+    void SetVowelEnable(Csm::csmBool enable);
+
+    Csm::csmBool IsVowelEnabled() const;
+
+    /**
+    * @brief 平滑后的各元音权重，持续有声时和趋近 1，无声或未开启元音分析时衰减为 0
+    *
+    * @param outWeights 长度为 Vowel_Count 的数组
+    */
+    void GetVowelWeights(Csm::csmFloat32* outWeights) const;
+
+private:
+    LAppLipSync(const LAppLipSync&);
+    LAppLipSync& operator=(const LAppLipSync&);
+
+    /**
+    * @brief 带通滤波器的个数上限
+    */
+    static const Csm::csmInt32 MaxBandCount = 16;
+
+    struct Band
+    {
+        Csm::csmFloat32 b0, b2, a1, a2; ///< 归一化后的 biquad 系数，b1 恒为 0
+        Csm::csmFloat32 z1, z2;
+    };
+
+    void Reset(Csm::csmInt32 sampleRate);
+    void Analyze(const Csm::csmFloat32* first, Csm::csmUint32 firstCount,
+                 const Csm::csmFloat32* second, Csm::csmUint32 secondCount,
+                 Csm::csmFloat32 deltaTimeSeconds);
+    void AnalyzeBands(const Csm::csmFloat32* samples, Csm::csmUint32 count);
+    void UpdateVowelWeights(Csm::csmUint32 count, Csm::csmFloat32 deltaTimeSeconds);
+
+    Csm::csmInt32 _sampleRate;
+    Csm::csmInt32 _channels;
+    double _sampleCarry;                       ///< 尚未取出的不足一个样本的部分
+
+    Csm::csmVector<Csm::csmFloat32> _ring;     ///< 单声道的环形缓冲区，长度为 2 的幂
+    Csm::csmUint32 _ringMask;
+    std::atomic<Csm::csmUint32> _writeCount;   ///< 累计写入的样本数，仅 Feed 修改
+    std::atomic<Csm::csmUint32> _readCount;    ///< 累计取出的样本数，仅 Update 修改
+    Csm::csmBool _streamOpen;
+
+    Csm::csmVector<Csm::csmFloat32> _clip;     ///< 归一化后的 wav 样本
+    Csm::csmUint32 _clipPosition;
+    Csm::csmBool _clipActive;
+
+    Csm::csmFloat32 _gain;
+    Csm::csmFloat32 _rms;
+    Csm::csmFloat32 _starvedSeconds;           ///< 流连续没有样本的时间
+
+    Csm::csmBool _vowelEnabled;
+    Csm::csmInt32 _bandCount;
+    Band _bands[MaxBandCount];
+    Csm::csmFloat32 _bandEnergy[MaxBandCount];
+    Csm::csmFloat32 _templates[Vowel_Count][MaxBandCount]; ///< 各元音归一化的频带能量模板
+    Csm::csmFloat32 _lastSample;               ///< 预加重用的上一个样本
+    Csm::csmFloat32 _vowelWeights[Vowel_Count];
+};
@@ -7,6 +7,7 @@
  */
 
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <vector>
 #include <CubismModelSettingJson.hpp>
@@ -20,6 +21,7 @@
 #include "LAppDefine.hpp"
 #include "LAppPal.hpp"
 #include "LAppTextureManager.hpp"
+#include "LAppAssetCache.hpp"
 
 #include <Log.hpp>
 #include <filesystem>
@@ -42,6 +44,26 @@ namespace
         Info("delete buffer: %s", path);
         LAppPal::ReleaseBytes(buffer);
     }
+
+    /**
+     * @brief 按 id 查找参数下标，不存在时返回 -1 且不登记为新参数
+     */
+    csmInt32 FindParameterIndex(CubismModel *model, CubismIdHandle id)
+    {
+        for (csmInt32 i = 0; i < model->GetParameterCount(); ++i)
+        {
+            if (model->GetParameterId(i) == id)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    csmFloat32 MillisecondsSince(double start)
+    {
+        return static_cast<csmFloat32>((LAppPal::GetCurrentTimePoint() - start) * 1000.0);
+    }
 }
 
 class FakeMotion : public ACubismMotion
@@ -56,11 +78,66 @@ public:
     FakeMotion() = default;
 };
 
+namespace
+{
+    // 动作文件不存在时直接依次调用开始与结束回调
+    void NotifyMissingMotion(const csmChar *group, csmInt32 no,
+                             void *onStartedCallee, ACubismMotion::BeganMotionCallback onStartMotionHandler,
+                             void *onFinishedCallee, ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
+    {
+        FakeMotion fakeMotion;
+        fakeMotion.group = group;
+        fakeMotion.no = no;
+        fakeMotion.onStartedCallee = onStartedCallee;
+        fakeMotion.onFinishedCallee = onFinishedCallee;
+        if (onStartMotionHandler)
+        {
+            onStartMotionHandler(&fakeMotion);
+        }
+        if (onFinishedMotionHandler)
+        {
+            onFinishedMotionHandler(&fakeMotion);
+        }
+    }
+
+    void SetMotionCallbacks(ACubismMotion *motion, const csmChar *group, csmInt32 no,
+                            void *onStartedCallee, ACubismMotion::BeganMotionCallback onStartMotionHandler,
+                            void *onFinishedCallee, ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
+    {
+        motion->group = group;
+        motion->no = no;
+        motion->onStartedCallee = onStartedCallee;
+        motion->onFinishedCallee = onFinishedCallee;
+        motion->SetBeganMotionHandler(onStartMotionHandler);
+        motion->SetFinishedMotionHandler(onFinishedMotionHandler);
+    }
+}
+
 LAppModel::LAppModel()
-    : CubismUserModel(), _modelSetting(nullptr), _autoBlink(true), _autoBreath(true),
-      _matrixManager(), _tmpOrderedDrawIndices(nullptr), _defaultParameterValues(nullptr),
-      _parameterValues(nullptr), _parameterCount(0), _clearMotionFlag(false), _lastFrame(0.0), _currentFrame(0.0)
+    : CubismUserModel(), _modelSetting(nullptr), _matrixManager(), _autoBreath(true), _autoBlink(true),
+      _tmpOrderedDrawIndices(nullptr), _currentFrame(0.0), _lastFrame(0.0), _defaultParameterValues(nullptr),
+      _parameterValues(nullptr), _clearMotionFlag(false), _parameterCount(0), _arena(nullptr),
+      _motionMixer(CubismDefaultMotionEventCallback, this), _loadPeakBytes(0), _preloadMotions(true)
 {
+    _memoryAccount = LAppMemoryAccount::Create();
+    memset(&_loadTimings, 0, sizeof(_loadTimings));
+    _pendingMotion.active = false;
+    _proceduralEffects = true;
+    _deltaTimeSeconds = 0.0f;
+    _elapsedSeconds = 0.0;
+    _drawablesUpdated = false;
+    _pipeline = nullptr;
+    _pipelineHook = nullptr;
+    _pipelineHookContext = nullptr;
+    _pipelineDeltaTime = 0.0f;
+    _parameterChannelWeight = 1.0f;
+    _modelGeneration = 0;
+    for (csmInt32 v = 0; v < LAppLipSync::Vowel_Count; ++v)
+    {
+        _vowelParamIndices[v] = -1;
+    }
+    SetRandomSeed(static_cast<csmUint32>(rand()));
+
     _mocConsistency = MocConsistencyValidationEnable;
 
     _idParamAngleX = CubismFramework::GetIdManager()->GetId(ParamAngleX);
@@ -73,12 +150,31 @@ LAppModel::LAppModel()
 
 LAppModel::~LAppModel()
 {
+    // 模拟线程可能仍在访问模型，须最先结束
+    ReleasePipeline(false);
+
+    // arena 在其中的块全部释放后才真正归还，CubismUserModel 的析构晚于此处也没有问题
+    if (_arena != nullptr)
+    {
+        _arena->Release();
+    }
+    _memoryAccount->Release();
+
     _renderBuffer.DestroyOffscreenSurface();
     _textureManager.ReleaseTextures();
 
+    CancelPendingMotion();
+    CancelMotionPrefetches();
+
     ReleaseMotions();
     ReleaseExpressions();
 
+    for (csmUint32 i = 0; i < _sharedAssets.GetSize(); ++i)
+    {
+        LAppAssetCache::Release(_sharedAssets[i]);
+    }
+    _sharedAssets.Clear();
+
     if (_modelSetting == nullptr)
         return;
 
@@ -86,8 +182,19 @@ LAppModel::~LAppModel()
     delete[] _tmpOrderedDrawIndices;
 }
 
-void LAppModel::LoadModelJson(const csmChar *fileName)
+void LAppModel::LoadModelJson(const csmChar *fileName, csmBool preloadMotions)
 {
+    _preloadMotions = preloadMotions;
+
+    // 快照与记下的参数修改都属于旧模型
+    const bool pipelined = _pipeline != nullptr;
+    ReleasePipeline(false);
+
+    // 旧模型的预取与等待中的动作不会再开始
+    CancelPendingMotion();
+    CancelMotionPrefetches();
+    _motionManager->SetReservePriority(PriorityNone);
+
     // linux 下不支持对 "XXX/XXX.model.json/../" 的解析
     // 因此改用 cpp17 的标准库
     std::filesystem::path p = std::filesystem::u8path(fileName);
@@ -100,11 +207,36 @@ void LAppModel::LoadModelJson(const csmChar *fileName)
     csmSizeInt size;
     const csmString path = fileName;
 
-    csmByte *buffer = CreateBuffer(path.GetRawString(), &size);
-    ICubismModelSetting *setting = new CubismModelSettingJson(buffer, size);
-    DeleteBuffer(buffer, path.GetRawString());
+    memset(&_loadTimings, 0, sizeof(_loadTimings));
+    const double loadStart = LAppPal::GetCurrentTimePoint();
+
+    // moc 采用文件映射后，加载期间的瞬时峰值应接近 moc 大小的一倍而不是两倍
+    // 不重置进程的峰值（那是整个宿主进程的状态），需要精确值的一方（如基准测试）自行调用 LAppPal::ResetPeakResidentBytes
+    csmUint64 residentBefore, peakBefore;
+    LAppPal::GetResidentBytes(&residentBefore, &peakBefore);
+
+    if (_arena == nullptr)
+    {
+        _arena = LAppAllocator::CreateArena();
+    }
+
+    {
+        // 加载期间的分配放入本模型的 arena，渲染器不在其中
+        LAppAllocator::ArenaScope arenaScope(_arena);
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Other);
+
+        csmByte *buffer = CreateBuffer(path.GetRawString(), &size);
+        ICubismModelSetting *setting = new CubismModelSettingJson(buffer, size);
+        DeleteBuffer(buffer, path.GetRawString());
+        _loadTimings.settingMs = MillisecondsSince(loadStart);
+
+        SetupModel(setting);
+    }
 
-    SetupModel(setting);
+    if (pipelined)
+    {
+        SetPipelineEnable(true, _pipelineHook, _pipelineHookContext);
+    }
 
     if (_model == nullptr)
     {
@@ -112,9 +244,24 @@ void LAppModel::LoadModelJson(const csmChar *fileName)
         return;
     }
 
-    CreateRenderer(2);
+    {
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Renderer);
+        const double start = LAppPal::GetCurrentTimePoint();
 
-    SetupTextures();
+        CreateRenderer(2);
+        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMaskHook(LAppProfiler::MaskHook, &_profiler);
+
+        SetupTextures();
+        _loadTimings.texturesMs = MillisecondsSince(start);
+    }
+    _loadTimings.totalMs = MillisecondsSince(loadStart);
+
+    // 加载抬高了进程峰值时峰值即发生在加载期间；否则只能以加载前后常驻内存之差作为下限
+    csmUint64 resident, peak;
+    LAppPal::GetResidentBytes(&resident, &peak);
+    const csmUint64 loadPeak = peak > peakBefore ? peak : resident;
+    _loadPeakBytes = loadPeak > residentBefore ? static_cast<csmInt64>(loadPeak - residentBefore) : 0;
+    Info("load peak: %lld bytes", static_cast<long long>(_loadPeakBytes));
 }
 
 void LAppModel::SetupModel(ICubismModelSetting *setting)
@@ -135,14 +282,27 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
 
         Info("create model: %s", setting->GetModelFileName());
 
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadModel(buffer, size, _mocConsistency);
-        DeleteBuffer(buffer, path.GetRawString());
+        // 同一 moc 由所有实例共享，每个实例只创建自己的 CubismModel
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Model);
+        const double start = LAppPal::GetCurrentTimePoint();
+        CubismMoc *moc = LAppAssetCache::AcquireMoc(path.GetRawString(), _mocConsistency);
+        if (moc)
+        {
+            _sharedAssets.PushBack(moc);
+            LoadModelFromMoc(moc);
+        }
+        else
+        {
+            Error("Failed to load moc: %s", path.GetRawString());
+        }
+        _loadTimings.mocMs = MillisecondsSince(start);
     }
 
     // Expression
     if (_modelSetting->GetExpressionCount() > 0)
     {
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Expressions);
+        const double start = LAppPal::GetCurrentTimePoint();
         const csmInt32 count = _modelSetting->GetExpressionCount();
         for (csmInt32 i = 0; i < count; i++)
         {
@@ -150,21 +310,21 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
             csmString path = _modelSetting->GetExpressionFileName(i);
             path = _modelHomeDir + path;
 
-            buffer = CreateBuffer(path.GetRawString(), &size);
-            ACubismMotion *motion = LoadExpression(buffer, size, name.GetRawString());
+            const CubismExpressionMotion *expression = LAppAssetCache::AcquireExpression(path.GetRawString());
 
-            if (motion)
+            if (expression)
             {
+                _sharedAssets.PushBack(expression);
+
                 if (_expressions[name] != NULL)
                 {
                     ACubismMotion::Delete(_expressions[name]);
                     _expressions[name] = NULL;
                 }
-                _expressions[name] = motion;
+                _expressions[name] = expression->Clone();
             }
-
-            DeleteBuffer(buffer, path.GetRawString());
         }
+        _loadTimings.expressionsMs = MillisecondsSince(start);
     }
 
     // Physics
@@ -173,9 +333,20 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
         csmString path = _modelSetting->GetPhysicsFileName();
         path = _modelHomeDir + path;
 
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        LoadPhysics(buffer, size);
-        DeleteBuffer(buffer, path.GetRawString());
+        // 模板从未参与计算，复制后各实例拥有独立的质点状态
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Physics);
+        const double start = LAppPal::GetCurrentTimePoint();
+        const CubismPhysics *physics = LAppAssetCache::AcquirePhysics(path.GetRawString());
+        if (physics)
+        {
+            _sharedAssets.PushBack(physics);
+            _physics = physics->Clone();
+        }
+        else
+        {
+            Error("Failed to LoadPhysics().");
+        }
+        _loadTimings.physicsMs = MillisecondsSince(start);
     }
 
     // Pose
@@ -184,15 +355,19 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
         csmString path = _modelSetting->GetPoseFileName();
         path = _modelHomeDir + path;
 
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Pose);
+        const double start = LAppPal::GetCurrentTimePoint();
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadPose(buffer, size);
         DeleteBuffer(buffer, path.GetRawString());
+        _loadTimings.poseMs = MillisecondsSince(start);
     }
 
     // EyeBlink
     if (_modelSetting->GetEyeBlinkParameterCount() > 0)
     {
         _eyeBlink = CubismEyeBlink::Create(_modelSetting);
+        _eyeBlink->SetRandomSeed(NextRandom());
     }
 
     // Breath
@@ -217,9 +392,12 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
     {
         csmString path = _modelSetting->GetUserDataFile();
         path = _modelHomeDir + path;
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_UserData);
+        const double start = LAppPal::GetCurrentTimePoint();
         buffer = CreateBuffer(path.GetRawString(), &size);
         LoadUserData(buffer, size);
         DeleteBuffer(buffer, path.GetRawString());
+        _loadTimings.userDataMs = MillisecondsSince(start);
     }
 
     // EyeBlinkIds
@@ -254,10 +432,17 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
 
     _model->SaveParameters();
 
-    for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+    // 不预加载时动作在 StartMotion 中同步读取，或用 PrefetchMotion 提前在后台加载
+    if (_preloadMotions)
     {
-        const csmChar *group = _modelSetting->GetMotionGroupName(i);
-        PreloadMotionGroup(group);
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Motions);
+        const double start = LAppPal::GetCurrentTimePoint();
+        for (csmInt32 i = 0; i < _modelSetting->GetMotionGroupCount(); i++)
+        {
+            const csmChar *group = _modelSetting->GetMotionGroupName(i);
+            PreloadMotionGroup(group);
+        }
+        _loadTimings.motionsMs = MillisecondsSince(start);
     }
 
     _motionManager->StopAllMotions();
@@ -273,12 +458,46 @@ void LAppModel::SetupModel(ICubismModelSetting *setting)
     _parameterValues = Live2D::Cubism::Core::csmGetParameterValues(model);
     _parameterCount = Live2D::Cubism::Core::csmGetParameterCount(model);
 
-    _iParamAngleX = _model->GetParameterIndex(_idParamAngleX);
-    _iParamAngleY = _model->GetParameterIndex(_idParamAngleY);
-    _iParamAngleZ = _model->GetParameterIndex(_idParamAngleZ);
-    _iParamBodyAngleX = _model->GetParameterIndex(_idParamBodyAngleX);
-    _iParamEyeBallX = _model->GetParameterIndex(_idParamEyeBallX);
-    _iParamEyeBallY = _model->GetParameterIndex(_idParamEyeBallY);
+    // ドラッグによる顔・体・目の向きの調整
+    const LAppProceduralEffects::GazeTarget gazeTargets[] = {
+        {_idParamAngleX, 30.0f, 0.0f, 0.0f}, // -30から30の値を加える
+        {_idParamAngleY, 0.0f, 30.0f, 0.0f},
+        {_idParamAngleZ, 0.0f, 0.0f, -30.0f},
+        {_idParamBodyAngleX, 10.0f, 0.0f, 0.0f}, // -10から10の値を加える
+        {_idParamEyeBallX, 1.0f, 0.0f, 0.0f}, // -1から1の値を加える
+        {_idParamEyeBallY, 0.0f, 1.0f, 0.0f},
+    };
+    const csmVector<CubismIdHandle> noEyeBlinkIds;
+    _effects.Setup(_model, _breath->GetParameters(), _eyeBlink != NULL ? _eyeBlink->GetParameterIds() : noEyeBlinkIds,
+                   gazeTargets, sizeof(gazeTargets) / sizeof(gazeTargets[0]));
+
+    // 口型同步的目标参数
+    _lipSyncParamIndices.Clear();
+    for (csmUint32 i = 0; i < _lipSyncIds.GetSize(); ++i)
+    {
+        const csmInt32 index = FindParameterIndex(_model, _lipSyncIds[i]);
+        if (index >= 0)
+        {
+            _lipSyncParamIndices.PushBack(index);
+        }
+    }
+    if (_lipSyncIds.GetSize() == 0)
+    {
+        const csmInt32 index = FindParameterIndex(_model, CubismFramework::GetIdManager()->GetId(ParamMouthOpenY));
+        if (index >= 0)
+        {
+            _lipSyncParamIndices.PushBack(index);
+        }
+    }
+
+    const csmChar *vowelIds[LAppLipSync::Vowel_Count] = {"ParamA", "ParamI", "ParamU", "ParamE", "ParamO"};
+    for (csmInt32 v = 0; v < LAppLipSync::Vowel_Count; ++v)
+    {
+        _vowelParamIndices[v] = FindParameterIndex(_model, CubismFramework::GetIdManager()->GetId(vowelIds[v]));
+    }
+
+    ResolveParameterChannel();
+    ++_modelGeneration;
 }
 
 void LAppModel::PreloadMotionGroup(const csmChar *group)
@@ -304,237 +523,936 @@ void LAppModel::PreloadMotionGroup(const csmChar *group)
 
         path = _modelHomeDir + path;
 
-        csmByte *buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-        CubismMotion *tmpMotion = static_cast<CubismMotion *>(LoadMotion(buffer, size, name.GetRawString()));
+        // 曲线数据由所有实例共享，实例只持有播放状态
+        const CubismMotion *motionTemplate = LAppAssetCache::AcquireMotion(path.GetRawString(), GetMotionBakeRate(group, i));
+        CubismMotion *tmpMotion = NULL;
+        if (motionTemplate)
+        {
+            _sharedAssets.PushBack(motionTemplate);
+            tmpMotion = CreateMotionInstance(motionTemplate, group, i);
+        }
 
         if (tmpMotion)
         {
-            csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, i);
-            if (fadeTime >= 0.0f)
+            if (_motions[name] != NULL)
             {
-                tmpMotion->SetFadeInTime(fadeTime);
+                ACubismMotion::Delete(_motions[name]);
             }
+            _motions[name] = tmpMotion;
+        }
+    }
+}
+
+/**
+ * @brief すべてのモーションデータの解放
+ *
+ * すべてのモーションデータを解放する。
+ */
+void LAppModel::ReleaseMotions()
+{
+    for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
+    {
+        ACubismMotion::Delete(iter->Second);
+    }
+
+    _motions.Clear();
+}
+
+/**
+ * @brief すべての表情データの解放
+ *
+ * すべての表情データを解放する。
+ */
+void LAppModel::ReleaseExpressions()
+{
+    for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _expressions.Begin(); iter != _expressions.End(); ++iter)
+    {
+        ACubismMotion::Delete(iter->Second);
+    }
+
+    _expressions.Clear();
+}
+
+void LAppModel::Update()
+{
+    _currentFrame = LAppPal::GetCurrentTimePoint();
+    const double deltaTimeSeconds = std::min(0.1, _currentFrame - _lastFrame); // 防止间隔过大导致后续状态异常
+    _lastFrame = _currentFrame;
+
+    Update(static_cast<csmFloat32>(deltaTimeSeconds));
+}
+
+void LAppModel::Tick(csmInt32 steps, csmFloat32 deltaTimeSeconds)
+{
+    for (csmInt32 i = 0; i < steps; i++)
+    {
+        Update(deltaTimeSeconds);
+    }
+}
+
+void LAppModel::UpdateDrawables()
+{
+    // 流水线的每一步自行计算并复制到快照
+    if (_model == NULL || _pipeline != nullptr)
+    {
+        return;
+    }
+
+    LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_ModelUpdate);
+    _model->Update();
+    _drawablesUpdated = true;
+}
+
+void LAppModel::InvalidateDrawables()
+{
+    _drawablesUpdated = false;
+}
+
+void LAppModel::SetRandomSeed(csmUint32 seed)
+{
+    // xorshift 无法离开 0
+    _randomState = seed != 0 ? seed : 0x9E3779B9u;
+
+    if (_eyeBlink != NULL)
+    {
+        _eyeBlink->SetRandomSeed(NextRandom());
+    }
+}
+
+csmUint32 LAppModel::NextRandom()
+{
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    return _randomState;
+}
+
+double LAppModel::GetElapsedSeconds() const
+{
+    return _elapsedSeconds;
+}
+
+void LAppModel::SetPipelineEnable(csmBool enable, PipelineHook hook, void *hookContext)
+{
+    if (!enable)
+    {
+        ReleasePipeline(true);
+        return;
+    }
+
+    WaitPipeline();
+    _pipelineHook = hook;
+    _pipelineHookContext = hookContext;
+    if (_pipeline == nullptr)
+    {
+        _pipeline = new LAppUpdatePipeline(RunPipelineStep, this);
+    }
+}
+
+bool LAppModel::IsPipelineEnabled() const
+{
+    return _pipeline != nullptr;
+}
+
+void LAppModel::WaitPipeline()
+{
+    if (_pipeline != nullptr && _pipeline->Wait())
+    {
+        _model->SetDrawableSnapshot(_pipeline->GetFrontSnapshot());
+    }
+}
+
+void LAppModel::GetPipelineStats(LAppUpdatePipeline::Stats &stats) const
+{
+    if (_pipeline == nullptr)
+    {
+        memset(&stats, 0, sizeof(stats));
+        return;
+    }
+
+    _pipeline->GetStats(&stats);
+}
+
+LAppProfiler &LAppModel::GetProfiler()
+{
+    return _profiler;
+}
+
+void LAppModel::ReleasePipeline(bool applyOverrides)
+{
+    if (_pipeline == nullptr)
+    {
+        return;
+    }
+
+    WaitPipeline();
+    delete _pipeline;
+    _pipeline = nullptr;
+
+    if (_model != nullptr)
+    {
+        _model->SetDrawableSnapshot(NULL);
+        if (applyOverrides)
+        {
+            ApplyOverrides(_pendingOverrides);
+        }
+    }
+    _pendingOverrides.Clear();
+    _stepOverrides.Clear();
+    _drawablesUpdated = false;
+}
+
+void LAppModel::RunPipelineStep(void *context, CubismDrawableSnapshot *snapshot)
+{
+    LAppModel *self = static_cast<LAppModel *>(context);
+    if (self->_pipelineHook != nullptr)
+    {
+        self->_pipelineHook(self->_pipelineHookContext, true);
+    }
+
+    self->Simulate(self->_pipelineDeltaTime);
+    self->ApplyOverrides(self->_stepOverrides);
+
+    {
+        LAppAllocator::AccountScope accountScope(self->_memoryAccount, LAppMemoryAccount::Category_Renderer);
+        LAppProfiler::Scope scope(self->_profiler, LAppProfiler::Stage_ModelUpdate);
+        self->_model->Update();
+        snapshot->Capture(*self->_model);
+    }
+    self->_profiler.Commit(LAppProfiler::Stage_Update, LAppProfiler::Stage_ModelUpdate);
+
+    if (self->_pipelineHook != nullptr)
+    {
+        self->_pipelineHook(self->_pipelineHookContext, false);
+    }
+}
+
+void LAppModel::QueueOverride(ParameterOverride::Type type, CubismIdHandle id, csmInt32 index,
+                              csmFloat32 value, csmFloat32 weight)
+{
+    ParameterOverride item;
+    item.type = type;
+    item.id = id;
+    item.index = index;
+    item.value = value;
+    item.weight = weight;
+    _pendingOverrides.PushBack(item);
+}
 
-            fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, i);
-            if (fadeTime >= 0.0f)
+void LAppModel::ApplyOverrides(const csmVector<ParameterOverride> &overrides)
+{
+    for (csmUint32 i = 0; i < overrides.GetSize(); ++i)
+    {
+        const ParameterOverride &item = overrides[i];
+        switch (item.type)
+        {
+        case ParameterOverride::Type_SetParameter:
+            if (item.id != NULL)
             {
-                tmpMotion->SetFadeOutTime(fadeTime);
+                _model->SetAndSaveParameterValue(item.id, item.value, item.weight);
             }
-            tmpMotion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-
-            if (_motions[name] != NULL)
+            else
             {
-                ACubismMotion::Delete(_motions[name]);
+                _model->SetAndSaveParameterValue(item.index, item.value, item.weight);
             }
-            _motions[name] = tmpMotion;
+            break;
+        case ParameterOverride::Type_AddParameter:
+            if (item.id != NULL)
+            {
+                _model->AddAndSaveParameterValue(item.id, item.value);
+            }
+            else
+            {
+                _model->AddAndSaveParameterValue(item.index, item.value);
+            }
+            break;
+        case ParameterOverride::Type_PartOpacity:
+            _model->SetPartOpacity(item.index, item.value);
+            break;
+        }
+    }
+}
+
+void LAppModel::Update(csmFloat32 deltaTimeSeconds)
+{
+    if (_pipeline == nullptr)
+    {
+        Simulate(deltaTimeSeconds);
+        _profiler.Commit(LAppProfiler::Stage_Update, LAppProfiler::Stage_Pose);
+        return;
+    }
+
+    // 上一步完成后模拟线程空闲，此时交接时间间隔与记下的参数修改
+    WaitPipeline();
+    _pipelineDeltaTime = deltaTimeSeconds;
+    _stepOverrides.Clear();
+    for (csmUint32 i = 0; i < _pendingOverrides.GetSize(); ++i)
+    {
+        _stepOverrides.PushBack(_pendingOverrides[i]);
+    }
+    _pendingOverrides.Clear();
+    _pipeline->Start();
+}
+
+void LAppModel::Simulate(csmFloat32 deltaTimeSeconds)
+{
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Other);
+    LAppProfiler::Scope updateScope(_profiler, LAppProfiler::Stage_Update);
+
+    _deltaTimeSeconds = std::max(0.0f, deltaTimeSeconds);
+    _elapsedSeconds += _deltaTimeSeconds;
+    _drawablesUpdated = false;
+
+    _dragManager->Update(_deltaTimeSeconds);
+    _dragX = _dragManager->GetX();
+    _dragY = _dragManager->GetY();
+
+    // 后台加载完成的动作，以及等待它们的 StartMotion
+    PollMotionRequests();
+
+    // モーションによるパラメータ更新の有無
+    csmBool motionUpdated = false;
+
+    //-----------------------------------------------------------------
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_Motion);
+        _model->LoadParameters(); // 前回セーブされた状態を
+        if (!_motionManager->IsFinished())
+        {
+            motionUpdated = _motionManager->UpdateMotion(_model, _deltaTimeSeconds); // モーションを更新
+        }
+        _motionMixer.Update(_model, _deltaTimeSeconds); // 各动作层叠加在主动作之上
+        _model->SaveParameters(); // 状態を保存
+    }
+    //-----------------------------------------------------------------
+
+    // 不透明度
+    _opacity = _model->GetModelOpacity();
+
+    // まばたき
+    if (!motionUpdated)
+    {
+        if (_autoBlink && _eyeBlink != NULL)
+        {
+            // メインモーションの更新がないとき
+            LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_EyeBlink);
+            if (_proceduralEffects)
+            {
+                _effects.ApplyEyeBlink(_model, _eyeBlink->UpdateBlinkingValue(_deltaTimeSeconds)); // 目パチ
+            }
+            else
+            {
+                _eyeBlink->UpdateParameters(_model, _deltaTimeSeconds);
+            }
+        }
+    }
+
+    if (_expressionManager != NULL)
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_Expression);
+        _expressionManager->UpdateMotion(_model, _deltaTimeSeconds); // 表情でパラメータ更新（相対変化）
+    }
+
+    // 面部捕捉等外部输入覆盖动作与表情的结果，物理随之运动
+    if (_parameterChannel.GetSlotCount() > 0)
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_ParameterInput);
+        if (_parameterChannel.Update(_deltaTimeSeconds))
+        {
+            const csmFloat32 *values = _parameterChannel.GetValues();
+            for (csmUint32 i = 0; i < _parameterChannelIndices.GetSize(); ++i)
+            {
+                if (_parameterChannelIndices[i] >= 0)
+                {
+                    _model->SetParameterValue(_parameterChannelIndices[i], values[i], _parameterChannelWeight);
+                }
+            }
+        }
+    }
+
+    // ドラッグによる変化
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_Drag);
+
+        if (_proceduralEffects)
+        {
+            _effects.ApplyGaze(_model, _dragX, _dragY);
+        }
+        else
+        {
+            // ドラッグによる顔・体・目の向きの調整
+            _model->AddParameterValue(_idParamAngleX, _dragX * 30);
+            _model->AddParameterValue(_idParamAngleY, _dragY * 30);
+            _model->AddParameterValue(_idParamAngleZ, _dragX * _dragY * -30);
+            _model->AddParameterValue(_idParamBodyAngleX, _dragX * 10);
+            _model->AddParameterValue(_idParamEyeBallX, _dragX);
+            _model->AddParameterValue(_idParamEyeBallY, _dragY);
+        }
+    }
+
+    // 呼吸など
+    if (_autoBreath && _breath != NULL)
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_Breath);
+        if (_proceduralEffects)
+        {
+            _effects.UpdateBreath(_model, _deltaTimeSeconds);
+        }
+        else
+        {
+            _breath->UpdateParameters(_model, _deltaTimeSeconds);
+        }
+    }
+
+    // 物理演算の設定
+    if (_physics != NULL)
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_Physics);
+        _physics->Evaluate(_model, _deltaTimeSeconds);
+    }
+
+    // リップシンクの設定
+    if (_lipSync.IsActive())
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_LipSync);
+        _lipSync.Update(_deltaTimeSeconds);
+        ApplyLipSync();
+    }
+
+    // ポーズの設定
+    if (_pose != NULL)
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_Pose);
+        _pose->UpdateParameters(_model, _deltaTimeSeconds);
+    }
+}
+
+LAppLipSync &LAppModel::GetLipSync()
+{
+    return _lipSync;
+}
+
+void LAppModel::BindParameterChannel(const csmChar *const *ids, csmInt32 count, csmFloat32 weight, csmInt32 capacity)
+{
+    _parameterChannelIds.Clear();
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        _parameterChannelIds.PushBack(CubismFramework::GetIdManager()->GetId(ids[i]));
+    }
+    _parameterChannelWeight = weight;
+    _parameterChannel.Bind(count, capacity);
+    ResolveParameterChannel();
+}
+
+LAppParameterChannel &LAppModel::GetParameterChannel()
+{
+    return _parameterChannel;
+}
+
+void LAppModel::BindParameterPlan(LAppParameterPlan &plan, const csmChar *const *ids, csmInt32 count)
+{
+    csmVector<CubismIdHandle> handles;
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        handles.PushBack(CubismFramework::GetIdManager()->GetId(ids[i]));
+    }
+    plan.Bind(_model, count > 0 ? &handles[0] : NULL, count, _modelGeneration);
+}
+
+void LAppModel::SetParameterValues(LAppParameterPlan &plan, const csmFloat32 *values, const csmFloat32 *weights,
+                                   csmFloat32 weight)
+{
+    if (_model == NULL)
+    {
+        return;
+    }
+    if (plan.GetGeneration() != _modelGeneration)
+    {
+        plan.Resolve(_model, _modelGeneration);
+    }
+
+    if (_pipeline != nullptr)
+    {
+        for (csmInt32 i = 0; i < plan.GetResolvedCount(); ++i)
+        {
+            const csmInt32 slot = plan.GetSlot(i);
+            QueueOverride(ParameterOverride::Type_SetParameter, NULL, plan.GetParameterIndex(i), values[slot],
+                          weights != NULL ? weights[slot] : weight);
+        }
+        return;
+    }
+    plan.Set(_model, values, weights, weight);
+    _drawablesUpdated = false;
+}
+
+void LAppModel::AddParameterValues(LAppParameterPlan &plan, const csmFloat32 *values, csmFloat32 weight)
+{
+    if (_model == NULL)
+    {
+        return;
+    }
+    if (plan.GetGeneration() != _modelGeneration)
+    {
+        plan.Resolve(_model, _modelGeneration);
+    }
+
+    if (_pipeline != nullptr)
+    {
+        // AddAndSaveParameterValue(index, value × weight) 与带权重的加法结果相同
+        for (csmInt32 i = 0; i < plan.GetResolvedCount(); ++i)
+        {
+            QueueOverride(ParameterOverride::Type_AddParameter, NULL, plan.GetParameterIndex(i),
+                          values[plan.GetSlot(i)] * weight, 1.0f);
+        }
+        return;
+    }
+    plan.Add(_model, values, weight);
+    _drawablesUpdated = false;
+}
+
+void LAppModel::ResolveParameterChannel()
+{
+    _parameterChannelIndices.Clear();
+    if (_model == NULL)
+    {
+        return;
+    }
+
+    for (csmUint32 i = 0; i < _parameterChannelIds.GetSize(); ++i)
+    {
+        _parameterChannelIndices.PushBack(FindParameterIndex(_model, _parameterChannelIds[i]));
+    }
+}
+
+void LAppModel::ApplyLipSync()
+{
+    const csmFloat32 value = _lipSync.GetValue();
+
+    // 元音参数存在时由各自的权重分配张嘴程度，其余的口型同步参数照常驱动
+    csmBool vowels = false;
+    if (_lipSync.IsVowelEnabled())
+    {
+        csmFloat32 weights[LAppLipSync::Vowel_Count];
+        _lipSync.GetVowelWeights(weights);
+        for (csmInt32 v = 0; v < LAppLipSync::Vowel_Count; ++v)
+        {
+            if (_vowelParamIndices[v] >= 0)
+            {
+                _model->AddParameterValue(_vowelParamIndices[v], value * weights[v], 0.8f);
+                vowels = true;
+            }
+        }
+    }
+
+    for (csmUint32 i = 0; i < _lipSyncParamIndices.GetSize(); ++i)
+    {
+        const csmInt32 index = _lipSyncParamIndices[i];
+        if (vowels && std::find(_vowelParamIndices, _vowelParamIndices + LAppLipSync::Vowel_Count, index)
+                          != _vowelParamIndices + LAppLipSync::Vowel_Count)
+        {
+            continue;
+        }
+        _model->AddParameterValue(index, value, 0.8f);
+    }
+}
+
+CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar *group, csmInt32 no, csmInt32 priority,
+                                                    void *onStartedCallee,
+                                                    ACubismMotion::BeganMotionCallback onStartMotionHandler,
+                                                    void *onFinishedCallee,
+                                                    ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
+{
+    // 未预加载的动作及动作队列条目
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Motions);
+
+    if (priority == PriorityForce)
+    {
+        _motionManager->SetReservePriority(priority);
+    }
+    else if (!_motionManager->ReserveMotion(priority))
+    {
+        Info("can't start motion.");
+        return InvalidMotionQueueEntryHandleValue;
+    }
+
+    // 等待预取完成的动作被新的动作取代，其回调在这里结束
+    PollMotionRequests();
+    CancelPendingMotion();
+
+    const csmString fileName = _modelSetting->GetMotionFileName(group, no);
+
+    // ex) idle_0
+    csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
+    CubismMotion *motion = static_cast<CubismMotion *>(_motions[name.GetRawString()]);
+    csmBool autoDelete = false;
+
+    csmBool hasMotion = true;
+
+    if (fileName.GetLength() <= 0)
+    {
+        hasMotion = false;
+        Info("motion(%s) has no file attached", name.GetRawString());
+        goto handler_label;
+    }
+
+    if (motion == NULL && FindMotionPrefetch(group, no) >= 0)
+    {
+        // 正在后台加载：保留优先级预约，加载完成后在 Update 中开始，不在这里等待文件读取
+        _pendingMotion.active = true;
+        _pendingMotion.group = group;
+        _pendingMotion.no = no;
+        _pendingMotion.priority = priority;
+        _pendingMotion.onStartedCallee = onStartedCallee;
+        _pendingMotion.onStartMotionHandler = onStartMotionHandler;
+        _pendingMotion.onFinishedCallee = onFinishedCallee;
+        _pendingMotion.onFinishedMotionHandler = onFinishedMotionHandler;
+        return InvalidMotionQueueEntryHandleValue;
+    }
+
+    if (motion == NULL)
+    {
+        motion = LoadMotionInstance(group, no);
+        if (motion)
+        {
+            autoDelete = true; // 終了時にメモリから削除
+        }
+    }
+
+    if (motion)
+    {
+        SetMotionCallbacks(motion, group, no, onStartedCallee, onStartMotionHandler, onFinishedCallee,
+                           onFinishedMotionHandler);
+    }
+
+handler_label:
+
+    if (!hasMotion)
+    {
+        // 添加空指针判断，如果 motion 文件不存在，直接调用动作结束回调函数
+        // 修复模型文件不存在时，导致崩溃
+        NotifyMissingMotion(group, no, onStartedCallee, onStartMotionHandler, onFinishedCallee,
+                            onFinishedMotionHandler);
+        _motionManager->SetReservePriority(PriorityNone);
+        return InvalidMotionQueueEntryHandleValue;
+    }
+
+    return _motionManager->StartMotionPriority(motion, autoDelete, priority);
+}
+
+void LAppModel::PrefetchMotion(const csmChar *group, csmInt32 no)
+{
+    const csmString fileName = _modelSetting->GetMotionFileName(group, no);
+    if (fileName.GetLength() <= 0)
+    {
+        return;
+    }
+
+    const csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
+    if ((_motions.IsExist(name) && _motions[name] != NULL) || FindMotionPrefetch(group, no) >= 0)
+    {
+        return;
+    }
+
+    MotionPrefetch *prefetch = CSM_NEW MotionPrefetch();
+    prefetch->group = group;
+    prefetch->no = no;
+    prefetch->request = LAppAssetCache::RequestMotion((_modelHomeDir + fileName).GetRawString(), GetMotionBakeRate(group, no));
+    _motionPrefetches.PushBack(prefetch);
+}
+
+void LAppModel::PrefetchGroup(const csmChar *group)
+{
+    const csmInt32 count = _modelSetting->GetMotionCount(group);
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        PrefetchMotion(group, i);
+    }
+}
+
+csmInt32 LAppModel::FindMotionPrefetch(const csmChar *group, csmInt32 no) const
+{
+    for (csmUint32 i = 0; i < _motionPrefetches.GetSize(); i++)
+    {
+        if (_motionPrefetches[i]->no == no && _motionPrefetches[i]->group == group)
+        {
+            return static_cast<csmInt32>(i);
+        }
+    }
+
+    return -1;
+}
+
+void LAppModel::PollMotionRequests()
+{
+    for (csmUint32 i = 0; i < _motionPrefetches.GetSize();)
+    {
+        if (!LAppAssetCache::IsReady(_motionPrefetches[i]->request))
+        {
+            i++;
+            continue;
+        }
+
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Motions);
+
+        MotionPrefetch *ready = _motionPrefetches[i];
+        _motionPrefetches.Remove(i);
+        const MotionPrefetch prefetch = *ready;
+        CSM_DELETE(ready);
+
+        // 加载完成后与预加载的动作相同
+        const csmChar *group = prefetch.group.GetRawString();
+        const csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, prefetch.no);
+        const CubismMotion *motionTemplate = LAppAssetCache::TakeMotion(prefetch.request);
+        CubismMotion *motion = NULL;
+        if (motionTemplate)
+        {
+            _sharedAssets.PushBack(motionTemplate);
+            motion = CreateMotionInstance(motionTemplate, group, prefetch.no);
+        }
+
+        if (motion)
+        {
+            if (_motions.IsExist(name) && _motions[name] != NULL)
+            {
+                ACubismMotion::Delete(_motions[name]);
+            }
+            _motions[name] = motion;
+        }
+        else
+        {
+            Info("prefetch motion failed: [%s]", name.GetRawString());
+        }
+
+        if (!_pendingMotion.active || _pendingMotion.no != prefetch.no || !(_pendingMotion.group == prefetch.group))
+        {
+            continue;
         }
 
-        DeleteBuffer(buffer, path.GetRawString());
+        _pendingMotion.active = false;
+        if (motion)
+        {
+            SetMotionCallbacks(motion, group, prefetch.no, _pendingMotion.onStartedCallee,
+                               _pendingMotion.onStartMotionHandler, _pendingMotion.onFinishedCallee,
+                               _pendingMotion.onFinishedMotionHandler);
+            _motionManager->StartMotionPriority(motion, false, _pendingMotion.priority);
+        }
+        else
+        {
+            NotifyMissingMotion(group, prefetch.no, _pendingMotion.onStartedCallee,
+                                _pendingMotion.onStartMotionHandler, _pendingMotion.onFinishedCallee,
+                                _pendingMotion.onFinishedMotionHandler);
+            _motionManager->SetReservePriority(PriorityNone);
+        }
     }
 }
 
-/**
- * @brief すべてのモーションデータの解放
- *
- * すべてのモーションデータを解放する。
- */
-void LAppModel::ReleaseMotions()
+void LAppModel::CancelPendingMotion()
 {
-    for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _motions.Begin(); iter != _motions.End(); ++iter)
+    if (!_pendingMotion.active)
     {
-        ACubismMotion::Delete(iter->Second);
+        return;
     }
 
-    _motions.Clear();
+    _pendingMotion.active = false;
+    NotifyMissingMotion(_pendingMotion.group.GetRawString(), _pendingMotion.no, _pendingMotion.onStartedCallee,
+                        _pendingMotion.onStartMotionHandler, _pendingMotion.onFinishedCallee,
+                        _pendingMotion.onFinishedMotionHandler);
 }
 
-/**
- * @brief すべての表情データの解放
- *
- * すべての表情データを解放する。
- */
-void LAppModel::ReleaseExpressions()
+void LAppModel::CancelMotionPrefetches()
 {
-    for (csmMap<csmString, ACubismMotion *>::const_iterator iter = _expressions.Begin(); iter != _expressions.End(); ++iter)
+    for (csmUint32 i = 0; i < _motionPrefetches.GetSize(); ++i)
     {
-        ACubismMotion::Delete(iter->Second);
+        LAppAssetCache::CancelRequest(_motionPrefetches[i]->request);
+        CSM_DELETE(_motionPrefetches[i]);
     }
+    _motionPrefetches.Clear();
+}
 
-    _expressions.Clear();
+void LAppModel::SetMotionBakeRate(const csmChar *group, csmFloat32 rate)
+{
+    _motionBakeRates[group] = rate > 0.0f ? rate : 0.0f;
 }
 
-void LAppModel::Update()
+csmFloat32 LAppModel::GetMotionBakeError(const csmChar *group, csmInt32 no)
 {
-    _currentFrame = LAppPal::GetCurrentTimePoint();
-    _deltaTimeSeconds = static_cast<float>(std::min(0.1, _currentFrame - _lastFrame)); // 防止间隔过大导致后续状态异常
-    _lastFrame = _currentFrame;
+    const csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
+    if (!_motions.IsExist(name) || _motions[name] == NULL)
+    {
+        return -1.0f;
+    }
 
-    _dragManager->Update(_deltaTimeSeconds);
-    _dragX = _dragManager->GetX();
-    _dragY = _dragManager->GetY();
+    return static_cast<CubismMotion *>(_motions[name])->GetBakeError();
+}
 
-    // モーションによるパラメータ更新の有無
-    csmBool motionUpdated = false;
+csmFloat32 LAppModel::GetMotionBakeRate(const csmChar *group, csmInt32 no)
+{
+    const csmString name = group;
+    if (_motionBakeRates.IsExist(name))
+    {
+        return _motionBakeRates[name];
+    }
 
-    //-----------------------------------------------------------------
-    _model->LoadParameters(); // 前回セーブされた状態を
-    if (!_motionManager->IsFinished())
+    return _modelSetting->GetMotionBakeRateValue(group, no);
+}
+
+CubismMotion *LAppModel::LoadMotionInstance(const csmChar *group, csmInt32 no)
+{
+    const csmString path = _modelHomeDir + _modelSetting->GetMotionFileName(group, no);
+
+    // 克隆后不必继续持有模板
+    CubismMotion *motion = NULL;
+    const CubismMotion *motionTemplate = LAppAssetCache::AcquireMotion(path.GetRawString(), GetMotionBakeRate(group, no));
+    if (motionTemplate)
     {
-        motionUpdated = _motionManager->UpdateMotion(_model, _deltaTimeSeconds); // モーションを更新
+        motion = CreateMotionInstance(motionTemplate, group, no);
+        LAppAssetCache::Release(motionTemplate);
     }
-    _model->SaveParameters(); // 状態を保存
-    //-----------------------------------------------------------------
 
-    // 不透明度
-    _opacity = _model->GetModelOpacity();
+    return motion;
+}
 
-    // まばたき
-    if (!motionUpdated)
+CubismMotion *LAppModel::CreateMotionInstance(const CubismMotion *motionTemplate, const csmChar *group, csmInt32 no)
+{
+    CubismMotion *motion = motionTemplate->Clone();
+
+    if (motion)
     {
-        if (_autoBlink && _eyeBlink != NULL)
+        csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
+        if (fadeTime >= 0.0f)
         {
-            // メインモーションの更新がないとき
-            _eyeBlink->UpdateParameters(_model, _deltaTimeSeconds); // 目パチ
+            motion->SetFadeInTime(fadeTime);
         }
-    }
 
-    if (_expressionManager != NULL)
-    {
-        _expressionManager->UpdateMotion(_model, _deltaTimeSeconds); // 表情でパラメータ更新（相対変化）
+        fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
+        if (fadeTime >= 0.0f)
+        {
+            motion->SetFadeOutTime(fadeTime);
+        }
+        motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
     }
 
-    // ドラッグによる変化
-    // ドラッグによる顔の向きの調整
-    _model->AddParameterValue(_iParamAngleX, _dragX * 30); // -30から30の値を加える
-    _model->AddParameterValue(_iParamAngleY, _dragY * 30);
-    _model->AddParameterValue(_iParamAngleZ, _dragX * _dragY * -30);
+    return motion;
+}
 
-    // ドラッグによる体の向きの調整
-    _model->AddParameterValue(_iParamBodyAngleX, _dragX * 10); // -10から10の値を加える
+void LAppModel::AddMotionLayer(const csmChar *name, bool additive, float weight)
+{
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Motions);
 
-    // ドラッグによる目の向きの調整
-    _model->AddParameterValue(_iParamEyeBallX, _dragX); // -1から1の値を加える
-    _model->AddParameterValue(_iParamEyeBallY, _dragY);
+    _motionMixer.AddLayer(name, additive ? LAppMotionMixer::BlendMode_Additive : LAppMotionMixer::BlendMode_Override,
+                          weight);
+}
 
-    // 呼吸など
-    if (_autoBreath && _breath != NULL)
+void LAppModel::RemoveMotionLayer(const csmChar *name)
+{
+    _motionMixer.RemoveLayer(_motionMixer.FindLayer(name));
+}
+
+bool LAppModel::SetMotionLayerWeight(const csmChar *name, float weight)
+{
+    const csmInt32 layer = _motionMixer.FindLayer(name);
+    if (layer < 0)
     {
-        _breath->UpdateParameters(_model, _deltaTimeSeconds);
+        return false;
     }
 
-    // 物理演算の設定
-    if (_physics != NULL)
+    _motionMixer.SetWeight(layer, weight);
+    return true;
+}
+
+bool LAppModel::SetMotionLayerMask(const csmChar *name, const csmChar *const *paramIds, int count)
+{
+    const csmInt32 layer = _motionMixer.FindLayer(name);
+    if (layer < 0)
     {
-        _physics->Evaluate(_model, _deltaTimeSeconds);
+        return false;
     }
 
-    // ポーズの設定
-    if (_pose != NULL)
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Motions);
+
+    // GetParameterIndex 会为未知的 id 登记新参数，这里只查找；不存在的 id 记为 -1，由 SetMask 跳过。
+    // 仍按 count 传入，全部 id 都不存在时该层不影响任何参数，而不是变成影响全部参数
+    std::vector<csmInt32> indices;
+    indices.reserve(count);
+    for (int i = 0; i < count; i++)
     {
-        _pose->UpdateParameters(_model, _deltaTimeSeconds);
+        indices.push_back(FindParameterIndex(_model, CubismFramework::GetIdManager()->GetId(paramIds[i])));
     }
+
+    _motionMixer.SetMask(layer, indices.data(), count, _model->GetParameterCount());
+    return true;
 }
 
-CubismMotionQueueEntryHandle LAppModel::StartMotion(const csmChar *group, csmInt32 no, csmInt32 priority,
-                                                    void *onStartedCallee,
-                                                    ACubismMotion::BeganMotionCallback onStartMotionHandler,
-                                                    void *onFinishedCallee,
-                                                    ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
+CubismMotionQueueEntryHandle LAppModel::StartLayerMotion(const csmChar *layer, const csmChar *group, csmInt32 no,
+                                                         void *onStartedCallee,
+                                                         ACubismMotion::BeganMotionCallback onStartMotionHandler,
+                                                         void *onFinishedCallee,
+                                                         ACubismMotion::FinishedMotionCallback onFinishedMotionHandler)
 {
-    if (priority == PriorityForce)
-    {
-        _motionManager->SetReservePriority(priority);
-    }
-    else if (!_motionManager->ReserveMotion(priority))
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Motions);
+
+    const csmInt32 layerIndex = _motionMixer.FindLayer(layer);
+    if (layerIndex < 0)
     {
-        Info("can't start motion.");
+        Info("motion layer(%s) not found", layer);
+        NotifyMissingMotion(group, no, onStartedCallee, onStartMotionHandler, onFinishedCallee,
+                            onFinishedMotionHandler);
         return InvalidMotionQueueEntryHandleValue;
     }
 
     const csmString fileName = _modelSetting->GetMotionFileName(group, no);
-
-    // ex) idle_0
-    csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
-    CubismMotion *motion = static_cast<CubismMotion *>(_motions[name.GetRawString()]);
-    csmBool autoDelete = false;
-
-    csmBool hasMotion = true;
-
     if (fileName.GetLength() <= 0)
     {
-        hasMotion = false;
-        Info("motion(%s) has no file attached", name.GetRawString());
-        goto handler_label;
+        Info("motion(%s_%d) has no file attached", group, no);
+        NotifyMissingMotion(group, no, onStartedCallee, onStartMotionHandler, onFinishedCallee,
+                            onFinishedMotionHandler);
+        return InvalidMotionQueueEntryHandleValue;
     }
 
-    if (motion == NULL)
+    // 预加载过的动作直接克隆，共享曲线数据
+    const csmString name = Utils::CubismString::GetFormatedString("%s_%d", group, no);
+    CubismMotion *motion = NULL;
+    if (_motions.IsExist(name) && _motions[name] != NULL)
     {
-        csmString path = fileName;
-
-        path = _modelHomeDir + path;
-
-        csmByte *buffer;
-        csmSizeInt size;
-        buffer = CreateBuffer(path.GetRawString(), &size);
-
-        motion = static_cast<CubismMotion *>(LoadMotion(buffer, size, NULL));
+        motion = static_cast<CubismMotion *>(_motions[name])->Clone();
+    }
+    else
+    {
+        motion = LoadMotionInstance(group, no);
+    }
 
-        if (motion)
-        {
-            csmFloat32 fadeTime = _modelSetting->GetMotionFadeInTimeValue(group, no);
-            if (fadeTime >= 0.0f)
-            {
-                motion->SetFadeInTime(fadeTime);
-            }
+    if (motion == NULL)
+    {
+        NotifyMissingMotion(group, no, onStartedCallee, onStartMotionHandler, onFinishedCallee,
+                            onFinishedMotionHandler);
+        return InvalidMotionQueueEntryHandleValue;
+    }
 
-            fadeTime = _modelSetting->GetMotionFadeOutTimeValue(group, no);
-            if (fadeTime >= 0.0f)
-            {
-                motion->SetFadeOutTime(fadeTime);
-            }
-            motion->SetEffectIds(_eyeBlinkIds, _lipSyncIds);
-            autoDelete = true; // 終了時にメモリから削除
-        }
+    SetMotionCallbacks(motion, group, no, onStartedCallee, onStartMotionHandler, onFinishedCallee,
+                       onFinishedMotionHandler);
 
-        DeleteBuffer(buffer, path.GetRawString());
-    }
+    return _motionMixer.GetMotionManager(layerIndex)->StartMotionPriority(motion, true, PriorityNormal);
+}
 
-    if (motion)
+bool LAppModel::IsLayerMotionFinished(const csmChar *layer, CubismMotionQueueEntryHandle handle)
+{
+    const csmInt32 layerIndex = _motionMixer.FindLayer(layer);
+    if (layerIndex < 0)
     {
-        motion->group = group;
-        motion->no = no;
-        motion->onStartedCallee = onStartedCallee;
-        motion->onFinishedCallee = onFinishedCallee;
-        motion->SetBeganMotionHandler(onStartMotionHandler);
-        motion->SetFinishedMotionHandler(onFinishedMotionHandler);
+        return true;
     }
 
-handler_label:
+    CubismMotionManager *motionManager = _motionMixer.GetMotionManager(layerIndex);
+    return handle == InvalidMotionQueueEntryHandleValue ? motionManager->IsFinished() : motionManager->IsFinished(handle);
+}
 
-    if (!hasMotion)
+void LAppModel::StopLayerMotions(const csmChar *layer)
+{
+    const csmInt32 layerIndex = _motionMixer.FindLayer(layer);
+    if (layerIndex >= 0)
     {
-        // 添加空指针判断，如果 motion 文件不存在，直接调用动作结束回调函数
-        // 修复模型文件不存在时，导致崩溃
-        FakeMotion fakeMotion;
-        fakeMotion.group = group;
-        fakeMotion.no = no;
-        fakeMotion.onStartedCallee = onStartedCallee;
-        fakeMotion.onFinishedCallee = onFinishedCallee;
-        if (onStartMotionHandler)
-        {
-            onStartMotionHandler(&fakeMotion);
-        }
-        if (onFinishedMotionHandler)
-        {
-            onFinishedMotionHandler(&fakeMotion);
-        }
-        _motionManager->SetReservePriority(PriorityNone);
-        return InvalidMotionQueueEntryHandleValue;
+        _motionMixer.GetMotionManager(layerIndex)->StopAllMotions();
     }
-
-    return _motionManager->StartMotionPriority(motion, autoDelete, priority);
 }
 
 CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar *group, csmInt32 priority,
@@ -548,7 +1466,7 @@ CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar *group,
         int gcnt = _modelSetting->GetMotionGroupCount();
         if (gcnt > 0)
         {
-            int gindex = rand() % gcnt;
+            int gindex = static_cast<int>(NextRandom() % gcnt);
             group = _modelSetting->GetMotionGroupName(gindex);
         }
     }
@@ -558,7 +1476,7 @@ CubismMotionQueueEntryHandle LAppModel::StartRandomMotion(const csmChar *group,
         return InvalidMotionQueueEntryHandleValue;
     }
 
-    csmInt32 no = rand() % _modelSetting->GetMotionCount(group);
+    csmInt32 no = static_cast<csmInt32>(NextRandom() % _modelSetting->GetMotionCount(group));
 
     return StartMotion(group, no, priority, onStartedCallee, onStartMotionHandler, onFinishedCallee,
                        onFinishedMotionHandler);
@@ -574,6 +1492,56 @@ void LAppModel::DoDraw()
     GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->DrawModel();
 }
 
+void LAppModel::PrepareDraw()
+{
+    if (_model == NULL)
+    {
+        return;
+    }
+
+    if (_pipeline != nullptr)
+    {
+        // 第一步完成前没有可绘制的快照
+        if (_pipeline->GetFrontSnapshot() == NULL)
+        {
+            WaitPipeline();
+        }
+        if (_pipeline->GetFrontSnapshot() != NULL)
+        {
+            _pipeline->OnDraw();
+        }
+        else if (!_drawablesUpdated)
+        {
+            LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_ModelUpdate);
+            _model->Update();
+        }
+    }
+    else if (!_drawablesUpdated)
+    {
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_ModelUpdate);
+        _model->Update();
+    }
+}
+
+CubismMatrix44 &LAppModel::GetMvpMatrix()
+{
+    return _matrixManager.GetMvp();
+}
+
+void LAppModel::ReleaseMaskBuffers()
+{
+    Rendering::CubismRenderer_OpenGLES2 *renderer = GetRenderer<Rendering::CubismRenderer_OpenGLES2>();
+    if (renderer == NULL)
+    {
+        return;
+    }
+
+    for (csmInt32 i = 0; i < renderer->GetMaskBufferCount(); i++)
+    {
+        renderer->GetMaskBuffer(i)->DestroyOffscreenSurface();
+    }
+}
+
 void LAppModel::Draw()
 {
     if (_model == NULL)
@@ -581,13 +1549,34 @@ void LAppModel::Draw()
         return;
     }
 
-    _model->Update();
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Renderer);
 
-    CubismMatrix44 &matrix = _matrixManager.GetMvp();
+    {
+        LAppProfiler::Scope drawScope(_profiler, LAppProfiler::Stage_Draw);
+
+        PrepareDraw();
+
+        CubismMatrix44 &matrix = _matrixManager.GetMvp();
+
+        GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMvpMatrix(&matrix);
 
-    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMvpMatrix(&matrix);
+        LAppProfiler::Scope scope(_profiler, LAppProfiler::Stage_DrawSubmit);
+        DoDraw();
+    }
 
-    DoDraw();
+    if (_profiler.IsEnabled())
+    {
+        const Rendering::CubismRenderer_OpenGLES2::DrawStats &drawStats =
+            GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->GetDrawStats();
+        _profiler.RecordCounter(LAppProfiler::Counter_DrawCalls, drawStats.drawCalls);
+        _profiler.RecordCounter(LAppProfiler::Counter_MaskDrawCalls, drawStats.maskDrawCalls);
+        _profiler.RecordCounter(LAppProfiler::Counter_Masks, drawStats.masks);
+        _profiler.RecordCounter(LAppProfiler::Counter_TargetSwitches, drawStats.targetSwitches);
+
+        // 流水线模式下 csmUpdateModel 在模拟线程上，随那一步提交
+        _profiler.Commit(_pipeline != nullptr ? LAppProfiler::Stage_Masks : LAppProfiler::Stage_ModelUpdate,
+                         LAppProfiler::Stage_Draw);
+    }
 }
 
 csmBool LAppModel::HitTest(const csmChar *hitAreaName, csmFloat32 x, csmFloat32 y)
@@ -623,6 +1612,7 @@ void LAppModel::SetExpression(const csmChar *expressionID)
 
     if (motion != NULL)
     {
+        LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Expressions);
         _expressionManager->StartMotion(motion, false);
     }
     else
@@ -638,7 +1628,7 @@ std::string LAppModel::SetRandomExpression()
     {
         return "";
     }
-    csmInt32 no = rand() % size;
+    csmInt32 no = static_cast<csmInt32>(NextRandom() % size);
     csmMap<csmString, ACubismMotion *>::const_iterator map_ite;
     csmInt32 i = 0;
     for (map_ite = _expressions.Begin(); map_ite != _expressions.End(); map_ite++)
@@ -656,9 +1646,12 @@ std::string LAppModel::SetRandomExpression()
 
 void LAppModel::ReloadRenderer()
 {
+    LAppAllocator::AccountScope accountScope(_memoryAccount, LAppMemoryAccount::Category_Renderer);
+
     DeleteRenderer();
 
     CreateRenderer();
+    GetRenderer<Rendering::CubismRenderer_OpenGLES2>()->SetMaskHook(LAppProfiler::MaskHook, &_profiler);
 
     SetupTextures();
 }
@@ -730,29 +1723,58 @@ csmBool LAppModel::HasMocConsistencyFromFile(const csmChar *mocFileName)
 
 bool LAppModel::IsMotionFinished()
 {
-    return _motionManager->IsFinished();
+    return !_pendingMotion.active && _motionManager->IsFinished();
+}
+
+bool LAppModel::IsMotionFinished(CubismMotionQueueEntryHandle handle)
+{
+    return _motionManager->IsFinished(handle);
 }
 
 void LAppModel::SetParameterValue(const char *paramId, float value, float weight)
 {
     const Csm::CubismId *paramHanle = CubismFramework::GetIdManager()->GetId(paramId);
+    if (_pipeline != nullptr)
+    {
+        QueueOverride(ParameterOverride::Type_SetParameter, paramHanle, 0, value, weight);
+        return;
+    }
     _model->SetAndSaveParameterValue(paramHanle, value, weight);
+    _drawablesUpdated = false;
 }
 
 void LAppModel::SetIndexParamValue(int index, float value, float weight)
 {
+    if (_pipeline != nullptr)
+    {
+        QueueOverride(ParameterOverride::Type_SetParameter, NULL, index, value, weight);
+        return;
+    }
     _model->SetAndSaveParameterValue(index, value, weight);
+    _drawablesUpdated = false;
 }
 
 void LAppModel::AddParameterValue(const char *paramId, float value)
 {
     const Csm::CubismId *paramHanle = CubismFramework::GetIdManager()->GetId(paramId);
+    if (_pipeline != nullptr)
+    {
+        QueueOverride(ParameterOverride::Type_AddParameter, paramHanle, 0, value, 1.0f);
+        return;
+    }
     _model->AddAndSaveParameterValue(paramHanle, value);
+    _drawablesUpdated = false;
 }
 
 void LAppModel::AddIndexParamValue(int index, float value)
 {
+    if (_pipeline != nullptr)
+    {
+        QueueOverride(ParameterOverride::Type_AddParameter, NULL, index, value, 1.0f);
+        return;
+    }
     _model->AddAndSaveParameterValue(index, value);
+    _drawablesUpdated = false;
 }
 
 void LAppModel::SetAutoBreathEnable(bool enable)
@@ -765,6 +1787,11 @@ void LAppModel::SetAutoBlinkEnable(bool enable)
     _autoBlink = enable;
 }
 
+void LAppModel::SetProceduralEffectsEnable(bool enable)
+{
+    _proceduralEffects = enable;
+}
+
 int LAppModel::GetParameterCount()
 {
     return _model->GetParameterCount();
@@ -798,7 +1825,13 @@ Csm::csmString LAppModel::GetPartId(int idx)
 
 void LAppModel::SetPartOpacity(int idx, float opacity)
 {
+    if (_pipeline != nullptr)
+    {
+        QueueOverride(ParameterOverride::Type_PartOpacity, NULL, idx, opacity, 1.0f);
+        return;
+    }
     _model->SetPartOpacity(idx, opacity);
+    _drawablesUpdated = false;
 }
 
 using namespace Live2D::Cubism::Core;
@@ -973,7 +2006,13 @@ void LAppModel::Rotate(float deg)
 
 void LAppModel::StopAllMotions()
 {
+    if (_pendingMotion.active)
+    {
+        CancelPendingMotion();
+        _motionManager->SetReservePriority(PriorityNone);
+    }
     _motionManager->StopAllMotions();
+    _motionMixer.StopAllMotions();
 }
 
 void LAppModel::ResetParameters()
@@ -983,6 +2022,7 @@ void LAppModel::ResetParameters()
         _parameterValues[i] = _defaultParameterValues[i];
     }
     _model->SaveParameters();
+    _drawablesUpdated = false;
 }
 
 void LAppModel::ResetPose()
@@ -991,6 +2031,7 @@ void LAppModel::ResetPose()
     {
         _pose->Reset(_model);
     }
+    _drawablesUpdated = false;
 }
 
 void LAppModel::ResetExpression()
@@ -1007,6 +2048,15 @@ void LAppModel::GetExpressionIds(void *collector, void (*callback)(void *collect
     }
 }
 
+void LAppModel::GetHitAreaNames(void *collector, void (*callback)(void *collector, const char *hitAreaName))
+{
+    const int count = _modelSetting->GetHitAreasCount();
+    for (int i = 0; i < count; i++)
+    {
+        callback(collector, _modelSetting->GetHitAreaName(i));
+    }
+}
+
 void LAppModel::GetMotionGroups(void *collector, void (*callback)(void *collector, const char *groupName, int count))
 {
     const int count = _modelSetting->GetMotionGroupCount();
@@ -1016,3 +2066,38 @@ void LAppModel::GetMotionGroups(void *collector, void (*callback)(void *collecto
         callback(collector, group, _modelSetting->GetMotionCount(group));
     }
 }
+
+void LAppModel::GetMemoryStats(MemoryStats &stats)
+{
+    for (csmInt32 i = 0; i < LAppMemoryAccount::Category_Count; i++)
+    {
+        stats.categoryBytes[i] = _memoryAccount->GetBytes(i);
+    }
+
+    stats.textureBytes = _textureManager.GetTextureBytes();
+    stats.loadPeakBytes = _loadPeakBytes;
+
+    // 显存不经过分配器，按缓冲的实际尺寸（RGBA8）计算
+    stats.maskBytes = 0;
+    Rendering::CubismRenderer_OpenGLES2 *renderer = GetRenderer<Rendering::CubismRenderer_OpenGLES2>();
+    if (renderer != NULL)
+    {
+        for (csmInt32 i = 0; i < renderer->GetMaskBufferCount(); i++)
+        {
+            const Rendering::CubismOffscreenSurface_OpenGLES2 *surface = renderer->GetMaskBuffer(i);
+            if (surface->IsValid())
+            {
+                stats.maskBytes += static_cast<csmInt64>(surface->GetBufferWidth()) * surface->GetBufferHeight() * 4;
+            }
+        }
+    }
+    if (_renderBuffer.IsValid())
+    {
+        stats.maskBytes += static_cast<csmInt64>(_renderBuffer.GetBufferWidth()) * _renderBuffer.GetBufferHeight() * 4;
+    }
+}
+
+const LAppModel::LoadTimings &LAppModel::GetLoadTimings() const
+{
+    return _loadTimings;
+}
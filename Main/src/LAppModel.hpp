@@ -9,6 +9,7 @@
 
 #include <CubismFramework.hpp>
 #include <Model/CubismUserModel.hpp>
+#include <Motion/CubismMotion.hpp>
 #include <ICubismModelSetting.hpp>
 #include <Type/csmRectF.hpp>
 #include <Rendering/OpenGL/CubismOffscreenSurface_OpenGLES2.hpp>
@@ -16,6 +17,15 @@
 #include "LAppTextureManager.hpp"
 
 #include "MatrixManager.hpp"
+#include "LAppAllocator.hpp"
+#include "LAppAssetCache.hpp"
+#include "LAppMotionMixer.hpp"
+#include "LAppUpdatePipeline.hpp"
+#include "LAppLipSync.hpp"
+#include "LAppParameterChannel.hpp"
+#include "LAppParameterPlan.hpp"
+#include "LAppProceduralEffects.hpp"
+#include "LAppProfiler.hpp"
 
 /**
  * @brief ユーザーが実際に使用するモデルの実装クラス<br>
@@ -39,8 +49,9 @@ public:
     /**
      * @brief model3.jsonが置かれたディレクトリとファイルパスからモデルを生成する
      *
+     * @param preloadMotions 为 false 时不在加载时读取动作，由 PrefetchMotion 或 StartMotion 按需加载
      */
-    void LoadModelJson(const Csm::csmChar* fileName);
+    void LoadModelJson(const Csm::csmChar* fileName, Csm::csmBool preloadMotions = true);
 
     /**
      * @brief レンダラを再構築する
@@ -51,9 +62,130 @@ public:
     /**
      * @brief   モデルの更新処理。モデルのパラメータから描画状態を決定する。
      *
+     * 时间间隔取自墙上时钟，上限 0.1 秒。
      */
     void Update();
 
+    /**
+     * @brief 以给定的时间间隔更新，不读取时钟
+     *
+     * 动作、表情、眨眼、呼吸、物理与姿势只由累计的时间间隔驱动。配合 SetRandomSeed，
+     * 相同的调用序列得到相同的结果，可用于离线渲染和批量生成。
+     */
+    void Update(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief 连续执行 steps 次 Update(deltaTimeSeconds)
+     */
+    void Tick(Csm::csmInt32 steps, Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief 根据当前参数计算顶点、不透明度等绘制数据（csmUpdateModel）
+     *
+     * 之后到下一次 Update 或修改参数之前，Draw 不再重复计算，
+     * 因此可以在工作线程上与 Update 一起执行，见 LAppWorkerPool。
+     */
+    void UpdateDrawables();
+
+    /**
+     * @brief 参数值或部件不透明度在 Core 内存中被直接写入后调用（如可写的数组视图），
+     *        下一次 Draw 重新计算绘制数据
+     */
+    void InvalidateDrawables();
+
+    /**
+     * @brief 设置 StartRandomMotion、SetRandomExpression 与自动眨眼使用的随机数种子
+     *
+     * 每个模型持有自己的随机数发生器，创建时以 rand() 初始化。
+     * 在 LoadModelJson 之前或之后调用均可。
+     */
+    void SetRandomSeed(Csm::csmUint32 seed);
+
+    /**
+     * @brief Update 累计的模型时间，单位秒
+     */
+    double GetElapsedSeconds() const;
+
+    /**
+     * @brief 流水线模式下每一步开始与结束时在模拟线程上调用，enter 分别为 true 与 false
+     */
+    typedef void (*PipelineHook)(void* context, Csm::csmBool enter);
+
+    /**
+     * @brief 开关流水线模式
+     *
+     * 开启后 Update 等待上一步完成并发布其绘制快照，然后在模拟线程上开始下一步；Draw 绘制已发布的快照，
+     * 与模拟同时进行，代价是画面比输入晚一帧。SetParameterValue、AddParameterValue、SetPartOpacity
+     * 先记下，在下一步的动作与物理之后应用，效果与普通模式下在 Update 与 Draw 之间修改相同。
+     * 除 Draw、Resize、SetOffset、SetScale、Rotate 与上述方法外，访问模型前须先调用 WaitPipeline。
+     */
+    void SetPipelineEnable(Csm::csmBool enable, PipelineHook hook = NULL, void* hookContext = NULL);
+
+    bool IsPipelineEnabled() const;
+
+    /**
+     * @brief 等待模拟线程上进行中的一步，非流水线模式下什么也不做
+     */
+    void WaitPipeline();
+
+    /**
+     * @brief 流水线的延迟与吞吐统计，非流水线模式下全为 0
+     */
+    void GetPipelineStats(LAppUpdatePipeline::Stats& stats) const;
+
+    /**
+     * @brief 分阶段计时，Update 与 Draw 的各阶段和每次绘制的计数记录在此
+     *
+     * 流水线模式下读取前须先调用 WaitPipeline。
+     */
+    LAppProfiler& GetProfiler();
+
+    /**
+     * @brief 口型同步的音频分析，在 Update 中按模型时间推进
+     *
+     * 有音频时张嘴程度加到模型设置的 LipSync 参数上，未设置时加到 ParamMouthOpenY；
+     * 开启元音分析且模型有 ParamA/I/U/E/O 时，各元音参数得到张嘴程度乘以该元音的权重。
+     * 流水线模式下除 Feed 外的方法须先调用 WaitPipeline。
+     */
+    LAppLipSync& GetLipSync();
+
+    /**
+     * @brief 把参数输入通道的槽位绑定到参数
+     *
+     * 绑定后 Update 在动作与表情之后、物理之前，以 weight 把通道的数值写入对应参数。
+     * 模型中不存在的 id 对应的槽位被忽略，count 为 0 时解除绑定。重新加载模型后按 id 重新查找下标。
+     *
+     * @param capacity  通道缓冲区能容纳的帧数
+     */
+    void BindParameterChannel(const Csm::csmChar* const* ids, Csm::csmInt32 count, Csm::csmFloat32 weight,
+                              Csm::csmInt32 capacity);
+
+    /**
+     * @brief 参数输入通道，生产者线程在此 Push
+     */
+    LAppParameterChannel& GetParameterChannel();
+
+    /**
+     * @brief 按 id 解析一组参数，供 SetParameterValues / AddParameterValues 使用
+     *
+     * 模型中不存在的 id 对应的槽位被跳过。重新加载模型后，下次写入时自动重新解析。
+     */
+    void BindParameterPlan(LAppParameterPlan& plan, const Csm::csmChar* const* ids, Csm::csmInt32 count);
+
+    /**
+     * @brief 一次写入整组参数，结果与逐个调用 SetParameterValue 相同
+     *
+     * @param values    长度为 plan.GetCount() 的数组
+     * @param weights   长度为 plan.GetCount() 的数组，为 NULL 时所有参数使用 weight
+     */
+    void SetParameterValues(LAppParameterPlan& plan, const Csm::csmFloat32* values, const Csm::csmFloat32* weights,
+                            Csm::csmFloat32 weight);
+
+    /**
+     * @brief 一次加到整组参数上，结果与逐个调用 AddParameterValue 相同
+     */
+    void AddParameterValues(LAppParameterPlan& plan, const Csm::csmFloat32* values, Csm::csmFloat32 weight);
+
     /**
      * @brief   モデルを描画する処理。モデルを描画する空間のView-Projection行列を渡す。
      *
@@ -61,6 +193,25 @@ public:
      */
     void Draw();
 
+    /**
+     * @brief 完成 Draw 在提交绘制之前的部分：流水线模式下取最新的快照，否则按需更新顶点
+     *
+     * 供不经过 Draw 的渲染（LAppCrowdRenderer）使用，之后即可读取可绘制对象的数据。
+     */
+    void PrepareDraw();
+
+    /**
+     * @brief Draw 所用的 MVP 矩阵，随 Resize、SetOffset、SetScale、Rotate 变化
+     */
+    Csm::CubismMatrix44& GetMvpMatrix();
+
+    /**
+     * @brief 释放渲染器的遮罩缓冲，下次 Draw 时按原尺寸重新创建
+     *
+     * 由 LAppCrowdRenderer 接管绘制的模型不再需要自己的遮罩缓冲。
+     */
+    void ReleaseMaskBuffers();
+
     /**
      * @brief   引数で指定したモーションの再生を開始する。
      *
@@ -138,8 +289,92 @@ public:
      */
     Csm::csmBool HasMocConsistencyFromFile(const Csm::csmChar* mocFileName);
 
+    /**
+     * @brief 主动作是否已经结束，等待预取完成后开始的动作视为未结束
+     */
     bool IsMotionFinished();
 
+    /**
+     * @brief 指定的动作是否已经结束
+     *
+     * 句柄来自 StartMotion / StartRandomMotion。动作结束后句柄即失效，
+     * 之后即使队列项被复用也不会误判为仍在播放。
+     */
+    bool IsMotionFinished(Csm::CubismMotionQueueEntryHandle handle);
+
+    /**
+     * @brief 在后台线程加载动作，完成后与预加载的动作相同，StartMotion 不再读取文件
+     *
+     * 已加载或正在加载的动作不会重复提交。对正在加载的动作调用 StartMotion 时，
+     * 动作在加载完成后的 Update 中开始，StartMotion 返回 InvalidMotionQueueEntryHandleValue。
+     */
+    void PrefetchMotion(const Csm::csmChar* group, Csm::csmInt32 no);
+
+    void PrefetchGroup(const Csm::csmChar* group);
+
+    /**
+     * @brief 设置动作组的烘焙采样率，覆盖 model3.json 中各动作的 "BakeRate"
+     *
+     * 烘焙后的动作以查表加线性插值代替逐帧求解贝塞尔曲线，见 CubismMotion::Bake。
+     * 只影响之后加载的动作，预加载动作时须在 LoadModelJson 之前调用。
+     *
+     * @param rate 每秒采样数，0 表示不烘焙
+     */
+    void SetMotionBakeRate(const Csm::csmChar* group, Csm::csmFloat32 rate);
+
+    /**
+     * @brief 已加载动作烘焙时测得的最大偏差，见 CubismMotion::GetBakeError
+     *
+     * @return 未烘焙时为 0，动作尚未加载时为 -1
+     */
+    Csm::csmFloat32 GetMotionBakeError(const Csm::csmChar* group, Csm::csmInt32 no);
+
+    /**
+     * @brief 添加动作层，同名的层已存在时更新其混合方式和权重
+     *
+     * 动作层在主动作之后按添加顺序求值，详见 LAppMotionMixer。
+     */
+    void AddMotionLayer(const Csm::csmChar* name, bool additive, float weight);
+
+    void RemoveMotionLayer(const Csm::csmChar* name);
+
+    /**
+     * @return 层不存在时返回 false
+     */
+    bool SetMotionLayerWeight(const Csm::csmChar* name, float weight);
+
+    /**
+     * @brief 设置受该层影响的参数
+     *
+     * @param paramIds  参数 id，count 为 0 时该层影响全部参数；模型中不存在的 id 被忽略
+     * @return          层不存在时返回 false
+     */
+    bool SetMotionLayerMask(const Csm::csmChar* name, const Csm::csmChar* const* paramIds, int count);
+
+    /**
+     * @brief 在指定的层上开始动作，该层正在播放的动作淡出
+     *
+     * 层上的动作总是独立的实例，同一动作可同时在多个层上播放，回调互不影响。
+     *
+     * @return 动作句柄，只在该层内有效；层或动作不存在时返回 InvalidMotionQueueEntryHandleValue，
+     *         此时开始与结束回调立即依次执行
+     */
+    Csm::CubismMotionQueueEntryHandle StartLayerMotion(const Csm::csmChar* layer, const Csm::csmChar* group,
+                                                       Csm::csmInt32 no,
+                                                       void* onStartedCallee = nullptr,
+                                                       Csm::ACubismMotion::BeganMotionCallback onStartMotionHandler =
+                                                           nullptr,
+                                                       void* onFinishedCallee = nullptr,
+                                                       Csm::ACubismMotion::FinishedMotionCallback
+                                                       onFinishedMotionHandler = nullptr);
+
+    /**
+     * @brief 层上的动作是否已经结束，handle 为 InvalidMotionQueueEntryHandleValue 时判断该层的全部动作
+     */
+    bool IsLayerMotionFinished(const Csm::csmChar* layer, Csm::CubismMotionQueueEntryHandle handle);
+
+    void StopLayerMotions(const Csm::csmChar* layer);
+
     void SetParameterValue(const char* paramId, float value, float weight = 1.0f);
 
     void SetIndexParamValue(int index, float value, float weight = 1.0f);
@@ -152,6 +387,14 @@ public:
 
     void SetAutoBlinkEnable(bool enable);
 
+    /**
+     * @brief 开关 LAppProceduralEffects，默认开启
+     *
+     * 关闭时呼吸、眨眼与拖拽视线改由 CubismBreath、CubismEyeBlink 与逐个参数的 AddParameterValue 计算，
+     * 用于对照两者的结果。
+     */
+    void SetProceduralEffectsEnable(bool enable);
+
     int GetParameterCount();
 
     void GetParameter(int i, const char*& id, int& type, float& value, float& maxValue, float& minValue,
@@ -202,8 +445,48 @@ public:
 
     void GetExpressionIds(void* collector, void(*callback)(void* collector, const char* expId));
 
+    void GetHitAreaNames(void* collector, void(*callback)(void* collector, const char* hitAreaName));
+
     void GetMotionGroups(void* collector, void(*callback)(void* collector, const char* groupName, int count));
 
+    /**
+     * @brief 模型占用的内存
+     */
+    struct MemoryStats
+    {
+        Csm::csmInt64 categoryBytes[LAppMemoryAccount::Category_Count]; ///< 各类别存活的字节数
+        Csm::csmInt64 textureBytes;     ///< 纹理显存，共用的纹理按引用数均分
+        Csm::csmInt64 maskBytes;        ///< 裁剪蒙版及离屏缓冲的显存
+        Csm::csmInt64 loadPeakBytes;    ///< 上次 LoadModelJson 期间进程常驻内存相对加载前的峰值增量，加载未抬高进程峰值时为前后之差
+    };
+
+    /**
+     * @brief 取得按类别统计的内存占用
+     *
+     * categoryBytes 来自分配器对本模型分配的标记；显存部分按已创建的纹理和缓冲尺寸计算。
+     */
+    void GetMemoryStats(MemoryStats& stats);
+
+    /**
+     * @brief 上次 LoadModelJson 各阶段的耗时，单位为毫秒
+     *
+     * 资源缓存命中时 moc、表情、物理与动作只计复制的时间。
+     */
+    struct LoadTimings
+    {
+        Csm::csmFloat32 settingMs;      ///< 读取并解析 model3.json
+        Csm::csmFloat32 mocMs;          ///< 读取 moc 并 csmReviveMocInPlace、创建模型
+        Csm::csmFloat32 expressionsMs;
+        Csm::csmFloat32 physicsMs;
+        Csm::csmFloat32 poseMs;
+        Csm::csmFloat32 userDataMs;
+        Csm::csmFloat32 motionsMs;      ///< 预加载所有动作，不预加载时为 0
+        Csm::csmFloat32 texturesMs;     ///< 创建渲染器并加载纹理
+        Csm::csmFloat32 totalMs;
+    };
+
+    const LoadTimings& GetLoadTimings() const;
+
 protected:
     /**
      *  @brief  モデルを描画する処理。モデルを描画する空間のView-Projection行列を渡す。
@@ -212,6 +495,11 @@ protected:
     void DoDraw();
 
 private:
+    /**
+     * @return 模型自己的随机数发生器的下一个值
+     */
+    Csm::csmUint32 NextRandom();
+
     /**
      * @brief model3.jsonからモデルを生成する。<br>
      *         model3.jsonの記述に従ってモデル生成、モーション、物理演算などのコンポーネント生成を行う。
@@ -235,6 +523,11 @@ private:
      */
     void PreloadMotionGroup(const Csm::csmChar* group);
 
+    /**
+     * @return SetMotionBakeRate 设置的采样率，未设置时为 model3.json 中的 "BakeRate"
+     */
+    Csm::csmFloat32 GetMotionBakeRate(const Csm::csmChar* group, Csm::csmInt32 no);
+
     /**
      * @brief すべてのモーションデータの解放
      *
@@ -249,12 +542,117 @@ private:
      */
     void ReleaseExpressions();
 
+    /**
+     * @brief 从缓存加载动作并按 model3.json 设置淡入淡出与效果参数，返回的实例由调用方释放
+     */
+    Csm::CubismMotion* LoadMotionInstance(const Csm::csmChar* group, Csm::csmInt32 no);
+
+    /**
+     * @brief Update 的实际内容：动作、表情、眨眼、拖拽、呼吸、物理与姿势
+     */
+    void Simulate(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+     * @brief 流水线的一步，在模拟线程上执行
+     */
+    static void RunPipelineStep(void* context, Csm::CubismDrawableSnapshot* snapshot);
+
+    /**
+     * @brief 结束流水线模式
+     *
+     * @param applyOverrides 是否把尚未应用的参数修改直接写入模型
+     */
+    void ReleasePipeline(bool applyOverrides);
+
+    /**
+     * @brief 流水线模式下记下的参数修改
+     */
+    struct ParameterOverride
+    {
+        enum Type
+        {
+            Type_SetParameter,
+            Type_AddParameter,
+            Type_PartOpacity,
+        };
+
+        Type type;
+        Csm::CubismIdHandle id; ///< 为 NULL 时使用 index
+        Csm::csmInt32 index;
+        Csm::csmFloat32 value;
+        Csm::csmFloat32 weight;
+    };
+
+    void QueueOverride(ParameterOverride::Type type, Csm::CubismIdHandle id, Csm::csmInt32 index,
+                       Csm::csmFloat32 value, Csm::csmFloat32 weight);
+
+    /**
+     * @brief 把口型同步的结果加到参数上
+     */
+    void ApplyLipSync();
+
+    /**
+     * @brief 按 id 查找参数输入通道各槽位对应的参数下标
+     */
+    void ResolveParameterChannel();
+
+    void ApplyOverrides(const Csm::csmVector<ParameterOverride>& overrides);
+
+    /**
+     * @brief 克隆动作模板并按 model3.json 设置淡入淡出与效果参数
+     */
+    Csm::CubismMotion* CreateMotionInstance(const Csm::CubismMotion* motionTemplate, const Csm::csmChar* group,
+                                            Csm::csmInt32 no);
+
+    /**
+     * @return 正在预取的动作在 _motionPrefetches 中的下标，不存在时返回 -1
+     */
+    Csm::csmInt32 FindMotionPrefetch(const Csm::csmChar* group, Csm::csmInt32 no) const;
+
+    /**
+     * @brief 收取后台加载完成的动作，并开始等待其中某个动作的 StartMotion
+     */
+    void PollMotionRequests();
+
+    /**
+     * @brief 放弃等待预取完成的主动作，开始与结束回调立即依次执行
+     */
+    void CancelPendingMotion();
+
+    /**
+     * @brief 放弃所有后台加载中的动作，结果由加载线程在完成后释放
+     */
+    void CancelMotionPrefetches();
+
+    struct MotionPrefetch
+    {
+        Csm::csmString group;
+        Csm::csmInt32 no;
+        LAppAssetCache::MotionRequest* request;
+    };
+
+    /**
+     * @brief 对正在预取的动作调用 StartMotion 时记下的参数
+     */
+    struct PendingMotion
+    {
+        bool active;
+        Csm::csmString group;
+        Csm::csmInt32 no;
+        Csm::csmInt32 priority;
+        void* onStartedCallee;
+        Csm::ACubismMotion::BeganMotionCallback onStartMotionHandler;
+        void* onFinishedCallee;
+        Csm::ACubismMotion::FinishedMotionCallback onFinishedMotionHandler;
+    };
+
     Csm::ICubismModelSetting* _modelSetting; ///< モデルセッティング情報
     Csm::csmString _modelHomeDir; ///< モデルセッティングが置かれたディレクトリ
     Csm::csmVector<Csm::CubismIdHandle> _eyeBlinkIds; ///< モデルに設定されたまばたき機能用パラメータID
     Csm::csmVector<Csm::CubismIdHandle> _lipSyncIds; ///< モデルに設定されたリップシンク機能用パラメータID
     Csm::csmMap<Csm::csmString, Csm::ACubismMotion*> _motions; ///< 読み込まれているモーションのリスト
     Csm::csmMap<Csm::csmString, Csm::ACubismMotion*> _expressions; ///< 読み込まれている表情のリスト
+    Csm::csmMap<Csm::csmString, Csm::csmFloat32> _motionBakeRates; ///< 动作组 -> 烘焙采样率
     const Csm::CubismId* _idParamAngleX; ///< パラメータID: ParamAngleX
     const Csm::CubismId* _idParamAngleY; ///< パラメータID: ParamAngleX
     const Csm::CubismId* _idParamAngleZ; ///< パラメータID: ParamAngleX
@@ -263,13 +661,6 @@ private:
     const Csm::CubismId* _idParamEyeBallY; ///< パラメータID: ParamEyeBallXY
     // 附加id，详见 https://docs.live2d.com/en/cubism-editor-manual/standard-parameter-list/
 
-    int _iParamAngleX;
-    int _iParamAngleY;
-    int _iParamAngleZ;
-    int _iParamBodyAngleX;
-    int _iParamEyeBallX;
-    int _iParamEyeBallY;
-
     LAppTextureManager _textureManager; ///< 纹理管理器
 
     Csm::Rendering::CubismOffscreenSurface_OpenGLES2 _renderBuffer; ///< フレームバッファ以外の描画先
@@ -284,10 +675,45 @@ private:
     double _currentFrame;
     double _lastFrame;
     float _deltaTimeSeconds;
+    double _elapsedSeconds; ///< 累计的模型时间
+    bool _drawablesUpdated; ///< UpdateDrawables 之后参数未被修改
+    Csm::csmUint32 _randomState; ///< xorshift32 的状态
+
+    LAppUpdatePipeline* _pipeline; ///< 流水线模式下的模拟线程，否则为 NULL
+    PipelineHook _pipelineHook;
+    void* _pipelineHookContext;
+    Csm::csmFloat32 _pipelineDeltaTime; ///< 模拟线程上这一步的时间间隔
+    Csm::csmVector<ParameterOverride> _pendingOverrides; ///< 上次 Update 之后记下的参数修改
+    Csm::csmVector<ParameterOverride> _stepOverrides; ///< 模拟线程上这一步要应用的参数修改
+
+    LAppLipSync _lipSync;
+    Csm::csmVector<Csm::csmInt32> _lipSyncParamIndices; ///< 口型同步驱动的参数下标
+    Csm::csmInt32 _vowelParamIndices[LAppLipSync::Vowel_Count]; ///< ParamA/I/U/E/O 的下标，不存在时为 -1
+
+    LAppParameterChannel _parameterChannel;
+    Csm::csmVector<Csm::CubismIdHandle> _parameterChannelIds; ///< 各槽位绑定的参数 id
+    Csm::csmVector<Csm::csmInt32> _parameterChannelIndices; ///< 各槽位对应的参数下标，不存在时为 -1
+    Csm::csmFloat32 _parameterChannelWeight;
+
+    Csm::csmUint32 _modelGeneration; ///< SetupModel 的次数，LAppParameterPlan 据此判断是否需要重新解析
+
+    LAppProfiler _profiler;
 
     // used to clear motion effect
     const float* _defaultParameterValues;
     float* _parameterValues;
     bool _clearMotionFlag;
     int _parameterCount;
+
+    LAppArena* _arena; ///< 加载模型期间使用的 arena，仅在 arena 分配器下非空
+    LAppMemoryAccount* _memoryAccount; ///< 本模型的内存账户
+    Csm::csmVector<const void*> _sharedAssets; ///< 从 LAppAssetCache 取得、析构时交还的资源
+    LAppMotionMixer _motionMixer; ///< 主动作之上的动作层
+    LAppProceduralEffects _effects; ///< 呼吸、眨眼与拖拽视线
+    bool _proceduralEffects; ///< 呼吸、眨眼与拖拽视线经 _effects 写入
+    Csm::csmVector<MotionPrefetch*> _motionPrefetches; ///< 后台加载中的动作
+    PendingMotion _pendingMotion; ///< 等待预取完成后开始的主动作
+    Csm::csmInt64 _loadPeakBytes;
+    LoadTimings _loadTimings;
+    Csm::csmBool _preloadMotions; ///< 加载模型时是否读取所有动作
 };
@@ -0,0 +1,203 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppMotionMixer.hpp"
+
+#include <Model/CubismModel.hpp>
+
+#include <cstring>
+
+using namespace Csm;
+
+LAppMotionMixer::LAppMotionMixer(CubismMotionEventFunction callback, void* customData)
+    : _eventCallback(callback), _eventCustomData(customData)
+{
+}
+
+LAppMotionMixer::~LAppMotionMixer()
+{
+    for (csmUint32 i = 0; i < _layers.GetSize(); i++)
+    {
+        CSM_DELETE(_layers[i]->motionManager);
+        CSM_DELETE(_layers[i]);
+    }
+}
+
+csmInt32 LAppMotionMixer::AddLayer(const csmChar* name, BlendMode mode, csmFloat32 weight)
+{
+    csmInt32 layer = FindLayer(name);
+    if (layer < 0)
+    {
+        Layer* newLayer = CSM_NEW Layer();
+        newLayer->name = name;
+        newLayer->motionManager = CSM_NEW CubismMotionManager();
+        newLayer->motionManager->SetEventCallback(_eventCallback, _eventCustomData);
+        _layers.PushBack(newLayer);
+        layer = static_cast<csmInt32>(_layers.GetSize()) - 1;
+    }
+
+    SetBlendMode(layer, mode);
+    SetWeight(layer, weight);
+
+    return layer;
+}
+
+void LAppMotionMixer::RemoveLayer(csmInt32 layer)
+{
+    if (layer < 0 || layer >= GetLayerCount())
+    {
+        return;
+    }
+
+    CSM_DELETE(_layers[layer]->motionManager);
+    CSM_DELETE(_layers[layer]);
+    _layers.Remove(layer);
+}
+
+csmInt32 LAppMotionMixer::FindLayer(const csmChar* name) const
+{
+    for (csmUint32 i = 0; i < _layers.GetSize(); i++)
+    {
+        if (_layers[i]->name == name)
+        {
+            return static_cast<csmInt32>(i);
+        }
+    }
+
+    return -1;
+}
+
+csmInt32 LAppMotionMixer::GetLayerCount() const
+{
+    return static_cast<csmInt32>(_layers.GetSize());
+}
+
+const csmChar* LAppMotionMixer::GetLayerName(csmInt32 layer) const
+{
+    return _layers[layer]->name.GetRawString();
+}
+
+void LAppMotionMixer::SetBlendMode(csmInt32 layer, BlendMode mode)
+{
+    _layers[layer]->mode = mode;
+}
+
+LAppMotionMixer::BlendMode LAppMotionMixer::GetBlendMode(csmInt32 layer) const
+{
+    return _layers[layer]->mode;
+}
+
+void LAppMotionMixer::SetWeight(csmInt32 layer, csmFloat32 weight)
+{
+    _layers[layer]->weight = weight < 0.0f ? 0.0f : (weight > 1.0f ? 1.0f : weight);
+}
+
+csmFloat32 LAppMotionMixer::GetWeight(csmInt32 layer) const
+{
+    return _layers[layer]->weight;
+}
+
+void LAppMotionMixer::SetMask(csmInt32 layer, const csmInt32* parameterIndices, csmInt32 count, csmInt32 parameterCount)
+{
+    csmVector<csmUint8>& mask = _layers[layer]->mask;
+
+    if (count <= 0)
+    {
+        mask.Clear();
+        return;
+    }
+
+    mask.UpdateSize(0);
+    mask.UpdateSize(parameterCount, 0, false);
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        if (parameterIndices[i] >= 0 && parameterIndices[i] < parameterCount)
+        {
+            mask[parameterIndices[i]] = 1;
+        }
+    }
+}
+
+CubismMotionManager* LAppMotionMixer::GetMotionManager(csmInt32 layer) const
+{
+    return _layers[layer]->motionManager;
+}
+
+csmBool LAppMotionMixer::Update(CubismModel* model, csmFloat32 deltaTimeSeconds)
+{
+    csmBool updated = false;
+
+    Live2D::Cubism::Core::csmModel* coreModel = model->GetModel();
+    const csmInt32 parameterCount = Live2D::Cubism::Core::csmGetParameterCount(coreModel);
+    csmFloat32* values = Live2D::Cubism::Core::csmGetParameterValues(coreModel);
+    const csmFloat32* defaultValues = Live2D::Cubism::Core::csmGetParameterDefaultValues(coreModel);
+    const csmFloat32* minimumValues = Live2D::Cubism::Core::csmGetParameterMinimumValues(coreModel);
+    const csmFloat32* maximumValues = Live2D::Cubism::Core::csmGetParameterMaximumValues(coreModel);
+
+    if (_baseValues.GetSize() < static_cast<csmUint32>(parameterCount))
+    {
+        _baseValues.UpdateSize(parameterCount, 0.0f, false);
+    }
+    csmFloat32* baseValues = _baseValues.GetPtr();
+
+    for (csmUint32 l = 0; l < _layers.GetSize(); l++)
+    {
+        Layer* layer = _layers[l];
+
+        if (layer->motionManager->IsFinished())
+        {
+            continue;
+        }
+
+        // 蒙版长度与模型不符（模型更换过）时视为全部参数
+        const csmUint8* mask = static_cast<csmInt32>(layer->mask.GetSize()) == parameterCount ? layer->mask.GetPtr() : NULL;
+        const csmFloat32 weight = layer->weight;
+        const csmBool additive = layer->mode == BlendMode_Additive;
+
+        memcpy(baseValues, values, sizeof(csmFloat32) * parameterCount);
+
+        if (additive)
+        {
+            for (csmInt32 i = 0; i < parameterCount; i++)
+            {
+                if (mask == NULL || mask[i])
+                {
+                    values[i] = defaultValues[i];
+                }
+            }
+        }
+
+        updated = layer->motionManager->UpdateMotion(model, deltaTimeSeconds) || updated;
+
+        for (csmInt32 i = 0; i < parameterCount; i++)
+        {
+            if (mask != NULL && !mask[i])
+            {
+                values[i] = baseValues[i];
+            }
+            else if (additive)
+            {
+                const csmFloat32 value = baseValues[i] + (values[i] - defaultValues[i]) * weight;
+                values[i] = value < minimumValues[i] ? minimumValues[i] : (value > maximumValues[i] ? maximumValues[i] : value);
+            }
+            else
+            {
+                values[i] = baseValues[i] + (values[i] - baseValues[i]) * weight;
+            }
+        }
+    }
+
+    return updated;
+}
+
+void LAppMotionMixer::StopAllMotions()
+{
+    for (csmUint32 i = 0; i < _layers.GetSize(); i++)
+    {
+        _layers[i]->motionManager->StopAllMotions();
+    }
+}
@@ -0,0 +1,118 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Motion/CubismMotionManager.hpp>
+#include <Type/csmString.hpp>
+#include <Type/csmVector.hpp>
+
+/**
+* @brief 多层动作混合器
+*
+* 每一层有自己的动作队列、参数蒙版、混合方式和权重，用于在主动作之外同时播放待机、手势、说话、视线等动作。
+* 各层按添加顺序直接在模型的参数数组上求值，层与层之间只借助一块参数数量大小的暂存区，
+* 不需要额外的 LoadParameters / SaveParameters。
+*
+* 覆盖层：蒙版内的参数 = 下层结果 + (本层结果 - 下层结果) * 权重。
+* 叠加层：本层动作从参数默认值开始求值，蒙版内的参数 = 下层结果 + (本层结果 - 默认值) * 权重。
+* 蒙版外的参数保持下层结果，即使本层的动作写入了它们。
+*/
+class LAppMotionMixer
+{
+public:
+    enum BlendMode
+    {
+        BlendMode_Override,
+        BlendMode_Additive,
+    };
+
+    /**
+    * @param callback    各层动作触发用户数据事件时的回调
+    * @param customData  传给回调的数据
+    */
+    LAppMotionMixer(Csm::CubismMotionEventFunction callback, void* customData);
+
+    ~LAppMotionMixer();
+
+    /**
+    * @brief 在最上面添加一层
+    *
+    * @return 层的下标；同名的层已存在时只更新其混合方式和权重并返回其下标
+    */
+    Csm::csmInt32 AddLayer(const Csm::csmChar* name, BlendMode mode, Csm::csmFloat32 weight);
+
+    /**
+    * @brief 移除一层并结束其中的动作，之后各层的下标前移
+    */
+    void RemoveLayer(Csm::csmInt32 layer);
+
+    /**
+    * @return 层的下标，不存在时返回 -1
+    */
+    Csm::csmInt32 FindLayer(const Csm::csmChar* name) const;
+
+    Csm::csmInt32 GetLayerCount() const;
+
+    const Csm::csmChar* GetLayerName(Csm::csmInt32 layer) const;
+
+    void SetBlendMode(Csm::csmInt32 layer, BlendMode mode);
+
+    BlendMode GetBlendMode(Csm::csmInt32 layer) const;
+
+    /**
+    * @brief 设置权重，限制在 0 到 1 之间
+    */
+    void SetWeight(Csm::csmInt32 layer, Csm::csmFloat32 weight);
+
+    Csm::csmFloat32 GetWeight(Csm::csmInt32 layer) const;
+
+    /**
+    * @brief 设置参数蒙版
+    *
+    * @param parameterIndices  受本层影响的参数下标，超出范围的下标被忽略
+    * @param count             下标个数，为 0 时本层影响全部参数
+    * @param parameterCount    模型的参数个数
+    */
+    void SetMask(Csm::csmInt32 layer, const Csm::csmInt32* parameterIndices, Csm::csmInt32 count, Csm::csmInt32 parameterCount);
+
+    /**
+    * @brief 取得层的动作队列，用于开始、查询本层的动作
+    */
+    Csm::CubismMotionManager* GetMotionManager(Csm::csmInt32 layer) const;
+
+    /**
+    * @brief 按顺序求值所有层并把结果写入模型参数
+    *
+    * @return 有任意一层更新了参数时返回 true
+    */
+    Csm::csmBool Update(Csm::CubismModel* model, Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+    * @brief 结束所有层的动作，层本身保留
+    */
+    void StopAllMotions();
+
+private:
+    struct Layer
+    {
+        Csm::csmString name;
+        BlendMode mode;
+        Csm::csmFloat32 weight;
+        Csm::csmVector<Csm::csmUint8> mask;     ///< 按参数下标的标记，为空时表示全部参数
+        Csm::CubismMotionManager* motionManager;
+    };
+
+    LAppMotionMixer(const LAppMotionMixer&);
+    LAppMotionMixer& operator=(const LAppMotionMixer&);
+
+    Csm::csmVector<Layer*> _layers;
+    Csm::csmVector<Csm::csmFloat32> _baseValues;  ///< 求值某一层前的参数值
+    Csm::CubismMotionEventFunction _eventCallback;
+    void* _eventCustomData;
+};
@@ -7,6 +7,7 @@
 
 #include "LAppPal.hpp"
 #include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <Model/CubismMoc.hpp>
@@ -15,6 +16,20 @@
 
 #include <filesystem>
 
+#if defined(_WIN32)
+#define PSAPI_VERSION 2
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+#endif
+
 using namespace Csm;
 
 csmByte* LAppPal::LoadFileAsBytes(const std::string filePath, csmSizeInt* outSize)
@@ -64,9 +79,136 @@ void LAppPal::ReleaseBytes(csmByte* byteData)
     delete[] byteData;
 }
 
+csmByte* LAppPal::MapFile(const std::string filePath, csmSizeInt* outSize)
+{
+    std::filesystem::path path = std::filesystem::u8path(filePath);
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        Info("Map failed. path:%s", filePath.c_str());
+        return NULL;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0 || fileSize.QuadPart > 0xFFFFFFFFLL)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+
+    // PAGE_WRITECOPY + FILE_MAP_COPY 即私有的写时复制映射，句柄关闭后视图仍然有效
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        return NULL;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL)
+    {
+        return NULL;
+    }
+
+    *outSize = static_cast<csmSizeInt>(fileSize.QuadPart);
+    return static_cast<csmByte*>(data);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        Info("Map failed. errno:%d path:%s", errno, filePath.c_str());
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 || st.st_size > 0xFFFFFFFFLL)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void* data = mmap(NULL, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    *outSize = static_cast<csmSizeInt>(st.st_size);
+    return static_cast<csmByte*>(data);
+#endif
+}
+
+void LAppPal::UnmapFile(csmByte* data, csmSizeInt size)
+{
+    if (data == NULL)
+    {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+void LAppPal::GetResidentBytes(csmUint64* outCurrent, csmUint64* outPeak)
+{
+    *outCurrent = 0;
+    *outPeak = 0;
+
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        *outCurrent = counters.WorkingSetSize;
+        *outPeak = counters.PeakWorkingSetSize;
+    }
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+    {
+        *outCurrent = info.resident_size;
+        *outPeak = info.resident_size_max;
+    }
+#else
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line))
+    {
+        // 单位为 kB
+        if (line.compare(0, 6, "VmRSS:") == 0)
+        {
+            *outCurrent = std::strtoull(line.c_str() + 6, NULL, 10) * 1024;
+        }
+        else if (line.compare(0, 6, "VmHWM:") == 0)
+        {
+            *outPeak = std::strtoull(line.c_str() + 6, NULL, 10) * 1024;
+        }
+    }
+#endif
+}
+
+void LAppPal::ResetPeakResidentBytes()
+{
+#if defined(__linux__)
+    // 写入 5 把 VmHWM 重置为当前 RSS（Linux 4.0+），不支持时忽略
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs.is_open())
+    {
+        clearRefs << "5";
+    }
+#endif
+}
+
 void LAppPal::PrintLn(const Csm::csmChar *message)
 {
-    Info(message);
+    Info("%s", message);
 }
 
 double LAppPal::GetCurrentTimePoint()
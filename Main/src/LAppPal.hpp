@@ -40,6 +40,36 @@ public:
     */
     static void ReleaseBytes(Csm::csmByte* byteData);
 
+    /**
+    * @brief 以写时复制方式映射整个文件
+    *
+    * 返回的地址按页对齐，可写，写入只影响本进程的私有页，不会写回文件。
+    * 未被写入的页直接使用系统的文件缓存，不占用额外的堆内存。
+    *
+    * @param[in]   filePath    文件路径
+    * @param[out]  outSize     文件大小
+    * @return                  映射地址，失败时返回 NULL
+    */
+    static Csm::csmByte* MapFile(const std::string filePath, Csm::csmSizeInt* outSize);
+
+    /**
+    * @brief 解除 MapFile 的映射
+    */
+    static void UnmapFile(Csm::csmByte* data, Csm::csmSizeInt size);
+
+    /**
+    * @brief 取得进程的常驻内存及其峰值（字节），平台不支持时为 0
+    */
+    static void GetResidentBytes(Csm::csmUint64* outCurrent, Csm::csmUint64* outPeak);
+
+    /**
+    * @brief 把常驻内存峰值重置为当前值，以便测量某一段操作的峰值
+    *
+    * 重置的是整个进程的峰值（VmHWM），只应由拥有进程的一方（如基准测试）调用，库内部不调用。
+    * 仅 Linux 支持，其余平台上峰值从进程启动起累计。
+    */
+    static void ResetPeakResidentBytes();
+
     static void PrintLn(const Csm::csmChar* message);
 
     static double GetCurrentTimePoint();
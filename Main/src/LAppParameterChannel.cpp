@@ -0,0 +1,284 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppParameterChannel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace Csm;
+
+namespace
+{
+    const double Pi = 3.14159265358979;
+
+    // 播放头落后超过 delay 加上这个时间时直接追到 delay 处，例如模型暂停更新之后
+    const double MaxLagSeconds = 0.25;
+
+    /**
+    * @brief 截止频率为 cutoff 的一阶低通在间隔 dt 下的系数
+    */
+    csmFloat32 LowPassAlpha(csmFloat32 cutoff, double dt)
+    {
+        const double tau = 1.0 / (2.0 * Pi * std::max(cutoff, 1e-3f));
+        return static_cast<csmFloat32>(1.0 / (1.0 + tau / dt));
+    }
+}
+
+LAppParameterChannel::LAppParameterChannel()
+    : _slotCount(0)
+    , _ringMask(0)
+    , _writeCount(0)
+    , _readCount(0)
+    , _droppedFrames(0)
+    , _filterType(FilterType_None)
+    , _timeConstant(0.1f)
+    , _minCutoff(1.0f)
+    , _beta(0.0f)
+    , _derivativeCutoff(1.0f)
+    , _filterPrimed(false)
+    , _lastFilterTime(0.0)
+    , _delay(-1.0f)
+    , _averageInterval(0.0)
+    , _playhead(0.0)
+    , _hasValues(false)
+{
+}
+
+LAppParameterChannel::~LAppParameterChannel()
+{
+}
+
+void LAppParameterChannel::Bind(csmInt32 slotCount, csmInt32 capacity)
+{
+    _slotCount = std::max(0, slotCount);
+
+    csmUint32 frames = 2;
+    while (frames < static_cast<csmUint32>(std::max(capacity, 2)) && frames < (1u << 16))
+    {
+        frames <<= 1;
+    }
+
+    _ringValues.Clear();
+    _ringTimes.Clear();
+    _historyValues.Clear();
+    _historyTimes.Clear();
+    _values.Clear();
+    _filterStates.Clear();
+    if (_slotCount > 0)
+    {
+        _ringValues.Resize(static_cast<csmInt32>(frames) * _slotCount, 0.0f);
+        _ringTimes.Resize(static_cast<csmInt32>(frames), 0.0);
+        _values.Resize(_slotCount, 0.0f);
+        FilterState state = {0.0f, 0.0f};
+        _filterStates.Resize(_slotCount, state);
+    }
+    _ringMask = frames - 1;
+    _writeCount.store(0, std::memory_order_relaxed);
+    _readCount.store(0, std::memory_order_relaxed);
+    _droppedFrames.store(0, std::memory_order_relaxed);
+
+    _filterPrimed = false;
+    _averageInterval = 0.0;
+    _playhead = 0.0;
+    _hasValues = false;
+}
+
+csmInt32 LAppParameterChannel::GetSlotCount() const
+{
+    return _slotCount;
+}
+
+csmBool LAppParameterChannel::Push(const csmFloat32* values, double timestamp)
+{
+    if (_slotCount == 0)
+    {
+        return false;
+    }
+
+    const csmUint32 write = _writeCount.load(std::memory_order_relaxed);
+    const csmUint32 read = _readCount.load(std::memory_order_acquire);
+    if (write - read > _ringMask)
+    {
+        _droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    const csmUint32 index = write & _ringMask;
+    memcpy(_ringValues.GetPtr() + static_cast<csmSizeInt>(index) * _slotCount, values, sizeof(csmFloat32) * _slotCount);
+    _ringTimes.GetPtr()[index] = timestamp;
+
+    _writeCount.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+void LAppParameterChannel::SetFilter(FilterType type, csmFloat32 timeConstant, csmFloat32 minCutoff,
+                                     csmFloat32 beta, csmFloat32 derivativeCutoff)
+{
+    _filterType = type;
+    _timeConstant = std::max(0.0f, timeConstant);
+    _minCutoff = std::max(1e-3f, minCutoff);
+    _beta = std::max(0.0f, beta);
+    _derivativeCutoff = std::max(1e-3f, derivativeCutoff);
+    _filterPrimed = false;
+}
+
+void LAppParameterChannel::SetDelay(csmFloat32 seconds)
+{
+    _delay = seconds;
+}
+
+csmBool LAppParameterChannel::Update(csmFloat32 deltaTimeSeconds)
+{
+    if (_slotCount == 0)
+    {
+        return false;
+    }
+
+    // 取出新帧，时间戳不递增的帧视为过时并丢弃
+    const csmUint32 read = _readCount.load(std::memory_order_relaxed);
+    const csmUint32 write = _writeCount.load(std::memory_order_acquire);
+    for (csmUint32 i = read; i != write; ++i)
+    {
+        const csmUint32 index = i & _ringMask;
+        const double timestamp = _ringTimes[index];
+        if (_historyTimes.GetSize() > 0 && timestamp <= _historyTimes[_historyTimes.GetSize() - 1])
+        {
+            continue;
+        }
+        AppendHistory(_ringValues.GetPtr() + static_cast<csmSizeInt>(index) * _slotCount, timestamp);
+    }
+    _readCount.store(write, std::memory_order_release);
+
+    const csmUint32 frameCount = _historyTimes.GetSize();
+    if (frameCount == 0)
+    {
+        return false;
+    }
+
+    const double latest = _historyTimes[frameCount - 1];
+    const double delay = _delay >= 0.0f ? _delay : _averageInterval;
+    if (!_hasValues)
+    {
+        _playhead = latest - delay;
+        _hasValues = true;
+    }
+    else
+    {
+        _playhead += std::max(0.0f, deltaTimeSeconds);
+        if (latest - _playhead > delay + MaxLagSeconds)
+        {
+            _playhead = latest - delay;
+        }
+    }
+
+    // 播放头之前的帧只保留最近的一帧作为插值的起点
+    csmUint32 first = 0;
+    while (first + 1 < frameCount && _historyTimes[first + 1] <= _playhead)
+    {
+        ++first;
+    }
+    DropHistory(first);
+
+    const csmFloat32* from = &_historyValues[0];
+    if (_historyTimes.GetSize() == 1 || _playhead <= _historyTimes[0])
+    {
+        memcpy(_values.GetPtr(), from, sizeof(csmFloat32) * _slotCount);
+        return true;
+    }
+
+    const csmFloat32* to = from + _slotCount;
+    const csmFloat32 t = static_cast<csmFloat32>((_playhead - _historyTimes[0]) / (_historyTimes[1] - _historyTimes[0]));
+    for (csmInt32 i = 0; i < _slotCount; ++i)
+    {
+        _values[i] = from[i] + (to[i] - from[i]) * t;
+    }
+    return true;
+}
+
+const csmFloat32* LAppParameterChannel::GetValues() const
+{
+    return _slotCount > 0 ? &_values[0] : NULL;
+}
+
+csmUint64 LAppParameterChannel::GetDroppedFrames() const
+{
+    return _droppedFrames.load(std::memory_order_relaxed);
+}
+
+void LAppParameterChannel::Filter(csmFloat32* values, double timestamp)
+{
+    const double dt = timestamp - _lastFilterTime;
+    const csmBool primed = _filterPrimed;
+    _filterPrimed = true;
+    _lastFilterTime = timestamp;
+
+    for (csmInt32 i = 0; i < _slotCount; ++i)
+    {
+        FilterState& state = _filterStates[i];
+        const csmFloat32 x = values[i];
+
+        if (!primed || _filterType == FilterType_None)
+        {
+            state.value = x;
+            state.derivative = 0.0f;
+            continue;
+        }
+
+        csmFloat32 alpha = 1.0f;
+        if (_filterType == FilterType_Ema)
+        {
+            if (_timeConstant > 0.0f)
+            {
+                alpha = static_cast<csmFloat32>(1.0 - std::exp(-dt / _timeConstant));
+            }
+        }
+        else
+        {
+            // 先对速度低通，再按速度提高截止频率
+            const csmFloat32 derivative = static_cast<csmFloat32>((x - state.value) / dt);
+            state.derivative += (derivative - state.derivative) * LowPassAlpha(_derivativeCutoff, dt);
+            alpha = LowPassAlpha(_minCutoff + _beta * std::fabs(state.derivative), dt);
+        }
+
+        state.value += (x - state.value) * alpha;
+        values[i] = state.value;
+    }
+}
+
+void LAppParameterChannel::AppendHistory(const csmFloat32* values, double timestamp)
+{
+    const csmUint32 frameCount = _historyTimes.GetSize();
+    if (frameCount > 0)
+    {
+        const double interval = timestamp - _historyTimes[frameCount - 1];
+        _averageInterval = _averageInterval > 0.0 ? _averageInterval + (interval - _averageInterval) * 0.1 : interval;
+    }
+
+    const csmInt32 offset = static_cast<csmInt32>(_historyValues.GetSize());
+    _historyValues.UpdateSize(offset + _slotCount, 0.0f, false);
+    memcpy(_historyValues.GetPtr() + offset, values, sizeof(csmFloat32) * _slotCount);
+    _historyTimes.PushBack(timestamp);
+
+    Filter(_historyValues.GetPtr() + offset, timestamp);
+}
+
+void LAppParameterChannel::DropHistory(csmUint32 frameCount)
+{
+    if (frameCount == 0)
+    {
+        return;
+    }
+
+    const csmUint32 remaining = _historyTimes.GetSize() - frameCount;
+    memmove(_historyTimes.GetPtr(), _historyTimes.GetPtr() + frameCount, sizeof(double) * remaining);
+    memmove(_historyValues.GetPtr(), _historyValues.GetPtr() + static_cast<csmSizeInt>(frameCount) * _slotCount,
+            sizeof(csmFloat32) * remaining * _slotCount);
+    _historyTimes.UpdateSize(static_cast<csmInt32>(remaining), 0.0, false);
+    _historyValues.UpdateSize(static_cast<csmInt32>(remaining) * _slotCount, 0.0f, false);
+}
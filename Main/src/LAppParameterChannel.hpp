@@ -0,0 +1,126 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Type/csmVector.hpp>
+
+#include <atomic>
+
+/**
+* @brief 面部捕捉等外部驱动写入参数的通道
+*
+* 每一帧是按 Bind 时的槽位排列的一组数值和它的时间戳。生产者用 Push 把帧写入无锁的环形缓冲区，
+* Update 取出所有新帧，经可选的 EMA / One-Euro 滤波后放入历史，再在播放头处对相邻两帧插值。
+* 播放头随 Update 的时间间隔前进，并保持在最新一帧之前 delay 秒，因此时间戳只需彼此一致，
+* 与模型的时钟无关，按固定步长离线更新时结果可以复现。
+* 同一时刻只能有一个线程调用 Push，它可以与 Update 同时进行；其余方法须在更新模型的线程上调用。
+*/
+class LAppParameterChannel
+{
+public:
+    enum FilterType
+    {
+        FilterType_None,
+        FilterType_Ema,     ///< 指数滑动平均，按时间常数换算每帧的系数
+        FilterType_OneEuro, ///< 1€ 滤波器，变化快时降低平滑以减少拖影
+    };
+
+    LAppParameterChannel();
+    ~LAppParameterChannel();
+
+    /**
+    * @brief 设定每帧的槽位数与缓冲区能容纳的帧数，丢弃已有的帧，slotCount 为 0 时关闭通道
+    */
+    void Bind(Csm::csmInt32 slotCount, Csm::csmInt32 capacity);
+
+    Csm::csmInt32 GetSlotCount() const;
+
+    /**
+    * @brief 写入一帧
+    *
+    * @param values 长度为槽位数的数组
+    * @param timestamp 采集时间（秒）
+    * @return 缓冲区已满或通道未绑定时返回 false，该帧被丢弃
+    */
+    Csm::csmBool Push(const Csm::csmFloat32* values, double timestamp);
+
+    /**
+    * @brief 设置滤波器，切换时重置滤波状态
+    *
+    * @param timeConstant       EMA 的时间常数（秒）
+    * @param minCutoff          One-Euro 的最小截止频率（Hz）
+    * @param beta               One-Euro 截止频率随速度增加的系数
+    * @param derivativeCutoff   One-Euro 估计速度时的截止频率（Hz）
+    */
+    void SetFilter(FilterType type, Csm::csmFloat32 timeConstant, Csm::csmFloat32 minCutoff,
+                   Csm::csmFloat32 beta, Csm::csmFloat32 derivativeCutoff);
+
+    /**
+    * @brief 播放头落后于最新一帧的时间，为负时取帧间隔的平均值
+    */
+    void SetDelay(Csm::csmFloat32 seconds);
+
+    /**
+    * @brief 取出新帧并把播放头推进 deltaTimeSeconds
+    *
+    * @return 是否已有可用的数值
+    */
+    Csm::csmBool Update(Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+    * @brief 播放头处插值后的数值，长度为槽位数
+    */
+    const Csm::csmFloat32* GetValues() const;
+
+    /**
+    * @brief 因缓冲区已满而丢弃的帧数
+    */
+    Csm::csmUint64 GetDroppedFrames() const;
+
+private:
+    LAppParameterChannel(const LAppParameterChannel&);
+    LAppParameterChannel& operator=(const LAppParameterChannel&);
+
+    struct FilterState
+    {
+        Csm::csmFloat32 value;
+        Csm::csmFloat32 derivative;
+    };
+
+    void ResetFilter();
+    void Filter(Csm::csmFloat32* values, double timestamp);
+    void AppendHistory(const Csm::csmFloat32* values, double timestamp);
+    void DropHistory(Csm::csmUint32 frameCount);
+
+    Csm::csmInt32 _slotCount;
+
+    Csm::csmVector<Csm::csmFloat32> _ringValues; ///< capacity × 槽位数
+    Csm::csmVector<double> _ringTimes;
+    Csm::csmUint32 _ringMask;
+    std::atomic<Csm::csmUint32> _writeCount;     ///< 累计写入的帧数，仅 Push 修改
+    std::atomic<Csm::csmUint32> _readCount;      ///< 累计取出的帧数，仅 Update 修改
+    std::atomic<Csm::csmUint64> _droppedFrames;
+
+    FilterType _filterType;
+    Csm::csmFloat32 _timeConstant;
+    Csm::csmFloat32 _minCutoff;
+    Csm::csmFloat32 _beta;
+    Csm::csmFloat32 _derivativeCutoff;
+    Csm::csmVector<FilterState> _filterStates;
+    Csm::csmBool _filterPrimed;
+    double _lastFilterTime;
+
+    Csm::csmVector<Csm::csmFloat32> _historyValues; ///< 滤波后的帧，按时间先后排列
+    Csm::csmVector<double> _historyTimes;
+    Csm::csmVector<Csm::csmFloat32> _values;
+    Csm::csmFloat32 _delay;
+    double _averageInterval;                    ///< 帧间隔的滑动平均
+    double _playhead;
+    Csm::csmBool _hasValues;
+};
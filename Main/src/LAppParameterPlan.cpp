@@ -0,0 +1,216 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppParameterPlan.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LAPP_PARAMETER_PLAN_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LAPP_PARAMETER_PLAN_NEON
+#endif
+
+using namespace Csm;
+
+namespace
+{
+    /**
+    * @brief 与 CubismModel::SetParameterValue 相同的截断与混合
+    *
+    * 先与最大值比较再与最小值比较，NaN 原样保留；权重恰为 1 时直接取输入，否则 current × (1 - w) + value × w。
+    * weights 为 NULL 时使用 weight。
+    */
+    void ClampAndBlend(const csmFloat32* values, const csmFloat32* currents, const csmFloat32* weights,
+                       csmFloat32 weight, const csmFloat32* minimums, const csmFloat32* maximums,
+                       csmFloat32* results, csmInt32 count)
+    {
+        csmInt32 i = 0;
+
+#if defined(LAPP_PARAMETER_PLAN_SSE2)
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 uniform = _mm_set1_ps(weight);
+        for (; i + 4 <= count; i += 4)
+        {
+            // minps / maxps 在任一操作数为 NaN 时返回第二个操作数，因此把输入放在第二位
+            __m128 value = _mm_min_ps(_mm_loadu_ps(maximums + i), _mm_loadu_ps(values + i));
+            value = _mm_max_ps(_mm_loadu_ps(minimums + i), value);
+
+            const __m128 w = weights != NULL ? _mm_loadu_ps(weights + i) : uniform;
+            const __m128 current = _mm_loadu_ps(currents + i);
+            const __m128 blended = _mm_add_ps(_mm_mul_ps(current, _mm_sub_ps(one, w)), _mm_mul_ps(value, w));
+            const __m128 exact = _mm_cmpeq_ps(w, one);
+            _mm_storeu_ps(results + i, _mm_or_ps(_mm_and_ps(exact, value), _mm_andnot_ps(exact, blended)));
+        }
+#elif defined(LAPP_PARAMETER_PLAN_NEON)
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t uniform = vdupq_n_f32(weight);
+        for (; i + 4 <= count; i += 4)
+        {
+            const float32x4_t maximum = vld1q_f32(maximums + i);
+            const float32x4_t minimum = vld1q_f32(minimums + i);
+            float32x4_t value = vld1q_f32(values + i);
+            value = vbslq_f32(vcltq_f32(maximum, value), maximum, value);
+            value = vbslq_f32(vcgtq_f32(minimum, value), minimum, value);
+
+            const float32x4_t w = weights != NULL ? vld1q_f32(weights + i) : uniform;
+            const float32x4_t current = vld1q_f32(currents + i);
+            const float32x4_t blended = vaddq_f32(vmulq_f32(current, vsubq_f32(one, w)), vmulq_f32(value, w));
+            vst1q_f32(results + i, vbslq_f32(vceqq_f32(w, one), value, blended));
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            csmFloat32 value = values[i];
+            if (maximums[i] < value)
+            {
+                value = maximums[i];
+            }
+            if (minimums[i] > value)
+            {
+                value = minimums[i];
+            }
+
+            const csmFloat32 w = weights != NULL ? weights[i] : weight;
+            results[i] = (w == 1.0f) ? value : currents[i] * (1.0f - w) + value * w;
+        }
+    }
+}
+
+LAppParameterPlan::LAppParameterPlan()
+    : _contiguous(true)
+    , _generation(0)
+{
+}
+
+void LAppParameterPlan::Bind(CubismModel* model, const CubismIdHandle* ids, csmInt32 count, csmUint32 generation)
+{
+    _ids.Clear();
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        _ids.PushBack(ids[i]);
+    }
+    Resolve(model, generation);
+}
+
+void LAppParameterPlan::Resolve(CubismModel* model, csmUint32 generation)
+{
+    _indices.Clear();
+    _slots.Clear();
+    _minimums.Clear();
+    _maximums.Clear();
+    _generation = generation;
+
+    if (model != NULL)
+    {
+        // 只在这里查找一次；不存在的 id 不调用 GetParameterIndex，以免登记为新参数
+        const csmInt32 parameterCount = model->GetParameterCount();
+        for (csmUint32 slot = 0; slot < _ids.GetSize(); ++slot)
+        {
+            for (csmInt32 index = 0; index < parameterCount; ++index)
+            {
+                if (model->GetParameterId(index) == _ids[slot])
+                {
+                    _indices.PushBack(index);
+                    _slots.PushBack(static_cast<csmInt32>(slot));
+                    _minimums.PushBack(model->GetParameterMinimumValue(index));
+                    _maximums.PushBack(model->GetParameterMaximumValue(index));
+                    break;
+                }
+            }
+        }
+    }
+
+    _contiguous = _indices.GetSize() == _ids.GetSize();
+    const csmInt32 resolved = static_cast<csmInt32>(_indices.GetSize());
+    _inputs.Resize(resolved, 0.0f);
+    _weights.Resize(resolved, 0.0f);
+    _results.Resize(resolved, 0.0f);
+}
+
+csmUint32 LAppParameterPlan::GetGeneration() const
+{
+    return _generation;
+}
+
+csmInt32 LAppParameterPlan::GetCount() const
+{
+    return static_cast<csmInt32>(_ids.GetSize());
+}
+
+csmInt32 LAppParameterPlan::GetResolvedCount() const
+{
+    return static_cast<csmInt32>(_indices.GetSize());
+}
+
+csmInt32 LAppParameterPlan::GetParameterIndex(csmInt32 i) const
+{
+    return _indices[i];
+}
+
+csmInt32 LAppParameterPlan::GetSlot(csmInt32 i) const
+{
+    return _slots[i];
+}
+
+void LAppParameterPlan::Set(CubismModel* model, const csmFloat32* values, const csmFloat32* weights, csmFloat32 weight)
+{
+    const csmInt32 count = GetResolvedCount();
+    if (count == 0)
+    {
+        return;
+    }
+
+    csmFloat32* currents = _results.GetPtr();
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        currents[i] = model->GetParameterValue(_indices[i]);
+    }
+
+    const csmFloat32* inputs = Gather(values, _inputs.GetPtr());
+    const csmFloat32* slotWeights = weights != NULL ? Gather(weights, _weights.GetPtr()) : NULL;
+    ClampAndBlend(inputs, currents, slotWeights, weight, &_minimums[0], &_maximums[0], currents, count);
+
+    model->StoreAndSaveParameterValues(&_indices[0], currents, count);
+}
+
+void LAppParameterPlan::Add(CubismModel* model, const csmFloat32* values, csmFloat32 weight)
+{
+    const csmInt32 count = GetResolvedCount();
+    if (count == 0)
+    {
+        return;
+    }
+
+    // AddAndSaveParameterValue 即以权重 1 设置 current + value × weight
+    const csmFloat32* inputs = Gather(values, _inputs.GetPtr());
+    csmFloat32* sums = _weights.GetPtr();
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        sums[i] = model->GetParameterValue(_indices[i]) + inputs[i] * weight;
+    }
+
+    csmFloat32* results = _results.GetPtr();
+    ClampAndBlend(sums, results, NULL, 1.0f, &_minimums[0], &_maximums[0], results, count);
+
+    model->StoreAndSaveParameterValues(&_indices[0], results, count);
+}
+
+const csmFloat32* LAppParameterPlan::Gather(const csmFloat32* values, csmFloat32* scratch) const
+{
+    if (_contiguous)
+    {
+        return values;
+    }
+
+    for (csmUint32 i = 0; i < _slots.GetSize(); ++i)
+    {
+        scratch[i] = values[_slots[i]];
+    }
+    return scratch;
+}
@@ -0,0 +1,87 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Model/CubismModel.hpp>
+#include <Type/csmVector.hpp>
+
+/**
+* @brief 预先解析好下标的一组参数，用于一次写入整组数值
+*
+* Bind 时把 id 解析为参数下标，并把各参数的最小、最大值收集为连续数组，
+* Set / Add 对整组数值做向量化的截断与混合后写回，结果与逐个调用 SetAndSaveParameterValue /
+* AddAndSaveParameterValue 相同。模型中不存在的 id 对应的槽位被跳过。
+*/
+class LAppParameterPlan
+{
+public:
+    LAppParameterPlan();
+
+    /**
+    * @brief 记下 id，并按当前模型解析
+    */
+    void Bind(Csm::CubismModel* model, const Csm::CubismIdHandle* ids, Csm::csmInt32 count, Csm::csmUint32 generation);
+
+    /**
+    * @brief 重新按 Bind 时的 id 解析，用于模型重新加载之后
+    */
+    void Resolve(Csm::CubismModel* model, Csm::csmUint32 generation);
+
+    /**
+    * @brief 解析时模型的加载次数，与模型当前的不同时须先 Resolve
+    */
+    Csm::csmUint32 GetGeneration() const;
+
+    /**
+    * @brief Bind 时的 id 个数，即输入数组的长度
+    */
+    Csm::csmInt32 GetCount() const;
+
+    /**
+    * @brief 模型中存在的参数个数
+    */
+    Csm::csmInt32 GetResolvedCount() const;
+
+    /**
+    * @brief 第 i 个存在的参数的下标，以及它对应输入数组中的位置
+    */
+    Csm::csmInt32 GetParameterIndex(Csm::csmInt32 i) const;
+    Csm::csmInt32 GetSlot(Csm::csmInt32 i) const;
+
+    /**
+    * @brief 截断到 [min, max] 后按权重与当前值混合，写入并保存
+    *
+    * @param values     长度为 GetCount() 的数组
+    * @param weights    长度为 GetCount() 的数组，为 NULL 时所有参数使用 weight
+    */
+    void Set(Csm::CubismModel* model, const Csm::csmFloat32* values, const Csm::csmFloat32* weights,
+             Csm::csmFloat32 weight);
+
+    /**
+    * @brief 把 values × weight 加到当前值上，截断后写入并保存
+    */
+    void Add(Csm::CubismModel* model, const Csm::csmFloat32* values, Csm::csmFloat32 weight);
+
+private:
+    /**
+    * @brief 按槽位收集输入，没有缺失的 id 时直接返回输入
+    */
+    const Csm::csmFloat32* Gather(const Csm::csmFloat32* values, Csm::csmFloat32* scratch) const;
+
+    Csm::csmVector<Csm::CubismIdHandle> _ids;
+    Csm::csmVector<Csm::csmInt32> _indices;     ///< 存在的参数的下标
+    Csm::csmVector<Csm::csmInt32> _slots;       ///< 存在的参数在输入数组中的位置
+    Csm::csmVector<Csm::csmFloat32> _minimums;
+    Csm::csmVector<Csm::csmFloat32> _maximums;
+    Csm::csmVector<Csm::csmFloat32> _inputs;    ///< 收集后的输入
+    Csm::csmVector<Csm::csmFloat32> _weights;   ///< 收集后的权重
+    Csm::csmVector<Csm::csmFloat32> _results;
+    Csm::csmBool _contiguous;                   ///< 所有 id 都存在，槽位与输入一一对应
+    Csm::csmUint32 _generation;
+};
@@ -0,0 +1,196 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppProceduralEffects.hpp"
+
+#include <Math/CubismMath.hpp>
+
+using namespace Csm;
+
+namespace
+{
+    /**
+    * @brief 与 CubismModel::AddParameterValue(index, value, weight) 相同
+    */
+    inline void AddParameterValue(CubismModel* model, csmFloat32* values, const csmFloat32* minimums,
+                                  const csmFloat32* maximums, csmInt32 parameterCount, csmInt32 index,
+                                  csmFloat32 value, csmFloat32 weight)
+    {
+        if (index >= parameterCount)
+        {
+            model->AddParameterValue(index, value, weight);
+            return;
+        }
+
+        csmFloat32 result = values[index] + (value * weight);
+        if (maximums[index] < result)
+        {
+            result = maximums[index];
+        }
+        if (minimums[index] > result)
+        {
+            result = minimums[index];
+        }
+        values[index] = result;
+    }
+}
+
+LAppProceduralEffects::LAppProceduralEffects()
+    : _breathSeconds(0.0f)
+{
+}
+
+void LAppProceduralEffects::Setup(CubismModel* model, const csmVector<CubismBreath::BreathParameterData>& breathParameters,
+                                  const csmVector<CubismIdHandle>& eyeBlinkIds, const GazeTarget* gazeTargets,
+                                  csmInt32 gazeTargetCount)
+{
+    _breathSeconds = 0.0f;
+    _breathIndices.Clear();
+    _breathOffsets.Clear();
+    _breathPeaks.Clear();
+    _breathCycles.Clear();
+    _breathWeights.Clear();
+    for (csmUint32 i = 0; i < breathParameters.GetSize(); ++i)
+    {
+        const CubismBreath::BreathParameterData& data = breathParameters[i];
+        _breathIndices.PushBack(model->GetParameterIndex(data.ParameterId));
+        _breathOffsets.PushBack(data.Offset);
+        _breathPeaks.PushBack(data.Peak);
+        _breathCycles.PushBack(data.Cycle);
+        _breathWeights.PushBack(data.Weight);
+    }
+    _breathValues.UpdateSize(_breathIndices.GetSize(), 0.0f, false);
+
+    _eyeBlinkIndices.Clear();
+    for (csmUint32 i = 0; i < eyeBlinkIds.GetSize(); ++i)
+    {
+        _eyeBlinkIndices.PushBack(model->GetParameterIndex(eyeBlinkIds[i]));
+    }
+
+    _gazeIndices.Clear();
+    _gazeX.Clear();
+    _gazeY.Clear();
+    _gazeXY.Clear();
+    for (csmInt32 i = 0; i < gazeTargetCount; ++i)
+    {
+        _gazeIndices.PushBack(model->GetParameterIndex(gazeTargets[i].parameterId));
+        _gazeX.PushBack(gazeTargets[i].x);
+        _gazeY.PushBack(gazeTargets[i].y);
+        _gazeXY.PushBack(gazeTargets[i].xy);
+    }
+}
+
+void LAppProceduralEffects::UpdateBreath(CubismModel* model, csmFloat32 deltaTimeSeconds)
+{
+    _breathSeconds += deltaTimeSeconds;
+
+    const csmFloat32 t = _breathSeconds * 2.0f * CubismMath::Pi;
+    const csmInt32 count = _breathIndices.GetSize();
+    csmFloat32* values = _breathValues.GetPtr();
+    const csmFloat32* offsets = _breathOffsets.GetPtr();
+    const csmFloat32* peaks = _breathPeaks.GetPtr();
+    const csmFloat32* cycles = _breathCycles.GetPtr();
+
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        values[i] = t / cycles[i];
+    }
+    Sin(values, values, count);
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        values[i] = offsets[i] + (peaks[i] * values[i]);
+    }
+
+    Live2D::Cubism::Core::csmModel* coreModel = model->GetModel();
+    csmFloat32* parameterValues = Live2D::Cubism::Core::csmGetParameterValues(coreModel);
+    const csmFloat32* minimums = Live2D::Cubism::Core::csmGetParameterMinimumValues(coreModel);
+    const csmFloat32* maximums = Live2D::Cubism::Core::csmGetParameterMaximumValues(coreModel);
+    const csmInt32 parameterCount = model->GetParameterCount();
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        AddParameterValue(model, parameterValues, minimums, maximums, parameterCount, _breathIndices[i], values[i],
+                          _breathWeights[i]);
+    }
+}
+
+void LAppProceduralEffects::ApplyEyeBlink(CubismModel* model, csmFloat32 value)
+{
+    Live2D::Cubism::Core::csmModel* coreModel = model->GetModel();
+    csmFloat32* parameterValues = Live2D::Cubism::Core::csmGetParameterValues(coreModel);
+    const csmFloat32* minimums = Live2D::Cubism::Core::csmGetParameterMinimumValues(coreModel);
+    const csmFloat32* maximums = Live2D::Cubism::Core::csmGetParameterMaximumValues(coreModel);
+    const csmInt32 parameterCount = model->GetParameterCount();
+
+    // 与 CubismModel::SetParameterValue(index, value) 相同
+    for (csmUint32 i = 0; i < _eyeBlinkIndices.GetSize(); ++i)
+    {
+        const csmInt32 index = _eyeBlinkIndices[i];
+        if (index >= parameterCount)
+        {
+            model->SetParameterValue(index, value);
+            continue;
+        }
+
+        csmFloat32 result = value;
+        if (maximums[index] < result)
+        {
+            result = maximums[index];
+        }
+        if (minimums[index] > result)
+        {
+            result = minimums[index];
+        }
+        parameterValues[index] = result;
+    }
+}
+
+void LAppProceduralEffects::ApplyGaze(CubismModel* model, csmFloat32 dragX, csmFloat32 dragY)
+{
+    Live2D::Cubism::Core::csmModel* coreModel = model->GetModel();
+    csmFloat32* parameterValues = Live2D::Cubism::Core::csmGetParameterValues(coreModel);
+    const csmFloat32* minimums = Live2D::Cubism::Core::csmGetParameterMinimumValues(coreModel);
+    const csmFloat32* maximums = Live2D::Cubism::Core::csmGetParameterMaximumValues(coreModel);
+    const csmInt32 parameterCount = model->GetParameterCount();
+    const csmFloat32 dragXY = dragX * dragY;
+
+    for (csmUint32 i = 0; i < _gazeIndices.GetSize(); ++i)
+    {
+        const csmFloat32 value = (dragX * _gazeX[i]) + (dragY * _gazeY[i]) + (dragXY * _gazeXY[i]);
+        AddParameterValue(model, parameterValues, minimums, maximums, parameterCount, _gazeIndices[i], value, 1.0f);
+    }
+}
+
+void LAppProceduralEffects::Sin(const csmFloat32* x, csmFloat32* out, csmInt32 count)
+{
+    // 2π 拆成三部分，前两部分只有 8 位有效数字，|k| < 2^16 时 k * TwoPiHigh 与 k * TwoPiMiddle 都没有舍入误差
+    const csmFloat32 InverseTwoPi = 0.159154943f;
+    const csmFloat32 TwoPiHigh = 6.28125f;
+    const csmFloat32 TwoPiMiddle = 1.9378662109375e-3f;
+    const csmFloat32 TwoPiLow = -2.55903137e-6f;
+    const csmFloat32 Pi = 3.14159265f;
+    const csmFloat32 HalfPi = 1.57079633f;
+
+    for (csmInt32 i = 0; i < count; ++i)
+    {
+        // 就近取整；|x| 超过 2^22 时 float 已无法表示小数部分，结果没有意义
+        const csmFloat32 scaled = x[i] * InverseTwoPi;
+        const csmFloat32 k = static_cast<csmFloat32>(static_cast<csmInt32>(scaled + (scaled >= 0.0f ? 0.5f : -0.5f)));
+        csmFloat32 r = ((x[i] - k * TwoPiHigh) - k * TwoPiMiddle) - k * TwoPiLow;
+
+        // sin(r) = sin(±π - r)，折到 [-π/2, π/2]
+        const csmFloat32 folded = (r >= 0.0f ? Pi : -Pi) - r;
+        r = (r > HalfPi || r < -HalfPi) ? folded : r;
+
+        const csmFloat32 r2 = r * r;
+        csmFloat32 p = -2.50521084e-8f;
+        p = p * r2 + 2.75573192e-6f;
+        p = p * r2 - 1.98412698e-4f;
+        p = p * r2 + 8.33333333e-3f;
+        p = p * r2 - 1.66666667e-1f;
+        out[i] = r + r * r2 * p;
+    }
+}
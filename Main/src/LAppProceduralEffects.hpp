@@ -0,0 +1,85 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Effect/CubismBreath.hpp>
+#include <Model/CubismModel.hpp>
+#include <Type/csmVector.hpp>
+
+/**
+* @brief 呼吸、眨眼与拖拽视线这几种程序化效果的参数写入
+*
+* 加载时把各效果的目标参数解析为下标，按效果分成连续的数组（SoA），更新时直接读写 Core 的参数数组，
+* 与 CubismModel::AddParameterValue / SetParameterValue 一样按参数范围截断，不再每帧按 ID 查找。
+* 呼吸的各振荡器在一个无分支的循环中计算，sin 用可向量化的多项式近似，误差在 float 的舍入误差量级。
+* 模型中不存在的参数仍交给 CubismModel 处理。
+* 各效果仍由 LAppModel 在原来的位置分别调用，与表情、外部输入和物理的先后顺序不变。
+*/
+class LAppProceduralEffects
+{
+public:
+    /**
+    * @brief 拖拽视线的一个目标，加到参数上的值为 x * dragX + y * dragY + xy * dragX * dragY
+    */
+    struct GazeTarget
+    {
+        Csm::CubismIdHandle parameterId;
+        Csm::csmFloat32 x;
+        Csm::csmFloat32 y;
+        Csm::csmFloat32 xy;
+    };
+
+    LAppProceduralEffects();
+
+    /**
+    * @brief 解析各效果的目标参数，模型加载完成后调用
+    */
+    void Setup(Csm::CubismModel* model, const Csm::csmVector<Csm::CubismBreath::BreathParameterData>& breathParameters,
+               const Csm::csmVector<Csm::CubismIdHandle>& eyeBlinkIds, const GazeTarget* gazeTargets,
+               Csm::csmInt32 gazeTargetCount);
+
+    /**
+    * @brief 推进呼吸的时间并把各振荡器的值加到参数上，对应 CubismBreath::UpdateParameters
+    */
+    void UpdateBreath(Csm::CubismModel* model, Csm::csmFloat32 deltaTimeSeconds);
+
+    /**
+    * @brief 把眨眼的值写入所有眨眼参数，值由 CubismEyeBlink::UpdateBlinkingValue 取得
+    */
+    void ApplyEyeBlink(Csm::CubismModel* model, Csm::csmFloat32 value);
+
+    /**
+    * @brief 按拖拽位置把视线与朝向的偏移加到参数上
+    */
+    void ApplyGaze(Csm::CubismModel* model, Csm::csmFloat32 dragX, Csm::csmFloat32 dragY);
+
+    /**
+    * @brief out[i] = sin(x[i])，x 与 out 可以是同一数组
+    *
+    * 先按 2π 归约到 [-π, π]，再折到 [-π/2, π/2] 上用 11 次泰勒多项式计算，循环内没有分支与函数调用。
+    * |x| ≤ 1e5 时与 sinf 的差不超过 2.4e-7；呼吸的相位约为经过秒数的 2 倍，足够连续运行十几个小时。
+    */
+    static void Sin(const Csm::csmFloat32* x, Csm::csmFloat32* out, Csm::csmInt32 count);
+
+private:
+    Csm::csmFloat32 _breathSeconds;
+    Csm::csmVector<Csm::csmInt32> _breathIndices;
+    Csm::csmVector<Csm::csmFloat32> _breathOffsets;
+    Csm::csmVector<Csm::csmFloat32> _breathPeaks;
+    Csm::csmVector<Csm::csmFloat32> _breathCycles;
+    Csm::csmVector<Csm::csmFloat32> _breathWeights;
+    Csm::csmVector<Csm::csmFloat32> _breathValues; ///< 每次更新的计算结果
+
+    Csm::csmVector<Csm::csmInt32> _eyeBlinkIndices;
+
+    Csm::csmVector<Csm::csmInt32> _gazeIndices;
+    Csm::csmVector<Csm::csmFloat32> _gazeX;
+    Csm::csmVector<Csm::csmFloat32> _gazeY;
+    Csm::csmVector<Csm::csmFloat32> _gazeXY;
+};
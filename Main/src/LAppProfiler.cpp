@@ -0,0 +1,294 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppProfiler.hpp"
+#include "LAppPal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+
+using namespace Csm;
+
+namespace
+{
+    const csmChar* StageNames[LAppProfiler::Stage_Count] = {
+        "update", "motion", "eyeBlink", "expression", "parameterInput", "drag", "breath", "physics", "lipSync", "pose",
+        "modelUpdate", "masks", "drawSubmit", "draw",
+    };
+
+    const csmChar* CounterNames[LAppProfiler::Counter_Count] = {
+        "drawCalls", "maskDrawCalls", "masks", "targetSwitches",
+    };
+
+    // trace 中的线程编号，按首次记录的顺序分配
+    std::atomic<csmUint32> s_nextThread(0);
+
+    csmUint32 GetThreadNumber()
+    {
+        static thread_local csmUint32 number = ++s_nextThread;
+        return number;
+    }
+}
+
+LAppProfiler::Scope::Scope(LAppProfiler& profiler, Stage stage)
+    : _profiler(profiler)
+    , _stage(stage)
+    , _start(profiler.Begin())
+{
+}
+
+LAppProfiler::Scope::~Scope()
+{
+    if (_start >= 0.0)
+    {
+        _profiler.End(_stage, _start);
+    }
+}
+
+LAppProfiler::LAppProfiler()
+    : _enabled(false)
+    , _window(0)
+    , _maskStart(-1.0)
+    , _tracing(false)
+    , _maxTraceEvents(0)
+    , _traceStart(0.0)
+{
+    Reset();
+}
+
+const csmChar* LAppProfiler::GetStageName(csmInt32 stage)
+{
+    return (0 <= stage && stage < Stage_Count) ? StageNames[stage] : "";
+}
+
+const csmChar* LAppProfiler::GetCounterName(csmInt32 counter)
+{
+    return (0 <= counter && counter < Counter_Count) ? CounterNames[counter] : "";
+}
+
+void LAppProfiler::SetEnable(csmBool enable, csmInt32 window)
+{
+    _enabled = false;
+    if (enable)
+    {
+        _window = std::max(1, window);
+        _stageSamples.Resize(Stage_Count * _window, 0.0f);
+        _counterSamples.Resize(Counter_Count * _window, 0.0f);
+        _sorted.Resize(_window, 0.0f);
+        Reset();
+    }
+    _enabled = enable;
+}
+
+csmBool LAppProfiler::IsEnabled() const
+{
+    return _enabled;
+}
+
+csmInt32 LAppProfiler::GetWindow() const
+{
+    return _window;
+}
+
+double LAppProfiler::Begin() const
+{
+    return (_enabled || _tracing) ? LAppPal::GetCurrentTimePoint() : -1.0;
+}
+
+void LAppProfiler::End(Stage stage, double start)
+{
+    if (start < 0.0)
+    {
+        return;
+    }
+
+    const double duration = LAppPal::GetCurrentTimePoint() - start;
+    if (_enabled)
+    {
+        _pending[stage] += duration;
+        _pendingFlags[stage] = true;
+    }
+
+    if (_tracing)
+    {
+        TraceEvent event;
+        event.stage = stage;
+        event.thread = GetThreadNumber();
+        event.start = start;
+        event.duration = duration;
+
+        std::lock_guard<std::mutex> lock(_traceMutex);
+        if (static_cast<csmInt32>(_traceEvents.GetSize()) < _maxTraceEvents)
+        {
+            _traceEvents.PushBack(event);
+        }
+    }
+}
+
+void LAppProfiler::Commit(Stage first, Stage last)
+{
+    if (!_enabled)
+    {
+        return;
+    }
+
+    for (csmInt32 stage = first; stage <= last; ++stage)
+    {
+        if (!_pendingFlags[stage])
+        {
+            continue;
+        }
+
+        const csmUint64 slot = _stageCounts[stage] % static_cast<csmUint64>(_window);
+        _stageSamples[stage * _window + static_cast<csmInt32>(slot)] = static_cast<csmFloat32>(_pending[stage] * 1000.0);
+        _stageCounts[stage]++;
+        _pending[stage] = 0.0;
+        _pendingFlags[stage] = false;
+    }
+}
+
+void LAppProfiler::RecordCounter(Counter counter, csmUint32 value)
+{
+    if (!_enabled)
+    {
+        return;
+    }
+
+    const csmUint64 slot = _counterCounts[counter] % static_cast<csmUint64>(_window);
+    _counterSamples[counter * _window + static_cast<csmInt32>(slot)] = static_cast<csmFloat32>(value);
+    _counterCounts[counter]++;
+}
+
+csmBool LAppProfiler::GetStageSummary(csmInt32 stage, Summary* outSummary) const
+{
+    if (_window == 0 || stage < 0 || stage >= Stage_Count || _stageCounts[stage] == 0)
+    {
+        return false;
+    }
+
+    Summarize(&_stageSamples[stage * _window], _stageCounts[stage], outSummary);
+    return true;
+}
+
+csmBool LAppProfiler::GetCounterSummary(csmInt32 counter, Summary* outSummary) const
+{
+    if (_window == 0 || counter < 0 || counter >= Counter_Count || _counterCounts[counter] == 0)
+    {
+        return false;
+    }
+
+    Summarize(&_counterSamples[counter * _window], _counterCounts[counter], outSummary);
+    return true;
+}
+
+void LAppProfiler::Summarize(const csmFloat32* samples, csmUint64 count, Summary* outSummary) const
+{
+    const csmInt32 n = static_cast<csmInt32>(std::min(count, static_cast<csmUint64>(_window)));
+    csmFloat32* sorted = _sorted.GetPtr();
+    std::copy(samples, samples + n, sorted);
+    std::sort(sorted, sorted + n);
+
+    double sum = 0.0;
+    for (csmInt32 i = 0; i < n; ++i)
+    {
+        sum += sorted[i];
+    }
+
+    // 最近秩法：第 ceil(p × n) 个样本
+    const csmFloat32 percentiles[3] = {0.50f, 0.95f, 0.99f};
+    csmFloat32 values[3];
+    for (csmInt32 i = 0; i < 3; ++i)
+    {
+        csmInt32 rank = static_cast<csmInt32>(std::ceil(percentiles[i] * n));
+        rank = std::min(n, std::max(1, rank));
+        values[i] = sorted[rank - 1];
+    }
+
+    outSummary->count = count;
+    outSummary->mean = static_cast<csmFloat32>(sum / n);
+    outSummary->p50 = values[0];
+    outSummary->p95 = values[1];
+    outSummary->p99 = values[2];
+    outSummary->max = sorted[n - 1];
+}
+
+void LAppProfiler::Reset()
+{
+    for (csmInt32 i = 0; i < Stage_Count; ++i)
+    {
+        _stageCounts[i] = 0;
+        _pending[i] = 0.0;
+        _pendingFlags[i] = false;
+    }
+    for (csmInt32 i = 0; i < Counter_Count; ++i)
+    {
+        _counterCounts[i] = 0;
+    }
+}
+
+void LAppProfiler::StartTrace(csmInt32 maxEvents)
+{
+    std::lock_guard<std::mutex> lock(_traceMutex);
+    _traceEvents.Clear();
+    _maxTraceEvents = std::max(0, maxEvents);
+    _traceStart = LAppPal::GetCurrentTimePoint();
+    _tracing = true;
+}
+
+csmBool LAppProfiler::IsTracing() const
+{
+    return _tracing;
+}
+
+csmInt32 LAppProfiler::StopTrace(const csmChar* path)
+{
+    _tracing = false;
+
+    std::lock_guard<std::mutex> lock(_traceMutex);
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        _traceEvents.Clear();
+        return -1;
+    }
+
+    // 时间以微秒为单位，相对于 StartTrace
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    for (csmUint32 i = 0; i < _traceEvents.GetSize(); ++i)
+    {
+        const TraceEvent& event = _traceEvents[i];
+        fprintf(file, "{\"name\":\"%s\",\"cat\":\"live2d\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                StageNames[event.stage], event.thread, (event.start - _traceStart) * 1e6, event.duration * 1e6,
+                i + 1 < _traceEvents.GetSize() ? "," : "");
+    }
+    fputs("]}\n", file);
+
+    const csmInt32 count = static_cast<csmInt32>(_traceEvents.GetSize());
+    _traceEvents.Clear();
+    const csmBool failed = ferror(file) != 0;
+    if (fclose(file) != 0 || failed)
+    {
+        return -1;
+    }
+    return count;
+}
+
+void LAppProfiler::MaskHook(void* context, csmBool begin)
+{
+    LAppProfiler* self = static_cast<LAppProfiler*>(context);
+    if (begin)
+    {
+        self->_maskStart = self->Begin();
+    }
+    else
+    {
+        self->End(Stage_Masks, self->_maskStart);
+        self->_maskStart = -1.0;
+    }
+}
@@ -0,0 +1,183 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Type/csmVector.hpp>
+
+#include <mutex>
+
+/**
+* @brief 单个模型的分阶段计时
+*
+* 各阶段用 Scope 计时，同一帧内多次进入的阶段累加，Commit 时作为一个样本写入该阶段最近 window 帧的环形缓冲区，
+* 据此计算 p50 / p95 / p99。关闭时 Scope 只做一次判断。
+* 模拟阶段与绘制阶段可以在不同线程上记录（流水线模式），但同一阶段只能由一个线程记录；读取前须等待模拟线程。
+* 另可把每次计时记为 Chrome trace 事件，用 chrome://tracing 或 Perfetto 查看。
+*/
+class LAppProfiler
+{
+public:
+    /**
+    * @brief 计时的阶段，模拟与绘制各自连续排列，以便 Commit 按区间提交
+    */
+    enum Stage
+    {
+        Stage_Update,           ///< 整个模拟步
+        Stage_Motion,           ///< 动作与动作层
+        Stage_EyeBlink,
+        Stage_Expression,
+        Stage_ParameterInput,   ///< 参数输入通道
+        Stage_Drag,
+        Stage_Breath,
+        Stage_Physics,
+        Stage_LipSync,
+        Stage_Pose,
+        Stage_ModelUpdate,      ///< csmUpdateModel
+        Stage_Masks,            ///< 裁剪蒙版的生成
+        Stage_DrawSubmit,       ///< 渲染器的 DrawModel，含蒙版生成
+        Stage_Draw,             ///< 整个 Draw
+        Stage_Count,
+    };
+
+    /**
+    * @brief 每次绘制的计数，取自 CubismRenderer_OpenGLES2::DrawStats
+    */
+    enum Counter
+    {
+        Counter_DrawCalls,
+        Counter_MaskDrawCalls,
+        Counter_Masks,
+        Counter_TargetSwitches,
+        Counter_Count,
+    };
+
+    /**
+    * @brief 最近 window 帧的统计，阶段以毫秒为单位，计数为原值
+    */
+    struct Summary
+    {
+        Csm::csmUint64 count;   ///< 开启以来的样本数
+        Csm::csmFloat32 mean;
+        Csm::csmFloat32 p50;
+        Csm::csmFloat32 p95;
+        Csm::csmFloat32 p99;
+        Csm::csmFloat32 max;
+    };
+
+    /**
+    * @brief 在作用域内为一个阶段计时
+    */
+    class Scope
+    {
+    public:
+        Scope(LAppProfiler& profiler, Stage stage);
+        ~Scope();
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        LAppProfiler& _profiler;
+        Stage _stage;
+        double _start;
+    };
+
+    LAppProfiler();
+
+    static const Csm::csmChar* GetStageName(Csm::csmInt32 stage);
+
+    static const Csm::csmChar* GetCounterName(Csm::csmInt32 counter);
+
+    /**
+    * @brief 开启或关闭统计，开启时清空已有的样本
+    *
+    * @param window 计算百分位数的帧数
+    */
+    void SetEnable(Csm::csmBool enable, Csm::csmInt32 window);
+
+    Csm::csmBool IsEnabled() const;
+
+    Csm::csmInt32 GetWindow() const;
+
+    /**
+    * @brief 开始计时，统计与 trace 均关闭时返回负数
+    */
+    double Begin() const;
+
+    /**
+    * @brief 结束 Begin 开始的计时
+    */
+    void End(Stage stage, double start);
+
+    /**
+    * @brief 把 [first, last] 内本帧记录过的阶段各写入一个样本
+    */
+    void Commit(Stage first, Stage last);
+
+    void RecordCounter(Counter counter, Csm::csmUint32 value);
+
+    /**
+    * @return 该阶段没有样本时返回 false
+    */
+    Csm::csmBool GetStageSummary(Csm::csmInt32 stage, Summary* outSummary) const;
+
+    Csm::csmBool GetCounterSummary(Csm::csmInt32 counter, Summary* outSummary) const;
+
+    /**
+    * @brief 清空样本
+    */
+    void Reset();
+
+    /**
+    * @brief 开始记录 trace 事件，超过 maxEvents 的事件被丢弃
+    */
+    void StartTrace(Csm::csmInt32 maxEvents);
+
+    Csm::csmBool IsTracing() const;
+
+    /**
+    * @brief 结束记录，并以 Chrome trace 的 JSON 格式写入文件
+    *
+    * @return 写入的事件数，无法写入文件时返回 -1
+    */
+    Csm::csmInt32 StopTrace(const Csm::csmChar* path);
+
+    /**
+    * @brief CubismRenderer_OpenGLES2::MaskHook，context 为 LAppProfiler
+    */
+    static void MaskHook(void* context, Csm::csmBool begin);
+
+private:
+    struct TraceEvent
+    {
+        Csm::csmInt32 stage;
+        Csm::csmUint32 thread;
+        double start;
+        double duration;
+    };
+
+    void Summarize(const Csm::csmFloat32* samples, Csm::csmUint64 count, Summary* outSummary) const;
+
+    Csm::csmBool _enabled;
+    Csm::csmInt32 _window;
+    Csm::csmVector<Csm::csmFloat32> _stageSamples;      ///< Stage_Count × window 的环形缓冲区，毫秒
+    Csm::csmUint64 _stageCounts[Stage_Count];
+    double _pending[Stage_Count];                       ///< 本帧累计的秒数
+    Csm::csmBool _pendingFlags[Stage_Count];
+    Csm::csmVector<Csm::csmFloat32> _counterSamples;    ///< Counter_Count × window 的环形缓冲区
+    Csm::csmUint64 _counterCounts[Counter_Count];
+    double _maskStart;
+    mutable Csm::csmVector<Csm::csmFloat32> _sorted;    ///< 计算百分位数用
+
+    Csm::csmBool _tracing;
+    Csm::csmInt32 _maxTraceEvents;
+    double _traceStart;
+    Csm::csmVector<TraceEvent> _traceEvents;
+    std::mutex _traceMutex;                             ///< 模拟线程与绘制线程都会追加事件
+};
@@ -12,6 +12,20 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "LAppPal.hpp"
+#include "LAppAssetCache.hpp"
+
+namespace
+{
+    // 来自 LAppAssetCache 的纹理交还给缓存，其余直接删除
+    void DeleteTexture(const LAppTextureManager::TextureInfo* texture)
+    {
+        if (!LAppAssetCache::ReleaseTexture(texture->id, texture->cacheOwner))
+        {
+            GLuint textureId = texture->id;
+            glDeleteTextures(1, &textureId);
+        }
+    }
+}
 
 LAppTextureManager::LAppTextureManager()
 {
@@ -39,7 +53,22 @@ LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(st
     unsigned char* png;
     unsigned char* address;
 
-    address = LAppPal::LoadFileAsBytes(fileName, &size);
+    // 其他模型已在当前上下文中上传过相同的图片时直接共用，此时不读入文件
+    std::string cacheKey;
+    const void* cacheOwner;
+    textureId = LAppAssetCache::FindTexture(fileName, &width, &height, &cacheOwner, &cacheKey, &address, &size);
+    if (textureId != 0)
+    {
+        LAppTextureManager::TextureInfo* textureInfo = new LAppTextureManager::TextureInfo();
+        textureInfo->fileName = fileName;
+        textureInfo->width = width;
+        textureInfo->height = height;
+        textureInfo->id = textureId;
+        textureInfo->cacheOwner = cacheOwner;
+        _textures.PushBack(textureInfo);
+
+        return textureInfo;
+    }
 
     // png情報を取得する
     png = stbi_load_from_memory(
@@ -70,6 +99,8 @@ LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(st
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glBindTexture(GL_TEXTURE_2D, 0);
 
+    cacheOwner = LAppAssetCache::AddTexture(cacheKey, textureId, width, height);
+
     // 解放処理
     stbi_image_free(png);
     LAppPal::ReleaseBytes(address);
@@ -81,6 +112,7 @@ LAppTextureManager::TextureInfo* LAppTextureManager::CreateTextureFromPngFile(st
         textureInfo->width = width;
         textureInfo->height = height;
         textureInfo->id = textureId;
+        textureInfo->cacheOwner = cacheOwner;
 
         _textures.PushBack(textureInfo);
     }
@@ -93,7 +125,7 @@ void LAppTextureManager::ReleaseTextures()
 {
     for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
     {
-        glDeleteTextures(1, &(_textures[i]->id));
+        DeleteTexture(_textures[i]);
         delete _textures[i];
     }
 
@@ -108,7 +140,7 @@ void LAppTextureManager::ReleaseTexture(Csm::csmUint32 textureId)
         {
             continue;
         }
-        glDeleteTextures(1, &(_textures[i]->id));
+        DeleteTexture(_textures[i]);
         delete _textures[i];
         _textures.Remove(i);
         break;
@@ -121,7 +153,7 @@ void LAppTextureManager::ReleaseTexture(std::string fileName)
     {
         if (_textures[i]->fileName == fileName)
         {
-            glDeleteTextures(1, &(_textures[i]->id));
+            DeleteTexture(_textures[i]);
             delete _textures[i];
             _textures.Remove(i);
             break;
@@ -141,3 +173,31 @@ LAppTextureManager::TextureInfo* LAppTextureManager::GetTextureInfoById(GLuint t
 
     return NULL;
 }
+
+Csm::csmInt64 LAppTextureManager::GetTextureBytes() const
+{
+    Csm::csmInt64 bytes = 0;
+
+    for (Csm::csmUint32 i = 0; i < _textures.GetSize(); i++)
+    {
+        Csm::csmInt64 width = _textures[i]->width;
+        Csm::csmInt64 height = _textures[i]->height;
+        Csm::csmInt64 textureBytes = 0;
+
+        // mipmap 链逐级减半，直到 1x1
+        while (true)
+        {
+            textureBytes += width * height * 4;
+            if (width == 1 && height == 1)
+            {
+                break;
+            }
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+
+        bytes += textureBytes / LAppAssetCache::GetTextureUsers(_textures[i]->id, _textures[i]->cacheOwner);
+    }
+
+    return bytes;
+}
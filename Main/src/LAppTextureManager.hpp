@@ -34,6 +34,7 @@ public:
         int width;              ///< 横幅
         int height;             ///< 高さ
         std::string fileName;   ///< ファイル名
+        const void* cacheOwner; ///< LAppAssetCache に登録したときの GL コンテキスト、登録していなければ NULL
     };
 
     /**
@@ -107,6 +108,14 @@ public:
      */
     TextureInfo* GetTextureInfoById(GLuint textureId) const;
 
+    /**
+     * @brief 所有纹理占用的显存字节数
+     *
+     * 按上传时的 RGBA8 格式及 glGenerateMipmap 生成的完整 mipmap 链计算。
+     * 经 LAppAssetCache 共用的纹理按引用数均分，所有模型之和即为实际占用
+     */
+    Csm::csmInt64 GetTextureBytes() const;
+
 private:
     Csm::csmVector<TextureInfo*> _textures;
 };
@@ -0,0 +1,132 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppUpdatePipeline.hpp"
+
+#include "LAppPal.hpp"
+
+using namespace Csm;
+
+LAppUpdatePipeline::LAppUpdatePipeline(Step step, void* context)
+    : _step(step)
+    , _context(context)
+    , _started(false)
+    , _busy(false)
+    , _quit(false)
+    , _front(-1)
+    , _frontDrawn(false)
+    , _steps(0)
+    , _stepSeconds(0.0)
+    , _waitSeconds(0.0)
+    , _latencySeconds(0.0)
+    , _latencySamples(0)
+{
+    _startTimes[0] = 0.0;
+    _startTimes[1] = 0.0;
+    _createdAt = LAppPal::GetCurrentTimePoint();
+    _thread = std::thread(&LAppUpdatePipeline::ThreadMain, this);
+}
+
+LAppUpdatePipeline::~LAppUpdatePipeline()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return !_busy; });
+        _quit = true;
+    }
+    _wakeUp.notify_one();
+    _thread.join();
+}
+
+void LAppUpdatePipeline::Start()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _startTimes[_front == 0 ? 1 : 0] = LAppPal::GetCurrentTimePoint();
+        _started = true;
+        _busy = true;
+    }
+    _wakeUp.notify_one();
+}
+
+csmBool LAppUpdatePipeline::Wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_started)
+    {
+        return false;
+    }
+
+    if (_busy)
+    {
+        const double waitBegin = LAppPal::GetCurrentTimePoint();
+        _done.wait(lock, [this] { return !_busy; });
+        _waitSeconds += LAppPal::GetCurrentTimePoint() - waitBegin;
+    }
+
+    _front = _front == 0 ? 1 : 0;
+    _frontDrawn = false;
+    _started = false;
+    return true;
+}
+
+const CubismDrawableSnapshot* LAppUpdatePipeline::GetFrontSnapshot() const
+{
+    return _front < 0 ? NULL : &_snapshots[_front];
+}
+
+void LAppUpdatePipeline::OnDraw()
+{
+    if (_front < 0 || _frontDrawn)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _latencySeconds += LAppPal::GetCurrentTimePoint() - _startTimes[_front];
+    _latencySamples++;
+    _frontDrawn = true;
+}
+
+void LAppUpdatePipeline::GetStats(Stats* outStats) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const double elapsed = LAppPal::GetCurrentTimePoint() - _createdAt;
+
+    outStats->steps = _steps;
+    outStats->stepMs = _steps > 0 ? static_cast<csmFloat32>(_stepSeconds * 1000.0 / _steps) : 0.0f;
+    outStats->waitMs = _steps > 0 ? static_cast<csmFloat32>(_waitSeconds * 1000.0 / _steps) : 0.0f;
+    outStats->latencyMs = _latencySamples > 0 ? static_cast<csmFloat32>(_latencySeconds * 1000.0 / _latencySamples) : 0.0f;
+    outStats->stepsPerSecond = elapsed > 0.0 ? static_cast<csmFloat32>(_steps / elapsed) : 0.0f;
+}
+
+void LAppUpdatePipeline::ThreadMain()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _wakeUp.wait(lock, [this] { return _busy || _quit; });
+        if (_quit)
+        {
+            return;
+        }
+
+        // 前台快照只由调用线程读取，后台快照只由这里写入
+        CubismDrawableSnapshot* snapshot = &_snapshots[_front == 0 ? 1 : 0];
+        lock.unlock();
+
+        const double begin = LAppPal::GetCurrentTimePoint();
+        _step(_context, snapshot);
+        const double seconds = LAppPal::GetCurrentTimePoint() - begin;
+
+        lock.lock();
+        _stepSeconds += seconds;
+        _steps++;
+        _busy = false;
+        _done.notify_all();
+    }
+}
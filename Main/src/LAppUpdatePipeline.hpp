@@ -0,0 +1,100 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+#include <Model/CubismDrawableSnapshot.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+* @brief 单个模型的模拟线程与双缓冲的绘制快照
+*
+* 模拟线程执行 step 计算下一帧，并把 csmUpdateModel 的结果复制进后台快照；
+* 绘制线程在此期间使用前台快照。Wait 之后两块快照交换，刚完成的一帧成为前台。
+* Start 与 Wait 只能在同一个线程上调用。
+*/
+class LAppUpdatePipeline
+{
+public:
+    /**
+    * @brief 在模拟线程上执行的一步，须把结果写入 snapshot
+    */
+    typedef void (*Step)(void* context, Csm::CubismDrawableSnapshot* snapshot);
+
+    struct Stats
+    {
+        Csm::csmUint64 steps;           ///< 已完成的步数
+        Csm::csmFloat32 stepMs;         ///< 模拟线程上每步的平均耗时
+        Csm::csmFloat32 waitMs;         ///< 调用线程在 Wait 中平均等待的时间，越接近 0 重叠越充分
+        Csm::csmFloat32 latencyMs;      ///< 从 Start 到该步的快照首次被绘制的平均时间
+        Csm::csmFloat32 stepsPerSecond; ///< 自创建以来每秒完成的步数
+    };
+
+    LAppUpdatePipeline(Step step, void* context);
+
+    /**
+    * @brief 等待进行中的一步并结束模拟线程
+    */
+    ~LAppUpdatePipeline();
+
+    /**
+    * @brief 在模拟线程上开始下一步，须确保上一步已被 Wait
+    */
+    void Start();
+
+    /**
+    * @brief 等待进行中的一步完成并交换快照
+    *
+    * @return 是否有新的快照成为前台
+    */
+    Csm::csmBool Wait();
+
+    /**
+    * @brief 当前用于绘制的快照，第一步完成前为 NULL
+    */
+    const Csm::CubismDrawableSnapshot* GetFrontSnapshot() const;
+
+    /**
+    * @brief 绘制前台快照时调用，用于统计延迟
+    */
+    void OnDraw();
+
+    void GetStats(Stats* outStats) const;
+
+private:
+    LAppUpdatePipeline(const LAppUpdatePipeline&);
+    LAppUpdatePipeline& operator=(const LAppUpdatePipeline&);
+
+    void ThreadMain();
+
+    Step _step;
+    void* _context;
+
+    std::thread _thread;
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeUp;
+    std::condition_variable _done;
+    bool _started;                      ///< 已 Start 但尚未 Wait
+    bool _busy;                         ///< 模拟线程正在执行
+    bool _quit;
+
+    Csm::CubismDrawableSnapshot _snapshots[2];
+    Csm::csmInt32 _front;               ///< 前台快照的下标，尚无时为 -1
+    double _startTimes[2];              ///< 各快照对应的一步开始的时间
+    bool _frontDrawn;
+
+    double _createdAt;
+    Csm::csmUint64 _steps;
+    double _stepSeconds;
+    double _waitSeconds;
+    double _latencySeconds;
+    Csm::csmUint64 _latencySamples;
+};
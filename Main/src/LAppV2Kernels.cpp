@@ -0,0 +1,309 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppV2Kernels.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace Csm;
+
+namespace
+{
+    /**
+    * @brief 网格四边形的四个角，按 Python 实现中的两个三角形插值
+    *
+    * p00 为第一个三角形的原点，p11 为第二个三角形的原点，u、v 为四边形内的坐标。
+    */
+    inline void InterpolateQuad(double p00x, double p00y, double p10x, double p10y, double p01x, double p01y,
+                                double p11x, double p11y, double u, double v, double* out)
+    {
+        if (u + v <= 1)
+        {
+            out[0] = p00x + (p10x - p00x) * u + (p01x - p00x) * v;
+            out[1] = p00y + (p10y - p00y) * u + (p01y - p00y) * v;
+        }
+        else
+        {
+            out[0] = p11x + (p01x - p11x) * (1 - u) + (p10x - p11x) * (1 - v);
+            out[1] = p11y + (p01y - p11y) * (1 - u) + (p10y - p11y) * (1 - v);
+        }
+    }
+}
+
+void LAppV2Kernels::InterpolatePoints(const double* pivots, csmInt32 pointLength, const csmInt32* indices,
+                                      const double* t, csmInt32 dimension, csmInt32 valueCount, double* out)
+{
+    if (dimension <= 0)
+    {
+        memcpy(out, pivots + static_cast<size_t>(indices[0]) * pointLength, sizeof(double) * valueCount);
+        return;
+    }
+
+    const csmInt32 pivotCount = 1 << dimension;
+    double stackWeights[32];
+    std::vector<double> heapWeights;
+    double* weights = stackWeights;
+    if (pivotCount > 32)
+    {
+        heapWeights.resize(pivotCount);
+        weights = heapWeights.data();
+    }
+
+    if (dimension <= 4)
+    {
+        // 展开的分支中权重为 (1 - t) 或 t 从最高维乘到第 0 维
+        for (csmInt32 k = 0; k < pivotCount; ++k)
+        {
+            double weight = ((k >> (dimension - 1)) & 1) ? t[dimension - 1] : 1 - t[dimension - 1];
+            for (csmInt32 j = dimension - 2; j >= 0; --j)
+            {
+                weight *= ((k >> j) & 1) ? t[j] : 1 - t[j];
+            }
+            weights[k] = weight;
+        }
+
+        const double* pivot = pivots + static_cast<size_t>(indices[0]) * pointLength;
+        for (csmInt32 i = 0; i < valueCount; ++i)
+        {
+            out[i] = weights[0] * pivot[i];
+        }
+    }
+    else
+    {
+        // 通用分支的下标以浮点数逐次减半，第一次遇到奇数或小数后其余维度都取 t，与原实现一致
+        for (csmInt32 k = 0; k < pivotCount; ++k)
+        {
+            double index = k;
+            double weight = 1;
+            for (csmInt32 j = 0; j < dimension; ++j)
+            {
+                weight *= (fmod(index, 2.0) == 0) ? 1 - t[j] : t[j];
+                index /= 2;
+            }
+            weights[k] = weight;
+        }
+
+        const double* pivot = pivots + static_cast<size_t>(indices[0]) * pointLength;
+        for (csmInt32 i = 0; i < valueCount; ++i)
+        {
+            out[i] = 0.0 + weights[0] * pivot[i];
+        }
+    }
+
+    // 逐个枢轴累加，每个值的求和顺序与 Python 相同，内层循环可以向量化
+    for (csmInt32 k = 1; k < pivotCount; ++k)
+    {
+        const double weight = weights[k];
+        const double* pivot = pivots + static_cast<size_t>(indices[k]) * pointLength;
+        for (csmInt32 i = 0; i < valueCount; ++i)
+        {
+            out[i] += weight * pivot[i];
+        }
+    }
+}
+
+csmBool LAppV2Kernels::TransformWarpPoints(const double* src, double* dst, csmInt32 pointCount, csmInt32 offset,
+                                           csmInt32 step, const double* grid, csmInt32 row, csmInt32 col)
+{
+    const csmInt32 stride = row + 1;
+    const csmInt32 end = pointCount * step;
+
+    // 网格外的点按整个网格的平行四边形近似外推，首次用到时计算
+    csmBool outsideReady = false;
+    double centerX = 0;
+    double centerY = 0;
+    double axisX0 = 0;
+    double axisY0 = 0;
+    double axisX1 = 0;
+    double axisY1 = 0;
+
+#define GRID_X(i, j) grid[((i) + (j) * stride) * 2]
+#define GRID_Y(i, j) grid[((i) + (j) * stride) * 2 + 1]
+
+    for (csmInt32 k = offset; k < end; k += step)
+    {
+        const double x = src[k];
+        const double y = src[k + 1];
+        const double gx = x * row;
+        const double gy = y * col;
+
+        if (gx < 0 || gy < 0 || row <= gx || col <= gy)
+        {
+            if (!outsideReady)
+            {
+                outsideReady = true;
+                centerX = 0.25 * (GRID_X(0, 0) + GRID_X(row, 0) + GRID_X(0, col) + GRID_X(row, col));
+                centerY = 0.25 * (GRID_Y(0, 0) + GRID_Y(row, 0) + GRID_Y(0, col) + GRID_Y(row, col));
+                const double diagonalX0 = GRID_X(row, col) - GRID_X(0, 0);
+                const double diagonalY0 = GRID_Y(row, col) - GRID_Y(0, 0);
+                const double diagonalX1 = GRID_X(row, 0) - GRID_X(0, col);
+                const double diagonalY1 = GRID_Y(row, 0) - GRID_Y(0, col);
+                axisX0 = (diagonalX0 + diagonalX1) * 0.5;
+                axisY0 = (diagonalY0 + diagonalY1) * 0.5;
+                axisX1 = (diagonalX0 - diagonalX1) * 0.5;
+                axisY1 = (diagonalY0 - diagonalY1) * 0.5;
+                centerX -= 0.5 * (axisX0 + axisX1);
+                centerY -= 0.5 * (axisY0 + axisY1);
+            }
+
+            const double cx = centerX;
+            const double cy = centerY;
+            const double bl = axisX0;
+            const double bk = axisY0;
+            const double bf = axisX1;
+            const double be = axisY1;
+
+            if ((-2 < x && x < 3) && (-2 < y && y < 3))
+            {
+                if (x <= 0)
+                {
+                    if (y <= 0)
+                    {
+                        InterpolateQuad(cx - 2 * bl - 2 * bf, cy - 2 * bk - 2 * be,
+                                        cx - 2 * bf, cy - 2 * be,
+                                        cx - 2 * bl, cy - 2 * bk,
+                                        GRID_X(0, 0), GRID_Y(0, 0),
+                                        0.5 * (x - (-2)), 0.5 * (y - (-2)), dst + k);
+                    }
+                    else if (y >= 1)
+                    {
+                        InterpolateQuad(cx - 2 * bl + 1 * bf, cy - 2 * bk + 1 * be,
+                                        GRID_X(0, col), GRID_Y(0, col),
+                                        cx - 2 * bl + 3 * bf, cy - 2 * bk + 3 * be,
+                                        cx + 3 * bf, cy + 3 * be,
+                                        0.5 * (x - (-2)), 0.5 * (y - (1)), dst + k);
+                    }
+                    else
+                    {
+                        csmInt32 j = static_cast<csmInt32>(gy);
+                        if (j == col)
+                        {
+                            j = col - 1;
+                        }
+                        const double v0 = static_cast<double>(j) / col;
+                        const double v1 = static_cast<double>(j + 1) / col;
+                        InterpolateQuad(cx - 2 * bl + v0 * bf, cy - 2 * bk + v0 * be,
+                                        GRID_X(0, j), GRID_Y(0, j),
+                                        cx - 2 * bl + v1 * bf, cy - 2 * bk + v1 * be,
+                                        GRID_X(0, j + 1), GRID_Y(0, j + 1),
+                                        0.5 * (x - (-2)), gy - j, dst + k);
+                    }
+                }
+                else if (1 <= x)
+                {
+                    if (y <= 0)
+                    {
+                        InterpolateQuad(cx + 1 * bl - 2 * bf, cy + 1 * bk - 2 * be,
+                                        cx + 3 * bl - 2 * bf, cy + 3 * bk - 2 * be,
+                                        GRID_X(row, 0), GRID_Y(row, 0),
+                                        cx + 3 * bl, cy + 3 * bk,
+                                        0.5 * (x - (1)), 0.5 * (y - (-2)), dst + k);
+                    }
+                    else if (y >= 1)
+                    {
+                        InterpolateQuad(GRID_X(row, col), GRID_Y(row, col),
+                                        cx + 3 * bl + 1 * bf, cy + 3 * bk + 1 * be,
+                                        cx + 1 * bl + 3 * bf, cy + 1 * bk + 3 * be,
+                                        cx + 3 * bl + 3 * bf, cy + 3 * bk + 3 * be,
+                                        0.5 * (x - (1)), 0.5 * (y - (1)), dst + k);
+                    }
+                    else
+                    {
+                        csmInt32 j = static_cast<csmInt32>(gy);
+                        if (j == col)
+                        {
+                            j = col - 1;
+                        }
+                        const double v0 = static_cast<double>(j) / col;
+                        const double v1 = static_cast<double>(j + 1) / col;
+                        InterpolateQuad(GRID_X(row, j), GRID_Y(row, j),
+                                        cx + 3 * bl + v0 * bf, cy + 3 * bk + v0 * be,
+                                        GRID_X(row, j + 1), GRID_Y(row, j + 1),
+                                        cx + 3 * bl + v1 * bf, cy + 3 * bk + v1 * be,
+                                        0.5 * (x - (1)), gy - j, dst + k);
+                    }
+                }
+                else
+                {
+                    csmInt32 i = static_cast<csmInt32>(gx);
+                    if (i == row)
+                    {
+                        i = row - 1;
+                    }
+                    const double u0 = static_cast<double>(i) / row;
+                    const double u1 = static_cast<double>(i + 1) / row;
+
+                    if (y <= 0)
+                    {
+                        InterpolateQuad(cx + u0 * bl - 2 * bf, cy + u0 * bk - 2 * be,
+                                        cx + u1 * bl - 2 * bf, cy + u1 * bk - 2 * be,
+                                        GRID_X(i, 0), GRID_Y(i, 0),
+                                        GRID_X(i + 1, 0), GRID_Y(i + 1, 0),
+                                        gx - i, 0.5 * (y - (-2)), dst + k);
+                    }
+                    else if (y >= 1)
+                    {
+                        InterpolateQuad(GRID_X(i, col), GRID_Y(i, col),
+                                        GRID_X(i + 1, col), GRID_Y(i + 1, col),
+                                        cx + u0 * bl + 3 * bf, cy + u0 * bk + 3 * be,
+                                        cx + u1 * bl + 3 * bf, cy + u1 * bk + 3 * be,
+                                        gx - i, 0.5 * (y - (1)), dst + k);
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+            }
+            else
+            {
+                dst[k] = cx + x * bl + y * bf;
+                dst[k + 1] = cy + x * bk + y * be;
+            }
+        }
+        else
+        {
+            const csmInt32 i = static_cast<csmInt32>(gx);
+            const csmInt32 j = static_cast<csmInt32>(gy);
+            const double u = gx - i;
+            const double v = gy - j;
+            const csmInt32 base = 2 * (i + j * stride);
+            const csmInt32 below = base + 2 * stride;
+            if (u + v < 1)
+            {
+                dst[k] = grid[base] * (1 - u - v) + grid[base + 2] * u + grid[below] * v;
+                dst[k + 1] = grid[base + 1] * (1 - u - v) + grid[base + 3] * u + grid[below + 1] * v;
+            }
+            else
+            {
+                dst[k] = grid[below + 2] * (u - 1 + v) + grid[below] * (1 - u) + grid[base + 2] * (1 - v);
+                dst[k + 1] = grid[below + 3] * (u - 1 + v) + grid[below + 1] * (1 - u) + grid[base + 3] * (1 - v);
+            }
+        }
+    }
+
+#undef GRID_X
+#undef GRID_Y
+
+    return true;
+}
+
+void LAppV2Kernels::TransformAffinePoints(const double* src, double* dst, csmInt32 pointCount, csmInt32 offset,
+                                          csmInt32 step, double m00, double m01, double m10, double m11,
+                                          double tx, double ty)
+{
+    const csmInt32 end = pointCount * step;
+    for (csmInt32 k = offset; k < end; k += step)
+    {
+        const double x = src[k];
+        const double y = src[k + 1];
+        dst[k] = m00 * x + m01 * y + tx;
+        dst[k + 1] = m10 * x + m11 * y + ty;
+    }
+}
@@ -0,0 +1,56 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+/**
+* @brief Cubism 2 运行时（live2d.v2，纯 Python 实现）中逐点计算的部分
+*
+* 与 UtInterpolate.interpolatePoints、WarpDeformer.transformPoints_sdk2 和 RotationDeformer.transformPoints
+* 一一对应。Python 的浮点数是双精度，这里按相同的运算顺序以 double 计算，结果与 Python 实现逐位相同，
+* 因此本文件须在不合并乘加（-ffp-contract=off）的情况下编译。
+*/
+class LAppV2Kernels
+{
+public:
+    /**
+    * @brief 按枢轴插值顶点
+    *
+    * @param pivots      所有枢轴的顶点，每个枢轴 pointLength 个值，依次排列
+    * @param indices     参与插值的 2^dimension 个枢轴下标（PivotManager.calcPivotIndices 的结果）
+    * @param t           各维度的插值系数
+    * @param dimension   需要插值的维度数，0 表示直接取 indices[0]
+    * @param valueCount  输出的值数，即顶点数 * 2，不超过 pointLength
+    * @param out         连续存放的输出
+    */
+    static void InterpolatePoints(const double* pivots, Csm::csmInt32 pointLength, const Csm::csmInt32* indices,
+                                  const double* t, Csm::csmInt32 dimension, Csm::csmInt32 valueCount, double* out);
+
+    /**
+    * @brief 用网格变形器变换顶点
+    *
+    * 处理 src 中下标为 offset, offset + step, ... 且小于 pointCount * step 的点，结果写到 dst 的相同位置。
+    * src 与 dst 可以是同一数组。
+    *
+    * @param grid  (row + 1) * (col + 1) 个网格点
+    * @return 点落在网格外 3 倍范围以上的非法位置时返回 false（对应 Python 的 "error @BDBoxGrid"）
+    */
+    static Csm::csmBool TransformWarpPoints(const double* src, double* dst, Csm::csmInt32 pointCount,
+                                            Csm::csmInt32 offset, Csm::csmInt32 step, const double* grid,
+                                            Csm::csmInt32 row, Csm::csmInt32 col);
+
+    /**
+    * @brief 用仿射变换变换顶点，点的选取与 TransformWarpPoints 相同
+    *
+    * x' = m00 * x + m01 * y + tx，y' = m10 * x + m11 * y + ty
+    */
+    static void TransformAffinePoints(const double* src, double* dst, Csm::csmInt32 pointCount,
+                                      Csm::csmInt32 offset, Csm::csmInt32 step, double m00, double m01,
+                                      double m10, double m11, double tx, double ty);
+};
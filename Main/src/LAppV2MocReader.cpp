@@ -0,0 +1,572 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppV2MocReader.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Csm;
+
+namespace
+{
+    const csmInt32 FormatVersionTexOption = 8;   // LIVE2D_FORMAT_VERSION_V2_8_TEX_OPTION
+    const csmInt32 FormatVersionSdk2 = 10;       // LIVE2D_FORMAT_VERSION_V2_10_SDK2
+    const csmInt32 FormatVersionAvailable = 11;  // LIVE2D_FORMAT_VERSION_AVAILABLE
+    const csmInt32 ObjectRef = 33;               // OBJECT_REF
+    const csmInt32 MaxDepth = 256;               // 正常的模型不超过十层，防止损坏的文件耗尽栈
+
+    // Live2DObjectFactory 中的类编号
+    enum ClassId
+    {
+        Class_WarpDeformer = 65,
+        Class_PivotManager = 66,
+        Class_ParamPivots = 67,
+        Class_RotationDeformer = 68,
+        Class_AffineEnt = 69,
+        Class_Mesh = 70,
+        Class_ParamDefFloat = 131,
+        Class_PartsData = 133,
+        Class_ModelImpl = 136,
+        Class_ParamDefSet = 137,
+        Class_Avatar = 142,
+    };
+}
+
+LAppV2MocReader::LAppV2MocReader()
+    : _data(NULL)
+    , _size(0)
+    , _offset(0)
+    , _bitOffset(0)
+    , _currentBits(0)
+    , _formatVersion(0)
+    , _objectCount(0)
+{
+}
+
+csmBool LAppV2MocReader::Read(const csmUint8* data, csmSizeType size)
+{
+    _data = data;
+    _size = size;
+    _offset = 0;
+    _bitOffset = 0;
+    _currentBits = 0;
+    _formatVersion = 0;
+    _objectCount = 0;
+    _error.clear();
+    _tokens.clear();
+    _int32s.clear();
+    _float32s.clear();
+    _float64s.clear();
+
+    // 各数组的长度都不超过文件大小的四分之一，预留后解码过程中几乎不再扩容
+    _tokens.reserve(size / 4);
+    _float32s.reserve(size / 4);
+
+    csmUint8 magic[4];
+    for (csmInt32 i = 0; i < 4; i++)
+    {
+        if (!ReadByte(&magic[i]))
+        {
+            return false;
+        }
+        if (i == 2 && !(magic[0] == 'm' && magic[1] == 'o' && magic[2] == 'c'))
+        {
+            return Fail("Invalid MOC file.");
+        }
+    }
+
+    _formatVersion = magic[3];
+    if (_formatVersion > FormatVersionAvailable)
+    {
+        csmChar message[64];
+        snprintf(message, sizeof(message), "Unsupported version %d\n", _formatVersion);
+        return Fail(message);
+    }
+
+    if (!ReadObject(0))
+    {
+        return false;
+    }
+
+    if (_formatVersion >= FormatVersionTexOption)
+    {
+        // 两个值为 0x8888 的 readUShort
+        const csmUint8* eof;
+        if (!ReadBytes(&eof, 4))
+        {
+            return false;
+        }
+        if (eof[0] != 0x88 || eof[1] != 0x88 || eof[2] != 0x88 || eof[3] != 0x88)
+        {
+            return Fail("Invalid load EOF");
+        }
+    }
+
+    return true;
+}
+
+const std::string& LAppV2MocReader::GetError() const
+{
+    return _error;
+}
+
+csmInt32 LAppV2MocReader::GetFormatVersion() const
+{
+    return _formatVersion;
+}
+
+const std::vector<csmInt32>& LAppV2MocReader::GetTokens() const
+{
+    return _tokens;
+}
+
+const std::vector<csmInt32>& LAppV2MocReader::GetInt32s() const
+{
+    return _int32s;
+}
+
+const std::vector<csmFloat32>& LAppV2MocReader::GetFloat32s() const
+{
+    return _float32s;
+}
+
+const std::vector<double>& LAppV2MocReader::GetFloat64s() const
+{
+    return _float64s;
+}
+
+csmBool LAppV2MocReader::ReadObject(csmInt32 depth)
+{
+    if (depth >= MaxDepth)
+    {
+        return Fail("moc object nesting too deep");
+    }
+
+    csmInt32 type;
+    if (!ReadNumber(&type))
+    {
+        return false;
+    }
+
+    if (type == ObjectRef)
+    {
+        csmInt32 index;
+        if (!ReadInt32(&index))
+        {
+            return false;
+        }
+        if (index < 0 || index >= _objectCount)
+        {
+            return Fail("_sL _4i @_m0");
+        }
+        AddToken(Token_Ref, index, 0);
+        return true;
+    }
+
+    // 与 BinaryReader.readKnownTypeObject 的判断顺序相同
+    csmBool ok;
+    if (type == 0)
+    {
+        AddToken(Token_Null, 0, 0);
+        ok = true;
+    }
+    else if (type == 50 || type == 51 || type == 134 || type == 60)
+    {
+        ok = ReadStringToken(Token_Id);
+    }
+    else if (type >= 48)
+    {
+        ok = ReadClass(type, depth);
+    }
+    else if (type == 1)
+    {
+        ok = ReadStringToken(Token_String);
+    }
+    else if (type == 15)
+    {
+        csmInt32 count;
+        if (!ReadNumber(&count))
+        {
+            return false;
+        }
+        // 每个元素至少占一个字节
+        if (!Remaining(static_cast<csmSizeType>(count)))
+        {
+            return false;
+        }
+        AddToken(Token_Array, count, 0);
+        ok = true;
+        for (csmInt32 i = 0; i < count && ok; i++)
+        {
+            ok = ReadObject(depth + 1);
+        }
+    }
+    else if (type == 23)
+    {
+        return Fail("type not implemented");
+    }
+    else if (type == 16 || type == 25)
+    {
+        ok = ReadInt32ArrayToken();
+    }
+    else if (type == 26)
+    {
+        ok = ReadFloat64ArrayToken();
+    }
+    else if (type == 27)
+    {
+        ok = ReadFloat32ArrayToken();
+    }
+    else
+    {
+        csmChar message[32];
+        snprintf(message, sizeof(message), "type error %d", type);
+        return Fail(message);
+    }
+
+    if (ok)
+    {
+        _objectCount++;
+    }
+    return ok;
+}
+
+csmBool LAppV2MocReader::ReadClass(csmInt32 classId, csmInt32 depth)
+{
+    AddToken(Token_Object, classId, 0);
+    depth++;
+
+    switch (classId)
+    {
+    case Class_WarpDeformer:
+        return ReadDeformer(depth) && ReadInt32Token() && ReadInt32Token() &&
+               ReadObject(depth) && ReadObject(depth) && ReadOpacity();
+    case Class_PivotManager:
+        return ReadObject(depth);
+    case Class_ParamPivots:
+        return ReadObject(depth) && ReadInt32Token() && ReadObject(depth);
+    case Class_RotationDeformer:
+        return ReadDeformer(depth) && ReadObject(depth) && ReadObject(depth) && ReadOpacity();
+    case Class_AffineEnt:
+        for (csmInt32 i = 0; i < 5; i++)
+        {
+            if (!ReadFloat32Token())
+            {
+                return false;
+            }
+        }
+        return _formatVersion < FormatVersionSdk2 || (ReadBooleanToken() && ReadBooleanToken());
+    case Class_Mesh:
+    {
+        if (!ReadIdDrawData(depth) || !ReadInt32Token() || !ReadInt32Token() || !ReadInt32Token() ||
+            !ReadObject(depth) || !ReadObject(depth) || !ReadObject(depth))
+        {
+            return false;
+        }
+        if (_formatVersion < FormatVersionTexOption)
+        {
+            return true;
+        }
+        csmInt32 optionFlag;
+        if (!ReadInt32(&optionFlag))
+        {
+            return false;
+        }
+        AddToken(Token_Int32, optionFlag, 0);
+        if ((optionFlag & 1) != 0)
+        {
+            return Fail("not handled");
+        }
+        return true;
+    }
+    case Class_ParamDefFloat:
+        return ReadFloat32Token() && ReadFloat32Token() && ReadFloat32Token() && ReadObject(depth);
+    case Class_PartsData:
+        return ReadBitToken() && ReadBitToken() && ReadObject(depth) && ReadObject(depth) && ReadObject(depth);
+    case Class_ModelImpl:
+        return ReadObject(depth) && ReadObject(depth) && ReadInt32Token() && ReadInt32Token();
+    case Class_ParamDefSet:
+        return ReadObject(depth);
+    case Class_Avatar:
+        return ReadObject(depth) && ReadObject(depth) && ReadObject(depth);
+    default:
+    {
+        csmChar message[48];
+        snprintf(message, sizeof(message), "Unknown class ID: %d", classId);
+        return Fail(message);
+    }
+    }
+}
+
+csmBool LAppV2MocReader::ReadIdDrawData(csmInt32 depth)
+{
+    if (!ReadObject(depth) || !ReadObject(depth) || !ReadObject(depth) || !ReadInt32Token() ||
+        !ReadInt32ArrayToken() || !ReadFloat32ArrayToken())
+    {
+        return false;
+    }
+    return _formatVersion < FormatVersionAvailable || ReadObject(depth);
+}
+
+csmBool LAppV2MocReader::ReadDeformer(csmInt32 depth)
+{
+    return ReadObject(depth) && ReadObject(depth);
+}
+
+csmBool LAppV2MocReader::ReadOpacity()
+{
+    return _formatVersion < FormatVersionSdk2 || ReadFloat32ArrayToken();
+}
+
+csmBool LAppV2MocReader::ReadNumber(csmInt32* out)
+{
+    // 与 BinaryReader.readNumber 相同，包括第三、四个字节取满 8 位的写法
+    csmUint8 b1, b2, b3, b4;
+    if (!ReadByte(&b1))
+    {
+        return false;
+    }
+    if ((b1 & 128) == 0)
+    {
+        *out = b1;
+        return true;
+    }
+
+    if (!ReadByte(&b2))
+    {
+        return false;
+    }
+    if ((b2 & 128) == 0)
+    {
+        *out = ((b1 & 127) << 7) | (b2 & 127);
+        return true;
+    }
+
+    if (!ReadByte(&b3))
+    {
+        return false;
+    }
+    if ((b3 & 128) == 0)
+    {
+        *out = ((b1 & 127) << 14) | ((b2 & 127) << 7) | b3;
+        return true;
+    }
+
+    if (!ReadByte(&b4))
+    {
+        return false;
+    }
+    if ((b4 & 128) == 0)
+    {
+        *out = ((b1 & 127) << 21) | ((b2 & 127) << 14) | ((b3 & 127) << 7) | b4;
+        return true;
+    }
+
+    return Fail("number parse error");
+}
+
+csmBool LAppV2MocReader::ReadByte(csmUint8* out)
+{
+    const csmUint8* bytes;
+    if (!ReadBytes(&bytes, 1))
+    {
+        return false;
+    }
+    *out = bytes[0];
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadBytes(const csmUint8** out, csmSizeType size)
+{
+    // 除 readBit 外的读取都先丢弃未读完的位（BinaryReader.checkBits）
+    _bitOffset = 0;
+    if (!Remaining(size))
+    {
+        return false;
+    }
+    *out = _data + _offset;
+    _offset += size;
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadInt32(csmInt32* out)
+{
+    const csmUint8* bytes;
+    if (!ReadBytes(&bytes, 4))
+    {
+        return false;
+    }
+    const csmUint32 value = (static_cast<csmUint32>(bytes[0]) << 24) | (static_cast<csmUint32>(bytes[1]) << 16) |
+                            (static_cast<csmUint32>(bytes[2]) << 8) | static_cast<csmUint32>(bytes[3]);
+    memcpy(out, &value, sizeof(value));
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadFloat32(csmFloat32* out)
+{
+    csmInt32 bits;
+    if (!ReadInt32(&bits))
+    {
+        return false;
+    }
+    memcpy(out, &bits, sizeof(bits));
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadFloat64(double* out)
+{
+    const csmUint8* bytes;
+    if (!ReadBytes(&bytes, 8))
+    {
+        return false;
+    }
+    csmUint64 value = 0;
+    for (csmInt32 i = 0; i < 8; i++)
+    {
+        value = (value << 8) | bytes[i];
+    }
+    memcpy(out, &value, sizeof(value));
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadInt32Token()
+{
+    csmInt32 value;
+    if (!ReadInt32(&value))
+    {
+        return false;
+    }
+    AddToken(Token_Int32, value, 0);
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadFloat32Token()
+{
+    csmFloat32 value;
+    if (!ReadFloat32(&value))
+    {
+        return false;
+    }
+    AddToken(Token_Float32, static_cast<csmInt32>(_float32s.size()), 0);
+    _float32s.push_back(value);
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadBitToken()
+{
+    // 与 BinaryReader.readBit 相同：位从高到低取，读满 8 位或被其他读取打断后重新取一个字节
+    if (_bitOffset == 0 || _bitOffset == 8)
+    {
+        if (!ReadByte(&_currentBits))
+        {
+            return false;
+        }
+    }
+    AddToken(Token_Bit, (_currentBits >> (7 - _bitOffset)) & 1, 0);
+    _bitOffset++;
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadBooleanToken()
+{
+    csmUint8 value;
+    if (!ReadByte(&value))
+    {
+        return false;
+    }
+    AddToken(Token_Boolean, value != 0 ? 1 : 0, 0);
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadStringToken(TokenKind kind)
+{
+    csmInt32 length;
+    if (!ReadNumber(&length) || !Remaining(static_cast<csmSizeType>(length)))
+    {
+        return false;
+    }
+    AddToken(kind, static_cast<csmInt32>(_offset), length);
+    _offset += length;
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadInt32ArrayToken()
+{
+    csmInt32 count;
+    if (!ReadNumber(&count) || !Remaining(static_cast<csmSizeType>(count) * 4))
+    {
+        return false;
+    }
+    const csmSizeType start = _int32s.size();
+    _int32s.resize(start + count);
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        ReadInt32(&_int32s[start + i]);
+    }
+    AddToken(Token_Int32Array, static_cast<csmInt32>(start), count);
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadFloat32ArrayToken()
+{
+    csmInt32 count;
+    if (!ReadNumber(&count) || !Remaining(static_cast<csmSizeType>(count) * 4))
+    {
+        return false;
+    }
+    const csmSizeType start = _float32s.size();
+    _float32s.resize(start + count);
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        ReadFloat32(&_float32s[start + i]);
+    }
+    AddToken(Token_Float32Array, static_cast<csmInt32>(start), count);
+    return true;
+}
+
+csmBool LAppV2MocReader::ReadFloat64ArrayToken()
+{
+    csmInt32 count;
+    if (!ReadNumber(&count) || !Remaining(static_cast<csmSizeType>(count) * 8))
+    {
+        return false;
+    }
+    const csmSizeType start = _float64s.size();
+    _float64s.resize(start + count);
+    for (csmInt32 i = 0; i < count; i++)
+    {
+        ReadFloat64(&_float64s[start + i]);
+    }
+    AddToken(Token_Float64Array, static_cast<csmInt32>(start), count);
+    return true;
+}
+
+void LAppV2MocReader::AddToken(TokenKind kind, csmInt32 a, csmInt32 b)
+{
+    _tokens.push_back(kind);
+    _tokens.push_back(a);
+    _tokens.push_back(b);
+}
+
+csmBool LAppV2MocReader::Fail(const std::string& message)
+{
+    if (_error.empty())
+    {
+        _error = message;
+    }
+    return false;
+}
+
+csmBool LAppV2MocReader::Remaining(csmSizeType size)
+{
+    if (size > _size - _offset)
+    {
+        return Fail("unexpected end of moc data");
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+* @brief Cubism 2 的 .moc 文件解码器，供 live2d.v2 的 NativeBinaryReader 使用
+*
+* 按 BinaryReader.readObject 与各模型类的 read() 相同的顺序遍历对象图，把读到的每个值记为一个记号，
+* 数组内容放进按类型分开的连续数组。Python 端依次取出记号，各类的 read() 无需修改。
+* 记号为 (kind, a, b) 三个 csmInt32，含义见 TokenKind。
+*/
+class LAppV2MocReader
+{
+public:
+    /**
+    * @brief 记号种类，数值须与 native_binary_reader.py 中的常量一致
+    */
+    enum TokenKind
+    {
+        Token_Null,          ///< 类型 0
+        Token_Ref,           ///< a 为已读对象的下标
+        Token_Object,        ///< a 为类编号，其后是该类 read() 读取的记号
+        Token_Id,            ///< a、b 为 UTF-8 字符串在文件中的偏移与字节数
+        Token_String,        ///< 同 Token_Id
+        Token_Array,         ///< a 为元素数，其后是各元素的记号
+        Token_Int32Array,    ///< a、b 为 GetInt32s() 中的偏移与长度
+        Token_Float32Array,  ///< a、b 为 GetFloat32s() 中的偏移与长度
+        Token_Float64Array,  ///< a、b 为 GetFloat64s() 中的偏移与长度
+        Token_Int32,         ///< a 为值
+        Token_Float32,       ///< a 为 GetFloat32s() 中的下标
+        Token_Bit,           ///< a 为 0 或 1
+        Token_Boolean,       ///< a 为 0 或 1
+    };
+
+    LAppV2MocReader();
+
+    /**
+    * @brief 解码整个 .moc 文件，包括文件头与结尾的校验
+    *
+    * @return 失败时返回 false，原因由 GetError() 取得，与 Python 实现抛出的信息相同
+    */
+    Csm::csmBool Read(const Csm::csmUint8* data, Csm::csmSizeType size);
+
+    const std::string& GetError() const;
+
+    Csm::csmInt32 GetFormatVersion() const;
+
+    const std::vector<Csm::csmInt32>& GetTokens() const;
+
+    const std::vector<Csm::csmInt32>& GetInt32s() const;
+
+    const std::vector<Csm::csmFloat32>& GetFloat32s() const;
+
+    const std::vector<double>& GetFloat64s() const;
+
+private:
+    Csm::csmBool ReadObject(Csm::csmInt32 depth);
+    Csm::csmBool ReadClass(Csm::csmInt32 classId, Csm::csmInt32 depth);
+    Csm::csmBool ReadIdDrawData(Csm::csmInt32 depth);
+    Csm::csmBool ReadDeformer(Csm::csmInt32 depth);
+    Csm::csmBool ReadOpacity();
+
+    Csm::csmBool ReadNumber(Csm::csmInt32* out);
+    Csm::csmBool ReadByte(Csm::csmUint8* out);
+    Csm::csmBool ReadBytes(const Csm::csmUint8** out, Csm::csmSizeType size);
+    Csm::csmBool ReadInt32(Csm::csmInt32* out);
+    Csm::csmBool ReadFloat32(Csm::csmFloat32* out);
+    Csm::csmBool ReadFloat64(double* out);
+    Csm::csmBool ReadInt32Token();
+    Csm::csmBool ReadFloat32Token();
+    Csm::csmBool ReadBitToken();
+    Csm::csmBool ReadBooleanToken();
+    Csm::csmBool ReadStringToken(TokenKind kind);
+    Csm::csmBool ReadInt32ArrayToken();
+    Csm::csmBool ReadFloat32ArrayToken();
+    Csm::csmBool ReadFloat64ArrayToken();
+
+    void AddToken(TokenKind kind, Csm::csmInt32 a, Csm::csmInt32 b);
+    Csm::csmBool Fail(const std::string& message);
+    Csm::csmBool Remaining(Csm::csmSizeType size);
+
+    const Csm::csmUint8* _data;
+    Csm::csmSizeType _size;
+    Csm::csmSizeType _offset;
+    Csm::csmInt32 _bitOffset;      ///< 对应 BinaryReader.offset8Bit
+    Csm::csmUint8 _currentBits;    ///< 对应 BinaryReader.current8Bit
+    Csm::csmInt32 _formatVersion;
+    Csm::csmInt32 _objectCount;    ///< 已读完的对象数，即 Python 端 objects 列表的长度
+    std::string _error;
+    std::vector<Csm::csmInt32> _tokens;
+    std::vector<Csm::csmInt32> _int32s;
+    std::vector<Csm::csmFloat32> _float32s;
+    std::vector<double> _float64s;
+};
@@ -0,0 +1,160 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#include "LAppWorkerPool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using namespace Csm;
+
+namespace
+{
+    /**
+    * @brief 线程池的状态
+    *
+    * generation 每开始一个批次加一，工作线程据此判断是否有新的批次。
+    * 工作线程只在持锁确认批次仍有未领取的下标时加入，Run 持锁确认下标已领完且没有工作线程在执行后才返回，
+    * 因此醒得晚的线程不会把旧批次的任务带进下一批次。
+    */
+    struct Pool
+    {
+        std::mutex runMutex;
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::condition_variable done;
+        csmUint64 generation;
+        LAppWorkerPool::Task task;
+        void* context;
+        csmInt32 count;
+        std::atomic<csmInt32> next;
+        csmInt32 busyWorkers;
+        csmInt32 workerCount;
+        csmInt32 startedWorkers;
+    };
+
+    Pool* GetPool()
+    {
+        static Pool* pool = NULL;
+        static std::once_flag once;
+        std::call_once(once, [] {
+            pool = new Pool();
+            pool->generation = 0;
+            pool->task = NULL;
+            pool->context = NULL;
+            pool->count = 0;
+            pool->next = 0;
+            pool->busyWorkers = 0;
+            pool->startedWorkers = 0;
+
+            const csmUint32 hardwareThreads = std::thread::hardware_concurrency();
+            pool->workerCount = hardwareThreads > 1 ? static_cast<csmInt32>(hardwareThreads) - 1 : 0;
+        });
+        return pool;
+    }
+
+    void RunTasks(Pool* pool, LAppWorkerPool::Task task, void* context, csmInt32 count)
+    {
+        for (csmInt32 i = pool->next.fetch_add(1); i < count; i = pool->next.fetch_add(1))
+        {
+            task(context, i);
+        }
+    }
+
+    void WorkerMain(Pool* pool, csmInt32 id)
+    {
+        csmUint64 seen = 0;
+        std::unique_lock<std::mutex> lock(pool->mutex);
+        while (true)
+        {
+            pool->wakeUp.wait(lock, [pool, seen] { return pool->generation != seen; });
+            seen = pool->generation;
+
+            if (id >= pool->workerCount || pool->next.load() >= pool->count)
+            {
+                continue;
+            }
+
+            LAppWorkerPool::Task task = pool->task;
+            void* context = pool->context;
+            const csmInt32 count = pool->count;
+            pool->busyWorkers++;
+
+            lock.unlock();
+            RunTasks(pool, task, context, count);
+            lock.lock();
+
+            if (--pool->busyWorkers == 0)
+            {
+                pool->done.notify_one();
+            }
+        }
+    }
+}
+
+void LAppWorkerPool::Run(csmInt32 count, Task task, void* context)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    Pool* pool = GetPool();
+    std::lock_guard<std::mutex> runLock(pool->runMutex);
+    csmBool serial;
+    {
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        serial = count == 1 || pool->workerCount == 0;
+        if (!serial)
+        {
+            for (; pool->startedWorkers < pool->workerCount; pool->startedWorkers++)
+            {
+                std::thread(WorkerMain, pool, pool->startedWorkers).detach();
+            }
+
+            // 下标、任务与批次号须在同一次持锁内更新，否则醒得晚的线程可能用新的下标执行旧的任务
+            pool->task = task;
+            pool->context = context;
+            pool->count = count;
+            pool->next = 0;
+            pool->generation++;
+        }
+    }
+
+    if (serial)
+    {
+        for (csmInt32 i = 0; i < count; i++)
+        {
+            task(context, i);
+        }
+        return;
+    }
+
+    pool->wakeUp.notify_all();
+
+    RunTasks(pool, task, context, count);
+
+    std::unique_lock<std::mutex> lock(pool->mutex);
+    pool->done.wait(lock, [pool] { return pool->busyWorkers == 0 && pool->next.load() >= pool->count; });
+}
+
+void LAppWorkerPool::SetThreadCount(csmInt32 count)
+{
+    Pool* pool = GetPool();
+    std::lock_guard<std::mutex> runLock(pool->runMutex);
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    pool->workerCount = count > 1 ? count - 1 : 0;
+}
+
+csmInt32 LAppWorkerPool::GetThreadCount()
+{
+    Pool* pool = GetPool();
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    return pool->workerCount + 1;
+}
@@ -0,0 +1,41 @@
+﻿/**
+ * Copyright(c) Live2D Inc. All rights reserved.
+ *
+ * Use of this source code is governed by the Live2D Open Software license
+ * that can be found at https://www.live2d.com/eula/live2d-open-software-license-agreement_en.html.
+ */
+
+#pragma once
+
+#include <CubismFramework.hpp>
+
+/**
+* @brief 进程内共享的常驻工作线程池，用于把互不相关的模型更新分摊到多个核心上
+*
+* 工作线程在 Run 时按需创建，默认数量为硬件线程数减一，调用线程同样参与执行。
+* 线程分离且状态从不释放，与 LAppAssetCache 的加载线程相同。
+*/
+class LAppWorkerPool
+{
+public:
+    typedef void (*Task)(void* context, Csm::csmInt32 index);
+
+    /**
+    * @brief 对 [0, count) 中的每个下标调用一次 task(context, index)，全部完成后返回
+    *
+    * 下标的执行顺序与所在线程不确定。多个线程同时调用时各批次依次执行。
+    */
+    static void Run(Csm::csmInt32 count, Task task, void* context);
+
+    /**
+    * @brief 设置参与执行的线程数，含调用线程，1 表示在调用线程上依次执行
+    *
+    * 默认为硬件线程数。可在任意批次之间调用，多出的工作线程保持休眠。
+    */
+    static void SetThreadCount(Csm::csmInt32 count);
+
+    /**
+    * @brief 参与执行的线程数，含调用线程
+    */
+    static Csm::csmInt32 GetThreadCount();
+};
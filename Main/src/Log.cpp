@@ -1,52 +1,311 @@
-#include "Log.hpp"
-#include <ctime>
+﻿#include "Log.hpp"
+#include <chrono>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdarg>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 
 bool live2dLogEnable = true;
 
-void Debug(const char *fmt, ...)
+namespace
 {
-    if (live2dLogEnable)
+    const unsigned int Capacity = 1024;     // 2 的幂
+
+    /**
+    * @brief 环形缓冲的槽位
+    *
+    * sequence 按 Vyukov 的有界队列使用：等于写入位置时可写，等于写入位置 + 1 时可读。
+    */
+    struct Cell
+    {
+        std::atomic<unsigned int> sequence;
+        LogLevel level;
+        const char* file;
+        int line;
+        unsigned int suppressed;
+        char message[LogRecord::MaxMessageLength + 1];
+    };
+
+    /**
+    * @brief 日志的状态
+    *
+    * 后台线程分离且状态从不释放，与 LAppWorkerPool 相同，进程退出时不必等待线程结束。
+    * 读端与 sink 由 drainMutex 保护，因此 LogFlush 可以在任意线程上代替后台线程取出消息。
+    */
+    struct Logger
+    {
+        Cell cells[Capacity];
+        std::atomic<unsigned int> writePosition;
+        std::atomic<unsigned int> dropped;
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        std::mutex drainMutex;
+        unsigned int readPosition;
+        LogSink sink;
+        void* sinkUserData;
+    };
+
+    std::atomic<int> s_level(LogLevel_Debug);
+    std::atomic<int> s_rateLimit(20);
+
+    // 当前线程持有 drainMutex 并正在调用 sink，sink 中再调用 LogFlush / LogSetSink 不能再次加锁
+    thread_local bool t_draining = false;
+
+    void DrainLoop(Logger* logger);
+    void FlushAtExit();
+
+    Logger* GetLogger()
+    {
+        static Logger* logger = NULL;
+        static std::once_flag once;
+        std::call_once(once, [] {
+            logger = new Logger();
+            for (unsigned int i = 0; i < Capacity; ++i)
+            {
+                logger->cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            logger->writePosition = 0;
+            logger->dropped = 0;
+            logger->readPosition = 0;
+            logger->sink = NULL;
+            logger->sinkUserData = NULL;
+
+            std::thread(DrainLoop, logger).detach();
+            atexit(FlushAtExit);
+        });
+        return logger;
+    }
+
+    void PrintRecord(const LogRecord* record)
+    {
+        switch (record->level)
+        {
+        case LogLevel_Debug:
+            printf("\033[34m[DEBUG] %s", record->message);
+            break;
+        case LogLevel_Info:
+            printf("[INFO]  %s", record->message);
+            break;
+        case LogLevel_Warn:
+            printf("\033[33m[WARN]  %s", record->message);
+            break;
+        default:
+            printf("\033[31m[ERROR] %s", record->message);
+            break;
+        }
+        if (record->suppressed > 0)
+        {
+            printf(" (%u similar messages suppressed)", record->suppressed);
+        }
+        printf(record->level == LogLevel_Info ? "\n" : "\033[0m\n");
+    }
+
+    void Emit(Logger* logger, const LogRecord* record)
+    {
+        if (logger->sink != NULL)
+        {
+            t_draining = true;
+            logger->sink(logger->sinkUserData, record);
+            t_draining = false;
+        }
+        else
+        {
+            PrintRecord(record);
+        }
+    }
+
+    /**
+    * @brief 取出所有已写完的消息，调用方持有 drainMutex
+    */
+    void Drain(Logger* logger)
+    {
+        for (;;)
+        {
+            Cell& cell = logger->cells[logger->readPosition & (Capacity - 1)];
+            if (cell.sequence.load(std::memory_order_acquire) != logger->readPosition + 1)
+            {
+                break;
+            }
+
+            LogRecord record;
+            record.level = cell.level;
+            record.file = cell.file;
+            record.line = cell.line;
+            record.suppressed = cell.suppressed;
+            record.message = cell.message;
+            Emit(logger, &record);
+
+            cell.sequence.store(logger->readPosition + Capacity, std::memory_order_release);
+            ++logger->readPosition;
+        }
+
+        const unsigned int dropped = logger->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0)
+        {
+            char message[64];
+            snprintf(message, sizeof(message), "%u log messages dropped, buffer full", dropped);
+            LogRecord record = {LogLevel_Warn, __FILE__, __LINE__, 0, message};
+            Emit(logger, &record);
+        }
+        if (logger->sink == NULL)
+        {
+            fflush(stdout);
+        }
+    }
+
+    void DrainLoop(Logger* logger)
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(logger->wakeMutex);
+                logger->wake.wait_for(lock, std::chrono::milliseconds(20));
+            }
+
+            std::lock_guard<std::mutex> lock(logger->drainMutex);
+            Drain(logger);
+        }
+    }
+
+    void FlushAtExit()
+    {
+        // 此时 sink 的所有者可能已经销毁，剩余消息写到 stdout
+        Logger* logger = GetLogger();
+        std::lock_guard<std::mutex> lock(logger->drainMutex);
+        logger->sink = NULL;
+        logger->sinkUserData = NULL;
+        Drain(logger);
+    }
+
+    long long NowMilliseconds()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+    * @brief 按一秒的固定窗口计数，返回 false 表示本条被限速
+    */
+    bool Admit(LogSite* site)
     {
-        printf("\033[34m[DEBUG] ");
-        va_list args;
-        va_start(args, fmt);
-        vfprintf(stdout, fmt, args);
-        va_end(args);
-        printf("\033[0m\n");
+        const int limit = s_rateLimit.load(std::memory_order_relaxed);
+        if (limit <= 0)
+        {
+            return true;
+        }
+
+        const long long now = NowMilliseconds();
+        long long start = site->windowStart.load(std::memory_order_relaxed);
+        if (now - start >= 1000 && site->windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed))
+        {
+            site->count.store(0, std::memory_order_relaxed);
+        }
+
+        if (site->count.fetch_add(1, std::memory_order_relaxed) >= static_cast<unsigned int>(limit))
+        {
+            site->suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
     }
 }
 
-void Info(const char *fmt, ...)
+void LogSetSink(LogSink sink, void* userData)
 {
-    if (live2dLogEnable)
+    Logger* logger = GetLogger();
+    if (t_draining)
     {
-        printf("[INFO]  ");
-        va_list args;
-        va_start(args, fmt);
-        vfprintf(stdout, fmt, args);
-        va_end(args);
-        printf("\n");
+        logger->sink = sink;
+        logger->sinkUserData = userData;
+        return;
     }
+
+    std::lock_guard<std::mutex> lock(logger->drainMutex);
+    logger->sink = sink;
+    logger->sinkUserData = userData;
 }
 
-void Warn(const char *fmt, ...)
+void LogSetLevel(LogLevel level)
 {
-    printf("\033[33m[WARN]  ");
-    va_list args;
-    va_start(args, fmt);
-    vfprintf(stdout, fmt, args);
-    va_end(args);
-    printf("\033[0m\n");
+    s_level.store(level, std::memory_order_relaxed);
 }
 
-void Error(const char *fmt, ...)
+LogLevel LogGetLevel()
 {
-    printf("\033[31m[ERROR] ");
+    return static_cast<LogLevel>(s_level.load(std::memory_order_relaxed));
+}
+
+void LogSetRateLimit(int perSecond)
+{
+    s_rateLimit.store(perSecond, std::memory_order_relaxed);
+}
+
+void LogFlush()
+{
+    if (t_draining)
+    {
+        return;
+    }
+
+    Logger* logger = GetLogger();
+    std::lock_guard<std::mutex> lock(logger->drainMutex);
+    Drain(logger);
+}
+
+void LogWrite(LogSite* site, LogLevel level, const char* fmt, ...)
+{
+    if (level < s_level.load(std::memory_order_relaxed) || (level < LogLevel_Warn && !live2dLogEnable))
+    {
+        return;
+    }
+    if (!Admit(site))
+    {
+        return;
+    }
+
+    // 认领一个空槽，缓冲满时丢弃而不等待
+    Logger* logger = GetLogger();
+    unsigned int position = logger->writePosition.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;)
+    {
+        cell = &logger->cells[position & (Capacity - 1)];
+        const int difference = static_cast<int>(cell->sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0)
+        {
+            if (logger->writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            logger->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = logger->writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->level = level;
+    cell->file = site->file;
+    cell->line = site->line;
+    cell->suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+
     va_list args;
     va_start(args, fmt);
-    vfprintf(stdout, fmt, args);
+    vsnprintf(cell->message, sizeof(cell->message), fmt, args);
     va_end(args);
-    printf("\033[0m\n");
-}
\ No newline at end of file
+
+    cell->sequence.store(position + 1, std::memory_order_release);
+
+    // 警告与错误尽快输出，其余由后台线程定时取出
+    if (level >= LogLevel_Warn)
+    {
+        logger->wake.notify_one();
+    }
+}
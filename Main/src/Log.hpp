@@ -1,11 +1,119 @@
-#pragma once
+﻿#pragma once
+
+#include <atomic>
+
+/**
+* 日志
+*
+* Debug / Info / Warn / Error 只在调用线程上格式化，然后放入无锁的多生产者环形缓冲，
+* 由后台线程写到 sink（默认为带颜色的 stdout），因此渲染线程不会等待输出。
+* 缓冲满时丢弃新消息并在之后报告丢弃条数，单条消息超过 LogRecord::MaxMessageLength 时截断。
+*
+* 每个调用点单独限速，每秒超出 LogSetRateLimit 条数的消息被丢弃，并在该调用点下一条消息中注明。
+* 低于编译期阈值 LIVE2D_LOG_LEVEL 的级别展开为空语句，参数不会被求值。
+*/
+
+enum LogLevel
+{
+    LogLevel_Debug = 10,    ///< 与 Python logging 的数值相同
+    LogLevel_Info = 20,
+    LogLevel_Warn = 30,
+    LogLevel_Error = 40,
+};
+
+#ifndef LIVE2D_LOG_LEVEL
+#define LIVE2D_LOG_LEVEL 10
+#endif
 
 extern bool live2dLogEnable;
 
-void Debug(const char *fmt, ...);
+/**
+* @brief 调用点的限速状态，由日志宏以静态变量的形式定义
+*/
+struct LogSite
+{
+    const char* file;
+    int line;
+    std::atomic<long long> windowStart;     ///< 当前一秒窗口的起点，毫秒
+    std::atomic<unsigned int> count;        ///< 窗口内已放行的条数
+    std::atomic<unsigned int> suppressed;   ///< 上次放行后被限速丢弃的条数
+};
+
+struct LogRecord
+{
+    enum
+    {
+        MaxMessageLength = 255,
+    };
+
+    LogLevel level;
+    const char* file;
+    int line;
+    unsigned int suppressed;    ///< 本条之前该调用点被限速丢弃的条数
+    const char* message;
+};
+
+/**
+* @brief 在后台线程上调用，同一时刻只有一个调用在执行
+*/
+typedef void (*LogSink)(void* userData, const LogRecord* record);
+
+/**
+* @brief 设置日志输出，NULL 恢复为 stdout
+*
+* 返回时正在执行的旧 sink 调用已经结束，之后不会再以旧的 userData 调用。
+* 在 sink 中调用时立即替换，当前这次调用之后的消息交给新的 sink。
+*/
+void LogSetSink(LogSink sink, void* userData);
+
+/**
+* @brief 运行期的最低级别，默认 LogLevel_Debug；Debug 与 Info 另外受 live2dLogEnable 控制
+*/
+void LogSetLevel(LogLevel level);
+
+LogLevel LogGetLevel();
+
+/**
+* @brief 每个调用点每秒最多输出的条数，0 表示不限，默认 20
+*/
+void LogSetRateLimit(int perSecond);
+
+/**
+* @brief 把缓冲中已有的消息全部交给 sink 后返回
+*
+* 在 sink 中调用时直接返回，剩余的消息由正在进行的这次取出继续交给 sink。
+*/
+void LogFlush();
+
+void LogWrite(LogSite* site, LogLevel level, const char* fmt, ...);
+
+#define LIVE2D_LOG(level, ...)                                              \
+    do                                                                      \
+    {                                                                       \
+        static LogSite live2dLogSite = {__FILE__, __LINE__, {0}, {0}, {0}}; \
+        LogWrite(&live2dLogSite, level, __VA_ARGS__);                       \
+    } while (0)
+
+#if LIVE2D_LOG_LEVEL <= 10
+#define Debug(...) LIVE2D_LOG(LogLevel_Debug, __VA_ARGS__)
+#else
+#define Debug(...) ((void)0)
+#endif
 
-void Info(const char *fmt, ...);
+#if LIVE2D_LOG_LEVEL <= 20
+#define Info(...) LIVE2D_LOG(LogLevel_Info, __VA_ARGS__)
+#else
+#define Info(...) ((void)0)
+#endif
 
-void Warn(const char *fmt, ...);
+#if LIVE2D_LOG_LEVEL <= 30
+#define Warn(...) LIVE2D_LOG(LogLevel_Warn, __VA_ARGS__)
+#else
+#define Warn(...) ((void)0)
+#endif
 
-void Error(const char *fmt, ...);
+#if LIVE2D_LOG_LEVEL <= 40
+#define Error(...) LIVE2D_LOG(LogLevel_Error, __VA_ARGS__)
+#else
+#define Error(...) ((void)0)
+#endif
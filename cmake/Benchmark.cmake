@@ -0,0 +1,6 @@
+# 无窗口的性能基准，需要 EGL（Linux），默认不构建
+option(LIVE2D_BUILD_BENCHMARK "Build the headless benchmark executable" OFF)
+
+if(LIVE2D_BUILD_BENCHMARK)
+  add_subdirectory(Benchmark)
+endif()
@@ -6,6 +6,10 @@ set_property(TARGET Main PROPERTY CXX_STANDARD_REQUIRED ON)
 
 target_include_directories(Main PUBLIC src)
 
+# 低于该级别的日志调用在编译期移除：10 Debug，20 Info，30 Warn，40 Error
+set(LIVE2D_LOG_LEVEL 10 CACHE STRING "Minimum log level compiled into the library")
+target_compile_definitions(Main PUBLIC LIVE2D_LOG_LEVEL=${LIVE2D_LOG_LEVEL})
+
 find_package(OpenGL REQUIRED)
 
 if(APPLE)
@@ -24,6 +28,7 @@ endif()
 target_link_libraries(Main
   Framework
   ${OPENGL_LIBRARIES}
+  ${CMAKE_DL_LIBS}
 )
 
 if(APPLE)
@@ -0,0 +1,41 @@
+# test_*.py 共用的模型工厂与参数读取，须在 live2d.init() 与 GL 上下文创建之后调用
+
+import os
+
+import live2d.v3 as live2d
+
+import resources
+
+
+def model_path(name):
+    return os.path.join(resources.RESOURCES_DIRECTORY, "v3/%s/%s.model3.json" % (name, name))
+
+
+def create_model(name="Haru", seed=None, size=200, autoBlink=True, autoBreath=True):
+    model = live2d.LAppModel()
+    if seed is not None:
+        model.SetRandomSeed(seed)
+    model.LoadModelJson(model_path(name))
+    model.Resize(size, size)
+    if not autoBlink:
+        model.SetAutoBlinkEnable(False)
+    if not autoBreath:
+        model.SetAutoBreathEnable(False)
+    return model
+
+
+def create_models(count, name="Haru", seed=None, **kwargs):
+    """seed 不为 None 时第 i 个模型的随机种子为 seed + i"""
+    return [create_model(name, None if seed is None else seed + i, **kwargs) for i in range(count)]
+
+
+def parameters(model):
+    return [model.GetParameterValue(i) for i in range(model.GetParameterCount())]
+
+
+def index_of(model, paramId):
+    return [model.GetParameter(i).id for i in range(model.GetParameterCount())].index(paramId)
+
+
+def parameter(model, paramId):
+    return model.GetParameterValue(index_of(model, paramId))
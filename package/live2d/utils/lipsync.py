@@ -4,6 +4,13 @@ import time
 
 
 class WavHandler:
+    """
+    按时钟读取 wav 并计算响度，v2 与 v3 通用
+
+    v3 模型可以改用 `LAppModel.StartLipSyncWav` 或 `OpenLipSyncStream`/`FeedLipSync`，
+    在 C++ 中按模型时间分析并直接驱动口型参数，不需要每帧调用 `Update`
+    """
+
     def __init__(self):
         # 每个通道的采样帧数
         self.numFrames: int = 0
@@ -3,9 +3,10 @@ from typing import TYPE_CHECKING, Union
 
 from .DEF import LIVE2D_FORMAT_VERSION_AVAILABLE, LIVE2D_FORMAT_VERSION_V2_8_TEX_OPTION
 from .id import Id
-from .io import BinaryReader
+from .io import BinaryReader, NativeBinaryReader
 from .model import ModelImpl
 from .model_context import ModelContext
+from .util import UtNative
 
 if TYPE_CHECKING:
     from .draw import MeshContext, IDrawData, Mesh
@@ -143,6 +144,19 @@ class ALive2DModel(ABC):
         if not (isinstance(buf, bytes)):
             raise RuntimeError("param error")
 
+        if UtNative.available:
+            # the native decoder checks the header and the EOF marker itself
+            aL = NativeBinaryReader(buf, UtNative.decodeMoc(buf)).readObject()
+        else:
+            aL = ALive2DModel.readModelImpl(buf)
+
+        model.setModelImpl(aL)
+        model_context = model.getModelContext()
+        model_context.setDrawParam(model.getDrawParam())
+        model_context.init()
+
+    @staticmethod
+    def readModelImpl(buf: bytes):
         br = BinaryReader(buf)
         magic1 = br.readByte()
         magic2 = br.readByte()
@@ -164,8 +178,4 @@ class ALive2DModel(ABC):
             aT = br.readUShort()
             if aH != -30584 or aT != -30584:
                 raise RuntimeError("Invalid load EOF")
-
-        model.setModelImpl(aL)
-        model_context = model.getModelContext()
-        model_context.setDrawParam(model.getDrawParam())
-        model_context.init()
+        return aL
@@ -6,7 +6,7 @@ from .rotation_context import RotationContext
 from ..DEF import LIVE2D_FORMAT_VERSION_V2_10_SDK2
 from ..param import PivotManager
 from ..type import Float32Array, Array
-from ..util import UtMath
+from ..util import UtMath, UtNative
 
 if TYPE_CHECKING:
     from .deformer_context import DeformerContext
@@ -335,6 +335,10 @@ class RotationDeformer(Deformer):
         aZ = aP * a3 * aV
         aY = aU.originX
         aX = aU.originY
+        if UtNative.available and numPoint >= UtNative.MIN_TRANSFORM_POINTS:
+            UtNative.transformAffinePoints(srcPoints, dstPoints, numPoint, ptOffset, ptStep, aS, aQ, a1, aZ, aY, aX)
+            return
+
         aI = numPoint * ptStep
         for aK in range(ptOffset, aI, ptStep):
             aN = srcPoints[aK]
@@ -3,7 +3,7 @@ from .warp_context import WarpContext
 from ..live2d import Live2D
 from ..param import PivotManager
 from ..type import Float32Array
-from ..util import UtInterpolate
+from ..util import UtInterpolate, UtNative
 
 
 class WarpDeformer(Deformer):
@@ -15,6 +15,7 @@ class WarpDeformer(Deformer):
         self.col = 0
         self.pivotMgr = None
         self.pivotPoints = None
+        self.packedPivotPoints = None
 
     def read(self, br):
         super().read(br)
@@ -22,6 +23,7 @@ class WarpDeformer(Deformer):
         self.row = br.readInt32()
         self.pivotMgr = br.readObject()
         self.pivotPoints = br.readObject()
+        self.packedPivotPoints = UtNative.packPoints(self.pivotPoints)
         super().readOpacity(br)
 
     def init(self, mc):
@@ -50,7 +52,7 @@ class WarpDeformer(Deformer):
         aH = WarpDeformer.gT_
         aH[0] = False
         UtInterpolate.interpolatePoints(modelContext, self.pivotMgr, aH, aL, self.pivotPoints, aK.interpolatedPoints, 0,
-                                        2)
+                                        2, self.packedPivotPoints)
         deformerContext.setOutsideParam(aH[0])
         self.interpolateOpacity(modelContext, self.pivotMgr, deformerContext, aH)
 
@@ -94,6 +96,10 @@ class WarpDeformer(Deformer):
 
     @staticmethod
     def transformPoints_sdk2(hvs, dst, pointCount, srcOffset, srcStep, grid, row, col):
+        if UtNative.available and pointCount >= UtNative.MIN_TRANSFORM_POINTS:
+            UtNative.transformWarpPoints(hvs, dst, pointCount, srcOffset, srcStep, grid, row, col)
+            return
+
         aW = pointCount * srcStep
         aT = 0
         aS = 0
@@ -7,7 +7,7 @@ from ..DEF import LIVE2D_FORMAT_VERSION_V2_8_TEX_OPTION, VERTEX_STEP, VERTEX_TYP
 from ..live2d import Live2D
 from ..param import PivotManager
 from ..type import Int16Array, Float32Array
-from ..util import UtInterpolate
+from ..util import UtInterpolate, UtNative
 
 if TYPE_CHECKING:
     from ..model_context import ModelContext
@@ -29,6 +29,7 @@ class Mesh(IDrawData):
         self.optionFlag = None
         self.indexArray = None
         self.pivotPoints = None
+        self.packedPivotPoints = None
         self.uvs = None
         self.colorCompositionType = Mesh.COLOR_COMPOSITION_NORMAL
         self.culling = True
@@ -64,6 +65,7 @@ class Mesh(IDrawData):
             self.indexArray[aJ] = obj[aJ]
 
         self.pivotPoints = br.readObject()
+        self.packedPivotPoints = UtNative.packPoints(self.pivotPoints)
         self.uvs = br.readObject()
         if br.getFormatVersion() >= LIVE2D_FORMAT_VERSION_V2_8_TEX_OPTION:
             self.optionFlag = br.readInt32()
@@ -132,7 +134,7 @@ class Mesh(IDrawData):
         aI = Mesh.paramOutside
         aI[0] = False
         UtInterpolate.interpolatePoints(aJ, self.pivotMgr, aI, self.pointCount, self.pivotPoints, aK.interpolatedPoints,
-                                        VERTEX_OFFSET, VERTEX_STEP)
+                                        VERTEX_OFFSET, VERTEX_STEP, self.packedPivotPoints)
 
     def setupTransform(self, mc, dc=None):
         if not (self == dc.getDrawData()):
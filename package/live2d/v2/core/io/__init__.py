@@ -1,2 +1,3 @@
 ﻿from .binary_reader import BinaryReader
 from .iserializable import ISerializable
+from .native_binary_reader import NativeBinaryReader
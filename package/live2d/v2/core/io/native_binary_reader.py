@@ -0,0 +1,107 @@
+﻿from typing import List, Any
+
+from .live2d_object_factory import Live2DObjectFactory
+from ..id import Id
+
+# token kinds, must match LAppV2MocReader::TokenKind
+TOKEN_NULL = 0
+TOKEN_REF = 1
+TOKEN_OBJECT = 2
+TOKEN_ID = 3
+TOKEN_STRING = 4
+TOKEN_ARRAY = 5
+TOKEN_INT32_ARRAY = 6
+TOKEN_FLOAT32_ARRAY = 7
+TOKEN_FLOAT64_ARRAY = 8
+TOKEN_INT32 = 9
+TOKEN_FLOAT32 = 10
+TOKEN_BIT = 11
+TOKEN_BOOLEAN = 12
+
+
+class NativeBinaryReader:
+    """
+    Replays a .moc file decoded by the native module.
+
+    The decoder walks the object graph in the same order as BinaryReader and the read() methods of the model
+    classes, recording every value as a (kind, a, b) token and the array contents in flat typed buffers, so
+    those read() methods work unchanged on either reader.
+    """
+
+    def __init__(self, buf: bytes, decoded):
+        formatVersion, tokens, int32s, float32s, float64s = decoded
+        self.formatVersion = formatVersion
+        self.objects: List[Any] = []
+        self.buf = buf
+        self.tokens = memoryview(tokens).cast('i').tolist()
+        self.int32s = memoryview(int32s).cast('i').tolist()
+        self.float32s = memoryview(float32s).cast('f').tolist()
+        self.float64s = memoryview(float64s).cast('d').tolist()
+        self.position = 0
+
+    def getFormatVersion(self):
+        return self.formatVersion
+
+    def setFormatVersion(self, aH):
+        self.formatVersion = aH
+
+    def nextToken(self, kind):
+        p = self.position
+        if self.tokens[p] != kind:
+            raise RuntimeError("moc token mismatch: expected %d, got %d" % (kind, self.tokens[p]))
+        self.position = p + 3
+        return self.tokens[p + 1], self.tokens[p + 2]
+
+    def readInt32(self):
+        return self.nextToken(TOKEN_INT32)[0]
+
+    def readFloat32(self):
+        return self.float32s[self.nextToken(TOKEN_FLOAT32)[0]]
+
+    def readBit(self):
+        return self.nextToken(TOKEN_BIT)[0] == 1
+
+    def readBoolean(self):
+        return self.nextToken(TOKEN_BOOLEAN)[0] == 1
+
+    def readInt32Array(self):
+        offset, length = self.nextToken(TOKEN_INT32_ARRAY)
+        return self.int32s[offset:offset + length]
+
+    def readFloat32Array(self):
+        offset, length = self.nextToken(TOKEN_FLOAT32_ARRAY)
+        return self.float32s[offset:offset + length]
+
+    def readFloat64Array(self):
+        offset, length = self.nextToken(TOKEN_FLOAT64_ARRAY)
+        return self.float64s[offset:offset + length]
+
+    def readObject(self):
+        p = self.position
+        kind, a, b = self.tokens[p], self.tokens[p + 1], self.tokens[p + 2]
+        self.position = p + 3
+        if kind == TOKEN_REF:
+            return self.objects[a]
+
+        if kind == TOKEN_OBJECT:
+            obj = Live2DObjectFactory.create(a)
+            obj.read(self)
+        elif kind == TOKEN_ID:
+            obj = Id.getID(self.buf[a:a + b].decode("utf-8"))
+        elif kind == TOKEN_ARRAY:
+            obj = [self.readObject() for _ in range(a)]
+        elif kind == TOKEN_FLOAT32_ARRAY:
+            obj = self.float32s[a:a + b]
+        elif kind == TOKEN_INT32_ARRAY:
+            obj = self.int32s[a:a + b]
+        elif kind == TOKEN_FLOAT64_ARRAY:
+            obj = self.float64s[a:a + b]
+        elif kind == TOKEN_STRING:
+            obj = self.buf[a:a + b].decode("utf-8")
+        elif kind == TOKEN_NULL:
+            obj = None
+        else:
+            raise RuntimeError("moc token mismatch: expected an object, got %d" % kind)
+
+        self.objects.append(obj)
+        return obj
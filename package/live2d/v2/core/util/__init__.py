@@ -1,7 +1,8 @@
 ﻿from .log import __ut_log as log
 from .ut_interpolate import UtInterpolate
 from .ut_math import UtMath
+from .ut_native import UtNative
 from .ut_string import UtString
 from .ut_system import UtSystem
 
-__all__ = ['UtMath', 'UtString', 'UtInterpolate', 'UtSystem', 'log']
+__all__ = ['UtMath', 'UtNative', 'UtString', 'UtInterpolate', 'UtSystem', 'log']
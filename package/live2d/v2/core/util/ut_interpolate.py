@@ -1,6 +1,7 @@
 ﻿from typing import List
 from typing import TYPE_CHECKING
 
+from .ut_native import UtNative
 from .ut_system import UtSystem
 from ..type import Float32Array
 
@@ -201,11 +202,15 @@ class UtInterpolate:
             return bc
 
     @staticmethod
-    def interpolatePoints(mdc: 'ModelContext', pivotMgr: 'PivotManager', retParamOut: List[bool], numPts: int, pivotPoints: List[float], dstPoints, ptOffset, ptStep):
+    def interpolatePoints(mdc: 'ModelContext', pivotMgr: 'PivotManager', retParamOut: List[bool], numPts: int, pivotPoints: List[float], dstPoints, ptOffset, ptStep, packedPivotPoints=None):
         aN = pivotMgr.calcPivotValues(mdc, retParamOut)
         bw = mdc.getTempPivotTableIndices()
         a2 = mdc.getTempT()
         pivotMgr.calcPivotIndices(bw, a2, aN)
+        if packedPivotPoints is not None:
+            UtNative.interpolatePoints(packedPivotPoints, bw, a2, aN, numPts, dstPoints, ptOffset, ptStep)
+            return
+
         aJ = numPts * 2
         aQ = ptOffset
         if aN <= 0:
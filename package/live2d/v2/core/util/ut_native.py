@@ -0,0 +1,65 @@
+﻿import os
+
+
+class UtNative:
+    """
+    Native kernels for the per-point loops and the .moc decoder of the v2 runtime, provided by the
+    compiled v3 module.
+
+    They compute in double precision in the same order as the Python code, so the results are
+    identical; set LIVE2D_V2_NATIVE=0 to fall back to the Python implementation.
+    """
+    # below this many points the call overhead outweighs the loop
+    MIN_TRANSFORM_POINTS = 8
+
+    available = False
+    _native = None
+
+    @staticmethod
+    def load():
+        if os.environ.get("LIVE2D_V2_NATIVE", "1") == "0":
+            return
+
+        try:
+            from ....v3 import live2d as native
+        except ImportError:
+            return
+
+        if hasattr(native, "_v2InterpolatePoints") and hasattr(native, "_v2DecodeMoc"):
+            UtNative._native = native
+            UtNative.available = True
+
+    @staticmethod
+    def packPoints(pivotPoints):
+        """
+        Packs the pivot point arrays of a mesh or warp deformer for `interpolatePoints`.
+
+        :return: an opaque handle, or None when the native module is unavailable
+        """
+        if not UtNative.available or not pivotPoints:
+            return None
+        return UtNative._native._v2PackPoints(pivotPoints)
+
+    @staticmethod
+    def decodeMoc(buf):
+        """
+        Decodes a whole .moc file into tokens and flat typed arrays for NativeBinaryReader.
+        """
+        return UtNative._native._v2DecodeMoc(buf)
+
+    @staticmethod
+    def interpolatePoints(packedPivotPoints, indices, t, dimension, numPts, dstPoints, ptOffset, ptStep):
+        UtNative._native._v2InterpolatePoints(packedPivotPoints, indices, t, max(dimension, 0), numPts, dstPoints,
+                                              ptOffset, ptStep)
+
+    @staticmethod
+    def transformWarpPoints(srcPoints, dstPoints, pointCount, srcOffset, srcStep, grid, row, col):
+        UtNative._native._v2TransformWarpPoints(srcPoints, dstPoints, pointCount, srcOffset, srcStep, grid, row, col)
+
+    @staticmethod
+    def transformAffinePoints(srcPoints, dstPoints, pointCount, ptOffset, ptStep, m00, m01, m10, m11, tx, ty):
+        UtNative._native._v2TransformAffinePoints(srcPoints, dstPoints, pointCount, ptOffset, ptStep,
+                                                  m00, m01, m10, m11, tx, ty)
+
+
+UtNative.load()
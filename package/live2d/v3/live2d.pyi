@@ -1,10 +1,16 @@
-from typing import Any
+from typing import Any, Callable, Iterable, Sequence
 from .params import Parameter
 
 
-def init() -> None:
+def init(allocator: str = "default") -> None:
     """
     initialize inner memory allocator for live2d models
+
+    :param allocator: memory allocator used by the Cubism Framework, only takes effect before the first `init()`
+        - "default": malloc/free
+        - "pool": thread-local size-class pool for the many small allocations (<= 256 bytes)
+        - "arena": each model loads into its own arena, which is released in bulk when the model is destroyed
+        - "tracking": malloc/free, and counts live bytes, peak bytes and allocations per call site, see `getAllocatorStats()`
     """
     ...
 
@@ -47,6 +53,204 @@ def logEnable() -> bool:
     ...
 
 
+def setLogSink(sink: Callable[[int, str, str, int], None] | None) -> None:
+    """
+    route native log messages to `sink(level, message, file, line)` instead of stdout; None restores stdout
+
+    Messages are queued by the calling thread and delivered on a background thread (holding the GIL),
+    so `sink` runs asynchronously and may be called from any thread. `level` uses the numeric
+    values of the `logging` module (DEBUG=10, INFO=20, WARNING=30, ERROR=40), e.g.
+    `setLogSink(lambda level, message, file, line: logger.log(level, message))`.
+    Called from inside the sink, the replacement takes effect from the next message.
+    """
+    ...
+
+
+def setLogLevel(level: int) -> None:
+    """
+    drop messages below `level` (`logging` numeric levels); Debug and Info also require `setLogEnable(True)`
+
+    Levels below the build option `LIVE2D_LOG_LEVEL` are compiled out and never emitted.
+    """
+    ...
+
+
+def getLogLevel() -> int:
+    ...
+
+
+def setLogRateLimit(perSecond: int) -> None:
+    """
+    maximum messages per second from each call site, 0 for no limit, defaults to 20;
+    the next message from a throttled call site reports how many were suppressed
+    """
+    ...
+
+
+def flushLog() -> None:
+    """
+    deliver all queued log messages to the sink before returning; called from inside the sink it returns at once,
+    the delivery already in progress goes on with the remaining messages
+    """
+    ...
+
+
+def getAllocatorStats() -> dict:
+    """
+    allocation statistics, only accumulated with `init(allocator="tracking")`
+
+    :return: {
+        "allocator": str,
+        "liveBytes": int,
+        "peakBytes": int,
+        "allocations": int,
+        "deallocations": int,
+        "sites": [(file, line, allocations, liveCount, liveBytes), ...]  # sorted by liveBytes
+    }
+    call sites are only recorded when the framework is built with `CSM_DEBUG_MEMORY_LEAKING`,
+    otherwise all allocations are reported under a single ("", 0) site
+    """
+    ...
+
+
+def setAssetCacheEnable(enable: bool) -> None:
+    """
+    share moc, motion curves, expressions, physics templates and textures between models
+    loading the same files (matched by path and content), enabled by default
+
+    each model still owns its parameters, physics state and motion playback state;
+    disabling only affects models loaded afterwards
+    """
+    ...
+
+
+def getAssetCacheStats() -> dict:
+    """
+    :return: {
+        "mocs": int,
+        "motions": int,
+        "expressions": int,
+        "physics": int,
+        "textures": int,
+        "hits": int,
+        "misses": int
+    }
+    entry counts of assets currently shared, hits and misses are counted since start
+    """
+    ...
+
+
+def updateAll(models: Iterable[LAppModel], dt: float | None = None) -> None:
+    """
+    update many models at once, equivalent to calling `Update(dt)` on each of them,
+    but the work is spread over a persistent worker pool with the GIL released
+
+    vertex updates are done here too, so the following `Draw()` skips them unless
+    parameters are changed in between; motion start/finish callbacks run on the
+    calling thread after the whole batch, in the order of `models`
+
+    :param models: models to update, each one at most once
+    :param dt: time step in seconds, same as `LAppModel.Update`
+    """
+    ...
+
+
+def setUpdateThreadCount(count: int) -> None:
+    """
+    number of threads used by `updateAll`, including the calling thread;
+    defaults to the number of hardware threads, 1 updates the models one by one
+    """
+    ...
+
+
+def getUpdateThreadCount() -> int:
+    ...
+
+
+class ArrayView:
+    """
+    Buffer-protocol object aliasing one of the model's arrays in Cubism Core memory,
+    e.g. `numpy.asarray(view)` or `memoryview(view)` without copying (Python 3.11+ builds).
+
+    Each export waits for the model's pipeline step, so re-export with `numpy.asarray` per frame
+    in pipeline mode. While any export is alive the model cannot be reloaded (`BufferError`),
+    the same rule `bytearray` uses for resizing.
+    """
+    ...
+
+
+class ParameterPlan:
+    """
+    A group of parameters bound by `LAppModel.BindParameters`; ids are resolved once, and each
+    `set` / `add` writes the whole group in one call. Values may be a list, tuple, `array.array`,
+    or any float32 / float64 buffer (numpy arrays are read without copying on Python 3.11+ builds).
+
+    Results are identical to calling `SetParameterValue` / `AddParameterValue` per id, clamping included.
+    Ids missing from the model are skipped; after `LoadModelJson` the ids are resolved again.
+    In pipeline mode writes are queued for the next step like the per-id setters.
+    """
+
+    def __len__(self) -> int:
+        ...
+
+    def set(self, values: Sequence[float] | Any, weights: float | Sequence[float] | Any = 1.0) -> None:
+        """
+        :param values: one value per bound id
+        :param weights: a single weight for all parameters, or one weight per bound id
+        """
+        ...
+
+    def add(self, values: Sequence[float] | Any, weight: float = 1.0) -> None:
+        """
+        Adds `values * weight` to the current values.
+        """
+        ...
+
+
+class Crowd:
+    """
+    Draws many instances of one model together. Each instance stays a normal `LAppModel`
+    (parameters, motions, `SetOffset` / `SetScale` / `Resize` as usual); only drawing goes through the crowd.
+
+    UVs, indices and textures are shared; every frame the vertex positions of all instances go into one buffer
+    and each drawable is drawn once for all instances, with masks packed into one shared atlas.
+    The number of draw calls depends on the model only, not on the number of instances.
+
+    Differences from calling `Draw` on each model:
+        - the render order of the first instance is used for all instances
+        - overlapping instances interleave drawable by drawable instead of one model over another
+        - masks always use the atlas (no high precision masking)
+
+    Requires OpenGL 3.1; otherwise, or when the positions exceed the texture buffer limit,
+    the instances are drawn one by one with `LAppModel.Draw`. Models keep working with their own `Draw`
+    after leaving the crowd, their mask buffers are recreated on demand.
+    """
+
+    def __init__(self, models: Iterable[LAppModel]) -> None:
+        """
+        :param models: loaded from the same model file; raises `ValueError` otherwise.
+            Reloading a member with `LoadModelJson` is picked up on the next `Draw`.
+        """
+        ...
+
+    def Draw(self) -> None:
+        ...
+
+    def GetDrawStats(self) -> dict[str, int | bool]:
+        """
+        Counts of the last `Draw`: {"instances", "drawCalls", "maskDrawCalls", "instanced"};
+        `drawCalls` includes the mask draws, `instanced` is False when the instances were drawn one by one.
+        """
+        ...
+
+    def SetMaskAtlasSize(self, size: int) -> None:
+        """
+        Side length in pixels of the shared mask atlas, 2048 by default. Each (mask, instance) pair gets one
+        channel of one cell, so more instances mean lower mask resolution.
+        """
+        ...
+
+
 class LAppModel:
     """
     The LAppModel class provides a structured way to interact with Live2D models, 
@@ -57,11 +261,13 @@ class LAppModel:
     def __init__(self):
         ...
 
-    def LoadModelJson(self, fileName: str | Any) -> None:
+    def LoadModelJson(self, fileName: str | Any, preloadMotions: bool = True) -> None:
         """
         Load Live2D model assets.
         
         :param fileName: Name of the model's JSON configuration file.
+        :param preloadMotions: If False, motions are not read here; they are loaded by `PrefetchMotion`, or
+            synchronously by the first `StartMotion` that uses them.
         """
         ...
 
@@ -81,7 +287,7 @@ class LAppModel:
         ...
 
     def StartMotion(self, group: str | Any, no: int | Any, priority: int | Any, onStartMotionHandler=None,
-                    onFinishMotionHandler=None) -> None:
+                    onFinishMotionHandler=None) -> int:
         """
         Start a specific motion for the model.
         
@@ -90,17 +296,124 @@ class LAppModel:
         :param priority: Priority of the motion. Higher priority motions can interrupt lower priority ones.
         :param onStartMotionHandler: Optional callback function that gets called when the motion starts.
         :param onFinishMotionHandler: Optional callback function that gets called when the motion finishes.
+        :return: handle of the started motion, to be passed to `IsMotionFinished`; -1 if the motion was not started,
+            or if it is still being loaded by `PrefetchMotion` (it then starts in a later `Update`, and the callbacks
+            fire as usual; if another motion is started or the model is reloaded first, both callbacks fire at once).
         """
         ...
 
     def StartRandomMotion(self, group: str | Any = None, priority: int | Any = 3, onStartMotionHandler=None,
-                          onFinishMotionHandler=None) -> None:
+                          onFinishMotionHandler=None) -> int:
         """
         Start a random motion from a specified group.
         
         :param group: The group name of the motion.
         :param priority: Priority of the motion. Higher priority motions can interrupt lower priority ones.
         :param onFinishedMotionHandler: Optional callback function that gets called when the motion finishes.
+        :return: handle of the started motion, to be passed to `IsMotionFinished`; -1 if the motion was not started.
+        """
+        ...
+
+    def PrefetchMotion(self, group: str, no: int) -> None:
+        """
+        在后台线程加载动作，之后的 `StartMotion` 不再读取和解析文件
+
+        已加载或正在加载的动作不会重复提交。加载完成后在下一次 `Update` 中生效。
+
+        :param group: 动作组名
+        :param no: 动作在组内的序号
+        """
+        ...
+
+    def PrefetchGroup(self, group: str) -> None:
+        """
+        对动作组中的每个动作调用 `PrefetchMotion`
+
+        :param group: 动作组名
+        """
+        ...
+
+    def SetMotionBakeRate(self, group: str, rate: float) -> None:
+        """
+        设置动作组的烘焙采样率，覆盖 model3.json 中各动作的 "BakeRate"
+
+        烘焙时所有曲线按固定采样率采样为 16 位量化表，播放时以查表加线性插值代替逐帧求解贝塞尔曲线，
+        适合大量模型持续播放的循环待机动作。含阶梯段的曲线不烘焙。
+        误差为量化步长（曲线值域 / 65535）加上曲线在一个采样间隔内偏离直线的程度，
+        例如 Haru 的动作在 120 Hz 下最大偏差为参数值域的 1e-4 到 1e-3。
+        烘焙后的动作在所有使用相同采样率的模型间共享。
+
+        只影响之后加载的动作，预加载动作时须在 `LoadModelJson` 之前调用。
+
+        :param group: 动作组名
+        :param rate: 每秒采样数，0 表示不烘焙
+        """
+        ...
+
+    def GetMotionBakeError(self, group: str, no: int) -> float:
+        """
+        已加载动作烘焙时测得的最大偏差（每个采样间隔测量四个点）
+
+        :param group: 动作组名
+        :param no: 动作在组中的序号
+        :return: 未烘焙时为 0，动作尚未加载时为 -1
+        """
+        ...
+
+    def AddMotionLayer(self, name: str, additive: bool = False, weight: float = 1.0) -> None:
+        """
+        添加动作层，同名的层已存在时更新其混合方式和权重
+
+        动作层在 `StartMotion` 播放的主动作之后按添加顺序求值，可同时运行待机、手势、说话、视线等动作：
+        覆盖层把蒙版内的参数按权重从下层结果过渡到本层结果；
+        叠加层的动作以参数默认值为基准，把 (本层结果 - 默认值) * 权重 加到下层结果上。
+
+        :param name: 层名
+        :param additive: True 为叠加层，False 为覆盖层
+        :param weight: 0 到 1 之间的权重
+        """
+        ...
+
+    def RemoveMotionLayer(self, name: str) -> None:
+        """
+        移除动作层并结束其中的动作
+        """
+        ...
+
+    def SetMotionLayerWeight(self, name: str, weight: float) -> None:
+        """
+        设置动作层的权重，层不存在时抛出 KeyError
+        """
+        ...
+
+    def SetMotionLayerMask(self, name: str, paramIds: list[str] | None = None) -> None:
+        """
+        设置受动作层影响的参数，蒙版外的参数保持下层结果
+
+        :param paramIds: 参数 id 列表，None 或空列表表示全部参数；模型中不存在的 id 被忽略
+        """
+        ...
+
+    def StartLayerMotion(self, layer: str, group: str, no: int, onStartMotionHandler=None,
+                         onFinishMotionHandler=None) -> int:
+        """
+        在指定的动作层上开始动作，该层正在播放的动作淡出
+
+        :return: 动作句柄，只能用于同一层的 `IsLayerMotionFinished`；层或动作不存在时返回 -1
+        """
+        ...
+
+    def IsLayerMotionFinished(self, layer: str, handle: int = -1) -> bool:
+        """
+        动作层上的动作是否已经结束
+
+        :param handle: `StartLayerMotion` 返回的句柄，为 -1 时判断该层的全部动作
+        """
+        ...
+
+    def StopLayerMotions(self, layer: str) -> None:
+        """
+        结束动作层上的全部动作，层本身保留
         """
         ...
 
@@ -142,9 +455,11 @@ class LAppModel:
         """
         ...
 
-    def IsMotionFinished(self) -> bool:
+    def IsMotionFinished(self, handle: int | None = None) -> bool:
         """
         当前正在播放的动作是否已经结束
+        :param handle: StartMotion / StartRandomMotion 返回的句柄，指定时只判断该动作；
+                       动作结束后句柄失效，即使之后开始了新的动作也返回 True
         :return:
         """
         ...
@@ -193,9 +508,294 @@ class LAppModel:
     def AddIndexParamValue(self, index: int, value: float) -> None:
         ...
 
-    def Update(self) -> None:
+    def Update(self, dt: float | None = None) -> None:
         """
         初始化呼吸、动作、姿势、表情、各部分透明度等必要的参数值
+
+        :param dt: 时间间隔（秒）。省略时取自墙上时钟，上限 0.1 秒；
+            给定时不读取时钟，配合 `SetRandomSeed` 可逐帧复现，用于离线渲染
+        """
+        ...
+
+    def Tick(self, steps: int, dt: float) -> None:
+        """
+        连续执行 steps 次 `Update(dt)`，例如以 1/60 秒的步长快于实时地生成片段
+
+        :param steps: 步数
+        :param dt: 每步的时间间隔（秒）
+        """
+        ...
+
+    def SetRandomSeed(self, seed: int) -> None:
+        """
+        设置 `StartRandomMotion`、`SetRandomExpression` 与自动眨眼使用的随机数种子
+
+        每个模型持有自己的随机数发生器，相同的种子与相同的 `Update(dt)` 序列得到相同的参数值。
+
+        :param seed: 32 位无符号整数
+        """
+        ...
+
+    def SetPipelineEnable(self, enable: bool) -> None:
+        """
+        开关流水线模式，默认关闭
+
+        开启后 `Update` 等待上一步完成并发布其绘制快照，随即在该模型的模拟线程上开始下一步
+        （含顶点计算），`Draw` 绘制已发布的快照，模拟与绘制同时进行，代价是画面比输入晚一帧。
+
+        `SetParameterValue`、`AddParameterValue`、`SetPartOpacity` 等修改先记下，在下一步的动作与物理之后应用，
+        效果与普通模式下在 `Update` 与 `Draw` 之间修改相同。其余方法会先等待进行中的一步，
+        在 `Update` 与 `Draw` 之间频繁调用会抵消重叠；动作回调在这次等待之后执行。
+
+        :param enable: 是否开启
+        """
+        ...
+
+    def GetPipelineStats(self) -> dict:
+        """
+        :return: {
+            "steps": int,               # 已完成的步数
+            "stepMs": float,            # 模拟线程上每步的平均耗时
+            "waitMs": float,            # 调用线程平均等待模拟线程的时间，越接近 0 重叠越充分
+            "latencyMs": float,         # 从开始一步到其快照首次被绘制的平均时间
+            "stepsPerSecond": float     # 开启以来每秒完成的步数
+        }
+        未开启时全为 0
+        """
+        ...
+
+    def SetProfilerEnable(self, enable: bool, window: int = 240) -> None:
+        """
+        开启或关闭 `Update` / `Draw` 的分阶段计时，开启时清空已有的统计
+
+        关闭时每个阶段只多一次判断。
+        :param window: 计算百分位数所用的最近帧数
+        """
+        ...
+
+    def GetProfile(self) -> dict:
+        """
+        :return: {
+            "enabled": bool,
+            "window": int,
+            "stages": {name: summary},     # 毫秒；update、motion、eyeBlink、expression、parameterInput、drag、breath、
+                                           # physics、lipSync、pose、modelUpdate（csmUpdateModel）、masks（蒙版生成）、
+                                           # drawSubmit（含蒙版的绘制提交）、draw，本窗口内未执行过的阶段不出现
+            "counters": {name: summary}    # 每次 Draw 的 drawCalls、maskDrawCalls、masks、targetSwitches
+        }
+        summary 为 {"count": 开启以来的帧数, "mean", "p50", "p95", "p99", "max"}
+        """
+        ...
+
+    def ResetProfile(self) -> None:
+        """
+        清空分阶段计时的统计
+        """
+        ...
+
+    def StartProfileTrace(self, maxEvents: int = 1000000) -> None:
+        """
+        开始把每次计时记为 Chrome trace 事件，与 `SetProfilerEnable` 无关
+
+        :param maxEvents: 超过此数的事件被丢弃
+        """
+        ...
+
+    def SaveProfileTrace(self, path: str) -> int:
+        """
+        结束记录并写入 JSON 文件，可在 chrome://tracing 或 Perfetto 中打开
+
+        :return: 写入的事件数
+        """
+        ...
+
+    def OpenLipSyncStream(self, sampleRate: int, channels: int = 1, bufferSeconds: float = 0.5) -> None:
+        """
+        打开口型同步的 PCM 流，之后用 `FeedLipSync` 推入正在播放的音频
+
+        `Update` 按模型时间取出对应数量的样本，以其 RMS 驱动模型设置的 LipSync 参数
+        （未设置时为 ParamMouthOpenY）。缓冲区满时新样本被丢弃，口型落后于音频的时间不超过 bufferSeconds。
+
+        :param sampleRate: 采样率
+        :param channels: 声道数，推入的帧按声道取平均
+        :param bufferSeconds: 缓冲区能容纳的秒数
+        """
+        ...
+
+    def FeedLipSync(self, data: bytes | bytearray | memoryview, format: str = "int16") -> int:
+        """
+        推入交错排列的 PCM 帧，可以在音频回调等其他线程上调用，流水线模式下也不等待模拟线程
+
+        Python 3.11 起 bytes、bytearray、array 与连续的 numpy 数组等经缓冲区协议直接读取，不复制；
+        更早的版本以及不连续的缓冲区先复制一次
+
+        :param data: PCM 数据
+        :param format: "int16" 或 "float32"
+        :return: 写入的帧数，缓冲区已满或未打开流时小于推入的帧数
+        """
+        ...
+
+    def StartLipSyncWav(self, filePath: str) -> bool:
+        """
+        读入 wav 文件，从下一次 `Update` 起按模型时间分析，播放完后自动停止
+
+        支持 8/16/24/32 位整数与 32 位浮点 PCM，与 `WavHandler` 一样按峰值归一化。
+        与音频播放同时开始即可同步，不需要每帧调用 `WavHandler.Update`
+
+        :param filePath: wav 文件路径
+        :return: 文件无法读取或格式不支持时为 False
+        """
+        ...
+
+    def StopLipSync(self) -> None:
+        """
+        关闭口型同步的流或 wav
+        """
+        ...
+
+    def SetLipSyncGain(self, gain: float) -> None:
+        """
+        设置张嘴程度的增益，张嘴程度为 RMS 乘以增益并截断到 1，默认为 1
+
+        :param gain: 增益
+        """
+        ...
+
+    def SetLipSyncVowelEnable(self, enable: bool) -> None:
+        """
+        开关元音分析，默认关闭
+
+        开启后由一组带通滤波器的能量与 a/i/u/e/o 的共振峰模板比较，估计各元音的权重；
+        模型有 ParamA/I/U/E/O 时各参数得到张嘴程度乘以对应的权重
+
+        :param enable: 是否开启
+        """
+        ...
+
+    def GetLipSyncValue(self) -> float:
+        """
+        :return: 最近一次 `Update` 的张嘴程度，[0, 1]
+        """
+        ...
+
+    def GetLipSyncVowels(self) -> tuple[float, float, float, float, float]:
+        """
+        :return: a、i、u、e、o 的权重，持续有声时和趋近 1，无声或未开启元音分析时为 0
+        """
+        ...
+
+    def BindParameterChannel(self, ids: Iterable[str], weight: float = 1.0, capacity: int = 64) -> None:
+        """
+        绑定参数输入通道，供面部捕捉等外部驱动每帧写入一组参数
+
+        id 只在这里解析一次，之后 `PushParameterFrame` 只传数值。`Update` 在动作与表情之后、物理之前
+        以 weight 写入各参数，物理会随之运动。模型中不存在的 id 被忽略，空列表解除绑定，
+        重新加载模型后按 id 重新查找。
+
+        :param ids: 各槽位对应的参数 id
+        :param weight: 写入参数时的权重
+        :param capacity: 缓冲区能容纳的帧数
+        """
+        ...
+
+    def PushParameterFrame(self, values: list[float] | tuple[float, ...], timestamp: float | None = None) -> bool:
+        """
+        写入一帧，可以在捕捉线程上调用，流水线模式下也不等待模拟线程；同一时刻只能有一个线程写入
+
+        `Update` 取出新帧，播放头随其时间间隔前进并落后最新一帧 delay 秒（见 `SetParameterChannelDelay`），
+        在相邻两帧之间按时间戳插值，因此 30 Hz 的捕捉在 60 Hz 更新下也是连续的。
+
+        :param values: 按 `BindParameterChannel` 中 id 的顺序排列的数值
+        :param timestamp: 采集时间（秒），只需彼此一致，例如视频帧的时间；为 None 时取写入时刻
+        :return: 缓冲区已满时为 False，该帧被丢弃
+        """
+        ...
+
+    def SetParameterChannelFilter(self, filter: str = "none", timeConstant: float = 0.1, minCutoff: float = 1.0,
+                                  beta: float = 0.0, dCutoff: float = 1.0) -> None:
+        """
+        设置对输入帧的平滑，按帧的时间戳计算
+
+        :param filter: "none"、"ema" 或 "oneEuro"
+        :param timeConstant: "ema" 的时间常数（秒），与 `Params.smooth_factor` 的作用相同但与帧率无关
+        :param minCutoff: "oneEuro" 的最小截止频率（Hz），越小静止时越平稳
+        :param beta: "oneEuro" 截止频率随速度增加的系数，越大快速动作的拖影越小
+        :param dCutoff: "oneEuro" 估计速度时的截止频率（Hz）
+        """
+        ...
+
+    def SetParameterChannelDelay(self, seconds: float | None = None) -> None:
+        """
+        设置播放头落后最新一帧的时间，越大插值越平滑、延迟越高
+
+        :param seconds: 秒数，为 None 时取帧间隔的平均值（默认）
+        """
+        ...
+
+    def GetParameterChannelDroppedFrames(self) -> int:
+        """
+        :return: 绑定以来因缓冲区已满而丢弃的帧数
+        """
+        ...
+
+    def BindParameters(self, ids: Iterable[str]) -> ParameterPlan:
+        """
+        按 id 解析一组参数，之后每帧用 `ParameterPlan.set` / `ParameterPlan.add` 一次写入整组数值
+
+        :param ids: 参数 id，写入时数值按同样的顺序排列
+        """
+        ...
+
+    def GetParameterValuesView(self) -> ArrayView:
+        """
+        参数当前值的可写视图，float32，长度为参数个数
+
+        写入与 `SetParameterValue` 不同，不会保存：下一次 `Update` 会从动作重新计算，
+        因此应在 `Update` 与 `Draw` 之间写入，例如 `numpy.asarray(view)[:] = values` 一次写入全部参数
+        """
+        ...
+
+    def GetParameterMinimumValuesView(self) -> ArrayView:
+        """
+        参数最小值的只读视图，float32
+        """
+        ...
+
+    def GetParameterMaximumValuesView(self) -> ArrayView:
+        """
+        参数最大值的只读视图，float32
+        """
+        ...
+
+    def GetParameterDefaultValuesView(self) -> ArrayView:
+        """
+        参数默认值的只读视图，float32
+        """
+        ...
+
+    def GetPartOpacitiesView(self) -> ArrayView:
+        """
+        部件不透明度的可写视图，float32，长度为部件个数；与参数相同，应在 `Update` 与 `Draw` 之间写入
+        """
+        ...
+
+    def GetDrawableOpacitiesView(self) -> ArrayView:
+        """
+        drawable 不透明度的只读视图，float32，在 `Draw` 与 `updateAll` 时更新
+        """
+        ...
+
+    def GetDrawableRenderOrdersView(self) -> ArrayView:
+        """
+        drawable 绘制顺序的只读视图，int32，在 `Draw` 与 `updateAll` 时更新
+        """
+        ...
+
+    def GetDrawableVertexPositionsView(self, index: int) -> ArrayView:
+        """
+        第 index 个 drawable 顶点坐标的只读视图，float32，形状为 (顶点数, 2)，在 `Draw` 与 `updateAll` 时更新
+
+        :param index: drawable 的下标
         """
         ...
 
@@ -211,6 +811,14 @@ class LAppModel:
         """
         ...
 
+    def SetProceduralEffectsEnable(self, enable: bool) -> None:
+        """
+        开关按表批量计算的呼吸、眨眼与拖拽视线，默认开启
+
+        关闭时改由 Cubism SDK 的 CubismBreath / CubismEyeBlink 逐个参数计算，结果在 float 舍入误差内相同，用于对照
+        """
+        ...
+
     def GetParameterCount(self) -> int:
         ...
 
@@ -276,4 +884,29 @@ class LAppModel:
         ...
 
     def GetMotionGroups(self) -> dict[str, int]:
+        ...
+
+    def GetMemoryStats(self) -> dict[str, int]:
+        """
+        bytes currently held by this model, counted by the allocator as they are allocated and freed
+
+        :return: {
+            "model": int,        # CubismModel, the revived moc is shared through the asset cache and not counted
+            "motions": int,      # preloaded motions, on-demand motions and motion queue entries
+            "expressions": int,
+            "physics": int,
+            "pose": int,
+            "userData": int,
+            "renderer": int,     # renderer and clipping manager
+            "other": int,        # model setting, eye blink, breath, ...
+            "total": int,        # sum of the above
+            "textures": int,     # GPU memory of textures, RGBA8 with full mipmap chain; a texture shared
+                                 # through the asset cache is divided evenly between the models using it,
+                                 # so the sum over all models is the GPU memory actually held
+            "masks": int,        # GPU memory of clipping mask buffers and the offscreen render buffer
+            "loadPeak": int,     # peak growth of the process resident memory during the last LoadModelJson;
+                                 # exact when the load raised the process peak, otherwise the resident growth
+                                 # before/after the load (a lower bound). The process peak is never reset.
+        }
+        """
         ...
\ No newline at end of file
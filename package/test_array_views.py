@@ -0,0 +1,123 @@
+# 数组视图：与逐个读取的结果一致、写入参数与部件不透明度、只读检查、顶点坐标的形状，以及导出期间禁止重新加载
+
+import os
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = live2d.LAppModel()
+    modelPath = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json")
+    model.LoadModelJson(modelPath)
+    model.Resize(200, 200)
+    model.Update(1 / 60)
+    model.Draw()
+
+    # 参数：与逐个读取的结果一致，numpy.asarray 同样可以直接使用这些视图
+    values = memoryview(model.GetParameterValuesView())
+    minimums = memoryview(model.GetParameterMinimumValuesView())
+    maximums = memoryview(model.GetParameterMaximumValuesView())
+    defaults = memoryview(model.GetParameterDefaultValuesView())
+    count = model.GetParameterCount()
+    assert values.format == "f" and values.shape == (count,) and not values.readonly
+    for i in range(count):
+        assert values[i] == model.GetParameterValue(i)
+        assert defaults[i] == model.GetParameter(i).default
+        assert minimums[i] <= defaults[i] <= maximums[i]
+
+    values[0] = maximums[0]
+    assert model.GetParameterValue(0) == maximums[0]
+
+    try:
+        minimums[0] = 0.0
+        assert False
+    except TypeError:
+        pass
+
+    # 部件不透明度可写
+    parts = memoryview(model.GetPartOpacitiesView())
+    assert len(parts) == model.GetPartCount()
+    parts[0] = 0.25
+    assert memoryview(model.GetPartOpacitiesView())[0] == 0.25
+
+    # drawable：不透明度、绘制顺序与顶点坐标
+    opacities = memoryview(model.GetDrawableOpacitiesView())
+    orders = memoryview(model.GetDrawableRenderOrdersView())
+    drawableCount = len(opacities)
+    assert orders.format == "i" and len(orders) == drawableCount
+    assert sorted(orders.tolist()) == list(range(drawableCount))
+
+    vertices = memoryview(model.GetDrawableVertexPositionsView(0))
+    assert vertices.ndim == 2 and vertices.shape[1] == 2 and vertices.shape[0] > 0
+    print("parameters %d, parts %d, drawables %d, drawable 0 vertices %d"
+          % (count, len(parts), drawableCount, vertices.shape[0]))
+    try:
+        model.GetDrawableVertexPositionsView(drawableCount)
+        assert False
+    except IndexError:
+        pass
+
+    # 视图随模型更新：顶点在动作播放中变化
+    before = vertices.tolist()
+    model.StartMotion("Idle", 0, live2d.MotionPriority.FORCE)
+    for _ in range(30):
+        model.Update(1 / 60)
+        model.Draw()
+    assert vertices.tolist() != before
+
+    # updateAll 已算出绘制数据后经视图写入的部件不透明度，在 Draw 时同样生效
+    live2d.updateAll([model], 1 / 60)
+    assert max(opacities.tolist()) > 0
+    for i in range(len(parts)):
+        parts[i] = 0.0
+    model.Draw()
+    assert max(opacities.tolist()) == 0.0
+
+    # 导出期间重新加载会释放视图指向的内存，因此被拒绝
+    try:
+        model.LoadModelJson(modelPath)
+        assert False
+    except BufferError:
+        pass
+
+    for view in (values, minimums, maximums, defaults, parts, opacities, orders, vertices):
+        view.release()
+    model.LoadModelJson(modelPath)
+
+    # 流水线模式下导出时等待模拟线程
+    angleX = [model.GetParameter(i).id for i in range(count)].index("ParamAngleX")
+    model.SetPipelineEnable(True)
+    for frame in range(5):
+        model.SetParameterValue("ParamAngleX", frame * 5.0, 1.0)
+        model.Update(1 / 60)
+        model.Draw()
+    with memoryview(model.GetParameterValuesView()) as view:
+        assert view[angleX] == 20.0, view[angleX]
+    model.SetPipelineEnable(False)
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+# 同一模型加载多次，检查共享资源只加载一次，且全部释放后缓存清空
+
+import os
+import shutil
+import tempfile
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    path = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json")
+
+    models = []
+    for i in range(4):
+        start = time.perf_counter()
+        model = live2d.LAppModel()
+        model.LoadModelJson(path)
+        model.Resize(200, 200)
+        print(f"load #{i}: {(time.perf_counter() - start) * 1000:.1f} ms")
+        models.append(model)
+
+    stats = live2d.getAssetCacheStats()
+    print(stats)
+    assert stats["mocs"] == 1
+    assert stats["textures"] > 0
+
+    # 各实例的参数互不影响
+    models[0].StartRandomMotion("TapBody", 3)
+    for _ in range(30):
+        for model in models:
+            model.Update()
+            model.Draw()
+
+    # 乱序释放
+    del model
+    for i in (1, 3, 0, 2):
+        models[i] = None
+
+    stats = live2d.getAssetCacheStats()
+    print(stats)
+    assert stats["mocs"] == 0 and stats["textures"] == 0
+
+    # 修改时间变了但内容相同时仍共用；内容变了则作为新资源加载
+    with tempfile.TemporaryDirectory() as directory:
+        copy = os.path.join(directory, "Haru")
+        shutil.copytree(os.path.dirname(path), copy)
+        copyPath = os.path.join(copy, "Haru.model3.json")
+        physicsPath = os.path.join(copy, "Haru.physics3.json")
+
+        first = live2d.LAppModel()
+        first.LoadModelJson(copyPath)
+
+        stamp = os.stat(physicsPath).st_mtime_ns + 10 ** 9
+        os.utime(physicsPath, ns=(stamp, stamp))
+        second = live2d.LAppModel()
+        second.LoadModelJson(copyPath)
+        stats = live2d.getAssetCacheStats()
+        assert stats["mocs"] == 1 and stats["physics"] == 1, stats
+
+        with open(physicsPath, "a") as f:
+            f.write("\n")
+        third = live2d.LAppModel()
+        third.LoadModelJson(copyPath)
+        stats = live2d.getAssetCacheStats()
+        assert stats["mocs"] == 1 and stats["physics"] == 2, stats
+
+        del first, second, third
+        stats = live2d.getAssetCacheStats()
+        assert stats["mocs"] == 0 and stats["physics"] == 0 and stats["textures"] == 0, stats
+
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,177 @@
+# 群体绘制：与逐个 Draw 的像素一致、绘制次数与实例数无关、重新加载后重建、与单独 Draw 交替使用，以及参数校验
+
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+import OpenGL.GL as gl
+
+import fixtures
+from fixtures import model_path
+
+SIZE = 400
+
+
+def create_models(count, name="Haru"):
+    models = fixtures.create_models(count, name, size=SIZE)
+    for i, model in enumerate(models):
+        model.SetScale(0.25)
+        model.SetOffset(-0.75 + 0.5 * (i % 4), 0.75 - 0.5 * (i // 4 % 4))
+    return models
+
+
+def bind_framebuffer():
+    """绑定一个 SIZE x SIZE 的 RGBA 帧缓冲，读回的像素不受窗口缩放与合成影响"""
+    framebuffer = gl.glGenFramebuffers(1)
+    renderbuffer = gl.glGenRenderbuffers(1)
+    gl.glBindRenderbuffer(gl.GL_RENDERBUFFER, renderbuffer)
+    gl.glRenderbufferStorage(gl.GL_RENDERBUFFER, gl.GL_RGBA8, SIZE, SIZE)
+    gl.glBindFramebuffer(gl.GL_FRAMEBUFFER, framebuffer)
+    gl.glFramebufferRenderbuffer(gl.GL_FRAMEBUFFER, gl.GL_COLOR_ATTACHMENT0, gl.GL_RENDERBUFFER, renderbuffer)
+    assert gl.glCheckFramebufferStatus(gl.GL_FRAMEBUFFER) == gl.GL_FRAMEBUFFER_COMPLETE
+    gl.glViewport(0, 0, SIZE, SIZE)
+    return framebuffer, renderbuffer
+
+
+def render(draw):
+    live2d.clearBuffer()
+    draw()
+    return bytes(gl.glReadPixels(0, 0, SIZE, SIZE, gl.GL_RGBA, gl.GL_UNSIGNED_BYTE))
+
+
+def compare(a, b):
+    """返回通道的最大差与任一通道差超过 8 的像素数"""
+    largest = 0
+    differing = 0
+    for i in range(0, len(a), 4):
+        d = max(abs(a[i + c] - b[i + c]) for c in range(4))
+        largest = max(largest, d)
+        differing += d > 8
+    return largest, differing
+
+
+def check_pixels(name, count):
+    models = create_models(count, name)
+    for i, model in enumerate(models):
+        model.SetParameterValue("ParamAngleX", 10 * i - 15)
+    for _ in range(30):
+        live2d.updateAll(models, 1 / 60)
+
+    def draw_each():
+        for model in models:
+            model.Draw()
+
+    each = render(draw_each)
+    crowd = live2d.Crowd(models)
+    crowded = render(crowd.Draw)
+    largest, differing = compare(each, crowded)
+    drawn = sum(1 for i in range(3, len(each), 4) if each[i] > 0)
+    print("%s x%d: %d pixels drawn, max difference %d, %d pixels differ by more than 8"
+          % (name, count, drawn, largest, differing))
+    assert drawn > 0
+    # 共享图集中的遮罩分辨率较低，只允许遮罩边缘的少量像素不同
+    assert differing <= drawn // 200, (largest, differing)
+
+    # 单独 Draw 过的实例重新创建了遮罩缓冲，之后的群体绘制结果不变
+    models[1].Draw()
+    assert render(crowd.Draw) == crowded
+    assert render(draw_each) == each
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(SIZE, SIZE, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    previous = gl.glGetIntegerv(gl.GL_FRAMEBUFFER_BINDING)
+    framebuffer, renderbuffer = bind_framebuffer()
+    for name in ("Haru", "Hiyori", "Mao"):
+        check_pixels(name, 4)
+    gl.glBindFramebuffer(gl.GL_FRAMEBUFFER, previous)
+    gl.glDeleteFramebuffers(1, [framebuffer])
+    gl.glDeleteRenderbuffers(1, [renderbuffer])
+
+    stats = {}
+    for count in (3, 12):
+        models = create_models(count)
+        crowd = live2d.Crowd(models)
+        for frame in range(30):
+            for i, model in enumerate(models):
+                model.SetParameterValue("ParamAngleX", (frame + i * 5) % 30)
+            live2d.updateAll(models, 1 / 60)
+            crowd.Draw()
+        stats[count] = crowd.GetDrawStats()
+        print(count, "instances:", stats[count])
+        assert stats[count]["instances"] == count
+
+    if stats[3]["instanced"]:
+        assert stats[3]["drawCalls"] == stats[12]["drawCalls"], stats
+        assert stats[3]["maskDrawCalls"] == stats[12]["maskDrawCalls"] > 0, stats
+    else:
+        print("instanced drawing unavailable, drawn one by one")
+        assert stats[12]["drawCalls"] > stats[3]["drawCalls"], stats
+
+    # 重新加载后重建布局，交回单独绘制的模型重新创建遮罩缓冲
+    models[0].LoadModelJson(model_path("Haru"))
+    crowd.SetMaskAtlasSize(1024)
+    for _ in range(30):
+        live2d.updateAll(models, 1 / 60)
+        crowd.Draw()
+    assert crowd.GetDrawStats() == stats[12], crowd.GetDrawStats()
+    models[1].Update(1 / 60)
+    models[1].Draw()
+
+    # 同一个列表逐个绘制与群体绘制的耗时
+    for _ in range(2):
+        t = time.perf_counter()
+        for _ in range(60):
+            for model in models:
+                model.Draw()
+        each = time.perf_counter() - t
+        t = time.perf_counter()
+        for _ in range(60):
+            crowd.Draw()
+        print("12 instances x 60 frames: one by one %.3f s, crowd %.3f s" % (each, time.perf_counter() - t))
+
+    empty = live2d.Crowd([])
+    empty.Draw()
+    assert empty.GetDrawStats()["instances"] == 0
+
+    try:
+        live2d.Crowd([models[0], create_models(1, "Hiyori")[0]])
+        assert False
+    except ValueError:
+        pass
+
+    try:
+        live2d.Crowd([models[0], 1])
+        assert False
+    except TypeError:
+        pass
+
+    try:
+        crowd.SetMaskAtlasSize(0)
+        assert False
+    except ValueError:
+        pass
+
+    del crowd
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,93 @@
+# 表情混合：叠加播放多个表情时每帧不再分配内存，参数与改写前的 CubismExpressionMotionManager 记录下的值一致
+
+import json
+import os
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_model
+
+DT = 1 / 64
+# 帧号 -> 表情；F02、F05 以及 F03、F06、F08 都在前一个表情淡入完成之前开始
+SCHEDULE = {0: "F01", 30: "F02", 40: "F05", 100: "F03", 104: "F06", 106: "F08"}
+RESET_FRAME = 150
+FRAMES = 200
+# 每 10 帧记录一次，取第 9、19、... 帧更新之后的参数
+RECORD_EVERY = 10
+
+# 由改写前的实现以 1/64 秒的固定步长按 SCHEDULE 播放记录
+REFERENCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "expression_blend_reference.json")
+
+
+def check_reference():
+    with open(REFERENCE) as f:
+        reference = json.load(f)
+
+    model = create_model(autoBlink=False, autoBreath=False)
+    ids = [model.GetParameter(i).id for i in range(model.GetParameterCount())]
+    assert sorted(ids) == sorted(reference)
+
+    record = 0
+    largest = 0.0
+    for frame in range(FRAMES):
+        if frame in SCHEDULE:
+            model.SetExpression(SCHEDULE[frame])
+        if frame == RESET_FRAME:
+            model.ResetExpression()
+        model.Update(DT)
+        if frame % RECORD_EVERY == RECORD_EVERY - 1:
+            for i, paramId in enumerate(ids):
+                d = abs(model.GetParameterValue(i) - reference[paramId][record])
+                largest = max(largest, d)
+                assert d < 1e-6, (frame, paramId, model.GetParameterValue(i), reference[paramId][record])
+            record += 1
+    print("max difference from reference: %.3g" % largest)
+
+
+def check_allocations():
+    model = create_model(autoBlink=False, autoBreath=False)
+
+    # 三个表情同时处于淡入淡出中
+    for expression in ("F01", "F02", "F05"):
+        model.SetExpression(expression)
+        model.Update(DT)
+        model.Update(DT)
+
+    before = live2d.getAllocatorStats()["allocations"]
+    # 跨过前两个表情淡出结束被移除的时刻
+    for _ in range(120):
+        model.Update(DT)
+    after = live2d.getAllocatorStats()["allocations"]
+    print("allocations over 120 updates: %d" % (after - before))
+    assert after == before, after - before
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init(allocator="tracking")
+
+    live2d.glInit()
+
+    check_reference()
+    check_allocations()
+
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+# 以固定步长驱动两个使用相同种子的模型，检查参数逐帧一致，并统计推进 60 秒模型时间的耗时
+
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_model
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    a = create_model(seed=1234)
+    b = create_model(seed=1234)
+    dt = 1 / 60
+
+    for frame in range(600):
+        if frame % 120 == 0:
+            a.StartRandomMotion(priority=3)
+            b.StartRandomMotion(priority=3)
+            assert a.SetRandomExpression(fadeout=500) == b.SetRandomExpression(fadeout=500)
+        a.Update(dt)
+        b.Tick(1, dt)
+        for i in range(a.GetParameterCount()):
+            assert a.GetParameterValue(i) == b.GetParameterValue(i), (frame, i)
+
+    # 与逐帧 Update(dt) 的结果相同
+    a.Tick(30, dt)
+    for _ in range(30):
+        b.Update(dt)
+    assert [a.GetParameterValue(i) for i in range(a.GetParameterCount())] == \
+           [b.GetParameterValue(i) for i in range(b.GetParameterCount())]
+
+    t = time.perf_counter()
+    a.Tick(60 * 60, dt)
+    print("60 s of updates: %.2f s" % (time.perf_counter() - t))
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
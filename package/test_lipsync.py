@@ -0,0 +1,160 @@
+# 原生口型同步：wav 的逐帧 RMS 与 numpy 计算一致、PCM 流与缓冲区上限、元音分析，以及参数确实被驱动
+
+import array
+import math
+import os
+import wave
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+from fixtures import create_model, parameter
+
+
+def rms(samples):
+    return math.sqrt(sum(x * x for x in samples) / len(samples))
+
+
+def vowel_pcm(f1, f2, sampleRate, seconds):
+    # 120 Hz 的谐波经过两个共振峰的包络，近似一个持续的元音
+    harmonics = []
+    for k in range(1, int(4000 / 120)):
+        f = 120 * k
+        gain = math.exp(-0.5 * (math.log2(f / f1) / 0.3) ** 2) + 0.6 * math.exp(-0.5 * (math.log2(f / f2) / 0.3) ** 2)
+        harmonics.append((2 * math.pi * f / sampleRate, gain / k ** 0.5))
+    signal = [sum(g * math.sin(w * n) for w, g in harmonics) for n in range(int(sampleRate * seconds))]
+    peak = max(abs(x) for x in signal)
+    return array.array("f", (x / peak * 0.5 for x in signal))
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    dt = 1 / 60
+    audioPath = os.path.join(resources.CURRENT_DIRECTORY, "audio1.wav")
+
+    # wav：与按相同时间片在 Python 中计算的 RMS 比较
+    with wave.open(audioPath, "r") as wav:
+        sampleRate = wav.getframerate()
+        channels = wav.getnchannels()
+        samples = array.array("h", wav.readframes(wav.getnframes()))
+    pcm = [sum(samples[i:i + channels]) / channels for i in range(0, len(samples), channels)]
+    peak = max(abs(x) for x in pcm)
+    pcm = [x / peak for x in pcm]
+
+    model = create_model("Haru", seed=7, autoBlink=False, autoBreath=False)
+    reference = create_model("Haru", seed=7, autoBlink=False, autoBreath=False)
+    assert model.StartLipSyncWav(audioPath)
+    model.SetLipSyncGain(3)
+
+    carry = 0.0
+    offset = 0
+    maxError = 0.0
+    opened = 0
+    frames = int(len(pcm) / sampleRate / dt) + 10
+    for frame in range(frames):
+        model.Update(dt)
+        reference.Update(dt)
+
+        carry += dt * sampleRate
+        count = min(int(carry), len(pcm) - offset)
+        carry -= int(carry)
+        if count > 0:
+            expected = min(1.0, 3 * rms(pcm[offset:offset + count]))
+            offset += count
+            maxError = max(maxError, abs(model.GetLipSyncValue() - expected))
+            if parameter(model, "ParamMouthOpenY") > parameter(reference, "ParamMouthOpenY") + 0.1:
+                opened += 1
+    print("wav frames: %d, max error: %.2e, mouth opened on %d frames" % (frames, maxError, opened))
+    assert maxError < 1e-4
+    assert opened > frames // 4
+
+    # 播放完后不再驱动参数
+    for _ in range(5):
+        model.Update(dt)
+        reference.Update(dt)
+    assert abs(parameter(model, "ParamMouthOpenY") - parameter(reference, "ParamMouthOpenY")) < 1e-6
+
+    # 流：float32 的 bytes 与 int16 的 array
+    tone = array.array("f", (0.5 * math.sin(2 * math.pi * 440 * n / 16000) for n in range(16000)))
+    model.SetLipSyncGain(1)
+    model.OpenLipSyncStream(16000, 1, 2.0)
+    assert model.FeedLipSync(tone.tobytes(), "float32") == 16000
+    for _ in range(30):
+        model.Update(dt)
+    print("float32 stream rms: %.4f" % model.GetLipSyncValue())
+    assert abs(model.GetLipSyncValue() - 0.5 / math.sqrt(2)) < 0.01
+
+    stereo = array.array("h", (int(x * 32767) for x in tone for _ in range(2)))
+    model.OpenLipSyncStream(16000, 2, 2.0)
+    assert model.FeedLipSync(stereo) == 16000
+    model.Update(dt)
+    assert abs(model.GetLipSyncValue() - 0.5 / math.sqrt(2)) < 0.01
+
+    # bytearray 经缓冲区协议读取；不连续的 memoryview 复制一次后同样可用
+    model.OpenLipSyncStream(16000, 1, 2.0)
+    assert model.FeedLipSync(bytearray(tone.tobytes()), "float32") == 16000
+    model.Update(dt)
+    assert abs(model.GetLipSyncValue() - 0.5 / math.sqrt(2)) < 0.01
+    model.OpenLipSyncStream(16000, 1, 2.0)
+    assert model.FeedLipSync(memoryview(stereo)[::2]) == 16000
+    model.Update(dt)
+    assert abs(model.GetLipSyncValue() - 0.5 / math.sqrt(2)) < 0.01
+
+    # 缓冲区满时丢弃，0.1 秒取整到 2048 个样本
+    model.OpenLipSyncStream(16000, 1, 0.1)
+    accepted = model.FeedLipSync(tone.tobytes(), "float32")
+    print("accepted with 0.1s buffer: %d" % accepted)
+    assert accepted == 2048
+    assert model.FeedLipSync(tone.tobytes(), "float32") == 0
+
+    # 持续断供后闭嘴
+    for _ in range(30):
+        model.Update(dt)
+    assert model.GetLipSyncValue() == 0
+
+    model.StopLipSync()
+    assert model.FeedLipSync(tone.tobytes(), "float32") == 0
+
+    # 元音分析：Mao 有 ParamA/I/U/E/O
+    mao = create_model("Mao", seed=7, autoBlink=False, autoBreath=False)
+    mao.SetLipSyncVowelEnable(True)
+    mao.SetLipSyncGain(2)
+    names = "aiueo"
+    formants = {"a": (800, 1200), "i": (300, 2300), "u": (350, 1400), "e": (500, 1900), "o": (500, 850)}
+    correct = 0
+    for vowel, (f1, f2) in formants.items():
+        mao.OpenLipSyncStream(16000, 1, 1.0)
+        mao.FeedLipSync(vowel_pcm(f1, f2, 16000, 0.5).tobytes(), "float32")
+        for _ in range(20):
+            mao.Update(dt)
+        weights = mao.GetLipSyncVowels()
+        best = names[weights.index(max(weights))]
+        print("vowel %s -> %s %s" % (vowel, best, " ".join("%.2f" % w for w in weights)))
+        correct += best == vowel
+        assert abs(sum(weights) - 1) < 0.05
+        assert parameter(mao, "Param" + vowel.upper()) > 0.05
+    assert correct >= 4
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,117 @@
+# 异步日志：Python sink、级别过滤、按调用点限速，以及 sink 抛出异常时不影响调用方
+
+import os
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    records = []
+    live2d.setLogSink(lambda level, message, file, line: records.append((level, message, file, line)))
+    live2d.setLogEnable(True)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"))
+    model.Resize(200, 200)
+
+    # 加载期间的消息经后台线程到达 sink，带有调用点
+    live2d.flushLog()
+    assert any(level == 20 and message.startswith("load model setting:") for level, message, _, _ in records), records
+    assert all(file.endswith(".cpp") and line > 0 for _, _, file, line in records)
+
+    # 级别过滤
+    records.clear()
+    live2d.setLogLevel(30)
+    assert live2d.getLogLevel() == 30
+    model.SetExpression("missing")
+    live2d.flushLog()
+    assert records == [], records
+    live2d.setLogLevel(10)
+
+    # 每个调用点每秒最多两条，被丢弃的条数在窗口过后的下一条中注明
+    time.sleep(1.1)
+    live2d.setLogRateLimit(2)
+    records.clear()
+    for _ in range(10):
+        model.SetExpression("missing")
+    live2d.flushLog()
+    missing = [message for _, message, _, _ in records if message.startswith("expression[missing] is null")]
+    assert len(missing) == 2, records
+
+    time.sleep(1.1)
+    records.clear()
+    model.SetExpression("missing")
+    live2d.flushLog()
+    missing = [message for _, message, _, _ in records if message.startswith("expression[missing] is null")]
+    assert len(missing) == 1 and "(8 similar messages suppressed)" in missing[0], records
+    live2d.setLogRateLimit(0)
+
+    # sink 抛出的异常只作为 unraisable 报告
+    def failing_sink(level, message, file, line):
+        raise RuntimeError("sink failed")
+
+    live2d.setLogSink(failing_sink)
+    model.SetExpression("missing")
+    live2d.flushLog()
+
+    # sink 中调用 flushLog 直接返回，调用 setLogSink 立即替换，都不会在持有的锁上死锁
+    records.clear()
+
+    def collecting_sink(level, message, file, line):
+        records.append(message)
+
+    def reentrant_sink(level, message, file, line):
+        live2d.flushLog()
+        live2d.setLogSink(collecting_sink)
+
+    live2d.setLogSink(reentrant_sink)
+    model.SetExpression("missing")
+    model.SetExpression("missing")
+    live2d.flushLog()
+    assert any(message.startswith("expression[missing] is null") for message in records), records
+
+    # None 恢复为 stdout
+    live2d.setLogSink(None)
+    records.clear()
+    model.SetExpression("missing")
+    live2d.flushLog()
+    assert records == []
+
+    try:
+        live2d.setLogSink(1)
+        assert False, "expected TypeError"
+    except TypeError:
+        pass
+
+    live2d.setLogSink(lambda level, message, file, line: None)
+
+    model = None
+    live2d.dispose()
+
+    glfw.terminate()
+
+    print("pass")
+
+
+if __name__ == "__main__":
+    main()
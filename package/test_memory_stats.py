@@ -0,0 +1,69 @@
+# 按模型统计内存，并检查释放后分配器的存活字节数回落
+
+import os
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init(allocator="tracking")
+
+    live2d.glInit()
+
+    before = live2d.getAllocatorStats()["liveBytes"]
+
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"))
+    model.Resize(200, 200)
+    model.Update()
+    model.Draw()
+
+    stats = model.GetMemoryStats()
+    for k, v in stats.items():
+        print(f"{k:12s} {v:>12d}")
+
+    assert stats["model"] > 0
+    assert stats["textures"] > 0
+
+    # 共用的纹理按引用数均分，各模型之和与只加载一个时相同
+    others = []
+    for i in range(3):
+        other = live2d.LAppModel()
+        other.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"))
+        others.append(other)
+    shares = [m.GetMemoryStats()["textures"] for m in [model] + others]
+    print("texture shares:", shares)
+    assert abs(sum(shares) - stats["textures"]) < 4, shares
+    del other, others
+    assert model.GetMemoryStats()["textures"] == stats["textures"]
+
+    del model
+
+    after = live2d.getAllocatorStats()
+    print("live bytes held after release:", after["liveBytes"] - before)
+    for site in after["sites"][:10]:
+        print(site)
+
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
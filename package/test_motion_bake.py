@@ -0,0 +1,72 @@
+# 以 120 Hz 烘焙 Haru 的全部动作，烘焙测得的最大偏差应在参数值域的 1e-3 以内
+
+import os
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+RATE = 120.0
+TOLERANCE = 1e-3
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    modelPath = os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json")
+
+    plain = live2d.LAppModel()
+    plain.LoadModelJson(modelPath)
+    groups = plain.GetMotionGroups()
+    print("groups:", groups)
+
+    baked = live2d.LAppModel()
+    for group in groups:
+        baked.SetMotionBakeRate(group, RATE)
+    baked.LoadModelJson(modelPath)
+
+    # 曲线数值的范围不超过参数的值域
+    minimums = memoryview(baked.GetParameterMinimumValuesView())
+    maximums = memoryview(baked.GetParameterMaximumValuesView())
+    span = max(maximums[i] - minimums[i] for i in range(baked.GetParameterCount()))
+
+    for group, count in groups.items():
+        for no in range(count):
+            error = baked.GetMotionBakeError(group, no)
+            print(f"{group}[{no}]: {error:.2e} ({error / span:.2e} of {span:g})")
+            assert 0.0 < error < TOLERANCE * span
+            assert plain.GetMotionBakeError(group, no) == 0.0
+
+    assert baked.GetMotionBakeError("Missing", 0) == -1.0
+
+    # 烘焙后的动作照常播放
+    baked.StartMotion("TapBody", 0, 3)
+    for _ in range(30):
+        baked.Update(1 / 60)
+        baked.Draw()
+    assert not baked.IsMotionFinished()
+
+    del plain, baked
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
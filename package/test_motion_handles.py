@@ -0,0 +1,87 @@
+# 动作句柄：动作结束、槽位被新动作重用之后，旧句柄仍判定为已结束，不会指向新的动作
+
+import struct
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_model
+
+DT = 1 / 60
+# 句柄的低半部分为槽位号，高半部分为槽位的世代
+SLOT_MASK = (1 << (struct.calcsize("P") * 4)) - 1
+
+
+def play_to_end(model, handle):
+    for _ in range(int(30 / DT)):
+        if model.IsMotionFinished(handle):
+            break
+        model.Update(DT)
+    assert model.IsMotionFinished(handle)
+    # 结束的动作在下一次更新中移出队列，槽位随之空出
+    model.Update(DT)
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = create_model(seed=5, autoBlink=False, autoBreath=False)
+
+    first = model.StartMotion("TapBody", 0, live2d.MotionPriority.FORCE)
+    assert first != -1
+    assert not model.IsMotionFinished(first)
+    play_to_end(model, first)
+
+    # 每一代都重用同一个槽位，之前所有句柄都保持已结束，新句柄在播放期间未结束
+    stale = [first]
+    for i in range(5):
+        handle = model.StartMotion("TapBody", i % 3, live2d.MotionPriority.FORCE)
+        assert handle != -1
+        assert handle & SLOT_MASK == first & SLOT_MASK, (hex(handle), hex(first))
+        assert handle not in stale
+        model.Update(DT)
+        assert not model.IsMotionFinished(handle)
+        for old in stale:
+            assert model.IsMotionFinished(old), hex(old)
+        play_to_end(model, handle)
+        stale.append(handle)
+
+    # 打断播放中的动作时，被打断的动作淡出期间与新动作同时在队列中，各占一个槽位
+    playing = model.StartMotion("TapBody", 0, live2d.MotionPriority.FORCE)
+    model.Update(DT)
+    interrupting = model.StartMotion("TapBody", 1, live2d.MotionPriority.FORCE)
+    assert interrupting & SLOT_MASK != playing & SLOT_MASK
+    assert not model.IsMotionFinished(interrupting)
+    play_to_end(model, interrupting)
+    assert model.IsMotionFinished(playing)
+    for old in stale:
+        assert model.IsMotionFinished(old)
+
+    # 不是由 StartMotion 得到的句柄视为已结束
+    assert model.IsMotionFinished(0)
+    assert model.IsMotionFinished(-1)
+    assert model.IsMotionFinished(SLOT_MASK + 1 + 1000)
+
+    del model
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,84 @@
+# motion3.json 的流式读取与 CubismMotionJson 的 JSON 树读取结果逐项相同，截断或格式错误的文件读取失败
+
+import glob
+import json
+import os
+
+import live2d.v3 as live2d
+from live2d.v3 import live2d as native
+
+import resources
+
+
+def read(data, tree=False):
+    return native._readMotionJson(data, tree)
+
+
+def check_bundled():
+    paths = sorted(glob.glob(os.path.join(resources.RESOURCES_DIRECTORY, "v3/*/motions/*.motion3.json")))
+    assert paths
+    for path in paths:
+        with open(path, "rb") as f:
+            data = f.read()
+        streamed = read(data)
+        tree = read(data, tree=True)
+        for key in tree:
+            assert streamed[key] == tree[key], "%s: %s differs" % (path, key)
+        assert len(streamed["curves"]) == streamed["curveCount"], path
+        assert len(streamed["events"]) == streamed["eventCount"], path
+    print("%d motions read identically" % len(paths))
+    return data
+
+
+def check_malformed(data):
+    # 在任意位置截断都只会读取失败
+    for end in range(0, len(data), max(1, len(data) // 97)):
+        try:
+            read(data[:end])
+        except ValueError:
+            continue
+        raise AssertionError("truncated at %d was accepted" % end)
+
+    motion = json.loads(data)
+    segments = motion["Curves"][0]["Segments"]
+
+    cases = {
+        "unknown segment type": dict(motion, Curves=[dict(motion["Curves"][0], Segments=segments[:2] + [7] + segments[3:])]),
+        "incomplete segment": dict(motion, Curves=[dict(motion["Curves"][0], Segments=segments[:4])]),
+        "curves not a list": dict(motion, Curves={}),
+    }
+    for name, case in cases.items():
+        try:
+            read(json.dumps(case).encode())
+        except ValueError as e:
+            print("%s: %s" % (name, e))
+            continue
+        raise AssertionError(name + " was accepted")
+
+    for bad in (b"", b"{", b"[]", b'{"Meta": }', b'{"Meta": {"Duration": 1.0,}}'):
+        try:
+            read(bad)
+        except ValueError:
+            continue
+        raise AssertionError("%r was accepted" % bad)
+
+    try:
+        read("not bytes")
+    except TypeError:
+        pass
+    else:
+        raise AssertionError("str was accepted")
+
+
+def main():
+    live2d.init()
+
+    data = check_bundled()
+    check_malformed(data)
+
+    live2d.dispose()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+# 主动作之上叠加一个只影响头部角度的手势层，检查蒙版外的参数不受该层影响
+
+import os
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"))
+    model.Resize(200, 200)
+    model.SetAutoBlinkEnable(False)
+    model.SetAutoBreathEnable(False)
+
+    ids = model.GetParamIds()
+    masked = ["ParamAngleX", "ParamAngleY", "ParamAngleZ"]
+
+    model.AddMotionLayer("gesture", additive=False, weight=1.0)
+    model.SetMotionLayerMask("gesture", masked)
+
+    finished = []
+    handle = model.StartLayerMotion("gesture", "TapBody", 0, onFinishMotionHandler=lambda: finished.append(True))
+    assert handle != -1
+    assert not model.IsLayerMotionFinished("gesture", handle)
+    assert model.IsLayerMotionFinished("missing")
+
+    # 主动作不播放时，蒙版外的参数应保持默认值
+    defaults = [model.GetParameter(i).default for i in range(model.GetParameterCount())]
+    for _ in range(60):
+        model.Update()
+        model.Draw()
+        time.sleep(1 / 60)
+
+    # 头发由物理演算根据头部角度驱动，不算在内
+    changed = [ids[i] for i in range(len(ids)) if abs(model.GetParameterValue(i) - defaults[i]) > 1e-4]
+    print("changed:", changed)
+    assert any(i in masked for i in changed)
+    assert all(i in masked or i.startswith("ParamHair") for i in changed)
+
+    try:
+        model.SetMotionLayerWeight("missing", 0.5)
+        assert False
+    except KeyError:
+        pass
+
+    model.SetMotionLayerWeight("gesture", 0.0)
+    model.StopLayerMotions("gesture")
+    assert model.IsLayerMotionFinished("gesture")
+    model.RemoveMotionLayer("gesture")
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,100 @@
+# 不预加载动作，预取 TapBody 组并在加载完成前开始其中的动作：StartMotion 返回 -1，动作在之后的 Update 中开始
+
+import os
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"), preloadMotions=False)
+    model.Resize(200, 200)
+
+    started = []
+    finished = []
+    model.PrefetchGroup("TapBody")
+    model.PrefetchGroup("TapBody")
+    handle = model.StartMotion("TapBody", 1, 3,
+                               onStartMotionHandler=lambda *args: started.append(args),
+                               onFinishMotionHandler=lambda *args: finished.append(args))
+    print("handle:", handle)
+    if handle == -1:
+        # 仍在加载，开始被推迟到加载完成后的 Update
+        assert not model.IsMotionFinished()
+
+    for _ in range(30):
+        model.Update()
+        model.Draw()
+        time.sleep(1 / 60)
+
+    print("started:", started)
+    assert len(started) == 1
+    assert not model.IsMotionFinished()
+
+    # 加载完成后与预加载的动作相同
+    t = time.perf_counter()
+    handle = model.StartMotion("TapBody", 2, 3)
+    print("start: %.3f ms" % ((time.perf_counter() - t) * 1000))
+    assert handle != -1
+    assert not model.IsMotionFinished(handle)
+
+    # 未预取的动作仍然同步加载
+    assert model.StartMotion("Idle", 1, 3) != -1
+
+    model.PrefetchMotion("TapBody", 3)
+    model.PrefetchMotion("Missing", 0)
+    model.StopAllMotions()
+    assert model.IsMotionFinished()
+
+    # 等待中的动作被取代或模型重新加载时，其回调立即结束；排在后面的请求在 StartMotion 时通常仍在加载
+    waiting = live2d.LAppModel()
+    waiting.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"), preloadMotions=False)
+    waiting.PrefetchGroup("Idle")
+    waiting.PrefetchGroup("TapBody")
+    replaced = []
+    if waiting.StartMotion("TapBody", 2, 3, onFinishMotionHandler=lambda: replaced.append(2)) == -1:
+        waiting.StartMotion("TapBody", 3, 3, onFinishMotionHandler=lambda: replaced.append(3))
+        print("replaced:", replaced)
+        assert replaced == [2]
+        if not waiting.IsMotionFinished():
+            waiting.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"),
+                                  preloadMotions=False)
+            print("reloaded:", replaced)
+            assert replaced == [2, 3]
+            assert waiting.IsMotionFinished()
+    del waiting
+
+    # 加载未完成的模型也可以直接销毁
+    other = live2d.LAppModel()
+    other.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"), preloadMotions=False)
+    other.PrefetchGroup("Idle")
+    del other
+
+    del model
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,115 @@
+# 参数输入通道：按时间戳插值、缺失的 id 与长度检查、缓冲区满时丢帧、EMA / One-Euro 滤波，以及流水线模式
+
+import math
+import random
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_model, index_of, model_path
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    dt = 1 / 60
+    model = create_model(seed=3, autoBlink=False, autoBreath=False)
+    angleX = index_of(model, "ParamAngleX")
+    angleY = index_of(model, "ParamAngleY")
+
+    # 30 Hz 的斜坡 value = 30 * t，以 60 Hz 更新，播放头落后一帧，应当得到逐帧的线性插值
+    model.BindParameterChannel(["ParamAngleX", "NotAParameter", "ParamAngleY"])
+    model.SetParameterChannelDelay(1 / 30)
+    maxError = 0.0
+    for frame in range(50):
+        if frame % 2 == 0:
+            t = frame / 60
+            assert model.PushParameterFrame([30 * t, 123.0, -10.0], t)
+        model.Update(dt)
+        expected = max(0.0, (frame - 2) / 2)
+        maxError = max(maxError, abs(model.GetParameterValue(angleX) - expected))
+        assert abs(model.GetParameterValue(angleY) + 10) < 1e-5
+    print("interpolation max error: %.2e" % maxError)
+    assert maxError < 1e-4
+
+    try:
+        model.PushParameterFrame([1.0, 2.0])
+        assert False
+    except ValueError:
+        pass
+
+    # 缓冲区满时新帧被丢弃
+    model.BindParameterChannel(["ParamAngleX"], 1.0, 4)
+    results = [model.PushParameterFrame([float(i)], i / 30) for i in range(6)]
+    print("push results with capacity 4:", results, model.GetParameterChannelDroppedFrames())
+    assert results == [True] * 4 + [False] * 2
+    assert model.GetParameterChannelDroppedFrames() == 2
+    model.Update(dt)
+    assert model.PushParameterFrame([0.0], 1.0)
+
+    # 滤波：带噪声的常量经 EMA 后抖动明显减小，One-Euro 对阶跃仍能跟上
+    random.seed(1)
+    spreads = {}
+    for name, kwargs in (("none", {}), ("ema", {"timeConstant": 0.2}), ("oneEuro", {"minCutoff": 0.5, "beta": 0.05})):
+        model.BindParameterChannel(["ParamAngleX"])
+        model.SetParameterChannelFilter(name, **kwargs)
+        model.SetParameterChannelDelay(0)
+        values = []
+        for frame in range(240):
+            model.PushParameterFrame([10 + random.uniform(-3, 3)], frame / 60)
+            model.Update(dt)
+            if frame >= 120:
+                values.append(model.GetParameterValue(angleX))
+        mean = sum(values) / len(values)
+        spreads[name] = math.sqrt(sum((v - mean) ** 2 for v in values) / len(values))
+
+        for frame in range(240, 300):
+            model.PushParameterFrame([-20.0], frame / 60)
+            model.Update(dt)
+        assert abs(model.GetParameterValue(angleX) + 20) < 1.0, (name, model.GetParameterValue(angleX))
+    print("noise spread:", ", ".join("%s %.3f" % item for item in spreads.items()))
+    assert spreads["ema"] < spreads["none"] / 3
+    assert spreads["oneEuro"] < spreads["none"] / 3
+
+    # 流水线模式下推入不等待模拟线程，数值晚一步可见
+    model.SetParameterChannelFilter("none")
+    model.BindParameterChannel(["ParamAngleX"])
+    model.SetParameterChannelDelay(0)
+    model.SetPipelineEnable(True)
+    for frame in range(10):
+        model.PushParameterFrame([float(frame)], frame / 60)
+        model.Update(dt)
+    model.SetPipelineEnable(False)
+    print("pipelined value: %.2f" % model.GetParameterValue(angleX))
+    assert abs(model.GetParameterValue(angleX) - 9) < 1e-5
+
+    # 重新加载模型后按 id 重新绑定
+    model.LoadModelJson(model_path("Hiyori"))
+    model.PushParameterFrame([7.0], 100.0)
+    model.Update(dt)
+    assert abs(model.GetParameterValue(index_of(model, "ParamAngleX")) - 7) < 1e-5
+
+    model.BindParameterChannel([])
+    model.Update(dt)
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,125 @@
+# 批量参数写入：与逐个调用 SetParameterValue / AddParameterValue 的结果逐位一致，包括截断、权重、缺失的 id、
+# 流水线模式与重新加载模型
+
+import random
+from array import array
+
+import live2d.v3 as live2d
+
+import glfw
+
+import fixtures
+from fixtures import model_path, parameters
+
+
+def create_model():
+    model = fixtures.create_model(seed=3, autoBlink=False, autoBreath=False)
+    model.Update(1 / 60)
+    return model
+
+
+def f32(value):
+    return array("f", [value])[0]
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    random.seed(7)
+    reference = create_model()
+    batched = create_model()
+    ids = [reference.GetParameter(i).id for i in range(reference.GetParameterCount())]
+    ids.insert(3, "NotAParameter")
+
+    plan = batched.BindParameters(ids)
+    assert len(plan) == len(ids)
+
+    # 超出范围的数值被截断，权重为 1 与非 1 时都与逐个调用相同
+    for step in range(20):
+        values = [random.uniform(-60, 60) for _ in ids]
+        weights = [random.choice((1.0, 0.0, random.random())) for _ in ids]
+        for paramId, value, weight in zip(ids, values, weights):
+            if paramId != "NotAParameter":
+                reference.SetParameterValue(paramId, value, weight)
+        if step % 2 == 0:
+            plan.set(array("f", values), array("f", weights))
+        else:
+            plan.set(values, weights)
+        assert parameters(reference) == parameters(batched), step
+
+    for paramId in ids:
+        if paramId != "NotAParameter":
+            reference.SetParameterValue(paramId, 0.25, 0.5)
+    plan.set(array("d", [0.25] * len(ids)), 0.5)
+    assert parameters(reference) == parameters(batched)
+
+    # 乘积按 float32 计算，与 C++ 中 value * weight 相同
+    for step in range(20):
+        values = [f32(random.uniform(-5, 5)) for _ in ids]
+        weight = f32(random.choice((1.0, 0.3)))
+        for paramId, value in zip(ids, values):
+            if paramId != "NotAParameter":
+                reference.AddParameterValue(paramId, f32(value * weight))
+        plan.add(values, weight)
+        assert parameters(reference) == parameters(batched), step
+
+    # 保存的数值在下一次 Update 的 LoadParameters 之后仍然一致
+    reference.Update(1 / 60)
+    batched.Update(1 / 60)
+    assert parameters(reference) == parameters(batched)
+
+    try:
+        plan.set([1.0, 2.0])
+        assert False
+    except ValueError:
+        pass
+
+    # 流水线模式下写入排队到下一步
+    reference.SetPipelineEnable(True)
+    batched.SetPipelineEnable(True)
+    for step in range(10):
+        values = [f32(random.uniform(-30, 30)) for _ in ids]
+        for paramId, value in zip(ids, values):
+            if paramId != "NotAParameter":
+                reference.SetParameterValue(paramId, value, 0.5)
+                reference.AddParameterValue(paramId, f32(value * f32(0.1)))
+        plan.set(values, 0.5)
+        plan.add(values, 0.1)
+        reference.Update(1 / 60)
+        batched.Update(1 / 60)
+    reference.SetPipelineEnable(False)
+    batched.SetPipelineEnable(False)
+    assert parameters(reference) == parameters(batched)
+    print("pipelined values match")
+
+    # 重新加载模型后按 id 重新解析
+    batched.LoadModelJson(model_path("Hiyori"))
+    batched.Update(1 / 60)
+    angleX = [batched.GetParameter(i).id for i in range(batched.GetParameterCount())].index("ParamAngleX")
+    plan.set([12.5 if paramId == "ParamAngleX" else 0.0 for paramId in ids])
+    assert batched.GetParameterValue(angleX) == 12.5
+
+    empty = batched.BindParameters([])
+    empty.set([])
+    empty.add([])
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+# 流水线模式与普通模式用相同的种子和输入驱动，检查参数逐帧一致、参数修改推迟一步生效、动作回调照常执行、
+# Tick 的每一步都与普通模式一致（包括表情的 fadeout），并输出统计
+
+import math
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_model, parameters
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    pipelined = create_model(seed=42)
+    pipelined.SetPipelineEnable(True)
+    serial = create_model(seed=42)
+    dt = 1 / 60
+    finished = []
+
+    mouth = [0.5 + 0.5 * math.sin(frame * 0.3) for frame in range(900)]
+    for frame in range(900):
+        if frame % 300 == 0:
+            pipelined.StartRandomMotion(priority=3, onFinishMotionHandler=lambda: finished.append(frame))
+            serial.StartRandomMotion(priority=3)
+
+        pipelined.Update(dt)
+        serial.Update(dt)
+        # 上一帧在 Update 之后记下的修改，在这一步的动作与物理之后应用
+        if frame > 0:
+            serial.SetParameterValue("ParamMouthOpenY", mouth[frame - 1])
+        assert parameters(pipelined) == parameters(serial), frame
+
+        pipelined.SetParameterValue("ParamMouthOpenY", mouth[frame])
+        pipelined.Draw()
+        serial.Draw()
+
+    assert finished, finished
+    stats = pipelined.GetPipelineStats()
+    assert stats["steps"] == 900, stats
+    print(stats)
+
+    # Tick 连续推进多步：表情的 fadeout 按模型时间在同一步恢复，动作回调在 Tick 期间执行
+    ticked = create_model(seed=7)
+    ticked.SetPipelineEnable(True)
+    reference = create_model(seed=7)
+    callbacks = {"ticked": [], "reference": []}
+    for tick in range(90):
+        for name, model in (("ticked", ticked), ("reference", reference)):
+            # TapBody 3 长 4.03 秒，在下一次开始之前播完
+            if tick % 30 == 0:
+                model.SetExpression("F01")
+                model.SetExpression("F03", fadeout=400 + tick)
+                model.StartMotion("TapBody", 3, 3,
+                                  onFinishMotionHandler=lambda name=name, tick=tick: callbacks[name].append(tick))
+            model.Tick(10, dt)
+        # 动作在 Tick 的中间几步结束，回调须在 Tick 返回之前执行，而不是留到下一次调用
+        assert callbacks["ticked"] == callbacks["reference"], (tick, callbacks)
+        assert parameters(ticked) == parameters(reference), tick
+    assert len(callbacks["ticked"]) == 3, callbacks
+    assert ticked.GetPipelineStats()["steps"] == 900
+
+    # 关闭后记下的修改直接写入模型
+    pipelined.SetParameterValue("ParamMouthOpenY", 0.25)
+    pipelined.SetPipelineEnable(False)
+    assert abs(pipelined.GetParameterValue(pipelined.GetParamIds().index("ParamMouthOpenY")) - 0.25) < 1e-6
+    assert pipelined.GetPipelineStats()["steps"] == 0
+
+    pipelined.SetPipelineEnable(True)
+    for name, model in (("serial", serial), ("pipelined", pipelined)):
+        t = time.perf_counter()
+        for _ in range(600):
+            model.Update(dt)
+            model.Draw()
+        print("%s: %.2f ms/frame" % (name, (time.perf_counter() - t) * 1000 / 600))
+    print(pipelined.GetPipelineStats())
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,81 @@
+# 姿势：淡入淡出完成后更新不改变部件不透明度，切换显示部件的参数或外部改写不透明度时下一次更新立即响应
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_model
+
+DT = 1 / 60
+# Haru.pose3.json 的第一组，部件 id 同时作为选择显示部件的参数 id
+PART_A = "Part01ArmRA001"
+PART_B = "Part01ArmRB001"
+FADE_SECONDS = 0.5
+
+
+def settle(model, seconds=2.0):
+    for _ in range(int(seconds / DT)):
+        model.Update(DT)
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = create_model(autoBlink=False, autoBreath=False)
+    partIds = model.GetPartIds()
+    a = partIds.index(PART_A)
+    b = partIds.index(PART_B)
+    opacities = memoryview(model.GetPartOpacitiesView())
+
+    # 初始显示各组的第一个部件
+    settle(model)
+    assert opacities[a] == 1 and opacities[b] == 0, (opacities[a], opacities[b])
+
+    # 稳定后继续更新，所有部件的不透明度都不变
+    settled = opacities.tolist()
+    for _ in range(30):
+        model.Update(DT)
+        assert opacities.tolist() == settled
+
+    # 切换到 B：下一次更新 B 按 dt / 淡入时间开始淡入，A 随之变淡
+    model.SetParameterValue(PART_A, 0)
+    model.SetParameterValue(PART_B, 1)
+    model.Update(DT)
+    print("after switching: A %.4f, B %.4f" % (opacities[a], opacities[b]))
+    assert abs(opacities[b] - DT / FADE_SECONDS) < 1e-6, opacities[b]
+    assert opacities[a] < 1
+    settle(model)
+    assert opacities[a] == 0 and opacities[b] == 1, (opacities[a], opacities[b])
+
+    # 外部把隐藏的部件改为不透明，下一次更新由姿势重新隐藏
+    model.SetPartOpacity(a, 1)
+    model.Update(DT)
+    assert opacities[a] == 0 and opacities[b] == 1, (opacities[a], opacities[b])
+    switched = opacities.tolist()
+    for _ in range(30):
+        model.Update(DT)
+        assert opacities.tolist() == switched
+
+    del opacities
+    del model
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
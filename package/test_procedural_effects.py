@@ -0,0 +1,88 @@
+# 程序化效果：LAppProceduralEffects::Sin 的误差界，以及呼吸、眨眼与拖拽视线与 Cubism SDK 逐个参数计算的结果一致
+
+import math
+from array import array
+
+import live2d.v3 as live2d
+from live2d.v3 import live2d as native
+
+import glfw
+
+from fixtures import create_model, index_of, parameters
+
+SIN_ERROR = 2.4e-7
+SIN_RANGE = 1e5
+# 各模型与 SDK 计算的最大参数差；Hiyori 的物理把舍入差放大到约 1e-3，
+# 出现在范围为 ±45 的旋转参数上，约为范围的 1e-5
+TOLERANCE = {"Haru": 1e-5, "Hiyori": 2e-3, "Mao": 1e-5, "Natori": 1e-5}
+
+
+def check_sin():
+    # 整个范围均匀取点，另外取 π/2 的整数倍附近（折叠与归约的边界）
+    xs = [-SIN_RANGE + 2 * SIN_RANGE * i / 200000 for i in range(200001)]
+    for k in range(-64, 65):
+        for d in (-1e-3, -1e-6, 0.0, 1e-6, 1e-3):
+            xs.append(k * math.pi / 2 + d)
+    xs = array("f", xs)
+    ys = native._effectsSin(xs)
+    # 参照值为同一个 float 输入的 sin 舍入到 float，即 sinf
+    expected = array("f", [math.sin(x) for x in xs])
+    error = max(abs(y - e) for y, e in zip(ys, expected))
+    print("sin max error: %.3g" % error)
+    assert error <= SIN_ERROR, error
+
+
+def check_effects(name):
+    batched = create_model(name, seed=11)
+    reference = create_model(name, seed=11)
+    reference.SetProceduralEffectsEnable(False)
+
+    breath = index_of(batched, "ParamBreath")
+    breaths = set()
+    difference = 0.0
+    for frame in range(1200):
+        # 拖拽沿圆周移动，覆盖 x、y 与 xy 三项
+        if frame < 900:
+            x = 100 + 90 * math.cos(frame / 40)
+            y = 100 + 90 * math.sin(frame / 25)
+            batched.Drag(x, y)
+            reference.Drag(x, y)
+        batched.Update(1 / 60)
+        reference.Update(1 / 60)
+        breaths.add(round(batched.GetParameterValue(breath), 3))
+        difference = max(difference, max(abs(a - b) for a, b in zip(parameters(batched), parameters(reference))))
+
+    print("%s max difference: %.3g" % (name, difference))
+    assert len(breaths) > 10
+    assert difference < TOLERANCE[name], difference
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    check_sin()
+
+    for name in TOLERANCE:
+        check_effects(name)
+
+    live2d.dispose()
+
+    glfw.terminate()
+    print("success")
+
+
+if __name__ == "__main__":
+    main()
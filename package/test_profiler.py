@@ -0,0 +1,106 @@
+# 分阶段计时：各阶段与绘制计数的统计、关闭时不记录、流水线模式，以及 Chrome trace 的输出
+
+import json
+import os
+import tempfile
+
+import live2d.v3 as live2d
+
+import glfw
+
+import resources
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    model = live2d.LAppModel()
+    model.LoadModelJson(os.path.join(resources.RESOURCES_DIRECTORY, "v3/Haru/Haru.model3.json"))
+    model.Resize(200, 200)
+
+    # 关闭时不记录
+    for _ in range(10):
+        model.Update(1 / 60)
+        model.Draw()
+    profile = model.GetProfile()
+    assert not profile["enabled"] and profile["stages"] == {} and profile["counters"] == {}
+
+    model.SetProfilerEnable(True, 60)
+    for _ in range(100):
+        model.Update(1 / 60)
+        model.Draw()
+    profile = model.GetProfile()
+    for name, stats in profile["stages"].items():
+        print("%-15s p50 %.3f ms  p95 %.3f ms  p99 %.3f ms" % (name, stats["p50"], stats["p95"], stats["p99"]))
+    for name in ("update", "motion", "expression", "drag", "breath", "physics", "pose", "modelUpdate", "drawSubmit", "draw"):
+        stats = profile["stages"][name]
+        assert stats["count"] == 100, (name, stats)
+        assert 0 <= stats["p50"] <= stats["p95"] <= stats["p99"] <= stats["max"], (name, stats)
+    assert profile["stages"]["update"]["p50"] >= profile["stages"]["physics"]["p50"]
+    assert "lipSync" not in profile["stages"]
+
+    counters = profile["counters"]
+    print("counters:", {name: stats["max"] for name, stats in counters.items()})
+    assert counters["drawCalls"]["count"] == 100
+    assert counters["drawCalls"]["max"] > 0
+    assert counters["maskDrawCalls"]["max"] < counters["drawCalls"]["max"]
+    if counters["masks"]["max"] > 0:
+        assert "masks" in profile["stages"]
+        assert counters["maskDrawCalls"]["max"] > 0
+
+    model.ResetProfile()
+    assert model.GetProfile()["stages"] == {}
+
+    # 流水线模式下模拟阶段在模拟线程上记录
+    model.SetPipelineEnable(True)
+    for _ in range(30):
+        model.Update(1 / 60)
+        model.Draw()
+    model.SetPipelineEnable(False)
+    profile = model.GetProfile()
+    assert profile["stages"]["update"]["count"] == 30
+    assert profile["stages"]["modelUpdate"]["count"] == 30
+    assert profile["stages"]["draw"]["count"] == 30
+
+    # Chrome trace
+    model.SetProfilerEnable(False)
+    model.StartProfileTrace()
+    for _ in range(5):
+        model.Update(1 / 60)
+        model.Draw()
+    path = os.path.join(tempfile.mkdtemp(), "trace.json")
+    count = model.SaveProfileTrace(path)
+    with open(path) as f:
+        trace = json.load(f)
+    events = trace["traceEvents"]
+    print("trace events:", count)
+    assert len(events) == count > 0
+    assert sum(1 for event in events if event["name"] == "update") == 5
+    for event in events:
+        assert event["ph"] == "X" and event["dur"] >= 0
+    try:
+        model.SaveProfileTrace(path)
+        assert False
+    except RuntimeError:
+        pass
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
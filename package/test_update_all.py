@@ -0,0 +1,79 @@
+# 用 updateAll 批量更新一组模型，与逐个 Update(dt) 的结果比较，并检查动作回调在批次结束后按顺序执行
+
+import time
+
+import live2d.v3 as live2d
+
+import glfw
+
+from fixtures import create_models, parameters
+
+
+def main():
+
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    if not window:
+        glfw.terminate()
+        exit()
+
+    glfw.make_context_current(window)
+
+    live2d.init()
+
+    live2d.glInit()
+
+    count = 8
+    batched = create_models(count, seed=100)
+    serial = create_models(count, seed=100)
+    dt = 1 / 60
+    finished = []
+    current = [0]
+
+    for frame in range(900):
+        current[0] = frame
+        if frame % 300 == 0:
+            for i in range(count):
+                batched[i].StartRandomMotion(priority=3,
+                                             onFinishMotionHandler=lambda i=i: finished.append((current[0], i)))
+                serial[i].StartRandomMotion(priority=3)
+        live2d.updateAll(batched, dt)
+        for model in serial:
+            model.Update(dt)
+        for i in range(count):
+            assert parameters(batched[i]) == parameters(serial[i]), (frame, i)
+        batched[0].Draw()
+
+    # 同一批次内结束的动作按模型顺序回调
+    assert finished and finished == sorted(finished), finished
+    print("finished callbacks:", finished)
+
+    try:
+        live2d.updateAll([batched[0], batched[0]], dt)
+        assert False
+    except ValueError:
+        pass
+
+    try:
+        live2d.updateAll([batched[0], 1], dt)
+        assert False
+    except TypeError:
+        pass
+
+    many = create_models(32, seed=100)
+    for threads in (1, live2d.getUpdateThreadCount()):
+        live2d.setUpdateThreadCount(threads)
+        t = time.perf_counter()
+        for _ in range(300):
+            live2d.updateAll(many, dt)
+        print("%d threads, 32 models x 300 frames: %.2f s" % (threads, time.perf_counter() - t))
+
+    live2d.dispose()
+
+    glfw.terminate()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,87 @@
+# v2 原生 .moc 解码：与 BinaryReader 读出的对象图逐项相同，以及速度对比
+
+import glob
+import os
+import time
+
+import live2d.v2 as live2d
+from live2d.v2.core.alive2d_model import ALive2DModel
+from live2d.v2.core.io import NativeBinaryReader
+from live2d.v2.core.util import UtNative
+
+import resources
+
+
+def compare(a, b, path, seen):
+    if type(a) is not type(b):
+        raise AssertionError("%s: %s != %s" % (path, type(a).__name__, type(b).__name__))
+
+    if isinstance(a, (list, tuple)):
+        assert len(a) == len(b), path
+        for i in range(len(a)):
+            compare(a[i], b[i], "%s[%d]" % (path, i), seen)
+    elif hasattr(a, "__dict__") and not isinstance(a, type):
+        # 同一个对象被多处引用时，两边也须指向同一个对象
+        if id(a) in seen:
+            assert seen[id(a)] is b, path
+            return
+        seen[id(a)] = b
+        assert a.__dict__.keys() == b.__dict__.keys(), path
+        for key in a.__dict__:
+            # 句柄与按创建顺序编号的实例号不参与比较
+            if key in ("packedPivotPoints", "instanceNo"):
+                continue
+            compare(a.__dict__[key], b.__dict__[key], path + "." + key, seen)
+    else:
+        assert a == b, "%s: %r != %r" % (path, a, b)
+
+
+def decode(buf):
+    return NativeBinaryReader(buf, UtNative.decodeMoc(buf)).readObject()
+
+
+def main():
+    live2d.setLogEnable(False)
+
+    if not UtNative.available:
+        print("native module unavailable, skipped")
+        return
+
+    for path in sorted(glob.glob(os.path.join(resources.RESOURCES_DIRECTORY, "v2", "**", "*.moc"), recursive=True)):
+        with open(path, "rb") as f:
+            buf = f.read()
+
+        start = time.perf_counter()
+        python = ALive2DModel.readModelImpl(buf)
+        pythonTime = time.perf_counter() - start
+
+        start = time.perf_counter()
+        native = decode(buf)
+        nativeTime = time.perf_counter() - start
+
+        compare(python, native, "modelImpl", {})
+        print("%s: python %.2f ms, native %.2f ms" % (os.path.basename(path), pythonTime * 1000, nativeTime * 1000))
+
+        # 截断或损坏的文件两边都应当报错，原生解码不得越界
+        for size in (0, 3, 4, len(buf) // 3, len(buf) - 1):
+            for reader in (ALive2DModel.readModelImpl, decode):
+                try:
+                    reader(buf[:size])
+                except Exception:
+                    pass
+                else:
+                    raise AssertionError("%s truncated to %d bytes was accepted" % (path, size))
+
+    for buf, message in ((b"mod\x0b", "Invalid MOC file."), (b"moc\x0c", "Unsupported version 12\n")):
+        try:
+            decode(buf)
+        except RuntimeError as e:
+            assert str(e) == message, str(e)
+        else:
+            raise AssertionError(message)
+
+    print("pass")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,86 @@
+# v2 原生加速：与纯 Python 实现逐位相同的插值与变形结果，以及速度对比
+
+import os
+import time
+
+import live2d.v2 as live2d
+from live2d.v2.core.util import UtNative
+
+import glfw
+
+import resources
+
+
+def snapshot(model):
+    mc = model.live2DModel.getModelContext()
+    values = []
+    for dc in mc.drawContextList:
+        values.append(list(dc.interpolatedPoints) if dc.interpolatedPoints is not None else None)
+        values.append(list(dc.transformedPoints) if dc.transformedPoints is not None else None)
+    for dc in mc.deformerContextList:
+        for name in ("interpolatedPoints", "transformedPoints"):
+            points = getattr(dc, name, None)
+            values.append(list(points) if points is not None else None)
+        for name in ("interpolatedAffine", "transformedAffine"):
+            affine = getattr(dc, name, None)
+            if affine is not None:
+                values.append((affine.originX, affine.originY, affine.scaleX, affine.scaleY, affine.rotationDeg))
+    return values
+
+
+def update(model, native, frame):
+    UtNative.available = native
+    mc = model.live2DModel.getModelContext()
+    # 超出范围的取值让点落到网格之外
+    for i in range(len(mc.paramIdList)):
+        low = mc.getParamMin(i)
+        high = mc.getParamMax(i)
+        phase = ((frame * 7 + i * 13) % 29) / 28.0
+        mc.setParamFloat(i, low - (high - low) * 0.5 + (high - low) * 2.0 * phase)
+    start = time.perf_counter()
+    model.live2DModel.update()
+    return time.perf_counter() - start
+
+
+def main():
+    if not glfw.init():
+        exit()
+
+    window = glfw.create_window(200, 200, "test context", None, None)
+    glfw.make_context_current(window)
+
+    live2d.init()
+    live2d.setLogEnable(False)
+
+    if not UtNative.available:
+        print("native module unavailable, skipped")
+        return
+
+    for name in ("haru/haru.model.json", "kasumi2/kasumi2.model.json", "Epsilon/Epsilon.model.json"):
+        path = os.path.join(resources.RESOURCES_DIRECTORY, "v2", name)
+        if not os.path.exists(path):
+            continue
+
+        UtNative.available = True
+        native = live2d.LAppModel()
+        native.LoadModelJson(path)
+
+        UtNative.available = False
+        python = live2d.LAppModel()
+        python.LoadModelJson(path)
+
+        nativeTime = 0.0
+        pythonTime = 0.0
+        for frame in range(30):
+            nativeTime += update(native, True, frame)
+            pythonTime += update(python, False, frame)
+            assert snapshot(native) == snapshot(python), (name, frame)
+
+        UtNative.available = True
+        print("%s: python %.2f ms, native %.2f ms per update" % (name, pythonTime / 30 * 1000, nativeTime / 30 * 1000))
+
+    print("pass")
+
+
+if __name__ == "__main__":
+    main()